@@ -0,0 +1,16 @@
+#pragma once
+
+#include "ECS/ECStypes.h"
+
+#include <vector>
+#include <utility>
+
+// Finds the entries' pairs whose bounding volumes overlap, with at least one of them wanting callback.
+// Implementations keep state across frames, so they should get the entries of every frame
+class BroadPhaseCollision
+{
+public:
+    virtual ~BroadPhaseCollision() = default;
+
+    virtual std::vector<std::pair<CollisionDetectionEntry, CollisionDetectionEntry>> ExecuteBroadPhaseCollision(const std::vector<CollisionDetectionEntry>& collisionDetectionEntries) = 0;
+};
@@ -3,33 +3,94 @@
 #include "ECS/ECStypes.h"
 #include "ECS/ECSwrapper.h"
 
-#include "CollisionDetection/SweepAndPrune.h"
+#include "configuru.hpp"
+
+#include "CollisionDetection/BroadPhaseCollision.h"
+#include "CollisionDetection/CollisionPairCache.h"
+#include "CollisionDetection/ContinuousCollision.h"
 #include "CollisionDetection/OBBtreesCollision.h"
 #include "CollisionDetection/CreateUncollideRays.h"
+#include "CollisionDetection/SceneQueries.h"
 #include "CollisionDetection/ShootUncollideRays.h"
 
+#include <chrono>
+#include <map>
+
+class WorkersPool;
+
 class CollisionDetection
 {
 public:
-    CollisionDetection(ECSwrapper* in_ECSwrapper_ptr);
+    // Of the latest ExecuteCollisionDetection, so collision can be profiled without the renderer
+    struct FrameStats
+    {
+        size_t entriesCount = 0;
+        size_t broadPhasePairsCount = 0;
+        size_t collidedPairsCount = 0;
+        size_t sweptPairsCount = 0;
+        size_t tunneledPairsCount = 0;
+
+        std::chrono::duration<float> broadPhaseDuration = std::chrono::duration<float>::zero();
+        std::chrono::duration<float> pairsDuration = std::chrono::duration<float>::zero();           // mid and narrow phase
+        std::chrono::duration<float> continuousDuration = std::chrono::duration<float>::zero();
+        std::chrono::duration<float> callbacksDuration = std::chrono::duration<float>::zero();
+
+        uint64_t callbacksHash = 0;     // FNV-1a of the callbacks' data, changes with any difference at the results
+    };
+
+public:
+    CollisionDetection(ECSwrapper* in_ECSwrapper_ptr, configuru::Config& in_cfgFile, WorkersPool* in_workersPool_ptr = nullptr);
 
     void Reset();
     void AddCollisionDetectionEntry(const CollisionDetectionEntry in_collisionDetectionEntry);
 
     void ExecuteCollisionDetection();
 
+    // Counters since start, all zero when the pair cache is disabled
+    CollisionPairCache::Stats GetPairCacheStats() const;
+    const FrameStats& GetFrameStats() const;
+
+    // Over the entries of the latest ExecuteCollisionDetection, already during its callbacks
+    const SceneQueries* GetSceneQueriesPtr() const;
+
 private:
-    void MakeCallbacks(std::unordered_map<Entity, std::vector<CollisionCallbackData>>&& callbacks_to_be_made) const;
+    struct PairCollisionResult
+    {
+        bool hasCollided = false;
+        CollisionCallbackData firstCallbackData;
+        CollisionCallbackData secondCallbackData;
+
+        CollisionPairCache::LookupResult cacheLookupResult = CollisionPairCache::LookupResult::miss;
+        CollisionPairCache::Entry cacheEntry;           // unused when the cached entry is kept as it is
+    };
+
+    // Mid phase and narrow phase of a broad phase pair. Touches nothing but its result, so pairs can run in parallel
+    PairCollisionResult ExecutePairCollision(const std::pair<CollisionDetectionEntry, CollisionDetectionEntry>& entries_pair) const;
 
-    float PointMovementBetweenFrames(glm::vec3 point, const glm::mat4& m_first, const glm::mat4& m_second);
+    // Both entries' callback data go to their ancestors that are not common
+    void AddPairCallbacks(const CollisionCallbackData& first_collisionCallbackData,
+                          const CollisionCallbackData& second_collisionCallbackData,
+                          std::map<Entity, std::vector<CollisionCallbackData>>& callbacks_to_be_made) const;
+    void MakeCallbacks(std::map<Entity, std::vector<CollisionCallbackData>>&& callbacks_to_be_made) const;
+
+    float PointMovementBetweenFrames(glm::vec3 point, const glm::mat4& m_first, const glm::mat4& m_second) const;
+
+    static uint64_t GetCallbacksHash(const std::map<Entity, std::vector<CollisionCallbackData>>& callbacks_to_be_made);
 
 private:
     std::vector<CollisionDetectionEntry> collisionDetectionEntries;
+    FrameStats frameStats;
 
-    std::unique_ptr<SweepAndPrune> broadPhaseCollision_uptr;
+    std::unique_ptr<BroadPhaseCollision> broadPhaseCollision_uptr;
     std::unique_ptr<OBBtreesCollision> midPhaseCollision_uptr;
     std::unique_ptr<CreateUncollideRays> createUncollideRays_uptr;
     std::unique_ptr<ShootUncollideRays> shootDeltaUncollide_uptr;
+    std::unique_ptr<CollisionPairCache> pairCache_uptr;
+    std::unique_ptr<ContinuousCollision> continuousCollision_uptr;
+    std::unique_ptr<SceneQueries> sceneQueries_uptr;
 
     ECSwrapper* const ECSwrapper_ptr;
+    WorkersPool* const workersPool_ptr;
+
+    static constexpr size_t parallelPairsBatchSize = 4;
 };
\ No newline at end of file
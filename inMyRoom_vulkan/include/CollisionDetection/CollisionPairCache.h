@@ -0,0 +1,71 @@
+#pragma once
+
+#include "CollisionDetection/CreateUncollideRays.h"
+#include "ECS/ECStypes.h"
+
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Mid and narrow phase results of the previous frame's broad phase pairs, by entity pair.
+// A pair whose relative transform did not change reuses them (resting contacts), and a pair that moved
+// less than "revalidateMaxMovement" re-creates the uncollide rays only at the leaf pairs its last traversal found.
+// Lookups are const, so pairs can look up in parallel, and the cache is replaced once per frame
+class CollisionPairCache
+{
+public:
+    enum class LookupResult
+    {
+        miss,               // full mid and narrow phase
+        sameTransform,      // uncollide rays reused
+        revalidate          // uncollide rays re-created at cached leaf pairs
+    };
+
+    struct Entry
+    {
+        const OBBtree* firstOBBtree_ptr = nullptr;
+        const OBBtree* secondOBBtree_ptr = nullptr;
+
+        glm::mat4x4 traversalRelativeMatrix;                // second to first space, when the leaf pairs were found
+        OBBtreesIntersectInfo OBBtreesIntersectInfoObj;
+
+        glm::mat4x4 raysRelativeMatrix;                     // second to first space, when the rays were created
+        CDentriesUncollideRays uncollideRays;
+    };
+
+    struct Stats
+    {
+        size_t lookupsCount = 0;
+        size_t sameTransformHitsCount = 0;
+        size_t revalidateHitsCount = 0;
+
+        float GetHitRate() const {return lookupsCount ? float(sameTransformHitsCount + revalidateHitsCount) / float(lookupsCount) : 0.f;}
+    };
+
+public:
+    // Movement as a fraction of the second OBBtree's root OBB size
+    explicit CollisionPairCache(float in_revalidateMaxMovement);
+
+    LookupResult Lookup(const std::pair<CollisionDetectionEntry, CollisionDetectionEntry>& entries_pair,
+                        const glm::mat4x4& relative_matrix,
+                        const Entry*& cached_entry_ptr) const;
+
+    // New entries of this frame's pairs plus the pairs that keep their entry. Pairs missing from both are dropped
+    void Update(std::vector<std::pair<std::pair<Entity, Entity>, Entry>>&& new_entries,
+                const std::vector<std::pair<Entity, Entity>>& kept_entries_pairs);
+    void AddLookupResult(LookupResult lookup_result);
+
+    const Stats& GetStats() const {return stats;}
+
+private:
+    static uint64_t GetKey(Entity first, Entity second) {return (uint64_t(first) << 32) | uint64_t(second);}
+
+    static float GetMaxOBBcornersMovement(const OBB& obb, const glm::mat4x4& lhs_matrix, const glm::mat4x4& rhs_matrix);
+
+private:
+    std::unordered_map<uint64_t, Entry> entries;
+    Stats stats;
+
+    const float revalidateMaxMovement;
+};
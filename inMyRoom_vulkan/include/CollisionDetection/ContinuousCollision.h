@@ -0,0 +1,41 @@
+#pragma once
+
+#include "ECS/ECStypes.h"
+
+#include "Geometry/OBBtree.h"
+
+#include <utility>
+#include <vector>
+
+struct CDentriesTimeOfImpact
+{
+    CollisionDetectionEntry firstEntry;                     // the swept one
+    CollisionDetectionEntry secondEntry;
+    bool doImpact = false;
+    float timeOfImpact = 1.f;
+    glm::vec3 normal = glm::vec3(0.f);                      // world space of this frame, normalized, facing towards first. Zero when they overlapped already at the previous frame
+    glm::vec3 relativeDisplacement = glm::vec3(0.f);        // first's movement relative to second, world space of this frame
+};
+
+// Entries flagged "isContinuous" get their movement from the previous frame's matrices to this frame's swept against
+// the other entries' OBBtrees, so fast movers do not tunnel through thin geometry between two frames
+class ContinuousCollision
+{
+public:
+    // Entries that moved less than "in_minMovementFactor" of their root OBB's thinnest side are left to the discrete phases
+    explicit ContinuousCollision(float in_minMovementFactor);
+
+    // Continuous entry first. Bounds cover both frames, and at least one of the two entries wants callback
+    std::vector<std::pair<CollisionDetectionEntry, CollisionDetectionEntry>> FindSweptPairs(const std::vector<CollisionDetectionEntry>& collisionDetectionEntries) const;
+
+    // Sweeps first against second at second's space. Translation only: first keeps its previous frame's relative rotation along the sweep
+    CDentriesTimeOfImpact ExecuteTimeOfImpact(const std::pair<CollisionDetectionEntry, CollisionDetectionEntry>& entries_pair) const;
+
+private:
+    bool HasMovedEnough(const Paralgram& root_paralgram, const glm::vec3& movement) const;
+
+    static std::pair<glm::vec3, glm::vec3> GetSweptMinMax(const CollisionDetectionEntry& entry);
+
+private:
+    const float minMovementFactor;
+};
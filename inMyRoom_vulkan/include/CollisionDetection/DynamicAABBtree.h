@@ -0,0 +1,225 @@
+#pragma once
+
+#include "CollisionDetection/BroadPhaseCollision.h"
+#include "Geometry/OBBtree.h"
+#include "ECS/ECStypes.h"
+
+#include <array>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <vector>
+
+// Box at U, V, W axis, the same SweepAndPrune projects on, so both broad phases give the same pairs
+struct BroadPhaseAABB
+{
+    std::array<float, 3> min;
+    std::array<float, 3> max;
+
+    bool DoesOverlap(const BroadPhaseAABB& other) const;
+    bool DoesContain(const BroadPhaseAABB& other) const;
+    float GetSurfaceArea() const;
+    float GetDistanceSquared(const std::array<float, 3>& point) const;
+    // Distance at which the ray enters, infinity if it misses it before "max_distance"
+    float GetRayEnterDistance(const std::array<float, 3>& origin, const std::array<float, 3>& inverse_direction, float max_distance) const;
+
+    static BroadPhaseAABB GetUnion(const BroadPhaseAABB& lhs, const BroadPhaseAABB& rhs);
+};
+
+struct DynamicAABBtreeNode
+{
+    BroadPhaseAABB fatAABB;
+    int32_t parent = -1;            // or next free node
+    int32_t child1 = -1;
+    int32_t child2 = -1;
+    int32_t height = 0;             // leaf = 0, free = -1
+    Entity entity = 0;
+
+    bool IsLeaf() const {return child1 == -1;}
+};
+
+struct DynamicAABBtreeProxy
+{
+    BroadPhaseAABB tightAABB;
+    int32_t leafIndex = -1;
+    size_t entryIndex;              // at this frame's entries
+    size_t lastFrame = -1;
+    bool shouldCallback;
+};
+
+// Bounding volume tree of fattened AABBs. Leaves get reinserted only when their tight box leaves the fat one,
+// and the tree is kept balanced with rotations at insertions/removals
+class DynamicAABBtree final
+    : public BroadPhaseCollision
+{
+public:
+    DynamicAABBtree(glm::vec3 in_U_axis, glm::vec3 in_V_axis, glm::vec3 in_W_axis);
+
+    std::vector<std::pair<CollisionDetectionEntry, CollisionDetectionEntry>> ExecuteBroadPhaseCollision(const std::vector<CollisionDetectionEntry>& collisionDetectionEntries) override;
+
+    // Same as ExecuteBroadPhaseCollision without looking for pairs
+    void UpdateTree(const std::vector<CollisionDetectionEntry>& collisionDetectionEntries);
+
+    int32_t GetHeight() const;
+
+    // Queries over the latest entries, visitors get the entry's index at them. Points and directions are at world space
+    BroadPhaseAABB GetParalgramAABB(const Paralgram& paralgram) const;
+    std::array<float, 3> GetAxesProjections(const glm::vec3& vector) const;
+
+    template<typename Visitor>          // bool visitor(size_t entry_index), false stops
+    void QueryAABB(const BroadPhaseAABB& aabb, Visitor&& visitor) const;
+    template<typename Visitor>          // float visitor(size_t entry_index), returns the new max distance, negative stops. "direction" normalized
+    void QueryRay(const glm::vec3& origin, const glm::vec3& direction, float max_distance, Visitor&& visitor) const;
+    template<typename Visitor>          // float visitor(size_t entry_index, float box_distance), nearest box first, returns the max distance still wanted
+    void QueryNearest(const glm::vec3& point, Visitor&& visitor) const;
+
+private:
+    void UpdateProxies(const std::vector<CollisionDetectionEntry>& collisionDetectionEntries);
+    BroadPhaseAABB GetTightAABB(const CollisionDetectionEntry& collisionDetectionEntry) const;
+    BroadPhaseAABB GetFatAABB(const BroadPhaseAABB& tight_aabb, const CollisionDetectionEntry& collisionDetectionEntry) const;
+
+    int32_t AllocateNode();
+    void FreeNode(int32_t node_index);
+
+    void InsertLeaf(int32_t leaf_index);
+    void RemoveLeaf(int32_t leaf_index);
+    void RefitAncestors(int32_t node_index);
+    int32_t Balance(int32_t node_index);
+
+private:
+    std::vector<DynamicAABBtreeNode> nodes;
+    int32_t rootIndex = -1;
+    int32_t freeListIndex = -1;
+
+    std::vector<DynamicAABBtreeProxy> proxiesOfEntities;
+    std::vector<Entity> activeEntities;
+    size_t frameIndex = 0;
+
+    const std::array<glm::vec3, 3> axes;
+
+    static constexpr float fatMargin = 0.1f;
+    static constexpr float displacementMultiplier = 2.f;    // fat box stretches towards last frame's movement
+};
+
+template<typename Visitor>
+void DynamicAABBtree::QueryAABB(const BroadPhaseAABB& aabb, Visitor&& visitor) const
+{
+    if (rootIndex == -1)
+        return;
+
+    std::vector<int32_t> stack;
+    stack.emplace_back(rootIndex);
+    while (stack.size())
+    {
+        const DynamicAABBtreeNode& this_node = nodes[stack.back()];
+        stack.pop_back();
+
+        if (not this_node.fatAABB.DoesOverlap(aabb))
+            continue;
+
+        if (this_node.IsLeaf())
+        {
+            const DynamicAABBtreeProxy& this_proxy = proxiesOfEntities[this_node.entity];
+            if (this_proxy.tightAABB.DoesOverlap(aabb) && not visitor(this_proxy.entryIndex))
+                return;
+        }
+        else
+        {
+            stack.emplace_back(this_node.child1);
+            stack.emplace_back(this_node.child2);
+        }
+    }
+}
+
+template<typename Visitor>
+void DynamicAABBtree::QueryRay(const glm::vec3& origin, const glm::vec3& direction, float max_distance, Visitor&& visitor) const
+{
+    if (rootIndex == -1)
+        return;
+
+    // Axes are orthonormal, so distances along the ray stay the same
+    const std::array<float, 3> uvw_origin = GetAxesProjections(origin);
+    const std::array<float, 3> uvw_direction = GetAxesProjections(direction);
+    const std::array<float, 3> inverse_direction = {1.f / uvw_direction[0], 1.f / uvw_direction[1], 1.f / uvw_direction[2]};
+
+    // Nearest child first, so the max distance shrinks early
+    std::vector<std::pair<int32_t, float>> stack;
+    if (float root_distance = nodes[rootIndex].fatAABB.GetRayEnterDistance(uvw_origin, inverse_direction, max_distance);
+        root_distance != std::numeric_limits<float>::infinity())
+        stack.emplace_back(rootIndex, root_distance);
+
+    while (stack.size())
+    {
+        auto [node_index, enter_distance] = stack.back();
+        stack.pop_back();
+
+        if (enter_distance > max_distance)
+            continue;
+
+        const DynamicAABBtreeNode& this_node = nodes[node_index];
+        if (this_node.IsLeaf())
+        {
+            const DynamicAABBtreeProxy& this_proxy = proxiesOfEntities[this_node.entity];
+            if (this_proxy.tightAABB.GetRayEnterDistance(uvw_origin, inverse_direction, max_distance) != std::numeric_limits<float>::infinity())
+            {
+                max_distance = visitor(this_proxy.entryIndex);
+                if (max_distance < 0.f)
+                    return;
+            }
+        }
+        else
+        {
+            float child1_distance = nodes[this_node.child1].fatAABB.GetRayEnterDistance(uvw_origin, inverse_direction, max_distance);
+            float child2_distance = nodes[this_node.child2].fatAABB.GetRayEnterDistance(uvw_origin, inverse_direction, max_distance);
+
+            std::pair<int32_t, float> near_child = {this_node.child1, child1_distance};
+            std::pair<int32_t, float> far_child = {this_node.child2, child2_distance};
+            if (far_child.second < near_child.second)
+                std::swap(near_child, far_child);
+
+            if (far_child.second != std::numeric_limits<float>::infinity())
+                stack.emplace_back(far_child);
+            if (near_child.second != std::numeric_limits<float>::infinity())
+                stack.emplace_back(near_child);
+        }
+    }
+}
+
+template<typename Visitor>
+void DynamicAABBtree::QueryNearest(const glm::vec3& point, Visitor&& visitor) const
+{
+    if (rootIndex == -1)
+        return;
+
+    const std::array<float, 3> uvw_point = GetAxesProjections(point);
+    float max_distance = std::numeric_limits<float>::infinity();
+
+    // Min heap of squared distance to node's box
+    using heap_element = std::pair<float, int32_t>;
+    std::priority_queue<heap_element, std::vector<heap_element>, std::greater<heap_element>> heap;
+    heap.emplace(nodes[rootIndex].fatAABB.GetDistanceSquared(uvw_point), rootIndex);
+
+    while (heap.size())
+    {
+        auto [distance_squared, node_index] = heap.top();
+        heap.pop();
+
+        if (distance_squared > max_distance * max_distance)
+            return;
+
+        const DynamicAABBtreeNode& this_node = nodes[node_index];
+        if (this_node.IsLeaf())
+        {
+            const DynamicAABBtreeProxy& this_proxy = proxiesOfEntities[this_node.entity];
+            float tight_distance = std::sqrt(this_proxy.tightAABB.GetDistanceSquared(uvw_point));
+            if (tight_distance <= max_distance)
+                max_distance = visitor(this_proxy.entryIndex, tight_distance);
+        }
+        else
+        {
+            heap.emplace(nodes[this_node.child1].fatAABB.GetDistanceSquared(uvw_point), this_node.child1);
+            heap.emplace(nodes[this_node.child2].fatAABB.GetDistanceSquared(uvw_point), this_node.child2);
+        }
+    }
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "ECS/ECStypes.h"
+#include "CollisionDetection/DynamicAABBtree.h"
+
+#include <memory>
+#include <vector>
+
+// Raycasts, overlaps and nearest queries against the collision detection entries of the latest frame.
+// Candidates come from a DynamicAABBtree over the entries' root OBBs (the broad phase's, if it is one), then the meshes' OBBtrees decide.
+// Queries are const, so they can run in parallel with each other, but not with Update (ModelCollision's update runs at a stage of its own)
+class SceneQueries
+{
+public:
+    SceneQueries(glm::vec3 in_U_axis, glm::vec3 in_V_axis, glm::vec3 in_W_axis);
+    // Shares the broad phase's tree, which has to be updated with the same entries before Update
+    SceneQueries(const DynamicAABBtree* in_broadPhaseAABBtree_ptr);
+
+    void Update(const std::vector<CollisionDetectionEntry>& collisionDetectionEntries);
+
+    std::vector<SceneRaycastHit> Raycast(const glm::vec3& origin, const glm::vec3& direction, float max_distance, SceneRaycastMode mode) const;
+    std::vector<Entity> OverlapBox(const glm::vec3& center, const glm::vec3& half_side_u, const glm::vec3& half_side_v, const glm::vec3& half_side_w) const;
+    std::vector<Entity> OverlapSphere(const glm::vec3& center, float radius) const;
+    std::vector<SceneNearestEntity> NearestEntities(const glm::vec3& point, size_t count) const;
+
+private:
+    std::vector<CollisionDetectionEntry> collisionDetectionEntries;
+
+    std::unique_ptr<DynamicAABBtree> ownAABBtree_uptr;
+    const DynamicAABBtree* AABBtree_ptr;
+};
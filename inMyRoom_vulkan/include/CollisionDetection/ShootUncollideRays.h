@@ -13,12 +13,13 @@ private:
         glm::vec3 point_objB_normal;
     };
 
-    static HermannPassResult HermannPass(const OBBtree* objA_OBBtree_ptr,
-                                         const OBBtree* objB_OBBtree_ptr,
-                                         const glm::mat4& objA_mat,
-                                         const glm::mat4& objB_mat,
-                                         const glm::mat3& objB_normalCorrected_mat,
-                                         Ray ray);
+    // Rays are traced as batches, see RayPacket
+    static std::vector<HermannPassResult> HermannPasses(const OBBtree* objA_OBBtree_ptr,
+                                                        const OBBtree* objB_OBBtree_ptr,
+                                                        const glm::mat4& objA_mat,
+                                                        const glm::mat4& objB_mat,
+                                                        const glm::mat3& objB_normalCorrected_mat,
+                                                        const std::vector<Ray>& rays);
 
     static Ray ReflectHermannResult(const HermannPassResult& hermann_pass_result,
                                     const Ray& ray);
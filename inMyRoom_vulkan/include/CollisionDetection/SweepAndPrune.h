@@ -1,45 +1,65 @@
 #pragma once
 
+#include "CollisionDetection/BroadPhaseCollision.h"
 #include "Geometry/OBBtree.h"
 #include "ECS/ECStypes.h"
 
-struct SweepAndPruneEntry
-{
-    std::pair<float, float> minMaxProjection;
-    Entity index;
-    bool shouldCallback;
-};
+#include <array>
+#include <vector>
+#include <unordered_set>
 
-struct hash_pair
+struct SweepAndPruneProxy
 {
-    template <class T1, class T2>
-    size_t operator()(const std::pair<T1, T2>& p) const
-    {
-        auto hash1 = std::hash<T1>{}(p.first);
-        auto hash2 = std::hash<T2>{}(p.second);
-        return hash1 ^ hash2;
-    }
+    std::array<std::pair<float, float>, 3> minMaxProjections;   // at U, V, W axis
+    size_t entryIndex;                                          // at this frame's entries
+    size_t lastFrame = -1;
+    bool shouldCallback;
+    bool isActive = false;                                      // has endpoints at axes
 };
 
-struct commutative_equal_pair
+struct SweepAndPruneEndpoint
 {
-    template <class T1, class T2>
-    bool operator()(const std::pair<T1, T2>& p1, const std::pair<T1, T2>& p2) const
-    {
-        return (p1.first == p2.first) && (p1.second == p2.second) ||
-               (p1.first == p2.second) && (p1.second == p2.first);
-    }
+    float value;
+    Entity entity;
+    bool isMin;
 };
 
-class SweepAndPrune
+// Persistent SAP. Endpoints stay sorted across frames, so they are fixed with insertion sort,
+// and the overlapping pairs are kept up to date by the swaps it does.
+// A frame that adds many entities (as the first one) sorts all endpoints again and sweeps for the pairs instead
+class SweepAndPrune final
+    : public BroadPhaseCollision
 {
 public:
     SweepAndPrune(glm::vec3 in_U_axis, glm::vec3 in_V_axis, glm::vec3 in_W_axis);
 
-    std::vector<std::pair<CollisionDetectionEntry, CollisionDetectionEntry>> ExecuteSweepAndPrune(const std::vector<CollisionDetectionEntry>& collisionDetectionEntries);
+    std::vector<std::pair<CollisionDetectionEntry, CollisionDetectionEntry>> ExecuteBroadPhaseCollision(const std::vector<CollisionDetectionEntry>& collisionDetectionEntries) override;
 
 private:
-    const glm::vec3 U_axis;
-    const glm::vec3 V_axis;
-    const glm::vec3 W_axis;
-};
\ No newline at end of file
+    // Returns if so many got added that sorting from scratch is cheaper than their endpoints travelling from infinity
+    bool UpdateProxies(const std::vector<CollisionDetectionEntry>& collisionDetectionEntries);
+    void RemoveEndpointsAndPairsOf(const std::vector<Entity>& removed_entities);
+    void UpdateAxisEndpointsValues(size_t axis_index);
+    void SortAxisEndpoints(size_t axis_index);
+    void RebuildEndpointsAndPairs();
+
+    void OnOverlapBegin(Entity lhs, Entity rhs);
+    void OnOverlapEnd(Entity lhs, Entity rhs);
+
+    bool DoProxiesOverlap(const SweepAndPruneProxy& lhs, const SweepAndPruneProxy& rhs) const;
+    static bool IsEndpointAfter(const SweepAndPruneEndpoint& lhs, const SweepAndPruneEndpoint& rhs);
+    static uint64_t GetPairKey(Entity lhs, Entity rhs);
+
+private:
+    std::vector<SweepAndPruneProxy> proxiesOfEntities;
+    std::array<std::vector<SweepAndPruneEndpoint>, 3> axisEndpoints;
+
+    std::unordered_set<uint64_t> overlappingPairs;      // only of pairs that at least one should callback
+
+    std::vector<Entity> activeEntities;
+    size_t frameIndex = 0;
+
+    const std::array<glm::vec3, 3> axes;
+
+    static constexpr size_t rebuildAddedFraction = 8;      // rebuild when more than 1/8 of the entities were added
+};
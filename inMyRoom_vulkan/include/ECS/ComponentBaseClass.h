@@ -1,5 +1,6 @@
 #pragma once
 
+#include <chrono>
 #include <memory>
 #include <string>
 #include <map>
@@ -21,22 +22,23 @@ public:
     virtual void Deinit() {}
 
     virtual void Update() {}
-    virtual void AsyncInput(InputType input_type, void* struct_data = nullptr) {}
-    virtual void CollisionCallback(const std::vector<std::pair<Entity, std::vector<CollisionCallbackData>>>& callback_entity_data_pairs) {}
-    virtual void ToBeRemovedCallback(const std::vector<std::pair<Entity, Entity>>& callback_ranges) {}
+    virtual UpdateAccess GetUpdateAccess() const {return UpdateAccess(); }
+    virtual void AsyncInput(InputType /*input_type*/, void* /*struct_data*/, std::chrono::steady_clock::time_point /*event_timePoint*/) {}
+    virtual void CollisionCallback(const std::vector<std::pair<Entity, std::vector<CollisionCallbackData>>>& /*callback_entity_data_pairs*/) {}
+    virtual void ToBeRemovedCallback(const std::vector<std::pair<Entity, Entity>>& /*callback_ranges*/) {}
      
     virtual size_t PushBackNewFab() {return -1;}
-    virtual void AddCompEntityAtLatestFab(Entity entity, const std::string& fab_path, const CompEntityInitMap& init_map) {}
+    virtual void AddCompEntityAtLatestFab(Entity /*entity*/, const std::string& /*fab_path*/, const CompEntityInitMap& /*init_map*/) {}
     virtual std::pair<Entity, Entity> GetLatestFabRange() {return std::make_pair<Entity, Entity>(-1,-1);}
 
-    virtual DataSetPtr InitializeFab(Entity offset, size_t fab_index) {return nullptr; }
-    virtual void RemoveInstancesByRanges(const std::vector<std::pair<Entity, Entity>>& ranges) {}
+    virtual DataSetPtr InitializeFab(Entity /*offset*/, size_t /*fab_index*/) {return nullptr; }
+    virtual void RemoveInstancesByRanges(const std::vector<std::pair<Entity, Entity>>& /*ranges*/) {}
 
     virtual void AddInitializedFabs() {}
     virtual void NewUpdateSession() {}
                                                                         
 protected:
-    virtual ComponentEntityPtr GetComponentEntityVoidPtr(Entity this_entity, size_t index_hint) {return nullptr; }
+    virtual ComponentEntityPtr GetComponentEntityVoidPtr(Entity /*this_entity*/, size_t /*index_hint*/) {return nullptr; }
 
 public:
     virtual componentID GetComponentID() const {return -1; }
@@ -9,6 +9,7 @@
 
 #include "dense_set.h"
 #include "sparse_set.h"
+#include "chunked_set.h"
 
 template<typename ComponentEntityType, componentID _component_ID, FixedString _component_name,
          template<typename _I, typename _D, typename _D_B, _I _D_B::*> typename data_set>
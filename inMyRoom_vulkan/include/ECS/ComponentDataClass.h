@@ -2,8 +2,10 @@
 
 #include "ECS/ComponentBaseWrappedClass.h"
 #include "ECS/TemplateHelpers.h"
+#include "WorkersPool.h"
 
 #include <vector>
+#include <type_traits>
 
 template<typename ComponentEntityType, componentID component_ID, FixedString component_name,
          template<typename _I, typename _D, typename _D_B, _I _D_B::*> typename data_set>
@@ -31,6 +33,9 @@ protected:
     data_set<Entity, ComponentEntityType, CompEntityBaseClass, &CompEntityBaseClass::thisEntity>& GetContainerByIndex(size_t index);
     size_t GetContainersCount() const;
 
+    // For components that use the default Update and want to be scheduled by their CompEntity::Update signature
+    UpdateAccess GetUpdateAccessOfCompEntities() const requires TrivialUpdatable<ComponentEntityType>;
+
 private:
     ComponentEntityPtr GetComponentEntityVoidPtr(Entity this_entity, size_t index_hint) override;
 
@@ -43,6 +48,8 @@ protected:
 
     size_t containersUpdated = 0;
 
+    static constexpr size_t parallelUpdateBatchSize = 256;
+
 private:
     std::vector<data_set<Entity, ComponentEntityType, CompEntityBaseClass, &CompEntityBaseClass::thisEntity>> fabs;
 };
@@ -201,15 +208,54 @@ void ComponentDataClass<ComponentEntityType, component_ID, component_name, data_
 {
     auto component_ptrs = GetComponentPtrsOfArguments(ComponentBaseClass::ecsWrapper_ptr, &ComponentEntityType::Update);
 
+    WorkersPool* workers_pool_ptr = ComponentBaseClass::ecsWrapper_ptr->GetWorkersPool();
+    bool entities_parallel = workers_pool_ptr != nullptr && this->GetUpdateAccess().isEntitiesParallel;
+
     size_t containers_count_when_start = GetContainersCount();
     for(; containersUpdated != containers_count_when_start; ++containersUpdated)
     {
         auto& this_container = GetContainerByIndex(containersUpdated);
-        for(auto& this_comp_entity: this_container)
+        size_t this_container_index = containersUpdated;
+
+        auto update_range = [&this_container, this_container_index, &component_ptrs](size_t first, size_t last)
         {
-            auto arguments = TranslateComponentPtrsIntoArguments(static_cast<Entity>(this_comp_entity.thisEntity), containersUpdated, component_ptrs);
+            auto range_iterators = this_container.get_position_range_iterators(first, last);
+            for(auto it = range_iterators.first; it != range_iterators.second; ++it)
+            {
+                auto& this_comp_entity = *it;
+                auto arguments = TranslateComponentPtrsIntoArguments(static_cast<Entity>(this_comp_entity.thisEntity), this_container_index, component_ptrs);
 
-            std::apply(&ComponentEntityType::Update, std::tuple_cat(std::tie(this_comp_entity), arguments));
+                std::apply(&ComponentEntityType::Update, std::tuple_cat(std::tie(this_comp_entity), arguments));
+            }
+        };
+
+        if(entities_parallel && this_container.container_size() > parallelUpdateBatchSize)
+        {
+            if constexpr (requires {this_container.chunks_count();})
+            {
+                // Batches of whole chunks, so workers never share one
+                constexpr size_t chunk_size = std::remove_reference_t<decltype(this_container)>::chunk_size;
+                workers_pool_ptr->ParallelFor(this_container.chunks_count(), parallelUpdateBatchSize / chunk_size,
+                                              [&update_range](size_t first_chunk, size_t last_chunk)
+                                              {
+                                                  update_range(first_chunk * chunk_size, last_chunk * chunk_size);
+                                              });
+            }
+            else
+            {
+                workers_pool_ptr->ParallelFor(this_container.container_size(), parallelUpdateBatchSize, update_range);
+            }
+        }
+        else
+        {
+            update_range(0, this_container.container_size());
         }
     }
 }
+
+template<typename ComponentEntityType, componentID component_ID, FixedString component_name,
+        template<typename _I, typename _D, typename _D_B, _I _D_B::*> typename data_set>
+UpdateAccess ComponentDataClass<ComponentEntityType, component_ID, component_name, data_set>::GetUpdateAccessOfCompEntities() const requires TrivialUpdatable<ComponentEntityType>
+{
+    return GetUpdateAccessOfArguments(component_ID, &ComponentEntityType::Update);
+}
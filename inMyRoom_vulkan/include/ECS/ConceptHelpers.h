@@ -19,7 +19,7 @@ template <class T>
 concept DeltaTime = std::is_same<std::chrono::duration<float>, T>::value;
 
 template <class T>
-concept EntitiesHandlerType = std::is_same<class EntitiesHandler, T>::value;
+concept EntitiesHandlerType = std::is_same<class EntitiesHandler, typename std::remove_cv<T>::type>::value;
 
 template <class T>
 concept TrivialUpdateParameter = Component<typename std::remove_pointer<T>::type>
@@ -6,6 +6,7 @@
 #include <unordered_map>
 #include <map>
 #include <set>
+#include <type_traits>
 
 #include "glm/gtx/quaternion.hpp"
 #include "glm/vec3.hpp"
@@ -15,11 +16,22 @@
 #include "common/structs/ModelMatrices.h"
 #include "common/defines.h"
 
-typedef uint16_t Entity;
+typedef uint32_t Entity;
 typedef uint32_t componentID;
 typedef void* ComponentEntityPtr;
 typedef void* DataSetPtr;
 
+// Entity plus the generation of its slot at the time it was taken.
+// Entities get recycled, so long-living references (e.g. game code) should keep a handle and resolve it back to its entity
+// through ECSwrapper or ExportedFunctions every time they use it
+struct EntityHandle
+{
+    Entity entity = Entity(-1);
+    uint32_t generation = 0;
+
+    bool operator==(const EntityHandle& other) const = default;
+};
+
 struct CompEntityInitMap
 {
     std::unordered_map<std::string, glm::vec4> vec4Map;       // vec4_type
@@ -88,6 +100,19 @@ struct InstanceInfo
     std::set<InstanceInfo*> instanceChildren;
 };
 
+// used a lot in: ECSwrapper update scheduling
+struct UpdateAccess
+{
+    bool isSchedulable = false;             // If false, component updates alone at its componentID order
+    bool isEntitiesParallel = false;        // Component entities' updates are independent of each other
+
+    bool readsEntitiesHandler = false;
+    bool writesEntitiesHandler = false;
+
+    std::vector<componentID> readComponentIDs;
+    std::vector<componentID> writeComponentIDs;
+};
+
 // used a lot in: Animation Actors
 enum class InterpolationType
 {
@@ -152,6 +177,8 @@ struct CollisionDetectionEntry
     glm::mat4x4 previousGlobalMatrix;
     const class OBBtree* OBBtree_ptr;
     bool shouldCallback;
+    bool isStatic;          // both matrices same as at the previous collision detection
+    bool isContinuous;      // fast mover, also swept from previousGlobalMatrix to currentGlobalMatrix against the others
     Entity entity;
 };
 
@@ -160,6 +187,31 @@ struct CollisionCallbackData
     Entity familyEntity;
     Entity collideWithEntity;
     glm::vec3 deltaVector = glm::vec3(0.f, 0.f, 0.f);
+    bool hasTimeOfImpact = false;                           // set by continuous collision
+    float timeOfImpact = 1.f;                               // 0 at the previous frame's matrices, 1 at this frame's
+    glm::vec3 contactNormal = glm::vec3(0.f, 0.f, 0.f);     // normalized, facing towards familyEntity
+};
+
+// used a lot in: scene queries (ExportedFunctions)
+enum class SceneRaycastMode : uint8_t
+{
+    Closest,        // nearest hit only
+    Any,            // first hit found, cheapest
+    All             // nearest hit of every entity, sorted by distance
+};
+
+struct SceneRaycastHit
+{
+    Entity entity = 0;
+    float distance = 0.f;
+    glm::vec3 position = glm::vec3(0.f, 0.f, 0.f);
+    glm::vec3 normal = glm::vec3(0.f, 0.f, 0.f);            // of the hit triangle, normalized, facing against the ray
+};
+
+struct SceneNearestEntity
+{
+    Entity entity = 0;
+    float distance = 0.f;                                   // to the entity's root OBB, 0 if inside
 };
 
 // used a lot in: Light
@@ -203,8 +255,31 @@ struct DrawInfo
     bool isLightSource = false;
     bool hasMorphTargets = false;
 
-    std::vector<float> weights;
+    size_t weightsOffset = -1;              // morph target weights, range of the frame's morphWeights
+    size_t weightsCount = 0;
     size_t inverseMatricesOffset = -1;
 
     bool dontCull = false;
-};
\ No newline at end of file
+};
+
+// What the ECS hands to the renderer every frame. Graphics keeps one alive and only clears it,
+// renderers swap it with their own, so both sides reuse their buffers' capacity from frame to frame
+struct FrameDrawData
+{
+    std::vector<ModelMatrices> matrices;
+    std::vector<LightInfo> lightInfos;
+    std::vector<DrawInfo> drawInfos;
+    std::vector<float> morphWeights;
+    std::vector<uint32_t> visibleDrawInfos;     // ascending indices of drawInfos that passed frustum culling
+
+    void Clear()
+    {
+        matrices.clear();
+        lightInfos.clear();
+        drawInfos.clear();
+        morphWeights.clear();
+        visibleDrawInfos.clear();
+    }
+};
+// Copying them around (e.g. renderers assorting draw infos) must not touch the heap
+static_assert(std::is_trivially_copyable_v<LightInfo> && std::is_trivially_copyable_v<DrawInfo>);
\ No newline at end of file
@@ -15,6 +15,8 @@
 
 #include "ECS/ConceptHelpers.h"
 
+class WorkersPool;
+
 class AdditionInfo
 {
 public:
@@ -83,13 +85,20 @@ public:
     AdditionInfo* AddInstance(const FabInfo* fab_info_ptr, const std::string& instance_name, Entity parent = 0);
     void RemoveInstance(InstanceInfo* instance_info_ptr);
 
+    EntityHandle GetEntityHandle(Entity entity) const;
+    Entity ResolveEntityHandle(const EntityHandle& handle) const;                               // Entity(-1) once its instance's removal completes
+
     void Update();
-    void AsyncInput(InputType input_type, void* struct_data = nullptr);                         // Forbidden to add or remove anything
+    void AsyncInput(InputType input_type, void* struct_data = nullptr,                          // Forbidden to add or remove anything
+                    std::chrono::steady_clock::time_point event_timePoint = std::chrono::steady_clock::now());
 
     void CompleteAddsAndRemoves();
 
     ExportedFunctions* GetEnginesExportedFunctions() const;
 
+    void SetWorkersPool(WorkersPool* in_workersPool_ptr);                                       // nullptr: sequential update at componentID order
+    WorkersPool* GetWorkersPool() const;
+
 private:
     void AddNodeExistence(FabInfo& fab_info, Node* this_node_ptr, Entity& entities_added, Entity parent, std::string parent_name);
     void AddFabsCompEntitiesToComponents(FabInfo& fab_info, Node* this_node_ptr, Entity& entities_processes);
@@ -102,6 +111,12 @@ private:
 
     void GetChildrenInstanceTree(InstanceInfo* instance_info_ptr, std::vector<InstanceInfo*>& children);
 
+    void UpdateSequential();
+    void UpdateScheduled();
+    void UpdateStage(const std::vector<ComponentBaseClass*>& stage);
+    void BuildUpdateStages();
+    static bool DoUpdateAccessesConflict(const UpdateAccess& lhs, const UpdateAccess& rhs);
+
 private:    // data
     std::unordered_set<InstanceInfo*> instancesToBeRemoved;
     std::vector<InstanceInfo*> instancesToCallbackToBeRemoved;
@@ -121,6 +136,10 @@ private:    // data
     std::unique_ptr<EntitiesHandler> entitiesHandler_uptr;
     ExportedFunctions* const exportedFunctions_ptr;
 
+    WorkersPool* workersPool_ptr = nullptr;
+    std::vector<std::vector<ComponentBaseClass*>> updateStages;
+    bool updateStagesDirty = true;
+
     std::mutex controlMutex;
 };
 
@@ -30,9 +30,14 @@ public:
 
     Entity GetParentOfEntity(Entity entity) const;
     void ChangeParentOfInstance(InstanceInfo* instance_ptr, Entity new_parent);
+    size_t GetParentChangesCount() const;
 
     size_t GetContainerIndexOfEntity(Entity entity) const;
 
+    EntityHandle GetEntityHandle(Entity entity) const;
+    bool IsEntityHandleValid(const EntityHandle& handle) const;
+    Entity ResolveEntityHandle(const EntityHandle& handle) const;       // Entity(-1) if its instance got removed
+
 private:
     std::pair<Entity, Entity> GetRange(size_t size);
     void AddAvailableRanges(std::vector<std::pair<Entity, Entity>>&& new_ranges);
@@ -42,7 +47,9 @@ private:
 private: // Data
     std::vector<Entity> parentOfEachEntity;
     std::vector<InstanceInfo*> instancePtrOfEachEntity;
-    std::vector<uint16_t> containerIndexOfEachEntity;
+    std::vector<uint32_t> containerIndexOfEachEntity;
+    std::vector<uint32_t> generationOfEachEntity;
+    size_t parentChangesCount = 0;
 
     std::multimap<size_t, std::pair<Entity, Entity>> availableRanges;
     std::vector<std::pair<Entity, Entity>> additionsNotCompletedRanges;
@@ -12,7 +12,18 @@ public:
 
     virtual void BindCameraEntity(Entity this_camera_entity) const = 0;
 
+    // Handles outlive their entities, see EntityHandle. Resolving returns Entity(-1) once the entity's instance is removed
+    virtual EntityHandle GetEntityHandle(Entity entity) const = 0;
+    virtual Entity ResolveEntityHandle(const EntityHandle& handle) const = 0;
+
     virtual size_t GetSphereMeshIndex() const = 0;
     virtual size_t GetCylinderMeshIndex() const = 0;
+
+    // Scene queries against ModelCollision entities, at their matrices of the latest collision detection.
+    // Box is center and half sides, overlaps test the meshes' triangles
+    virtual std::vector<SceneRaycastHit> Raycast(const glm::vec3& origin, const glm::vec3& direction, float max_distance, SceneRaycastMode mode) const = 0;
+    virtual std::vector<Entity> OverlapBox(const glm::vec3& center, const glm::vec3& half_side_u, const glm::vec3& half_side_v, const glm::vec3& half_side_w) const = 0;
+    virtual std::vector<Entity> OverlapSphere(const glm::vec3& center, float radius) const = 0;
+    virtual std::vector<SceneNearestEntity> NearestEntities(const glm::vec3& point, size_t count) const = 0;
 };
 
@@ -25,13 +25,24 @@ public:
     */
     static LateNodeGlobalMatrixCompEntity CreateComponentEntityByMap(Entity in_entity, std::string entity_name, const CompEntityInitMap& in_map);
 
-    void Update(EntitiesHandler* entities_handler_ptr,
-                NodeDataComp* nodeDataComp_ptr,
+    void Update(const EntitiesHandler* entities_handler_ptr,
+                const NodeDataComp* nodeDataComp_ptr,
                 LateNodeGlobalMatrixComp* lateNodeGlobalMatrixComp_ptr);
 
+    // Recalculates globalMatrix only if node's local transform or parent's matrix changed since the last time. Returns if it did
+    bool UpdateGlobalMatrix(const NodeDataCompEntity& node_data,
+                            Entity parent_entity,
+                            const glm::mat4x4& parent_global_matrix,
+                            uint32_t parent_matrix_version);
+
 #endif
 public: // data
     glm::mat4x4 globalMatrix = glm::mat4x4(1.f);
+    uint32_t matrixVersion = 0;                 // increased every time globalMatrix gets recalculated, 0 = never calculated
+
+    NodeDataCompEntity::LocalTransform calculatedLocalTransform = {};
+    Entity calculatedParentEntity = 0;
+    uint32_t calculatedParentMatrixVersion = 0;
 };
 
 #ifdef GAME_DLL
@@ -20,19 +20,24 @@ public:
             "MeshIndex",         meshIndex               = int
             "DisableCollision",  disableCollision        = int         (optional)
             "ShouldCallback",    shouldCallback          = int         (optional)
+            "ContinuousCollision", continuousCollision   = int         (optional)
     */
     static ModelCollisionCompEntity CreateComponentEntityByMap(Entity in_entity, std::string entity_name, const CompEntityInitMap& in_map);
 
     void AddCollisionDetectionEntryToVector(EarlyNodeGlobalMatrixComp* thisFrameNodeGlobalMatrix_ptr,
                                             LateNodeGlobalMatrixComp* previousFrameNodeGlobalMatrix_ptr,
                                             class MeshesOfNodes* meshesOfNodes_ptr,
-                                            class CollisionDetection* collisionDetection_ptr) const;
+                                            class CollisionDetection* collisionDetection_ptr);
 
 #endif
 public:
     uint32_t meshIndex;
     bool disableCollision = false;
     bool shouldCallback = false;
+    bool continuousCollision = false;
+
+    uint32_t lastThisFrameMatrixVersion = 0;
+    uint32_t lastPreviousFrameMatrixVersion = 0;
 };
 
 #ifdef GAME_DLL
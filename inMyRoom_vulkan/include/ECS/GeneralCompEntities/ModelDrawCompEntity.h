@@ -31,8 +31,10 @@ public:
                      const DynamicMeshComp* dynamicMeshComp_ptr,
                      const LightComp* lightComp_ptr,
                      const glm::mat4& viewport_matrix,
+                     bool is_viewport_unchanged,
                      std::vector<ModelMatrices>& model_matrices,
-                     std::vector<DrawInfo>& draw_infos);
+                     std::vector<DrawInfo>& draw_infos,
+                     std::vector<float>& morph_weights);
 
     void ToBeRemovedCallback();
 
@@ -47,6 +49,9 @@ public: // data
     bool isLight = false;
 
     size_t lastMatricesOffset = -1;
+
+    ModelMatrices cachedMatrices = {};         // of rigid meshes, kept while neither viewport nor node's matrix changes
+    uint32_t cachedMatrixVersion = 0;
 };
 
 #ifdef GAME_DLL
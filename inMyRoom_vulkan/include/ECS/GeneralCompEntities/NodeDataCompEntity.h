@@ -12,6 +12,17 @@ class NodeDataComp;
 class NodeDataCompEntity :
     public CompEntityBaseWrappedClass<NodeDataComp>
 {
+public:
+    struct LocalTransform
+    {
+        glm::vec3 scale;
+        glm::qua<float> rotation;
+        glm::vec3 translation;
+        glm::vec3 globalTranslation;
+
+        bool operator==(const LocalTransform& rhs) const;
+    };
+
 #ifndef GAME_DLL
 public:
     NodeDataCompEntity(Entity this_entity);
@@ -27,6 +38,7 @@ public:
     static NodeDataCompEntity CreateComponentEntityByMap(Entity in_entity, std::string entity_name, const CompEntityInitMap& in_map);
 
     glm::mat4x4 GetGlobalMatrix(glm::mat4x4 parent_global_matrix) const;
+    LocalTransform GetLocalTransform() const;
 
     void Update();
 
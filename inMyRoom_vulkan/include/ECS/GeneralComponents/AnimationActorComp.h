@@ -16,6 +16,7 @@ public:
     ~AnimationActorComp() override;
 
     void Update() override;
+    UpdateAccess GetUpdateAccess() const override;
 private:
     AnimationsDataOfNodes* animationsDataOfNodes_ptr;
 };
\ No newline at end of file
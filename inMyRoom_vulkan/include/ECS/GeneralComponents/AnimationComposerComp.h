@@ -12,4 +12,5 @@ class AnimationComposerComp final
 public:
     explicit AnimationComposerComp(ECSwrapper* in_ecs_wrapper_ptr);
     ~AnimationComposerComp() override;
+    UpdateAccess GetUpdateAccess() const override;
 };
\ No newline at end of file
@@ -16,6 +16,7 @@ public:
     ~CameraComp() override;
 
     void Update() override;
+    UpdateAccess GetUpdateAccess() const override;
 
     void ToggleCullingDebugging();
 
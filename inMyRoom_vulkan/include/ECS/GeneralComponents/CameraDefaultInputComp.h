@@ -14,7 +14,8 @@ public:
     ~CameraDefaultInputComp() override;
 
     void Update() override;
-    void AsyncInput(InputType input_type, void* struct_data = nullptr) override;
+    UpdateAccess GetUpdateAccess() const override;
+    void AsyncInput(InputType input_type, void* struct_data, std::chrono::steady_clock::time_point event_timePoint) override;
 
 public: // data
     const float default_speed;
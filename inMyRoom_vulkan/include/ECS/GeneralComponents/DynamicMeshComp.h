@@ -15,6 +15,7 @@ public:
     DynamicMeshComp(ECSwrapper* ecs_wrapper_ptr, DynamicMeshes* dynamicMeshes_ptr, MeshesOfNodes* meshesOfNodes_ptr);
 
     void Update() override;
+    UpdateAccess GetUpdateAccess() const override;
     void ToBeRemovedCallback(const std::vector<std::pair<Entity, Entity>>& callback_ranges) override;
 
 private:
@@ -2,9 +2,12 @@
 
 #include "ECS/GeneralCompEntities/EarlyNodeGlobalMatrixCompEntity.h"
 #include "ECS/ComponentDataClass.h"
+#include "ECS/HierarchyLevels.h"
 
 #include "ECS/ComponentsIDsEnum.h"
 
+#include <atomic>
+
 
 class EarlyNodeGlobalMatrixComp final
     : public ComponentDataClass<EarlyNodeGlobalMatrixCompEntity, static_cast<componentID>(componentIDenum::EarlyNodeGlobalMatrix), "EarlyNodeGlobalMatrix", dense_set>
@@ -12,5 +15,25 @@ class EarlyNodeGlobalMatrixComp final
 public:
     explicit EarlyNodeGlobalMatrixComp(ECSwrapper* const in_ecs_wrapper_ptr);
     ~EarlyNodeGlobalMatrixComp() override;
-};
 
+    void Update() override;
+    UpdateAccess GetUpdateAccess() const override;
+
+    void RemoveInstancesByRanges(const std::vector<std::pair<Entity, Entity>>& ranges) override;
+    void AddInitializedFabs() override;
+    void NewUpdateSession() override;
+
+    // Of the current/latest update session. Clean entities kept their matrix as nothing above them moved
+    size_t GetDirtyEntitiesCount() const;
+    size_t GetCleanEntitiesCount() const;
+
+private:
+    void UpdateByLevels(const NodeDataComp* nodeDataComp_ptr);
+    void UpdateCompEntity(EarlyNodeGlobalMatrixCompEntity& this_comp_entity, Entity parent_entity, const NodeDataComp* nodeDataComp_ptr);
+
+private:
+    HierarchyLevels hierarchyLevels;
+
+    std::atomic<size_t> dirtyEntitiesCount = 0;
+    size_t updatedEntitiesCount = 0;
+};
@@ -2,9 +2,12 @@
 
 #include "ECS/GeneralCompEntities/LateNodeGlobalMatrixCompEntity.h"
 #include "ECS/ComponentDataClass.h"
+#include "ECS/HierarchyLevels.h"
 
 #include "ECS/ComponentsIDsEnum.h"
 
+#include <atomic>
+
 
 class LateNodeGlobalMatrixComp final
     : public ComponentDataClass<LateNodeGlobalMatrixCompEntity, static_cast<componentID>(componentIDenum::LateNodeGlobalMatrix), "LateNodeGlobalMatrix", dense_set>
@@ -12,5 +15,25 @@ class LateNodeGlobalMatrixComp final
 public:
     explicit LateNodeGlobalMatrixComp(ECSwrapper* const in_ecs_wrapper_ptr);
     ~LateNodeGlobalMatrixComp() override;
-};
 
+    void Update() override;
+    UpdateAccess GetUpdateAccess() const override;
+
+    void RemoveInstancesByRanges(const std::vector<std::pair<Entity, Entity>>& ranges) override;
+    void AddInitializedFabs() override;
+    void NewUpdateSession() override;
+
+    // Of the current/latest update session. Clean entities kept their matrix as nothing above them moved
+    size_t GetDirtyEntitiesCount() const;
+    size_t GetCleanEntitiesCount() const;
+
+private:
+    void UpdateByLevels(const NodeDataComp* nodeDataComp_ptr);
+    void UpdateCompEntity(LateNodeGlobalMatrixCompEntity& this_comp_entity, Entity parent_entity, const NodeDataComp* nodeDataComp_ptr);
+
+private:
+    HierarchyLevels hierarchyLevels;
+
+    std::atomic<size_t> dirtyEntitiesCount = 0;
+    size_t updatedEntitiesCount = 0;
+};
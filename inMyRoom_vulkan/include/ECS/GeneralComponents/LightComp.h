@@ -14,6 +14,7 @@ public:
     LightComp(ECSwrapper* ecs_wrapper_ptr, Lights* lights_ptr);
 
     void Update() override;
+    UpdateAccess GetUpdateAccess() const override;
     void ToBeRemovedCallback(const std::vector<std::pair<Entity, Entity>>& callback_ranges) override;
 
     void AddLightInfos(const glm::mat4& viewport_matrix,
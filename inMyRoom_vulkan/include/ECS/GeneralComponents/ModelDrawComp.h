@@ -8,17 +8,43 @@
 #include "Graphics/Meshes/MeshesOfNodes.h"
 #include "Graphics/Meshes/PrimitivesOfMeshes.h"
 #include "Geometry/FrustumCulling.h"
+#include "Graphics/CullingInstancesBVH.h"
 
 class ModelDrawComp final
     : public ComponentDataClass<ModelDrawCompEntity, static_cast<componentID>(componentIDenum::ModelDraw), "ModelDraw", sparse_set>
 {
 public:
-    explicit ModelDrawComp(ECSwrapper* const in_ecs_wrapper_ptr);
+    ModelDrawComp(ECSwrapper* const in_ecs_wrapper_ptr,
+                  MeshesOfNodes* in_meshesOfNodes_ptr);
     ~ModelDrawComp() override;
 
+    // Every drawn entity emits its draw info each frame, as its matrices' offsets at the frame's buffers move with what is drawn.
+    // Of clean rigid nodes (same matrix version and viewport) only the matrices' products are skipped
     void AddDrawInfos(const glm::mat4& viewport_matrix,
                       std::vector<ModelMatrices>& matrices,
-                      std::vector<DrawInfo>& draw_infos);
+                      std::vector<DrawInfo>& draw_infos,
+                      std::vector<float>& morph_weights);
+    // Ascending indices of the latest AddDrawInfos' draw infos that the visibility passes should draw. Rigid meshes that allow culling are tested by
+    // their world root OBB's axis aligned box against the world space planes, skins, morphed meshes and light sources are always visible
+    void CullDrawInfos(const std::array<Plane, 6>& world_frustum_planes,
+                       const std::vector<DrawInfo>& draw_infos,
+                       std::vector<uint32_t>& visible_draw_infos);
     void ToBeRemovedCallback(const std::vector<std::pair<Entity, Entity>>& callback_ranges) override;
+
+private:
+    Paralgram GetWorldParalgram(size_t mesh_index, const glm::mat4& global_matrix) const;
+
+private:
+    MeshesOfNodes* const meshesOfNodes_ptr;
+
+    glm::mat4 lastViewportMatrix = glm::mat4(0.f);
+
+    std::vector<CullingInstancesBVH::InstanceKey> frameCullableInstances;      // of the latest AddDrawInfos, with their draw infos
+    std::vector<uint32_t> frameCullableDrawInfos;
+
+    CullingInstancesBVH cullingBVH;
+
+    std::vector<uint32_t> visibleInstances;
+    std::vector<uint8_t> isDrawInfoVisible;
 };
 
@@ -12,5 +12,7 @@ class NodeDataComp final
 public:
     explicit NodeDataComp(ECSwrapper* in_ecs_wrapper_ptr);
     ~NodeDataComp() override;
+
+    UpdateAccess GetUpdateAccess() const override;
 };
 
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <vector>
+#include <utility>
+
+#include "ECS/ECStypes.h"
+#include "WorkersPool.h"
+
+class EntitiesHandler;
+
+// Level-order (breadth-first) index of a component's entities, so the ones whose parent is root come first, then their children...
+// Updated incrementally on additions/removals, rebuilt only if an instance changed parent.
+// Levels are kept at entity order, so a level walks the component's data set forward and workers get spans of neighbor entities.
+class HierarchyLevels
+{
+public:
+    struct LevelEntry
+    {
+        Entity entity;
+        Entity parent;          // 0 if root
+    };
+
+public:
+    explicit HierarchyLevels(const EntitiesHandler* in_entitiesHandler_ptr);
+
+    void AddEntities(const std::vector<Entity>& entities);
+    void RemoveEntitiesByRanges(const std::vector<std::pair<Entity, Entity>>& ranges);
+    void Clear();
+
+    bool IsOutdated() const;
+
+    size_t GetLevelsCount() const;
+    const std::vector<LevelEntry>& GetLevel(size_t level) const;
+
+    // Calls func(const LevelEntry&) for every entity, one level after the other. Entities of a level may be spread to workers
+    template<typename Func>
+    void ForEachByLevels(WorkersPool* workers_pool_ptr, Func&& func) const;
+
+private:
+    uint32_t GetLevelOfEntity(Entity entity) const;
+    void ExtentVectors(Entity max_entity);
+    void RefreshPositionsInLevel(size_t level);
+
+private:
+    std::vector<std::vector<LevelEntry>> levels;
+
+    std::vector<uint32_t> levelOfEachEntity;
+    std::vector<uint32_t> positionInLevelOfEachEntity;
+
+    size_t parentChangesCountWhenBuilt = 0;
+
+    const EntitiesHandler* const entitiesHandler_ptr;
+
+    static constexpr size_t parallelBatchSize = 256;
+};
+
+
+// -----SOURCE-----
+
+template<typename Func>
+void HierarchyLevels::ForEachByLevels(WorkersPool* workers_pool_ptr, Func&& func) const
+{
+    for (const auto& this_level : levels)
+    {
+        if (workers_pool_ptr != nullptr && this_level.size() > parallelBatchSize)
+        {
+            workers_pool_ptr->ParallelFor(this_level.size(), parallelBatchSize,
+                                          [&this_level, &func](size_t first, size_t last)
+                                          {
+                                              for (size_t i = first; i != last; ++i)
+                                                  func(this_level[i]);
+                                          });
+        }
+        else
+        {
+            for (const LevelEntry& this_entry : this_level)
+                func(this_entry);
+        }
+    }
+}
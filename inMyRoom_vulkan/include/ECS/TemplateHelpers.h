@@ -1,6 +1,7 @@
 #pragma once
 
 #include <type_traits>
+#include <algorithm>
 
 #include "ECS/ConceptHelpers.h"
 
@@ -72,7 +73,7 @@ auto GetComponentPtrsOfArgumentsRecursion(const ECSwrapper* ECSwrapper_ptr)
 }
 
 template <typename Ret, typename Class, typename ...Args>
-auto GetComponentPtrsOfArguments(const ECSwrapper* ECSwrapper_ptr, Ret(Class::* mf)(Args...))
+auto GetComponentPtrsOfArguments(const ECSwrapper* ECSwrapper_ptr, Ret(Class::* /*mf*/)(Args...))
 {
     if constexpr (sizeof...(Args) > 0)
     {
@@ -123,6 +124,66 @@ auto TranslateComponentPtrsIntoArguments(Entity entity, size_t index_hint, const
 }
 
 
+// UPDATE ACCESS OF PARAMETERS
+//
+template <typename Arg>
+void AddUpdateAccessOfArgument(UpdateAccess& update_access)
+{
+    typedef typename std::remove_pointer<Arg>::type Arg_no_ptr;
+    typedef typename std::remove_reference<Arg_no_ptr>::type Arg_no_ptr_no_ref;
+    constexpr bool is_const = std::is_const<Arg_no_ptr_no_ref>::value;
+
+    if constexpr (Component<Arg_no_ptr_no_ref>)
+    {
+        // Component ptr can reach any component entity
+        if constexpr (is_const)
+            update_access.readComponentIDs.emplace_back(Arg_no_ptr_no_ref::component_ID);
+        else
+        {
+            update_access.writeComponentIDs.emplace_back(Arg_no_ptr_no_ref::component_ID);
+            update_access.isEntitiesParallel = false;
+        }
+    }
+    else if constexpr (CompEntity<Arg_no_ptr_no_ref>)
+    {
+        // Component entity reference is of the same entity
+        if constexpr (is_const)
+            update_access.readComponentIDs.emplace_back(decltype(Arg_no_ptr_no_ref::GetComponentType())::component_ID);
+        else
+            update_access.writeComponentIDs.emplace_back(decltype(Arg_no_ptr_no_ref::GetComponentType())::component_ID);
+    }
+    else if constexpr (EntitiesHandlerType<Arg_no_ptr_no_ref>)
+    {
+        if constexpr (is_const)
+            update_access.readsEntitiesHandler = true;
+        else
+        {
+            update_access.writesEntitiesHandler = true;
+            update_access.isEntitiesParallel = false;
+        }
+    }
+}
+
+template <typename Ret, typename Class, typename ...Args>
+UpdateAccess GetUpdateAccessOfArguments(componentID own_component_ID, Ret(Class::* /*mf*/)(Args...))
+{
+    UpdateAccess update_access;
+    update_access.isSchedulable = true;
+    update_access.isEntitiesParallel = true;
+
+    (AddUpdateAccessOfArgument<Args>(update_access), ...);
+
+    // Reaching other entities of own component makes entities' order matter
+    if (std::find(update_access.readComponentIDs.begin(), update_access.readComponentIDs.end(), own_component_ID) != update_access.readComponentIDs.end() ||
+        std::find(update_access.writeComponentIDs.begin(), update_access.writeComponentIDs.end(), own_component_ID) != update_access.writeComponentIDs.end())
+        update_access.isEntitiesParallel = false;
+
+    update_access.writeComponentIDs.emplace_back(own_component_ID);
+
+    return update_access;
+}
+
+
 // CONCEPT TRIVIAL UPDATE
 //
 template <typename T>
@@ -146,7 +207,7 @@ constexpr bool AreArgumentsTrivial()
 } 
 
 template <typename Ret, typename Class, typename ...Args>
-constexpr bool IsMethodTrivialUpdateable(Ret(Class::* mf)(Args...))
+constexpr bool IsMethodTrivialUpdateable(Ret(Class::* /*mf*/)(Args...))
 {
     if constexpr (sizeof...(Args) > 0)
     {
@@ -8,6 +8,7 @@
 #include "GameImporter.h"
 #include "ExportedFunctionsConstructor.h"
 #include "InputManager.h"
+#include "WorkersPool.h"
 
 #include "Graphics/VulkanInit.h"
 #include "Graphics/Graphics.h"
@@ -25,6 +26,8 @@ public:
     Graphics*       GetGraphicsPtr();
     GameImporter*   GetGameImporter();
     ECSwrapper*     GetECSwrapperPtr();
+    WorkersPool*    GetWorkersPoolPtr();
+    CollisionDetection* GetCollisionDetectionPtr();
 
     std::chrono::duration<float> GetECSdeltaTime() const;
 
@@ -34,6 +37,7 @@ private: // data
 
     configuru::Config& cfgFile;
 
+    std::unique_ptr<WorkersPool> workersPool_uptr;
     std::unique_ptr<GameImporter> gameImporter_uptr;
     std::unique_ptr<Graphics> graphics_uptr;
     std::unique_ptr<CollisionDetection> collisionDetection_uptr;
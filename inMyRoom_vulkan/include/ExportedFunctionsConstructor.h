@@ -13,9 +13,17 @@ public:
 
     void BindCameraEntity(Entity this_camera_entity) const override;
 
+    EntityHandle GetEntityHandle(Entity entity) const override;
+    Entity ResolveEntityHandle(const EntityHandle& handle) const override;
+
     size_t GetSphereMeshIndex() const override;
     size_t GetCylinderMeshIndex() const override;
 
+    std::vector<SceneRaycastHit> Raycast(const glm::vec3& origin, const glm::vec3& direction, float max_distance, SceneRaycastMode mode) const override;
+    std::vector<Entity> OverlapBox(const glm::vec3& center, const glm::vec3& half_side_u, const glm::vec3& half_side_v, const glm::vec3& half_side_w) const override;
+    std::vector<Entity> OverlapSphere(const glm::vec3& center, float radius) const override;
+    std::vector<SceneNearestEntity> NearestEntities(const glm::vec3& point, size_t count) const override;
+
 private:
     Engine* const engine_ptr;
 };
\ No newline at end of file
@@ -0,0 +1,225 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+#include "glm/vec3.hpp"
+#include "glm/mat4x4.hpp"
+
+#if defined(__AVX__) || defined(__SSE__)
+#include <immintrin.h>
+#endif
+
+// Lane types of the structure of arrays kernels (ParalgramBatch, RayPacket, TriangleBatch), and a mat4 product. Kernels are templates over them, so the
+// scalar fallback runs the same operations in the same order. "SimdFloat" has 8 lanes with AVX and 4 with SSE.
+// Every lane type gives "Load", "Store", "Broadcast", arithmetic, comparisons to a "Mask" and "Select"
+
+struct ScalarFloat
+{
+    float value;
+
+    struct Mask
+    {
+        bool value;
+    };
+
+    static ScalarFloat Load(const float* ptr) {return {*ptr};}
+    static ScalarFloat Broadcast(float in_value) {return {in_value};}
+    static Mask MaskFromBits(uint32_t bits) {return {(bits & 1u) != 0};}
+    void Store(float* ptr) const {*ptr = value;}
+};
+
+inline ScalarFloat operator+(ScalarFloat lhs, ScalarFloat rhs) {return {lhs.value + rhs.value};}
+inline ScalarFloat operator-(ScalarFloat lhs, ScalarFloat rhs) {return {lhs.value - rhs.value};}
+inline ScalarFloat operator*(ScalarFloat lhs, ScalarFloat rhs) {return {lhs.value * rhs.value};}
+inline ScalarFloat operator/(ScalarFloat lhs, ScalarFloat rhs) {return {lhs.value / rhs.value};}
+inline ScalarFloat Abs(ScalarFloat in) {return {std::abs(in.value)};}
+inline ScalarFloat Min(ScalarFloat lhs, ScalarFloat rhs) {return {std::min(lhs.value, rhs.value)};}
+inline ScalarFloat Max(ScalarFloat lhs, ScalarFloat rhs) {return {std::max(lhs.value, rhs.value)};}
+
+inline ScalarFloat::Mask operator<(ScalarFloat lhs, ScalarFloat rhs) {return {lhs.value < rhs.value};}
+inline ScalarFloat::Mask operator<=(ScalarFloat lhs, ScalarFloat rhs) {return {lhs.value <= rhs.value};}
+inline ScalarFloat::Mask operator>(ScalarFloat lhs, ScalarFloat rhs) {return {lhs.value > rhs.value};}
+inline ScalarFloat::Mask operator>=(ScalarFloat lhs, ScalarFloat rhs) {return {lhs.value >= rhs.value};}
+inline ScalarFloat::Mask operator&(ScalarFloat::Mask lhs, ScalarFloat::Mask rhs) {return {lhs.value && rhs.value};}
+inline ScalarFloat::Mask operator|(ScalarFloat::Mask lhs, ScalarFloat::Mask rhs) {return {lhs.value || rhs.value};}
+inline ScalarFloat Select(ScalarFloat::Mask mask, ScalarFloat if_true, ScalarFloat if_false) {return mask.value ? if_true : if_false;}
+inline uint32_t MoveMask(ScalarFloat::Mask mask) {return uint32_t(mask.value);}
+
+inline uint32_t OverlapMask(ScalarFloat lhs_min, ScalarFloat lhs_max, ScalarFloat rhs_min, ScalarFloat rhs_max)
+{
+    return uint32_t((lhs_max.value >= rhs_min.value) && (rhs_max.value >= lhs_min.value));
+}
+
+#if defined(__AVX__)
+struct SimdFloat
+{
+    __m256 value;
+
+    struct Mask
+    {
+        __m256 value;
+    };
+
+    static constexpr size_t width = 8;
+
+    static SimdFloat Load(const float* ptr) {return {_mm256_load_ps(ptr)};}
+    static SimdFloat Broadcast(float in_value) {return {_mm256_set1_ps(in_value)};}
+    static Mask MaskFromBits(uint32_t bits)
+    {
+        __m256i lane_bits = _mm256_setr_epi32(1, 2, 4, 8, 16, 32, 64, 128);
+        __m256i is_set = _mm256_cmpeq_epi32(_mm256_and_si256(_mm256_set1_epi32(int(bits)), lane_bits), lane_bits);
+        return {_mm256_castsi256_ps(is_set)};
+    }
+    void Store(float* ptr) const {_mm256_store_ps(ptr, value);}
+};
+
+inline SimdFloat operator+(SimdFloat lhs, SimdFloat rhs) {return {_mm256_add_ps(lhs.value, rhs.value)};}
+inline SimdFloat operator-(SimdFloat lhs, SimdFloat rhs) {return {_mm256_sub_ps(lhs.value, rhs.value)};}
+inline SimdFloat operator*(SimdFloat lhs, SimdFloat rhs) {return {_mm256_mul_ps(lhs.value, rhs.value)};}
+inline SimdFloat operator/(SimdFloat lhs, SimdFloat rhs) {return {_mm256_div_ps(lhs.value, rhs.value)};}
+inline SimdFloat Abs(SimdFloat in) {return {_mm256_andnot_ps(_mm256_set1_ps(-0.f), in.value)};}
+inline SimdFloat Min(SimdFloat lhs, SimdFloat rhs) {return {_mm256_min_ps(lhs.value, rhs.value)};}
+inline SimdFloat Max(SimdFloat lhs, SimdFloat rhs) {return {_mm256_max_ps(lhs.value, rhs.value)};}
+
+inline SimdFloat::Mask operator<(SimdFloat lhs, SimdFloat rhs) {return {_mm256_cmp_ps(lhs.value, rhs.value, _CMP_LT_OQ)};}
+inline SimdFloat::Mask operator<=(SimdFloat lhs, SimdFloat rhs) {return {_mm256_cmp_ps(lhs.value, rhs.value, _CMP_LE_OQ)};}
+inline SimdFloat::Mask operator>(SimdFloat lhs, SimdFloat rhs) {return {_mm256_cmp_ps(lhs.value, rhs.value, _CMP_GT_OQ)};}
+inline SimdFloat::Mask operator>=(SimdFloat lhs, SimdFloat rhs) {return {_mm256_cmp_ps(lhs.value, rhs.value, _CMP_GE_OQ)};}
+inline SimdFloat::Mask operator&(SimdFloat::Mask lhs, SimdFloat::Mask rhs) {return {_mm256_and_ps(lhs.value, rhs.value)};}
+inline SimdFloat::Mask operator|(SimdFloat::Mask lhs, SimdFloat::Mask rhs) {return {_mm256_or_ps(lhs.value, rhs.value)};}
+inline SimdFloat Select(SimdFloat::Mask mask, SimdFloat if_true, SimdFloat if_false) {return {_mm256_blendv_ps(if_false.value, if_true.value, mask.value)};}
+inline uint32_t MoveMask(SimdFloat::Mask mask) {return uint32_t(_mm256_movemask_ps(mask.value));}
+
+inline uint32_t OverlapMask(SimdFloat lhs_min, SimdFloat lhs_max, SimdFloat rhs_min, SimdFloat rhs_max)
+{
+    return MoveMask((lhs_max >= rhs_min) & (rhs_max >= lhs_min));
+}
+#elif defined(__SSE__)
+struct SimdFloat
+{
+    __m128 value;
+
+    struct Mask
+    {
+        __m128 value;
+    };
+
+    static constexpr size_t width = 4;
+
+    static SimdFloat Load(const float* ptr) {return {_mm_load_ps(ptr)};}
+    static SimdFloat Broadcast(float in_value) {return {_mm_set1_ps(in_value)};}
+    static Mask MaskFromBits(uint32_t bits)
+    {
+        __m128i lane_bits = _mm_setr_epi32(1, 2, 4, 8);
+        __m128i is_set = _mm_cmpeq_epi32(_mm_and_si128(_mm_set1_epi32(int(bits)), lane_bits), lane_bits);
+        return {_mm_castsi128_ps(is_set)};
+    }
+    void Store(float* ptr) const {_mm_store_ps(ptr, value);}
+};
+
+inline SimdFloat operator+(SimdFloat lhs, SimdFloat rhs) {return {_mm_add_ps(lhs.value, rhs.value)};}
+inline SimdFloat operator-(SimdFloat lhs, SimdFloat rhs) {return {_mm_sub_ps(lhs.value, rhs.value)};}
+inline SimdFloat operator*(SimdFloat lhs, SimdFloat rhs) {return {_mm_mul_ps(lhs.value, rhs.value)};}
+inline SimdFloat operator/(SimdFloat lhs, SimdFloat rhs) {return {_mm_div_ps(lhs.value, rhs.value)};}
+inline SimdFloat Abs(SimdFloat in) {return {_mm_andnot_ps(_mm_set1_ps(-0.f), in.value)};}
+inline SimdFloat Min(SimdFloat lhs, SimdFloat rhs) {return {_mm_min_ps(lhs.value, rhs.value)};}
+inline SimdFloat Max(SimdFloat lhs, SimdFloat rhs) {return {_mm_max_ps(lhs.value, rhs.value)};}
+
+inline SimdFloat::Mask operator<(SimdFloat lhs, SimdFloat rhs) {return {_mm_cmplt_ps(lhs.value, rhs.value)};}
+inline SimdFloat::Mask operator<=(SimdFloat lhs, SimdFloat rhs) {return {_mm_cmple_ps(lhs.value, rhs.value)};}
+inline SimdFloat::Mask operator>(SimdFloat lhs, SimdFloat rhs) {return {_mm_cmpgt_ps(lhs.value, rhs.value)};}
+inline SimdFloat::Mask operator>=(SimdFloat lhs, SimdFloat rhs) {return {_mm_cmpge_ps(lhs.value, rhs.value)};}
+inline SimdFloat::Mask operator&(SimdFloat::Mask lhs, SimdFloat::Mask rhs) {return {_mm_and_ps(lhs.value, rhs.value)};}
+inline SimdFloat::Mask operator|(SimdFloat::Mask lhs, SimdFloat::Mask rhs) {return {_mm_or_ps(lhs.value, rhs.value)};}
+inline SimdFloat Select(SimdFloat::Mask mask, SimdFloat if_true, SimdFloat if_false)
+{
+    return {_mm_or_ps(_mm_and_ps(mask.value, if_true.value), _mm_andnot_ps(mask.value, if_false.value))};
+}
+inline uint32_t MoveMask(SimdFloat::Mask mask) {return uint32_t(_mm_movemask_ps(mask.value));}
+
+inline uint32_t OverlapMask(SimdFloat lhs_min, SimdFloat lhs_max, SimdFloat rhs_min, SimdFloat rhs_max)
+{
+    return MoveMask((lhs_max >= rhs_min) & (rhs_max >= lhs_min));
+}
+#endif
+
+template<typename F>
+struct LanesVec3
+{
+    F x;
+    F y;
+    F z;
+
+    static LanesVec3 Broadcast(const glm::vec3& in_vec)
+    {
+        return {F::Broadcast(in_vec.x), F::Broadcast(in_vec.y), F::Broadcast(in_vec.z)};
+    }
+};
+
+template<typename F>
+inline LanesVec3<F> operator+(const LanesVec3<F>& lhs, const LanesVec3<F>& rhs)
+{
+    return {lhs.x + rhs.x, lhs.y + rhs.y, lhs.z + rhs.z};
+}
+
+template<typename F>
+inline LanesVec3<F> operator-(const LanesVec3<F>& lhs, const LanesVec3<F>& rhs)
+{
+    return {lhs.x - rhs.x, lhs.y - rhs.y, lhs.z - rhs.z};
+}
+
+template<typename F>
+inline LanesVec3<F> operator*(F lhs, const LanesVec3<F>& rhs)
+{
+    return {lhs * rhs.x, lhs * rhs.y, lhs * rhs.z};
+}
+
+template<typename F, typename M>
+inline LanesVec3<F> Select(M mask, const LanesVec3<F>& if_true, const LanesVec3<F>& if_false)
+{
+    return {Select(mask, if_true.x, if_false.x), Select(mask, if_true.y, if_false.y), Select(mask, if_true.z, if_false.z)};
+}
+
+// Same operations order as glm, so lanes give the same results as the glm code they replace
+template<typename F>
+inline F Dot(const LanesVec3<F>& lhs, const LanesVec3<F>& rhs)
+{
+    return lhs.x * rhs.x + lhs.y * rhs.y + lhs.z * rhs.z;
+}
+
+template<typename F>
+inline LanesVec3<F> Cross(const LanesVec3<F>& lhs, const LanesVec3<F>& rhs)
+{
+    return {lhs.y * rhs.z - rhs.y * lhs.z,
+            lhs.z * rhs.x - rhs.z * lhs.x,
+            lhs.x * rhs.y - rhs.x * lhs.y};
+}
+
+// 4x4 product of glm's column major matrices with the 4 floats of a column as lanes: a column of the result is the lhs columns
+// weighted by the components of the rhs column, summed at glm's order. Not over "SimdFloat", as its 8 AVX lanes would span two
+// columns. glm::mat4 is only float aligned, so loads and stores are unaligned
+inline glm::mat4 MultiplyMat4(const glm::mat4& lhs, const glm::mat4& rhs)
+{
+#if defined(__SSE__)
+    __m128 lhs_column_0 = _mm_loadu_ps(&lhs[0][0]);
+    __m128 lhs_column_1 = _mm_loadu_ps(&lhs[1][0]);
+    __m128 lhs_column_2 = _mm_loadu_ps(&lhs[2][0]);
+    __m128 lhs_column_3 = _mm_loadu_ps(&lhs[3][0]);
+
+    glm::mat4 result;
+    for (int column = 0; column != 4; ++column)
+    {
+        __m128 sum = _mm_mul_ps(lhs_column_0, _mm_set1_ps(rhs[column][0]));
+        sum = _mm_add_ps(sum, _mm_mul_ps(lhs_column_1, _mm_set1_ps(rhs[column][1])));
+        sum = _mm_add_ps(sum, _mm_mul_ps(lhs_column_2, _mm_set1_ps(rhs[column][2])));
+        sum = _mm_add_ps(sum, _mm_mul_ps(lhs_column_3, _mm_set1_ps(rhs[column][3])));
+        _mm_storeu_ps(&result[column][0], sum);
+    }
+
+    return result;
+#else
+    return lhs * rhs;
+#endif
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Geometry/Paralgram.h"
+#include "Geometry/Plane.h"
+
+// Bounding volume hierarchy over instances' world axis aligned boxes, culled against the 6 planes of a frustum.
+// Every node keeps the boxes of its children as structure of arrays, so a plane is tested against all of them at once.
+// Build sorts the instances by the Morton code of their centers, a leaf takes "width" consecutive instances and every level above
+// "width" consecutive nodes of the level below. Moving instances need only SetInstance and Refit, build again when instances are added or removed.
+// Width is 8 with AVX, 4 with SSE, and 4 with the scalar fallback
+class FrustumCullingBVH
+{
+public:
+#if defined(__AVX__)
+    static constexpr size_t width = 8;
+#else
+    static constexpr size_t width = 4;
+#endif
+
+public:
+    void Build(const std::vector<Paralgram>& instances_paralgrams);
+    // Takes effect at the next Refit
+    void SetInstance(size_t instance_index, const Paralgram& paralgram);
+    void Refit();
+
+    // Ascending indices of the instances whose boxes are not outside any of the planes.
+    // Same results as FrustumCulling::IsParalgramInsideFrustum with the instances' axis aligned boxes
+    void Cull(const std::array<Plane, 6>& frustum_planes, std::vector<uint32_t>& visible_instances);
+
+    size_t GetInstancesCount() const {return sortedInstances.size();};
+
+private:
+    struct alignas(32) Lanes
+    {
+        float values[width] = {};
+    };
+
+    struct Vec3Lanes
+    {
+        Lanes x;
+        Lanes y;
+        Lanes z;
+    };
+
+    // Children's boxes as centers and half extents, same as a Paralgram with axis aligned sides
+    struct Node
+    {
+        Vec3Lanes centers;
+        Vec3Lanes halfExtents;
+        uint32_t childrenCount = 0;
+    };
+
+    struct NodeAtLevel
+    {
+        size_t level;
+        size_t index;
+    };
+
+private:
+    static void SetLane(Node& node, size_t lane, const glm::vec3& center, const glm::vec3& half_extents);
+    // Bit "i" of outside mask is set when the child "i" is outside a plane, of inside mask when it is inside all of them
+    static void TestNode(const Node& node, const std::array<Plane, 6>& frustum_planes, uint32_t& outside_mask, uint32_t& inside_mask);
+    static void TestNodeScalar(const Node& node, const std::array<Plane, 6>& frustum_planes, uint32_t& outside_mask, uint32_t& inside_mask);
+
+    Node& GetNode(size_t level, size_t index) {return nodes[levelsOffsets[level] + index];};
+    const Node& GetNode(size_t level, size_t index) const {return nodes[levelsOffsets[level] + index];};
+    size_t GetLevelsCount() const {return levelsOffsets.size() - 1;};
+
+private:
+    std::vector<Node> nodes;                    // leaves first, then each level above, the root is the last
+    std::vector<size_t> levelsOffsets;          // first node of each level, then the nodes count
+    std::vector<uint8_t> dirtyNodes;            // nodes whose lanes changed since the last Refit
+
+    std::vector<uint32_t> sortedInstances;      // instance of each leaves' lane, in Morton order
+    std::vector<uint32_t> instancesLanes;       // leaves' lane of each instance
+
+    std::vector<NodeAtLevel> cullStack;
+};
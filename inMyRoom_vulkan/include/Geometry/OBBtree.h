@@ -1,9 +1,20 @@
 #pragma once
 
+#include <limits>
 #include <vector>
 #include <memory>
 
 #include "Geometry/OBB.h"
+#include "Geometry/ParalgramBatch.h"
+#include "Geometry/QuantizedOBB.h"
+
+class WorkersPool;
+
+enum class OBBtreeBuilder
+{
+    midpoint,       // splits at the center of the longest OBB axis
+    SAH             // binned surface area heuristic, see OBBtreeSAHbuilder
+};
 
 struct OBBtreesIntersectInfo
 {
@@ -18,8 +29,21 @@ struct OBBtreesIntersectInfo
     std::vector<CandidateTriangleRangeCombination> candidateTriangleRangeCombinations;
 };
 
+struct OBBtreesSweepInfo
+{
+    bool doIntersect = false;
+    float timeOfImpact = std::numeric_limits<float>::infinity();
+    glm::vec3 normal = glm::vec3(0.f);                  // at the static tree's space, see SweepIntersectInfo
+    size_t moving_triangle_index = size_t(-1);
+    size_t triangle_index = size_t(-1);
+};
+
 class OBBtree
 {
+    friend class OBBtreeSAHbuilder;
+    friend class OBBtreeCache;
+    friend class Ray;
+
 private:
     class OBBtreeSplitBuildNode
     {
@@ -74,6 +98,19 @@ private:
         uint16_t right_triangles_count = -1;
     };
 
+    // Same as OBBtreeNode, with children's OBBs quantized relative to this node's dequantized center
+    class QuantizedOBBtreeNode
+    {
+    public:
+        QuantizedOBB left_child_obb;
+        QuantizedOBB right_child_obb;
+        float quantization_scale;
+        uint32_t left_child_index_or_triangle_offset;
+        uint32_t right_child_index_or_triangle_offset;
+        uint16_t left_triangles_count;
+        uint16_t right_triangles_count;
+    };
+
 public:
     class OBBtreeTraveler
     {
@@ -100,28 +137,77 @@ public:
         const std::vector<OBBtreeNode>& OBBtreeNodes_ref;
     };
 
+    // Dequantizes children's OBBs on the fly while traveling down
+    class QuantizedOBBtreeTraveler
+    {
+    public:
+        QuantizedOBBtreeTraveler(const OBB& root_obb, const std::vector<QuantizedOBBtreeNode>& quantized_obb_tree_nodes, size_t in_triangles_count);
+
+        bool IsLeaf() const {return isLeaf;}
+        QuantizedOBBtreeTraveler GetLeftChildTraveler() const;
+        QuantizedOBBtreeTraveler GetRightChildTraveler() const;
+        Paralgram GetOBB() const {return paralgram;}
+        size_t GetTrianglesOffset() const;
+        size_t GetTrianglesCount() const;
+
+    private:
+        QuantizedOBBtreeTraveler(const std::vector<QuantizedOBBtreeNode>& quantized_obb_tree_nodes) : quantizedOBBtreeNodes_ptr(&quantized_obb_tree_nodes) {};
+        QuantizedOBBtreeTraveler GetChildTraveler(const QuantizedOBB& child_obb, uint32_t child_index_or_triangle_offset, uint16_t child_triangles_count) const;
+
+    private:
+        bool isLeaf = false;
+        Paralgram paralgram;
+
+        const QuantizedOBBtreeNode* quantizedOBBtreeNode_ptr = nullptr;
+
+        size_t triangles_offset = 0;
+        size_t triangles_count = 0;
+
+        const std::vector<QuantizedOBBtreeNode>* quantizedOBBtreeNodes_ptr;
+    };
+
 public:
     OBBtree() {};
-    OBBtree(std::vector<Triangle>&& in_triangles);
+    OBBtree(std::vector<Triangle>&& in_triangles, OBBtreeBuilder builder = OBBtreeBuilder::midpoint, WorkersPool* workers_pool_ptr = nullptr);
 
     OBB GetRootOBB() const;
     OBBtreeTraveler GetRootTraveler() const;
+    QuantizedOBBtreeTraveler GetRootQuantizedTraveler() const;
     TrianglePosition GetTrianglePosition(size_t index) const;
     TriangleNormal GetTriangleNormal(size_t index) const;
     TriangleIndices GetTriangleIndices(size_t index) const;
 
+    // Optional compact copy of the nodes (56 instead of 108 bytes per node), used by IntersectOBBtrees when both trees have it.
+    // Rays, sweeps and scene queries still travel the float nodes, so the copy is extra memory bought for fewer cache misses
+    void QuantizeNodes();
+    bool HasQuantizedNodes() const;
+    size_t GetNodesMemorySize() const;      // float nodes plus the quantized copy, if any
+
     static void IntersectOBBtrees(const OBBtree& first_tree,
                                   const OBBtree& second_tree,
                                   const glm::mat4x4& second_tree_matrix,
                                   OBBtreesIntersectInfo& intesection_info);
 
+    // First contact of "moving_tree" translating by "displacement" against "tree", both at the static tree's space.
+    // "moving_tree_matrix" places the moving tree at the start of the sweep, its rotation does not change along the sweep
+    static void SweepOBBtrees(const OBBtree& moving_tree,
+                              const glm::mat4x4& moving_tree_matrix,
+                              const glm::vec3& displacement,
+                              const OBBtree& tree,
+                              OBBtreesSweepInfo& sweep_info);
+
     static constexpr size_t GetMaxNumberOfTrianglesPerNode() {return OBBtreeSplitBuildNode::maxNumberOfTriangles;}
 
 private:
     void ConstructDFSrecursive(OBBtreeSplitBuildNode* obbtree_split_build_node_ptr);
 
-    static void IntersectOBBtreesRecursive(const OBBtreeTraveler& first_tree_traveler,
-                                           const OBBtreeTraveler& second_tree_traveler,
+    void QuantizeNodesRecursive(size_t node_index, const Paralgram& node_paralgram);
+
+    template<typename Traveler>
+    static void IntersectOBBtreesRecursive(const Traveler& first_tree_traveler,
+                                           const Paralgram& first_paralgram,
+                                           const Traveler& second_tree_traveler,
+                                           const Paralgram& second_paralgram,
                                            const glm::mat4x4& second_tree_matrix,
                                            OBBtreesIntersectInfo& intesection_info);
 
@@ -129,6 +215,7 @@ private:
     OBB root_obb;
 
     std::vector<OBBtreeNode> OBBtreeNodes;
+    std::vector<QuantizedOBBtreeNode> quantizedOBBtreeNodes;
     std::vector<TrianglePosition> triangles_position;
     std::vector<TriangleNormal> triangles_normal;
     std::vector<TriangleIndices> triangles_indices;
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "Geometry/OBBtree.h"
+
+// Flattened OBBtrees saved to disk by a hash of their triangles and builder, so meshes skip building them at next startups.
+// Files are memory mapped, validated by header and checksum, and copied as they are to the tree's arrays.
+// Filesystem errors never throw: a folder that cannot be created disables the cache, a failed store leaves no file behind
+class OBBtreeCache
+{
+public:
+    explicit OBBtreeCache(std::string in_cacheFolder);
+
+    bool IsEnabled() const {return isEnabled;}
+
+    static uint64_t GetKey(const std::vector<Triangle>& triangles, OBBtreeBuilder builder);
+
+    std::optional<OBBtree> Load(uint64_t key) const;
+    void Store(uint64_t key, const OBBtree& obb_tree) const;
+
+private:
+    struct FileHeader
+    {
+        char magic[8];
+        uint32_t formatVersion;
+        uint32_t headerSize;
+        uint64_t key;
+        uint64_t nodesCount;
+        uint64_t trianglesCount;
+        uint64_t payloadSize;
+        uint64_t payloadChecksum;
+    };
+
+    std::string GetPathOfKey(uint64_t key) const;
+    static uint64_t HashBytes(const void* data, size_t size, uint64_t hash = fnvOffsetBasis);
+
+private:
+    std::string cacheFolder;
+    bool isEnabled = true;
+
+    static constexpr char fileMagic[8] = {'O', 'B', 'B', 'T', 'R', 'E', 'E', '\0'};
+    static constexpr uint32_t fileFormatVersion = 1;            // bump when OBBtree's flattened layout changes
+
+    static constexpr uint64_t fnvOffsetBasis = 0xcbf29ce484222325ull;
+    static constexpr uint64_t fnvPrime = 0x100000001b3ull;
+};
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <array>
+#include <memory>
+#include <vector>
+
+#include "Geometry/OBBtree.h"
+
+class WorkersPool;
+
+// Binned surface area heuristic builder. Bins triangles' centroids at the 3 axes of each node's OBB, partitions
+// triangle indices in place instead of copying triangles to children, and builds big subtrees as worker tasks.
+// Gives the same flattened layout as the midpoint builder of OBBtree
+class OBBtreeSAHbuilder
+{
+public:
+    OBBtreeSAHbuilder(std::vector<Triangle>&& in_triangles, WorkersPool* in_workersPool_ptr = nullptr);
+
+    void FlattenToOBBtree(OBBtree& obb_tree) const;
+
+private:
+    struct BuildNode
+    {
+        OBB OBBvolume;
+        size_t firstIndex = 0;
+        size_t count = 0;
+        std::unique_ptr<BuildNode> leftChild_uptr;
+        std::unique_ptr<BuildNode> rightChild_uptr;
+
+        bool IsLeaf() const {return leftChild_uptr == nullptr;}
+    };
+
+    struct SplitAxis
+    {
+        glm::vec3 axis = glm::vec3(0.f, 0.f, 0.f);
+        float minCentroidProjection = 0.f;
+        float binsPerLength = 0.f;
+    };
+
+    struct Bin
+    {
+        std::array<float, 3> min;
+        std::array<float, 3> max;
+        size_t count = 0;
+
+        Bin();
+        void Grow(const Bin& other);
+        float GetSurface() const;
+    };
+
+    std::unique_ptr<BuildNode> BuildRecursive(size_t first_index, size_t count);
+    size_t PartitionBySAH(const BuildNode& node);
+    OBB CreateOBBofRange(size_t first_index, size_t count) const;
+    size_t GetBinIndex(const SplitAxis& split_axis, uint32_t triangle_index) const;
+
+    void FlattenRecursive(const BuildNode& node, size_t parent_index, bool is_right_child, OBBtree& obb_tree) const;
+    void AddTrianglesOfLeaf(const BuildNode& node, OBBtree& obb_tree) const;
+
+private:
+    std::vector<Triangle> triangles;
+    std::vector<glm::vec3> trianglesCentroid;
+    std::vector<uint32_t> trianglesIndices;         // partitioned in place, leaves point to ranges of it
+
+    std::unique_ptr<BuildNode> root_uptr;
+
+    WorkersPool* workersPool_ptr;
+
+    static constexpr size_t binsCount = 12;
+    static constexpr size_t parallelBuildMinTrianglesCount = 4096;
+};
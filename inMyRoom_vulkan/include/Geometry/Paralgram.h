@@ -3,12 +3,18 @@
 #include "glm/mat4x4.hpp" 
 #include "glm/vec3.hpp"
 
+#include "Geometry/SweepInterval.h"
+
 class Paralgram
 {
 public:
+    Paralgram() = default;
+    Paralgram(glm::vec3 in_center, glm::vec3 in_side_direction_u, glm::vec3 in_side_direction_v, glm::vec3 in_side_direction_w);
+
     static Paralgram MultiplyBy4x4Matrix(const glm::mat4x4& in_matrix, const Paralgram& rhs);
 
     static bool IntersectParalgramsBoolean(const Paralgram& lhs, const Paralgram& rhs);
+    static SweepIntersectInfo SweepParalgrams(const Paralgram& lhs, const glm::vec3& lhs_displacement, const Paralgram& rhs);     // Same 15 axes over lhs's translation
 
     std::pair<float, float> GetMinMaxProjectionToAxis(const glm::vec3& in_axis) const;
     float GetCenterProjectionToAxis(const glm::vec3& in_axis) const;
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "Geometry/Paralgram.h"
+
+// Up to "width" paralgrams, stored as structure of arrays, so one paralgram can be tested against all of them at once.
+// Width is 8 with AVX, 4 with SSE, and 4 with the scalar fallback
+class ParalgramBatch
+{
+public:
+#if defined(__AVX__)
+    static constexpr size_t width = 8;
+#else
+    static constexpr size_t width = 4;
+#endif
+
+public:
+    void Clear();
+    void Add(const Paralgram& paralgram);
+    void Set(size_t index, const Paralgram& paralgram);
+
+    size_t GetSize() const {return size;}
+    bool IsFull() const {return size == width;}
+
+    // Bit "i" is set when lhs intersects the paralgram at index "i". Same results as Paralgram::IntersectParalgramsBoolean
+    uint32_t IntersectParalgramBoolean(const Paralgram& lhs) const;
+
+private:
+    uint32_t IntersectParalgramBooleanScalar(const Paralgram& lhs) const;
+
+private:
+    struct alignas(32) Lanes
+    {
+        float values[width] = {};
+    };
+
+    struct Vec3Lanes
+    {
+        Lanes x;
+        Lanes y;
+        Lanes z;
+    };
+
+    Vec3Lanes centers;
+    Vec3Lanes sideDirectionsU;
+    Vec3Lanes sideDirectionsV;
+    Vec3Lanes sideDirectionsW;
+
+    size_t size = 0;
+};
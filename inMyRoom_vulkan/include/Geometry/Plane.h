@@ -25,6 +25,9 @@ public:
     PlaneIntersectResult IntersectParalgram(const Paralgram& in_paralgram) const;
     PlaneIntersectResult IntersectSphere(const Sphere& sphere) const;
 
+    const glm::vec3& GetNormal() const {return normal;}
+    float GetD() const {return d;}
+
 private:
     glm::vec3 normal;
     float d;
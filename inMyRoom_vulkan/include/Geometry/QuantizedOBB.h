@@ -0,0 +1,30 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include "glm/vec3.hpp"
+
+#include "Geometry/Paralgram.h"
+
+// Box stored relative to its parent's center: 16 bit center offset, octahedral encoded U and V axes (W = U x V) and 16 bit half lengths,
+// all scaled by a "scale" the parent node keeps. Half lengths are rounded up after the center and axes got quantized,
+// so the dequantized box always contains the original one
+struct QuantizedOBB
+{
+    std::array<int16_t, 3> centerOffset;
+    std::array<int16_t, 2> axisU;
+    std::array<int16_t, 2> axisV;
+    std::array<uint16_t, 3> halfLengths;
+
+    static QuantizedOBB Quantize(const Paralgram& paralgram, glm::vec3 parent_center, float scale);
+    Paralgram Dequantize(glm::vec3 parent_center, float scale) const;
+
+    static float GetQuantizationScale(const Paralgram& paralgram, glm::vec3 parent_center);
+
+private:
+    static std::array<int16_t, 2> EncodeOctahedral(glm::vec3 unit_vector);
+    static glm::vec3 DecodeOctahedral(std::array<int16_t, 2> encoded);
+    static void DequantizeAxes(const std::array<int16_t, 2>& axis_u, const std::array<int16_t, 2>& axis_v,
+                               glm::vec3& u, glm::vec3& v, glm::vec3& w);
+};
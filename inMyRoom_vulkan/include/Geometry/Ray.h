@@ -37,13 +37,15 @@ public:
 
     RayTriangleIntersectInfo IntersectTriangle(const TrianglePosition& triange) const;
     std::pair<bool, std::pair<float, float>> IntersectParalgram(const Paralgram& paralgram) const;        // Returns bool(doIntesept), pair(min, max) distance
-    RayOBBtreeIntersectInfo IntersectOBBtree(const OBBtree& obb_tree, const glm::mat4x4& matrix) const;
+    RayOBBtreeIntersectInfo IntersectOBBtree(const OBBtree& obb_tree, const glm::mat4x4& matrix) const;    // Nearest hit, ties go to the lowest triangle index
 
 private:
-    void IntersectOBBtreeRecursive(const OBBtree::OBBtreeTraveler& obb_tree_traveler,
-                                   const OBBtree& obb_tree,
-                                   const glm::mat4x4& matrix,
-                                   RayOBBtreeIntersectInfo& best_intersection_so_far) const;
+    // Ray has to be in the tree's space. Walks the flattened nodes with an explicit stack, nearest child first
+    RayOBBtreeIntersectInfo IntersectOBBtreeLocal(const OBBtree& obb_tree) const;
+    std::pair<bool, std::pair<float, float>> IntersectOBB(const OBB& obb) const;                         // Same as IntersectParalgram, for orthogonal sides
+    void IntersectTrianglesRange(const OBBtree& obb_tree, size_t triangles_offset, size_t triangles_count,
+                                 RayOBBtreeIntersectInfo& best_intersection_so_far_info) const;
+
 private:
     glm::vec3 origin;
     glm::vec3 direction;
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Geometry/Ray.h"
+
+// Up to "width" rays, stored as structure of arrays, traced together through an OBBtree: every node and triangle is
+// tested against all rays of the packet at once. Width is 8 with AVX, 4 with SSE, and 4 with the scalar fallback
+class RayPacket
+{
+public:
+#if defined(__AVX__)
+    static constexpr size_t width = 8;
+#else
+    static constexpr size_t width = 4;
+#endif
+
+public:
+    void Clear();
+    void Add(const Ray& ray);
+
+    size_t GetSize() const {return size;}
+    bool IsFull() const {return size == width;}
+
+    // Closest hit of every ray of the packet, same as Ray::IntersectOBBtree of each of them
+    std::array<RayOBBtreeIntersectInfo, width> IntersectOBBtree(const OBBtree& obb_tree, const glm::mat4x4& matrix) const;
+
+    // Packs rays of the same directions octant to packets. Rays of packets that are not coherent enough are traced one by one
+    static std::vector<RayOBBtreeIntersectInfo> IntersectRaysOBBtree(const std::vector<Ray>& rays, const OBBtree& obb_tree, const glm::mat4x4& matrix);
+
+private:
+    bool IsCoherent() const;
+
+private:
+    struct alignas(32) Lanes
+    {
+        float values[width] = {};
+    };
+
+    struct Vec3Lanes
+    {
+        Lanes x;
+        Lanes y;
+        Lanes z;
+    };
+
+    Vec3Lanes origins;
+    Vec3Lanes directions;
+
+    size_t size = 0;
+
+    static constexpr float minCoherentDirectionsCos = 0.9f;
+};
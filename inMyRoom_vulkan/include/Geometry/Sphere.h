@@ -1,10 +1,22 @@
 #pragma once
 
+#include <array>
 #include <vector>
 #include <tuple>
 
 #include "glm/vec3.hpp"
 #include "Geometry/Paralgram.h"
+#include "Geometry/Triangle.h"
+
+// A paralgram's 3 face slabs, for testing many spheres against the same paralgram. Slabs spanned by a zero side are unbounded
+struct ParalgramSlabs
+{
+    explicit ParalgramSlabs(const Paralgram& paralgram);
+
+    glm::vec3 center;
+    std::array<glm::vec3, 3> planesDirections;
+    std::array<float, 3> planesD;
+};
 
 class Sphere
 {
@@ -14,7 +26,9 @@ public:
     glm::vec3 GetOrigin() const {return origin;}
     float GetRadius() const {return radius;}
 
-    bool IntersectParalgram(const Paralgram& paralgram) const;
+    bool IntersectParalgram(const Paralgram& paralgram) const;         // Faces only, may pass near edges
+    bool IntersectParalgramSlabs(const ParalgramSlabs& slabs) const;   // Same as IntersectParalgram
+    bool IntersectTriangle(const TrianglePosition& triangle) const;
 
     static std::pair<std::vector<uint32_t>, std::vector<glm::vec3>> GetSphereMesh(size_t quality);
 
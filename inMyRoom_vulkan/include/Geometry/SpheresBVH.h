@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "glm/vec3.hpp"
+
+#include "Geometry/Paralgram.h"
+#include "Geometry/Sphere.h"
+
+// Binary hierarchy of bounding spheres over a set of spheres, for finding which of them pass Sphere::IntersectParalgram.
+// A node's sphere contains its children's, and the paralgram's slabs test lets through every sphere that contains one it lets through,
+// so descending only the nodes that pass gives the same spheres as testing all of them. Cheap to build, meant to be rebuilt every frame
+class SpheresBVH
+{
+public:
+    // "spheres_indices" picks the spheres to keep, queries return these indices
+    void Build(const std::vector<Sphere>& spheres, const std::vector<uint32_t>& spheres_indices);
+
+    // Ascending indices of the spheres that IntersectParalgram the paralgram. The traversal stack is the caller's, so concurrent queries are safe
+    void CollideParalgram(const Paralgram& paralgram, std::vector<uint32_t>& collided_indices, std::vector<uint32_t>& traversal_stack) const;
+
+private:
+    struct Node
+    {
+        glm::vec3 center;
+        float radius;
+        uint32_t offset;            // right child when inner (left is the next node), first sphere when leaf
+        uint32_t count;             // spheres of leaf, 0 when inner
+    };
+
+    struct SphereEntry
+    {
+        Sphere sphere;
+        uint32_t index;
+    };
+
+private:
+    uint32_t BuildNode(size_t first, size_t last);
+
+private:
+    static constexpr size_t leafSize = 4;
+
+    std::vector<Node> nodes;
+    std::vector<SphereEntry> entries;           // at leaves' order
+};
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <limits>
+#include <utility>
+
+#include "glm/vec3.hpp"
+#include "glm/geometric.hpp"
+
+struct SweepIntersectInfo
+{
+    bool doIntersect = false;
+    float timeOfImpact = std::numeric_limits<float>::infinity();   // 0 at the start of the sweep, 1 at its end
+    glm::vec3 normal = glm::vec3(0.f);                              // not normalized, facing towards the moving shape. Zero when they overlap from the start
+};
+
+// Separating axis test over a linear translation: "lhs" moves by "displacement" from time 0 to time 1, "rhs" stays.
+// Along every axis the projections overlap during one interval of time. The shapes touch at the latest entering time
+// of all axes, if it comes before the earliest leaving time. Exact for convex shapes that are given all of their axes
+class SweepInterval
+{
+public:
+    explicit SweepInterval(const glm::vec3& in_displacement);
+
+    // Returns false once no time is left
+    bool AddAxis(const glm::vec3& axis, std::pair<float, float> lhs_min_max, std::pair<float, float> rhs_min_max);
+
+    // Cross product of two edges as axis. Nearly parallel edges are skipped, their cross product has no usable direction
+    template<typename LhsShape, typename RhsShape>
+    bool AddCrossAxis(const glm::vec3& lhs_edge, const glm::vec3& rhs_edge, const LhsShape& lhs, const RhsShape& rhs);
+
+    template<typename LhsShape, typename RhsShape>
+    bool AddAxis(const glm::vec3& axis, const LhsShape& lhs, const RhsShape& rhs)
+    {
+        return AddAxis(axis, lhs.GetMinMaxProjectionToAxis(axis), rhs.GetMinMaxProjectionToAxis(axis));
+    }
+
+    SweepIntersectInfo GetInfo() const;
+
+private:
+    static bool IsCrossAxisDegenerate(const glm::vec3& axis, const glm::vec3& lhs_edge, const glm::vec3& rhs_edge);
+
+private:
+    glm::vec3 displacement;
+
+    float enterTime = -std::numeric_limits<float>::infinity();
+    float leaveTime = +std::numeric_limits<float>::infinity();
+    glm::vec3 enterNormal = glm::vec3(0.f);
+
+    static constexpr float minCrossAxisSin2 = 1.e-8f;
+};
+
+template<typename LhsShape, typename RhsShape>
+bool SweepInterval::AddCrossAxis(const glm::vec3& lhs_edge, const glm::vec3& rhs_edge, const LhsShape& lhs, const RhsShape& rhs)
+{
+    glm::vec3 axis = glm::cross(lhs_edge, rhs_edge);
+    if (IsCrossAxisDegenerate(axis, lhs_edge, rhs_edge))
+        return true;
+
+    return AddAxis(axis, lhs, rhs);
+}
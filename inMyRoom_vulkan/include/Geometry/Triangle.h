@@ -8,6 +8,7 @@
 #include "glm/mat4x4.hpp"
 
 #include "glTFenum.h"
+#include "Geometry/SweepInterval.h"
 
 struct TrianglesIntersectionInfo
 {
@@ -30,6 +31,7 @@ public:
 
     static TrianglePosition MultiplyBy4x4Matrix(const glm::mat4x4& in_matrix, const TrianglePosition& rhs);
     static TrianglesIntersectionInfo IntersectTriangles(const TrianglePosition& lhs, const TrianglePosition& rhs);
+    static SweepIntersectInfo SweepTriangles(const TrianglePosition& lhs, const glm::vec3& lhs_displacement, const TrianglePosition& rhs);   // Faces and edges cross products over lhs's translation
 
 protected:
     static std::vector<TrianglePosition> CreateTrianglePositionList(const std::vector<glm::vec3>& points,
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "Geometry/Triangle.h"
+
+// Up to "width" triangles, stored as structure of arrays, so one triangle can be tested against all of them at once.
+// Width is 8 with AVX, 4 with SSE, and 4 with the scalar fallback
+class TriangleBatch
+{
+public:
+#if defined(__AVX__)
+    static constexpr size_t width = 8;
+#else
+    static constexpr size_t width = 4;
+#endif
+
+public:
+    void Clear();
+    void Add(const TrianglePosition& triangle);
+    void Set(size_t index, const TrianglePosition& triangle);
+
+    size_t GetSize() const {return size;}
+    bool IsFull() const {return size == width;}
+
+    TrianglePosition GetTriangle(size_t index) const;
+
+    // "intersections_info[i]" is the same as TrianglePosition::IntersectTriangles(lhs, triangle at index "i"),
+    // bit "i" of the return is set when its "doIntersept" is. Coplanar pairs fall back to the scalar test
+    uint32_t IntersectTriangle(const TrianglePosition& lhs, std::array<TrianglesIntersectionInfo, width>& intersections_info) const;
+
+private:
+    uint32_t IntersectTriangleScalar(const TrianglePosition& lhs, std::array<TrianglesIntersectionInfo, width>& intersections_info) const;
+
+private:
+    struct alignas(32) Lanes
+    {
+        float values[width] = {};
+    };
+
+    struct Vec3Lanes
+    {
+        Lanes x;
+        Lanes y;
+        Lanes z;
+    };
+
+    Vec3Lanes points0;
+    Vec3Lanes points1;
+    Vec3Lanes points2;
+
+    size_t size = 0;
+};
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <array>
+#include <functional>
+#include <vector>
+
+#include "ECS/ECStypes.h"
+#include "Geometry/FrustumCullingBVH.h"
+
+// FrustumCullingBVH of the drawn entities' meshes, kept from frame to frame. Instances are keyed by entity handle and mesh index,
+// so a recycled entity or one that draws another mesh is a new instance and the BVH is built again, as when instances are added or removed.
+// Else only the instances whose matrix version changed are set again and refitted
+class CullingInstancesBVH
+{
+public:
+    struct InstanceKey
+    {
+        EntityHandle entityHandle;
+        size_t meshIndex = -1;
+
+        bool operator==(const InstanceKey& other) const = default;
+    };
+
+public:
+    // Instance "i" of "instances_keys" is at "get_matrix_version(i)", its world paralgram is asked only when it is built or changed
+    void Update(const std::vector<InstanceKey>& instances_keys,
+                const std::function<uint32_t(size_t)>& get_matrix_version,
+                const std::function<Paralgram(size_t)>& get_world_paralgram);
+
+    void Cull(const std::array<Plane, 6>& frustum_planes, std::vector<uint32_t>& visible_instances) {bvh.Cull(frustum_planes, visible_instances);};
+
+    size_t GetBuildsCount() const {return buildsCount;};
+
+private:
+    FrustumCullingBVH bvh;
+    std::vector<InstanceKey> instancesKeys;
+    std::vector<uint32_t> matrixVersions;
+    std::vector<Paralgram> instancesParalgrams;
+
+    size_t buildsCount = 0;
+};
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <vector>
+
+#include "ECS/ECStypes.h"
+
+// What makes each draw info the same instance as at the frame the draw list was built. Draw infos that only moved
+// (new matrices' offsets or matrices) keep the keys, added, removed, shown or hidden instances change them
+class DrawListKeys
+{
+public:
+    bool AreOf(const std::vector<DrawInfo>& draw_infos) const;
+    void Assign(const std::vector<DrawInfo>& draw_infos);
+
+private:
+    struct Key
+    {
+        size_t meshIndex = -1;
+        size_t dynamicMeshIndex = -1;
+        size_t lightIndex = -1;
+        bool isLightSource = false;
+    };
+
+private:
+    std::vector<Key> keys;
+};
@@ -98,8 +98,10 @@ public:
     void ObtainTransformRanges(vk::CommandBuffer command_buffer,
                                const std::vector<DrawInfo>& draw_infos,
                                uint32_t source_family_index) const;
+    // Draw infos' morph weights index into "morph_weights"
     void RecordTransformations(vk::CommandBuffer command_buffer,
-                               const std::vector<DrawInfo>& draw_infos);
+                               const std::vector<DrawInfo>& draw_infos,
+                               const std::vector<float>& morph_weights);
 
     // Transform and BLAS update sync with semaphore!
 
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <chrono>
+
 #include "configuru.hpp"
 
 #include "vulkan/vulkan.hpp"
@@ -27,9 +29,22 @@
 #include "Graphics/Renderers/OfflineRenderer.h"
 
 class Engine;       // Forward declaration
+class WorkersPool;
 
 class Graphics
 {
+public:
+    // How many of the frame draw data's five buffers had their capacity grown while the ECS built them for the renderer.
+    // Only those vectors are watched, the components' own allocations at the build stage are not counted
+    struct FrameDrawDataGrowthStats
+    {
+        size_t framesCount = 0;
+        size_t grownBuffersCount = 0;               // since start
+        size_t lastFrameGrownBuffersCount = 0;
+
+        std::chrono::duration<float> lastFrameBuildDuration = std::chrono::duration<float>::zero();
+    };
+
 public:
     Graphics(Engine* engine_ptr, configuru::Config& cfgFile, vk::Device device, vma::Allocator vma_allocator);
     ~Graphics();
@@ -60,11 +75,13 @@ public:
     size_t GetSubgroupSize() const;
 
     size_t GetMaxInstancesCount() const {return maxInstances;}
+    WorkersPool* GetDrawListWorkersPool() const {return drawListWorkersPool_ptr;}       // nullptr: draw list is updated by the calling thread only
 
     void LoadModel(const tinygltf::Model& in_model, std::string in_model_images_folder);
     void EndModelsLoad();
 
     void DrawFrame();
+    const FrameDrawDataGrowthStats& GetFrameDrawDataGrowthStats() const {return frameDrawDataGrowthStats;}
 
     void WriteCameraMarticesBuffers(ViewportFrustum viewport,
                                     const std::vector<ModelMatrices>& model_matrices,
@@ -93,6 +110,8 @@ private:
     std::pair<vk::Queue, uint32_t> computeQueue;
 
     std::unique_ptr<RendererBase> renderer_uptr;
+    FrameDrawData frameDrawData;        // swapped with the renderer's every frame
+    FrameDrawDataGrowthStats frameDrawDataGrowthStats;
 
     vk::Buffer              cameraBuffer;
     vma::Allocation         cameraAllocation;
@@ -133,5 +152,7 @@ private:
     Engine* const           engine_ptr;
     configuru::Config&      cfgFile;
 
+    WorkersPool*            drawListWorkersPool_ptr = nullptr;
+
     const size_t maxInstances = 4096;
 };
\ No newline at end of file
@@ -4,22 +4,28 @@
 #include <unordered_set>
 #include <vector>
 
-#include "hash_combine.h"
-
 #include "vulkan/vulkan.hpp"
 #include "vk_mem_alloc.hpp"
 
 #include "Geometry/Sphere.h"
+#include "Geometry/SpheresBVH.h"
 #include "Geometry/Paralgram.h"
+#include "Graphics/LightsCombinations.h"
 
 #include "common/structs/LightParameters.h"
 
 #include "ECS/ECStypes.h"
 
-struct LightsIndicesRange
+// A worker's share of a frame's collided lights: its chunk of primitives gets ranges at its own combinations,
+// which Lights::MergeCollidedLightsChunk adds to the frame's ones when the chunks are merged at the primitives' order
+struct CollidedLightsChunk
 {
-    uint32_t offset = 0;
-    uint32_t size = 0;
+    LightsCombinations combinations;
+    std::vector<uint32_t> mergedOffsets;        // of combinations' ranges, at the frame's combinations
+
+    std::vector<uint32_t> collidedLights;
+    std::vector<uint16_t> collidedLightsCombination;
+    std::vector<uint32_t> traversalStack;
 };
 
 class Lights
@@ -37,7 +43,9 @@ public:
     void AddLights(std::vector<LightInfo>& light_infos,
                    const std::vector<ModelMatrices>& model_matrices);
     LightsIndicesRange CreateLightsConesRange();
-    LightsIndicesRange CreateCollidedLightsRange(const Paralgram& paralgram);
+    // Range at the chunk's combinations, safe to call concurrently for different chunks. Merge the chunks, at their order, before WriteLightsBuffers
+    LightsIndicesRange CreateCollidedLightsRange(const Paralgram& paralgram, CollidedLightsChunk& chunk) const;
+    void MergeCollidedLightsChunk(CollidedLightsChunk& chunk);
     void WriteLightsBuffers() const;
 
     const LightInfo& GetLightInfo(size_t light_index) const;
@@ -56,7 +64,7 @@ private:
     void InitBuffers();
     void InitDescriptors();
 
-    std::vector<uint16_t> CollideParalgramWithLocalLights(const Paralgram& paralgram);
+    void CollideParalgramWithLocalLights(const Paralgram& paralgram, CollidedLightsChunk& chunk) const;
 
 private:
     std::unordered_set<size_t> lights_indices_uset;
@@ -67,8 +75,11 @@ private:
     std::vector<LightParameters> lightParameters;
     std::vector<Sphere> lightsSpheres;
 
-    std::unordered_map<std::vector<uint16_t>, LightsIndicesRange> combinationToLightsIndicesRange;
-    std::vector<uint16_t> lightsCombinationsIndices;
+    // Of the local lights that are not cones, rebuilt at every AddLights
+    SpheresBVH localLightsBVH;
+    std::vector<uint32_t> localLightsIndices;
+
+    LightsCombinations lightsCombinations;
 
     glm::vec3 uniformLuminance = glm::vec3(0.f);
 
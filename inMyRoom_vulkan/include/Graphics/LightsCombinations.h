@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+struct LightsIndicesRange
+{
+    uint32_t offset = 0;
+    uint32_t size = 0;
+};
+
+// Light indices of a frame's combinations, each distinct combination stored once.
+// Combinations are found by hashing their span into an open addressing table (power of two slots, linear probing) whose keys are
+// ranges at the indices, so neither lookups nor Clear allocate once capacities have settled
+class LightsCombinations
+{
+public:
+    LightsCombinations();
+
+    void Clear();
+
+    // Range of an equal combination added before, or of the combination appended now
+    LightsIndicesRange FindOrAddCombination(std::span<const uint16_t> combination);
+    // Appends without looking for or keeping the combination
+    LightsIndicesRange AddRange(std::span<const uint16_t> indices);
+
+    // FindOrAddCombination of every range of "other" at the order they were added, so merging per chunk tables at the chunks' order
+    // gives the same indices as one table filled serially. "merged_offsets" maps each of other's range offsets to its range's offset here
+    void MergeCombinations(const LightsCombinations& other, std::vector<uint32_t>& merged_offsets);
+
+    const std::vector<uint16_t>& GetIndices() const {return indices;};
+
+private:
+    struct Slot
+    {
+        size_t hash;
+        LightsIndicesRange range;       // of size 0 when empty
+    };
+
+private:
+    static size_t GetHash(std::span<const uint16_t> combination);
+    void Grow();
+
+private:
+    std::vector<uint16_t> indices;
+    std::vector<LightsIndicesRange> ranges;         // at the order they were added
+
+    std::vector<Slot> slots;
+    size_t combinationsCount = 0;
+
+    static constexpr size_t initialSlotsCount = 64;
+};
@@ -6,6 +6,7 @@
 #include "tiny_gltf.h"
 
 #include "Geometry/OBBtree.h"
+#include "Geometry/OBBtreeCache.h"
 #include "Geometry/Triangle.h"
 
 #include "Graphics/Meshes/MaterialsOfPrimitives.h"
@@ -123,6 +124,9 @@ public:
 
     void FlashDevice(std::vector<std::pair<vk::Queue, uint32_t>> queues);
 
+    void SetOBBtreeBuilder(OBBtreeBuilder builder, WorkersPool* workers_pool_ptr = nullptr);
+    void EnableOBBtreeCache(std::string cache_folder);
+    void SetQuantizeOBBtreeNodes(bool should_quantize);
     void StartRecordOBBtree();
     OBBtree GetOBBtreeAndReset();
 
@@ -154,6 +158,10 @@ private: // data
 
     std::vector<PrimitiveOBBtreeData> recorderPrimitivesOBBtreeDatas;
     bool recordingOBBtree = false;
+    OBBtreeBuilder obbTreeBuilder = OBBtreeBuilder::midpoint;
+    WorkersPool* obbTreeBuildWorkersPool_ptr = nullptr;
+    std::unique_ptr<OBBtreeCache> obbTreeCache_uptr;
+    bool quantizeOBBtreeNodes = false;
 
     vk::Device device;
     vma::Allocator vma_allocator;
@@ -4,6 +4,8 @@
 #include "vk_mem_alloc.hpp"
 
 #include "Geometry/ViewportFrustum.h"
+#include "Graphics/DrawListKeys.h"
+#include "Graphics/Lights.h"
 #include "ECS/ECStypes.h"
 
 class RendererBase
@@ -19,16 +21,45 @@ public:
               vma_allocator(in_vma_allocator) {};
     virtual ~RendererBase() = default;
 
+    // Renderers take the frame's data by swapping it with their previous frame's, which goes back to be cleared and refilled
     virtual void DrawFrame(const ViewportFrustum& viewport,
-                           std::vector<ModelMatrices>&& matrices,
-                           std::vector<LightInfo>&& light_infos,
-                           std::vector<DrawInfo>&& draw_infos) {}
+                           FrameDrawData& frame_draw_data) {}
 
     virtual void ToggleViewportFreeze() { viewportFreeze = !viewportFreeze; }
     virtual bool IsFreezed() const {return viewportFreeze;}
 
+    // Counters since start, a rebuild happens only when the drawn instances change
+    struct DrawListStats
+    {
+        size_t framesCount = 0;
+        size_t rebuildsCount = 0;
+    };
+    const DrawListStats& GetDrawListStats() const {return drawListStats;}
+
 protected:
-    std::vector<PrimitiveInstanceParameters> CreatePrimitivesInstanceParameters();
+    // One primitive of a visibility pass draw, the draw list keeps them sorted so pipeline changes are the fewest
+    struct PrimitiveDraw
+    {
+        vk::Pipeline pipeline;
+        size_t material = -1;
+        size_t meshIndex = -1;
+        size_t primitiveIndex = -1;
+
+        size_t drawInfoIndex = -1;
+        size_t primitiveNumber = -1;        // at its mesh, also its offset from the draw info's primitivesInstanceOffset
+    };
+
+protected:
+    void SwapFrameDrawData(FrameDrawData& frame_draw_data);
+
+    // Fills the frame's primitives instance parameters and the draw infos' primitivesInstanceOffset.
+    // Static meshes' parameters and the sorted primitive draws are retained, and rebuilt only when the drawn instances change (added, removed, shown or hidden).
+    // Every frame patches the matrices and lights fields, and dynamic meshes' whole parameters as DynamicMeshes may move their descriptors.
+    // Frustum culling filters only visiblePrimitiveDraws, every draw info keeps its instance parameters.
+    // Chunks of draw infos are written at Graphics' draw list workers pool, each gathering lights at its own combinations,
+    // which are merged at the chunks' order so the parameters and lights combinations are the same as when written serially
+    void UpdateDrawList(const std::vector<vk::Pipeline>& primitives_pipelines,
+                        std::vector<PrimitiveInstanceParameters>& primitive_instance_parameters);
 
 protected:
     class Graphics* const graphics_ptr;
@@ -37,9 +68,41 @@ protected:
     std::vector<ModelMatrices> matrices;
     std::vector<LightInfo>  lightInfos;
     std::vector<DrawInfo>   drawInfos;
+    std::vector<float>      morphWeights;
+    std::vector<uint32_t>   visibleDrawInfos;
+
+    std::vector<PrimitiveDraw> sortedPrimitiveDraws;        // of drawInfos, without light sources and primitives that have no pipeline
+    std::vector<PrimitiveDraw> visiblePrimitiveDraws;       // of sortedPrimitiveDraws, the ones whose draw info is visible
 
     vk::Device device;
     vma::Allocator vma_allocator;
 
     bool viewportFreeze = false;
+
+private:
+    void RebuildDrawList(const std::vector<vk::Pipeline>& primitives_pipelines);
+    size_t GetPrimitivesCount(const DrawInfo& draw_info) const;
+    void WritePrimitivesStaticParameters(const DrawInfo& draw_info, PrimitiveInstanceParameters* parameters_ptr) const;
+    void WritePrimitivesFrameParameters(const DrawInfo& draw_info, PrimitiveInstanceParameters* parameters_ptr, CollidedLightsChunk& collided_lights_chunk) const;
+    void SplitDrawListChunks();
+
+private:
+    // Contiguous draw infos, chunks have about the same primitives count
+    struct DrawListChunk
+    {
+        size_t firstDrawIndex = 0;
+        size_t lastDrawIndex = 0;
+        CollidedLightsChunk collidedLightsChunk;
+    };
+
+    static constexpr size_t drawListChunkMinPrimitives = 256;
+    static constexpr size_t drawListChunksPerThread = 4;
+
+private:
+    DrawListKeys drawListKeys;
+    std::vector<size_t> drawListInstanceOffsets;
+    std::vector<PrimitiveInstanceParameters> drawListInstanceParameters;
+    std::vector<DrawListChunk> drawListChunks;
+    std::vector<bool> isDrawInfoVisible;
+    DrawListStats drawListStats;
 };
\ No newline at end of file
@@ -5,8 +5,6 @@
 #include "Graphics/Exposure.h"
 #include "Graphics/Lights.h"
 
-#include "Geometry/FrustumCulling.h"
-
 class OfflineRenderer
     : public RendererBase
 {
@@ -24,9 +22,7 @@ public:
     ~OfflineRenderer() override;
 
     void DrawFrame(const ViewportFrustum& viewport,
-                   std::vector<ModelMatrices>&& matrices,
-                   std::vector<LightInfo>&& light_infos,
-                   std::vector<DrawInfo>&& draw_infos) override;
+                   FrameDrawData& frame_draw_data) override;
 
 private:
     void InitBuffers();
@@ -46,8 +42,7 @@ private:
     void RecordGraphicsCommandBuffer(vk::CommandBuffer command_buffer,
                                      uint32_t freezable_frame_index,
                                      uint32_t frame_index,
-                                     uint32_t swapchain_index,
-                                     const FrustumCulling& frustum_culling);
+                                     uint32_t swapchain_index);
     void AssortDrawInfos();
 
     void WriteInitHostBuffers(uint32_t frame_count) const;
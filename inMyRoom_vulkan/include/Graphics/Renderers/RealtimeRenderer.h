@@ -6,8 +6,6 @@
 #include "Graphics/NRDintegration.h"
 #include "Graphics/Exposure.h"
 
-#include "Geometry/FrustumCulling.h"
-
 class RealtimeRenderer
     : public RendererBase
 {
@@ -19,9 +17,7 @@ public:
     ~RealtimeRenderer() override;
 
     void DrawFrame(const ViewportFrustum& viewport,
-                   std::vector<ModelMatrices>&& matrices,
-                   std::vector<LightInfo>&& light_infos,
-                   std::vector<DrawInfo>&& draw_infos) override;
+                   FrameDrawData& frame_draw_data) override;
 
 private:
     void InitBuffers();
@@ -41,8 +37,7 @@ private:
     void InitMorphologicalAAcomputePipeline();
 
     void RecordGraphicsCommandBuffer(vk::CommandBuffer command_buffer,
-                                     uint32_t swapchain_index,
-                                     const FrustumCulling& frustum_culling);
+                                     uint32_t swapchain_index);
     void WriteInitHostBuffers() const;
     void AssortDrawInfos();
     void BindMAAimages(uint32_t frame_index, uint32_t swapchain_index);
@@ -1,8 +1,10 @@
 #pragma once
 
+#include <chrono>
+#include <deque>
 #include <unordered_map>
-#include <queue>
-#include <mutex>
+
+#include "spsc_ring.h"
 
 #include "configuru.hpp"
 
@@ -21,6 +23,13 @@ enum class eventInputIDenums
     TOGGLE_VIEWPORT_FREEZE
 };
 
+struct InputEvent
+{
+    InputType inputType;
+    InputMouse mouse;                                       // MouseMove only
+    std::chrono::steady_clock::time_point timePoint;        // when the input thread got it
+};
+
 class Engine;
 
 class InputManager
@@ -29,13 +38,19 @@ public:
     InputManager(Engine* engine_ptr, configuru::Config& in_cfgFile);
     ~InputManager();
 
+    // Main thread only
     std::vector<eventInputIDenums> GrabAndResetEventVector();
+    void DispatchInputEvents();                             // to ECS, in the order they happened
 
+    // Input thread only
     void KeyPressed(int key);
     void KeyReleased(int key);
 
     void MouseMoved(long xOffset, long yOffset);
 
+    // Pushes what did not fit to the rings before, returns if some still does not. Called when no input comes too
+    bool FlushPendingEvents();
+
 private:
     configuru::Config& cfgFile;
 
@@ -53,7 +68,9 @@ private:
     void StopMovingUp();
     void StopMovingDown();
 
+    // What does not fit to the rings is kept at the pending queues, to be pushed before the next one or by FlushPendingEvents
     void AddToQueue(eventInputIDenums event);
+    void AddInputEvent(InputType input_type, InputMouse mouse = InputMouse());
 
     bool forwardKeyIsPressed = false;
     bool backwardKeyIsPressed = false;
@@ -69,7 +86,11 @@ private:
     std::unordered_map<int, std::function<void()>> keyToFunction_onKeyPressed_umap;
     std::unordered_map<int, std::function<void()>> keyToFunction_onKeyReleased_umap;
 
-    std::vector<eventInputIDenums> eventVector;
+    // Input thread to main thread, without locks
+    spsc_ring<eventInputIDenums, 64> eventsRing;
+    spsc_ring<InputEvent, 4096> inputEventsRing;
+    std::deque<eventInputIDenums> pendingEvents;            // input thread's
+    std::deque<InputEvent> pendingInputEvents;              // input thread's
 
     std::map<std::string, std::pair<std::function<void()>, std::function<void()>>> functionNameToFunction_map =
     {
@@ -106,6 +127,4 @@ private:
     };
 
     Engine* engine_ptr;
-
-    std::mutex controlMutex;
 };
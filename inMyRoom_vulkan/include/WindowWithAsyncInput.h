@@ -24,6 +24,8 @@ public:
     void AddCallbackKeyPressLambda(std::function<void(int)> lambda);
     void AddCallbackKeyReleaseLambda(std::function<void(int)> lambda);
     void AddCallbackMouseMoveLambda(std::function<void(long,long)> lambda);
+    // Input thread calls it after every wait for events. Returning true means it has work left, so it gets called again soon, new events or not
+    void AddCallbackAfterEventsLambda(std::function<bool()> lambda);
     void DeleteCallbacks();
 
     bool ShouldClose() const;
@@ -35,6 +37,7 @@ private:
     std::vector<std::function<void(int)>> callbackListOnKeyPress;
     std::vector<std::function<void(int)>> callbackListOnKeyRelease;
     std::vector<std::function<void(long,long)>> callbackListOnMouseMove;
+    std::vector<std::function<bool()>> callbackListAfterEvents;
 
     std::pair<double, double> lastMousePosition;
     std::pair<double, double> moduloOfMousePosition;
@@ -43,6 +46,8 @@ private:
     std::mutex controlMutex;
     bool closeInputThread = false;
 
+    static constexpr double afterEventsRetryTimeout = 0.001;       // seconds
+
     GLFWwindow* window = nullptr;
 
     static void InitGlfw();
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <atomic>
+
+class WorkersPool
+{
+public:
+    explicit WorkersPool(size_t threads_count = 0);     // threads_count counts the calling thread too, 0 = hardware concurrency
+    ~WorkersPool();
+
+    size_t GetThreadsCount() const;
+
+    // Blocking. Calling thread works too while waiting, so it is safe to call them from inside a task
+    void RunTasks(const std::vector<std::function<void()>>& tasks);
+    void ParallelFor(size_t count, size_t min_batch_size, const std::function<void(size_t, size_t)>& batch_func);
+
+private:
+    struct Job
+    {
+        std::function<void()> func;
+        std::atomic<size_t>* remaining_ptr = nullptr;
+    };
+
+    void PushJobs(std::vector<Job>&& jobs);
+    bool TryRunJob();
+    void WaitAndHelp(const std::atomic<size_t>& remaining);
+    void WorkerLoop();
+
+private:
+    std::vector<std::thread> workerThreads;
+
+    std::deque<Job> jobsQueue;
+    std::mutex queueMutex;
+    std::condition_variable queueCV;
+    bool stopWorkers = false;
+};
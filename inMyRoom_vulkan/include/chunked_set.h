@@ -0,0 +1,404 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <iterator>
+#include <algorithm>
+#include <concepts>
+#include <cassert>
+#include <cstdint>
+#include <bit>
+#include <new>
+
+// Like dense_set elements are placed by their index, but in fixed-size chunks with an occupancy bitmask.
+// Iterators jump over empty chunks and removed elements a mask at a time, and empty chunks are freed on removal.
+// Chunks hold whole elements (AoS): elements are handed out by reference, so their fields can't be split to arrays per chunk.
+// Pays off for components that lose most of their entities; packed ones iterate faster at dense_set (see ChunkedSetBenchmark).
+template<typename index_T, typename dense_T, typename dense_base_T, index_T dense_base_T::* dense_T_index_ptr> requires
+    requires (dense_T t){index_T(t.*dense_T_index_ptr);}
+class chunked_set
+{
+public:
+    static constexpr size_t chunk_size = 64;
+
+    struct chunk
+    {
+        chunk() = default;
+        chunk(const chunk&) = delete;
+        chunk& operator=(const chunk&) = delete;
+        ~chunk()
+        {
+            for(uint64_t mask = occupancy; mask != 0; mask &= mask - 1)
+                element(size_t(std::countr_zero(mask)))->~dense_T();
+        }
+
+        dense_T* element(size_t slot) {return std::launder(reinterpret_cast<dense_T*>(storage) + slot);}
+        const dense_T* element(size_t slot) const {return std::launder(reinterpret_cast<const dense_T*>(storage) + slot);}
+
+        uint64_t occupancy = 0;
+        alignas(dense_T) unsigned char storage[sizeof(dense_T) * chunk_size];
+    };
+
+private:
+    // Finds next occupied slot at [position, end_position), shared by the iterators.
+    // "slots_mask" gets the occupied slots of its chunk from it up to end_position, so the iterators step in the chunk by the mask
+    static size_t next_valid_position(const std::unique_ptr<chunk>* chunks_ptr, size_t position, size_t end_position, uint64_t& slots_mask)
+    {
+        while(position < end_position)
+        {
+            const chunk* this_chunk_ptr = chunks_ptr[position / chunk_size].get();
+            size_t chunk_first_position = position / chunk_size * chunk_size;
+            size_t chunk_end_position = std::min(chunk_first_position + chunk_size, end_position);
+
+            if(this_chunk_ptr != nullptr)
+            {
+                uint64_t mask = this_chunk_ptr->occupancy & (~uint64_t(0) << (position % chunk_size));
+                if(chunk_end_position - chunk_first_position < chunk_size)
+                    mask &= (uint64_t(1) << (chunk_end_position - chunk_first_position)) - 1;
+
+                if(mask != 0)
+                {
+                    slots_mask = mask;
+                    return chunk_first_position + size_t(std::countr_zero(mask));
+                }
+            }
+
+            position = chunk_end_position;
+        }
+
+        slots_mask = 0;
+        return end_position;
+    }
+
+    static size_t next_position(const std::unique_ptr<chunk>* chunks_ptr, size_t position, size_t end_position, uint64_t& slots_mask)
+    {
+        slots_mask &= slots_mask - 1;
+        if(slots_mask != 0)
+            return position / chunk_size * chunk_size + size_t(std::countr_zero(slots_mask));
+        else
+            return next_valid_position(chunks_ptr, (position / chunk_size + 1) * chunk_size, end_position, slots_mask);
+    }
+
+public:
+    class iterator
+    {
+    public:
+        typedef iterator self_type;
+        typedef dense_T value_type;
+        typedef dense_T& reference;
+        typedef dense_T* pointer;
+        typedef std::forward_iterator_tag iterator_category;
+        typedef int difference_type;
+        iterator(std::unique_ptr<chunk>* chunks_ptr, size_t position, size_t end_position)
+            : chunks_ptr_(chunks_ptr), position_(position), end_position_(end_position) { go_to_valid_element(); }
+        self_type& operator++() { position_ = next_position(chunks_ptr_, position_, end_position_, slots_mask_); return *this;  }
+        self_type operator++(int junk) { self_type i = *this; position_ = next_position(chunks_ptr_, position_, end_position_, slots_mask_); return i; }
+        reference operator*() { return *chunks_ptr_[position_ / chunk_size]->element(position_ % chunk_size); }
+        pointer operator->() { return chunks_ptr_[position_ / chunk_size]->element(position_ % chunk_size); }
+        bool operator==(const self_type& rhs) const { return position_ == rhs.position_; }
+        bool operator!=(const self_type& rhs) const { return position_ != rhs.position_; }
+
+        void go_to_valid_element() { position_ = next_valid_position(chunks_ptr_, position_, end_position_, slots_mask_); }
+
+    private:
+        std::unique_ptr<chunk>* chunks_ptr_;
+        size_t position_;
+        size_t end_position_;
+        uint64_t slots_mask_ = 0;
+    };
+
+    class const_iterator
+    {
+    public:
+        typedef const_iterator self_type;
+        typedef dense_T value_type;
+        typedef const dense_T& reference;
+        typedef const dense_T* pointer;
+        typedef std::forward_iterator_tag iterator_category;
+        typedef int difference_type;
+        const_iterator(const std::unique_ptr<chunk>* chunks_ptr, size_t position, size_t end_position)
+            : chunks_ptr_(chunks_ptr), position_(position), end_position_(end_position) { go_to_valid_element(); }
+        self_type& operator++() { position_ = next_position(chunks_ptr_, position_, end_position_, slots_mask_); return *this;  }
+        self_type operator++(int junk) { self_type i = *this; position_ = next_position(chunks_ptr_, position_, end_position_, slots_mask_); return i; }
+        reference operator*() { return *chunks_ptr_[position_ / chunk_size]->element(position_ % chunk_size); }
+        pointer operator->() { return chunks_ptr_[position_ / chunk_size]->element(position_ % chunk_size); }
+        bool operator==(const self_type& rhs) const { return position_ == rhs.position_; }
+        bool operator!=(const self_type& rhs) const { return position_ != rhs.position_; }
+
+        void go_to_valid_element() { position_ = next_valid_position(chunks_ptr_, position_, end_position_, slots_mask_); }
+
+    private:
+        const std::unique_ptr<chunk>* chunks_ptr_;
+        size_t position_;
+        size_t end_position_;
+        uint64_t slots_mask_ = 0;
+    };
+
+    chunked_set() = default;
+    chunked_set(const chunked_set& other, index_T offset) {add_elements(other, offset);}
+    chunked_set(chunked_set&& other, index_T offset) {add_elements(std::move(other), offset);}
+    chunked_set(chunked_set&& other) noexcept = default;
+    chunked_set& operator=(chunked_set&& other) noexcept = default;
+
+    void deinit()
+    {
+        first_chunk = size_t(-1);
+        chunks.clear();
+        valid_objs = 0;
+    }
+
+    iterator begin() {return iterator(chunks.data(), 0, container_size());}
+    iterator end() {return iterator(chunks.data(), container_size(), container_size());}
+    const_iterator begin() const {return const_iterator(chunks.data(), 0, container_size());}
+    const_iterator end() const {return const_iterator(chunks.data(), container_size(), container_size());}
+    const_iterator cbegin() const {return const_iterator(chunks.data(), 0, container_size());}
+    const_iterator cend() const {return const_iterator(chunks.data(), container_size(), container_size());}
+
+    [[nodiscard]] std::pair<iterator, iterator> get_range_iterators(const std::pair<index_T, index_T>& range)
+    {
+        size_t first_position = size_t(range.first) - first_chunk * chunk_size;
+        size_t end_position = size_t(range.second) - first_chunk * chunk_size + 1;
+
+        return {iterator(chunks.data(), first_position, end_position), iterator(chunks.data(), end_position, end_position)};
+    }
+
+    [[nodiscard]] std::pair<const_iterator, const_iterator> get_range_iterators(const std::pair<index_T, index_T>& range) const
+    {
+        size_t first_position = size_t(range.first) - first_chunk * chunk_size;
+        size_t end_position = size_t(range.second) - first_chunk * chunk_size + 1;
+
+        return {const_iterator(chunks.data(), first_position, end_position), const_iterator(chunks.data(), end_position, end_position)};
+    }
+
+    [[nodiscard]] std::pair<iterator, iterator> get_position_range_iterators(size_t first_position, size_t last_position)
+    {
+        assert(first_position <= last_position && last_position <= container_size());
+
+        return {iterator(chunks.data(), first_position, last_position), iterator(chunks.data(), last_position, last_position)};
+    }
+
+    [[nodiscard]] dense_T& operator[](index_T index)
+    {
+        assert(does_exist(index));
+
+        size_t position = size_t(index) - first_chunk * chunk_size;
+        return *chunks[position / chunk_size]->element(position % chunk_size);
+    }
+    [[nodiscard]] const dense_T& operator[](index_T index) const
+    {
+        return const_cast<chunked_set*>(this)->operator[](index);
+    }
+
+    [[nodiscard]] bool does_exist(index_T index) const
+    {
+        if(first_chunk == size_t(-1) || index == index_T(-1))
+            return false;
+
+        size_t index_chunk = size_t(index) / chunk_size;
+        if(index_chunk < first_chunk || index_chunk >= first_chunk + chunks.size())
+            return false;
+
+        const chunk* this_chunk_ptr = chunks[index_chunk - first_chunk].get();
+        return this_chunk_ptr != nullptr && (this_chunk_ptr->occupancy >> (size_t(index) % chunk_size)) & 1;
+    }
+
+    // Positions are slots, including empty ones. Chunk i covers positions [i * chunk_size, (i + 1) * chunk_size)
+    [[nodiscard]] size_t container_size() const
+    {
+        return chunks.size() * chunk_size;
+    }
+
+    [[nodiscard]] size_t size() const
+    {
+        return valid_objs;
+    }
+
+    [[nodiscard]] size_t chunks_count() const
+    {
+        return chunks.size();
+    }
+
+    // nullptr if chunk has no elements
+    [[nodiscard]] chunk* get_chunk(size_t chunk_index)
+    {
+        return chunks[chunk_index].get();
+    }
+
+    [[nodiscard]] const chunk* get_chunk(size_t chunk_index) const
+    {
+        return chunks[chunk_index].get();
+    }
+
+    void add_element(const dense_T& dense_element, index_T offset = 0)
+    {
+        dense_T* ref_ptr = new (get_empty_slot(dense_element.*dense_T_index_ptr + offset)) dense_T(dense_element);
+        ref_ptr->*dense_T_index_ptr += offset;
+
+        ++valid_objs;
+    }
+
+    void add_element(dense_T&& dense_element, index_T offset = 0)
+    {
+        dense_T* ref_ptr = new (get_empty_slot(dense_element.*dense_T_index_ptr + offset)) dense_T(std::move(dense_element));
+        ref_ptr->*dense_T_index_ptr += offset;
+
+        ++valid_objs;
+    }
+
+    void add_elements(const chunked_set& other, index_T offset = 0)
+    {
+        if (other.first_chunk == size_t(-1))
+            return;
+
+        extent_chunks((other.first_chunk * chunk_size + offset) / chunk_size,
+                      ((other.first_chunk + other.chunks.size()) * chunk_size - 1 + offset) / chunk_size);
+
+        for(auto it = other.begin(); it != other.end(); ++it)
+        {
+            add_element(*it, offset);
+        }
+    }
+
+    void add_elements(chunked_set&& other, index_T offset = 0)
+    {
+        if (other.first_chunk == size_t(-1))
+            return;
+
+        extent_chunks((other.first_chunk * chunk_size + offset) / chunk_size,
+                      ((other.first_chunk + other.chunks.size()) * chunk_size - 1 + offset) / chunk_size);
+
+        for(auto it = other.begin(); it != other.end(); ++it)
+        {
+            add_element(std::move(*it), offset);
+        }
+
+        other.deinit();
+    }
+
+    template<class InputIt>
+        requires std::same_as<chunked_set, typename InputIt::value_type>
+    void add_elements_list(InputIt first, InputIt last)
+    {
+        if (first == last)
+            return;
+
+        size_t min_chunk = size_t(-1);
+        size_t max_chunk = 0;
+        for (auto _first = first; _first != last; ++_first)
+        {
+            if((*_first).first_chunk != size_t(-1))
+            {
+                min_chunk = std::min(min_chunk, (*_first).first_chunk);
+                max_chunk = std::max(max_chunk, (*_first).first_chunk + (*_first).chunks.size() - 1);
+            }
+        }
+
+        if(min_chunk != size_t(-1))
+        {
+            extent_chunks(min_chunk, max_chunk);
+
+            for (auto _first = first; _first != last; ++_first)
+            {
+                add_elements((*_first));
+            }
+        }
+    }
+
+    void remove_oneshot_added_ranges(std::vector<std::pair<index_T, index_T>> ranges_to_remove)
+    {
+        if(ranges_to_remove.empty())
+            return;
+
+        for(const auto& range: ranges_to_remove)
+        {
+            for(size_t index = range.first; index <= range.second; ++index)
+            {
+                size_t position = index - first_chunk * chunk_size;
+                chunk* this_chunk_ptr = chunks[position / chunk_size].get();
+
+                uint64_t slot_bit = uint64_t(1) << (position % chunk_size);
+                if(this_chunk_ptr != nullptr && (this_chunk_ptr->occupancy & slot_bit))
+                {
+                    this_chunk_ptr->element(position % chunk_size)->~dense_T();
+                    this_chunk_ptr->occupancy &= ~slot_bit;
+
+                    --valid_objs;
+                }
+            }
+        }
+
+        compact_chunks();
+    }
+
+private:
+    void* get_empty_slot(size_t index)
+    {
+        extent_chunks(index / chunk_size, index / chunk_size);
+
+        size_t position = index - first_chunk * chunk_size;
+        std::unique_ptr<chunk>& this_chunk_uptr = chunks[position / chunk_size];
+        if(this_chunk_uptr == nullptr)
+            this_chunk_uptr = std::make_unique<chunk>();
+
+        uint64_t slot_bit = uint64_t(1) << (position % chunk_size);
+        assert((this_chunk_uptr->occupancy & slot_bit) == 0);
+        this_chunk_uptr->occupancy |= slot_bit;
+
+        return static_cast<void*>(this_chunk_uptr->element(position % chunk_size));
+    }
+
+    void extent_chunks(size_t min_chunk, size_t max_chunk)
+    {
+        if(first_chunk == size_t(-1)) [[unlikely]]
+        {
+            chunks.resize(max_chunk - min_chunk + 1);
+            first_chunk = min_chunk;
+        }
+        else [[likely]]
+        {
+            if(min_chunk < first_chunk) [[unlikely]]
+            {
+                size_t front_blank_chunks = first_chunk - min_chunk;
+
+                std::vector<std::unique_ptr<chunk>> new_chunks(front_blank_chunks + chunks.size());
+                std::move(chunks.begin(), chunks.end(), new_chunks.begin() + front_blank_chunks);
+
+                chunks = std::move(new_chunks);
+
+                first_chunk = min_chunk;
+            }
+            if(max_chunk > first_chunk + chunks.size() - 1) [[unlikely]]
+            {
+                chunks.resize(max_chunk - first_chunk + 1);
+            }
+        }
+    }
+
+    void compact_chunks()
+    {
+        for(auto& this_chunk_uptr : chunks)
+        {
+            if(this_chunk_uptr != nullptr && this_chunk_uptr->occupancy == 0)
+                this_chunk_uptr.reset();
+        }
+
+        auto first_used_it = std::find_if(chunks.begin(), chunks.end(), [](const auto& this_chunk_uptr) {return this_chunk_uptr != nullptr;});
+        if(first_used_it == chunks.end())
+        {
+            deinit();
+            return;
+        }
+
+        auto last_used_it = std::find_if(chunks.rbegin(), chunks.rend(), [](const auto& this_chunk_uptr) {return this_chunk_uptr != nullptr;}).base();
+
+        first_chunk += size_t(std::distance(chunks.begin(), first_used_it));
+        chunks.erase(last_used_it, chunks.end());
+        chunks.erase(chunks.begin(), first_used_it);
+    }
+
+private:
+    size_t first_chunk = size_t(-1);
+    std::vector<std::unique_ptr<chunk>> chunks;
+
+    size_t valid_objs = 0;
+};
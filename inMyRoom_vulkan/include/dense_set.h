@@ -115,6 +115,16 @@ public:
         return range_iterators;
     }
 
+    [[nodiscard]] std::pair<iterator, iterator> get_position_range_iterators(size_t first_position, size_t last_position)
+    {
+        assert(first_position <= last_position && last_position <= array.size());
+
+        auto first_it = iterator(array.data() + first_position, array.data() + last_position);
+        first_it.go_to_valid_element();
+
+        return {first_it, iterator(array.data() + last_position, array.data() + last_position)};
+    }
+
     [[nodiscard]] dense_T& operator[](index_T index)
     {
         assert(index != index_T(-1) && array_offset != index_T(-1));
@@ -125,7 +135,7 @@ public:
     }
     const dense_T& operator[](index_T index) const
     {
-        return const_cast<dense_set>(this)->operator[](index);
+        return const_cast<dense_set*>(this)->operator[](index);
     }
 
     bool does_exist(index_T index) const
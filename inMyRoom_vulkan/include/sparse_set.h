@@ -88,6 +88,13 @@ public:
         return range_iterators;
     }
 
+    [[nodiscard]] std::pair<iterator, iterator> get_position_range_iterators(size_t first_position, size_t last_position)
+    {
+        assert(first_position <= last_position && last_position <= dense_array.size());
+
+        return {iterator(dense_array.data() + first_position), iterator(dense_array.data() + last_position)};
+    }
+
     [[nodiscard]] dense_T& operator[](index_T index)
     {
         assert(index != index_T(-1) && sparse_array_offset != index_T(-1));
@@ -99,7 +106,7 @@ public:
     }
     [[nodiscard]] const dense_T& operator[](index_T index) const
     {
-        return const_cast<sparse_set>(this)->operator[](index);
+        return const_cast<sparse_set*>(this)->operator[](index);
     }
 
     [[nodiscard]] bool does_exist(index_T index) const
@@ -109,6 +116,11 @@ public:
                sparse_array[index - sparse_array_offset] != index_T(-1);
     }
 
+    [[nodiscard]] size_t container_size() const
+    {
+        return dense_array.size();
+    }
+
     [[nodiscard]] size_t size() const
     {
         return dense_array.size();
@@ -229,7 +241,7 @@ public:
             {
                 sparse_array[*it.*dense_T_index_ptr - sparse_array_offset] = index_T(-1);
 
-                if (std::distance(dense_array.begin(), it) == dense_ranges_to_remove[current_remove_range].second)
+                if (std::distance(dense_array.begin(), it) == int(dense_ranges_to_remove[current_remove_range].second))
                     ++current_remove_range;
             }
             else
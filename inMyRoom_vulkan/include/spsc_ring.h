@@ -0,0 +1,91 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <deque>
+
+// Bounded lock-free queue for one producer thread and one consumer thread, neither of them ever waits for the other.
+// Indices only grow and wrap by masking, so capacity has to be a power of two
+template<typename T, size_t capacity> requires
+    (capacity != 0 && (capacity & (capacity - 1)) == 0)
+class spsc_ring
+{
+public:
+    spsc_ring() = default;
+    spsc_ring(const spsc_ring&) = delete;
+    spsc_ring& operator=(const spsc_ring&) = delete;
+
+    // Producer only, false when full
+    bool try_push(const T& value)
+    {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - cached_head_ == capacity)
+        {
+            cached_head_ = head_.load(std::memory_order_acquire);
+            if (tail - cached_head_ == capacity)
+                return false;
+        }
+
+        buffer_[tail & (capacity - 1)] = value;
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer only, false when empty
+    bool try_pop(T& value)
+    {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        if (head == cached_tail_)
+        {
+            cached_tail_ = tail_.load(std::memory_order_acquire);
+            if (head == cached_tail_)
+                return false;
+        }
+
+        value = buffer_[head & (capacity - 1)];
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Either side, may be outdated by the time it returns
+    size_t size() const
+    {
+        const size_t head = head_.load(std::memory_order_acquire);     // first, so tail cannot be behind it
+        return tail_.load(std::memory_order_acquire) - head;
+    }
+    bool empty() const {return size() == 0;}
+
+    static constexpr size_t get_capacity() {return capacity;}
+
+private:
+    // Each side on its own cache line, with its cached copy of the other side's index
+    alignas(64) std::atomic<size_t> head_ = 0;
+    size_t cached_tail_ = 0;
+
+    alignas(64) std::atomic<size_t> tail_ = 0;
+    size_t cached_head_ = 0;
+
+    alignas(64) std::array<T, capacity> buffer_;
+};
+
+// Producer only. Pushes, in order, what did not fit before, returns if some still do not
+template<typename T, size_t capacity>
+bool push_pending(spsc_ring<T, capacity>& ring, std::deque<T>& pending)
+{
+    while (pending.size() && ring.try_push(pending.front()))
+        pending.pop_front();
+
+    return not pending.empty();
+}
+
+// Producer only. Pushes first what did not fit before, then the value, and keeps at the producer's side what still does not fit,
+// so the producer neither waits nor loses values and the consumer gets them in order
+template<typename T, size_t capacity>
+void push_or_keep_pending(spsc_ring<T, capacity>& ring, std::deque<T>& pending, const T& value)
+{
+    push_pending(ring, pending);
+
+    if (pending.size() || not ring.try_push(value))
+        pending.emplace_back(value);
+}
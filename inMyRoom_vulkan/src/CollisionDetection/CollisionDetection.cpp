@@ -1,16 +1,33 @@
 #include "CollisionDetection/CollisionDetection.h"
 
+#include "CollisionDetection/SweepAndPrune.h"
+#include "CollisionDetection/DynamicAABBtree.h"
+#include "WorkersPool.h"
+
 #include <algorithm>
+#include <bit>
+#include <unordered_map>
 
-CollisionDetection::CollisionDetection(ECSwrapper* in_ECSwrapper_ptr)
-    :ECSwrapper_ptr(in_ECSwrapper_ptr)
+CollisionDetection::CollisionDetection(ECSwrapper* in_ECSwrapper_ptr, configuru::Config& in_cfgFile, WorkersPool* in_workersPool_ptr)
+    :ECSwrapper_ptr(in_ECSwrapper_ptr),
+     workersPool_ptr(in_workersPool_ptr)
 {
     {
         glm::vec3 U_axis = glm::normalize(glm::vec3(0.8f, -0.2f, 0.f));
         glm::vec3 W_axis = glm::normalize(glm::cross(U_axis, glm::vec3(0.f, -1.f, 0.f)));
         glm::vec3 V_axis = glm::normalize(glm::cross(W_axis, U_axis));
 
-        broadPhaseCollision_uptr = std::make_unique<SweepAndPrune>(U_axis, V_axis, W_axis);
+        if (in_cfgFile["collisionSettings"]["broadPhase"].as_string() == "DynamicAABBtree") {
+            printf("Broad phase collision: DynamicAABBtree\n");
+            std::unique_ptr<DynamicAABBtree> dynamicAABBtree_uptr = std::make_unique<DynamicAABBtree>(U_axis, V_axis, W_axis);
+            sceneQueries_uptr = std::make_unique<SceneQueries>(dynamicAABBtree_uptr.get());
+            broadPhaseCollision_uptr = std::move(dynamicAABBtree_uptr);
+        }
+        else {
+            printf("Broad phase collision: SweepAndPrune\n");
+            broadPhaseCollision_uptr = std::make_unique<SweepAndPrune>(U_axis, V_axis, W_axis);
+            sceneQueries_uptr = std::make_unique<SceneQueries>(U_axis, V_axis, W_axis);
+        }
     }
     {
         midPhaseCollision_uptr = std::make_unique<OBBtreesCollision>();
@@ -23,6 +40,23 @@ CollisionDetection::CollisionDetection(ECSwrapper* in_ECSwrapper_ptr)
                                                                         glm::radians(65.f),
                                                                         1.01f);
     }
+    {
+        if (in_cfgFile["collisionSettings"]["pairCache"].as_bool()) {
+            float revalidate_max_movement = in_cfgFile["collisionSettings"]["pairCacheRevalidateMovement"].as_float();
+            if (revalidate_max_movement > 0.f)
+                printf("Collision pair cache: enabled, revalidates up to %f of size movement\n", revalidate_max_movement);
+            else
+                printf("Collision pair cache: enabled, exact reuse only\n");
+            pairCache_uptr = std::make_unique<CollisionPairCache>(revalidate_max_movement);
+        }
+    }
+    {
+        if (in_cfgFile["collisionSettings"]["continuousCollision"].as_bool()) {
+            float min_movement = in_cfgFile["collisionSettings"]["continuousCollisionMinMovement"].as_float();
+            printf("Continuous collision: enabled, for flagged entries that move more than %f of their thinnest side\n", min_movement);
+            continuousCollision_uptr = std::make_unique<ContinuousCollision>(min_movement);
+        }
+    }
 }
 
 void CollisionDetection::Reset()
@@ -37,98 +71,319 @@ void CollisionDetection::AddCollisionDetectionEntry(const CollisionDetectionEntr
 
 void CollisionDetection::ExecuteCollisionDetection()
 {
-    if (collisionDetectionEntries.size() < 2) return;
+    frameStats = FrameStats();
+    frameStats.entriesCount = collisionDetectionEntries.size();
+    auto phase_start_time = std::chrono::steady_clock::now();
+    auto end_phase = [&phase_start_time](std::chrono::duration<float>& phase_duration)
+    {
+        auto now = std::chrono::steady_clock::now();
+        phase_duration = now - phase_start_time;
+        phase_start_time = now;
+    };
 
     // Broad phase collision
     // at least one of the entries should have callback
-    std::vector<std::pair<CollisionDetectionEntry, CollisionDetectionEntry>> broadPhaseResults = broadPhaseCollision_uptr->ExecuteSweepAndPrune(collisionDetectionEntries);
+    // (keeps state across frames, so it has to see every frame's entries)
+    std::vector<std::pair<CollisionDetectionEntry, CollisionDetectionEntry>> broadPhaseResults = broadPhaseCollision_uptr->ExecuteBroadPhaseCollision(collisionDetectionEntries);
+
+    // Before any callback, so callbacks can query this frame's scene
+    sceneQueries_uptr->Update(collisionDetectionEntries);
+
+    frameStats.broadPhasePairsCount = broadPhaseResults.size();
+    end_phase(frameStats.broadPhaseDuration);
+
+    if (collisionDetectionEntries.size() < 2) return;
 
-    // Mid phase collision (OBBtree vs OBBtree)
-    std::vector<CDentriesPairTrianglesPairs> midPhaseResults;
-    midPhaseResults.reserve(broadPhaseResults.size());
-    for(const std::pair<CollisionDetectionEntry, CollisionDetectionEntry>& this_pair: broadPhaseResults)
+    // Mid and narrow phase, each pair writes only its own result
+    std::vector<PairCollisionResult> pairs_results(broadPhaseResults.size());
+    auto execute_pairs_range = [this, &broadPhaseResults, &pairs_results](size_t first, size_t last)
     {
-        CDentriesPairTrianglesPairs this_result = midPhaseCollision_uptr->ExecuteOBBtreesCollision(this_pair);
-        if(this_result.OBBtreesIntersectInfoObj.candidateTriangleRangeCombinations.size())
+        for (size_t i = first; i != last; ++i)
+            pairs_results[i] = ExecutePairCollision(broadPhaseResults[i]);
+    };
+
+    if (workersPool_ptr != nullptr)
+        workersPool_ptr->ParallelFor(broadPhaseResults.size(), parallelPairsBatchSize, execute_pairs_range);
+    else
+        execute_pairs_range(0, broadPhaseResults.size());
+
+    frameStats.collidedPairsCount = size_t(std::count_if(pairs_results.begin(), pairs_results.end(),
+                                                         [](const PairCollisionResult& this_pair_result) {return this_pair_result.hasCollided;}));
+    end_phase(frameStats.pairsDuration);
+
+    // Continuous collision of fast movers, from the previous frame's matrices
+    std::vector<CDentriesTimeOfImpact> times_of_impact;
+    if (continuousCollision_uptr)
+    {
+        std::vector<std::pair<CollisionDetectionEntry, CollisionDetectionEntry>> swept_pairs = continuousCollision_uptr->FindSweptPairs(collisionDetectionEntries);
+
+        times_of_impact.resize(swept_pairs.size());
+        auto execute_swept_pairs_range = [this, &swept_pairs, &times_of_impact](size_t first, size_t last)
         {
-            midPhaseResults.emplace_back(std::move(this_result));
-        }
-    }     
+            for (size_t i = first; i != last; ++i)
+                times_of_impact[i] = continuousCollision_uptr->ExecuteTimeOfImpact(swept_pairs[i]);
+        };
+
+        if (workersPool_ptr != nullptr)
+            workersPool_ptr->ParallelFor(swept_pairs.size(), parallelPairsBatchSize, execute_swept_pairs_range);
+        else
+            execute_swept_pairs_range(0, swept_pairs.size());
+
+        frameStats.sweptPairsCount = swept_pairs.size();
+    }
 
-    // Create rays phase (narrow phase)
-    std::vector<CDentriesUncollideRays> createUncollideRaysResults;
-    for (const CDentriesPairTrianglesPairs& this_triangles_pairs : midPhaseResults)
+    // Impacts of pairs that also collide at this frame only add their time of impact, the rest tunneled through (unless they were separating)
+    std::vector<PairCollisionResult> tunneled_pairs_results;
+    if (not times_of_impact.empty())
     {
-        CDentriesUncollideRays this_result = createUncollideRays_uptr->ExecuteCreateUncollideRays(this_triangles_pairs);
-        if(this_result.rays_from_first_to_second.size() || this_result.rays_from_second_to_first.size())
+        auto get_key = [](Entity lhs, Entity rhs) -> uint64_t
+        {
+            return (uint64_t(std::min(lhs, rhs)) << 32) | uint64_t(std::max(lhs, rhs));
+        };
+
+        std::unordered_map<uint64_t, size_t> collided_pairs_indices;
+        for (size_t i = 0; i != pairs_results.size(); ++i)
+        {
+            if (pairs_results[i].hasCollided)
+                collided_pairs_indices.emplace(get_key(pairs_results[i].firstCallbackData.familyEntity, pairs_results[i].secondCallbackData.familyEntity), i);
+        }
+
+        for (const CDentriesTimeOfImpact& this_time_of_impact : times_of_impact)
         {
-            createUncollideRaysResults.emplace_back(std::move(this_result));
+            if (not this_time_of_impact.doImpact)
+                continue;
+
+            PairCollisionResult* pair_result_ptr = nullptr;
+
+            auto search = collided_pairs_indices.find(get_key(this_time_of_impact.firstEntry.entity, this_time_of_impact.secondEntry.entity));
+            if (search != collided_pairs_indices.end())
+            {
+                pair_result_ptr = &pairs_results[search->second];
+            }
+            else if (this_time_of_impact.normal == glm::vec3(0.f))
+            {
+                // Overlapped already at the previous frame and not anymore, so it is separating, not tunneling
+                continue;
+            }
+            else
+            {
+                PairCollisionResult& tunneled_pair_result = tunneled_pairs_results.emplace_back();
+                tunneled_pair_result.hasCollided = true;
+                tunneled_pair_result.firstCallbackData.familyEntity = this_time_of_impact.firstEntry.entity;
+                tunneled_pair_result.firstCallbackData.collideWithEntity = this_time_of_impact.secondEntry.entity;
+                tunneled_pair_result.secondCallbackData.familyEntity = this_time_of_impact.secondEntry.entity;
+                tunneled_pair_result.secondCallbackData.collideWithEntity = this_time_of_impact.firstEntry.entity;
+
+                // Back to the pose of impact, split by how much each one moved
+                const glm::vec3 first_center = this_time_of_impact.firstEntry.OBBtree_ptr->GetRootOBB().GetCenter();
+                const glm::vec3 second_center = this_time_of_impact.secondEntry.OBBtree_ptr->GetRootOBB().GetCenter();
+
+                float first_movement_between_frames = PointMovementBetweenFrames(first_center,
+                                                                                 this_time_of_impact.firstEntry.currentGlobalMatrix,
+                                                                                 this_time_of_impact.firstEntry.previousGlobalMatrix);
+                float second_movement_between_frames = PointMovementBetweenFrames(second_center,
+                                                                                  this_time_of_impact.secondEntry.currentGlobalMatrix,
+                                                                                  this_time_of_impact.secondEntry.previousGlobalMatrix);
+
+                float total_movement = first_movement_between_frames + second_movement_between_frames;
+                float first_share = total_movement > 0.f ? first_movement_between_frames / total_movement : 1.f;
+
+                glm::vec3 delta = (1.f - this_time_of_impact.timeOfImpact) * this_time_of_impact.relativeDisplacement;
+                tunneled_pair_result.firstCallbackData.deltaVector = - delta * first_share;
+                tunneled_pair_result.secondCallbackData.deltaVector = + delta * (1.f - first_share);
+
+                pair_result_ptr = &tunneled_pair_result;
+            }
+
+            for (CollisionCallbackData* this_callbackData_ptr : {&pair_result_ptr->firstCallbackData, &pair_result_ptr->secondCallbackData})
+            {
+                bool is_first = this_callbackData_ptr->familyEntity == this_time_of_impact.firstEntry.entity;
+
+                this_callbackData_ptr->hasTimeOfImpact = true;
+                this_callbackData_ptr->timeOfImpact = this_time_of_impact.timeOfImpact;
+                this_callbackData_ptr->contactNormal = is_first ? this_time_of_impact.normal : -this_time_of_impact.normal;
+            }
         }
     }
 
-    std::unordered_map<Entity, std::vector<CollisionCallbackData>> callbacks_to_be_made;
-    for (CDentriesUncollideRays& this_uncollideRaysResult : createUncollideRaysResults)
+    frameStats.tunneledPairsCount = tunneled_pairs_results.size();
+    end_phase(frameStats.continuousDuration);
+
+    // Merge at broad phase's pairs order, so callbacks do not depend on threads count
+    std::map<Entity, std::vector<CollisionCallbackData>> callbacks_to_be_made;
+    for (const PairCollisionResult& this_pair_result : pairs_results)
     {
-        CollisionCallbackData first_collisionCallbackData;
-        first_collisionCallbackData.familyEntity = this_uncollideRaysResult.firstEntry.entity;
-        first_collisionCallbackData.collideWithEntity = this_uncollideRaysResult.secondEntry.entity;
+        if (this_pair_result.hasCollided)
+            AddPairCallbacks(this_pair_result.firstCallbackData, this_pair_result.secondCallbackData, callbacks_to_be_made);
+    }
+
+    for (const PairCollisionResult& this_pair_result : tunneled_pairs_results)
+        AddPairCallbacks(this_pair_result.firstCallbackData, this_pair_result.secondCallbackData, callbacks_to_be_made);
 
-        CollisionCallbackData second_collisionCallbackData;
-        second_collisionCallbackData.familyEntity = this_uncollideRaysResult.secondEntry.entity;
-        second_collisionCallbackData.collideWithEntity = this_uncollideRaysResult.firstEntry.entity;
+    frameStats.callbacksHash = GetCallbacksHash(callbacks_to_be_made);
+    MakeCallbacks(std::move(callbacks_to_be_made));
+    end_phase(frameStats.callbacksDuration);
 
-        if(this_uncollideRaysResult.firstEntry.currentGlobalMatrix != this_uncollideRaysResult.firstEntry.previousGlobalMatrix ||
-           this_uncollideRaysResult.secondEntry.currentGlobalMatrix != this_uncollideRaysResult.secondEntry.previousGlobalMatrix)
+    if (pairCache_uptr)
+    {
+        std::vector<std::pair<std::pair<Entity, Entity>, CollisionPairCache::Entry>> new_cache_entries;
+        std::vector<std::pair<Entity, Entity>> kept_cache_entries_pairs;
+        for (size_t i = 0; i != broadPhaseResults.size(); ++i)
         {
-            // Shoot the rays!
-            glm::vec3 delta = shootDeltaUncollide_uptr->ExecuteShootUncollideRays(this_uncollideRaysResult);
+            std::pair<Entity, Entity> this_entities_pair = {broadPhaseResults[i].first.entity, broadPhaseResults[i].second.entity};
 
-            float first_movement_between_frames = PointMovementBetweenFrames(this_uncollideRaysResult.average_point_first_modelspace,
-                                                                             this_uncollideRaysResult.firstEntry.currentGlobalMatrix,
-                                                                             this_uncollideRaysResult.firstEntry.previousGlobalMatrix);
+            pairCache_uptr->AddLookupResult(pairs_results[i].cacheLookupResult);
+            if (pairs_results[i].cacheLookupResult == CollisionPairCache::LookupResult::sameTransform)
+                kept_cache_entries_pairs.emplace_back(this_entities_pair);
+            else
+                new_cache_entries.emplace_back(this_entities_pair, std::move(pairs_results[i].cacheEntry));
+        }
 
-            float second_movement_between_frames = PointMovementBetweenFrames(this_uncollideRaysResult.average_point_second_modelspace,
-                                                                              this_uncollideRaysResult.secondEntry.currentGlobalMatrix,
-                                                                              this_uncollideRaysResult.secondEntry.previousGlobalMatrix);
+        pairCache_uptr->Update(std::move(new_cache_entries), kept_cache_entries_pairs);
+    }
+}
 
-            float total_movement = first_movement_between_frames + second_movement_between_frames;
+CollisionPairCache::Stats CollisionDetection::GetPairCacheStats() const
+{
+    return pairCache_uptr ? pairCache_uptr->GetStats() : CollisionPairCache::Stats();
+}
 
-            first_collisionCallbackData.deltaVector = - delta * (first_movement_between_frames / total_movement);
-            second_collisionCallbackData.deltaVector = + delta * (second_movement_between_frames / total_movement);
+const CollisionDetection::FrameStats& CollisionDetection::GetFrameStats() const
+{
+    return frameStats;
+}
+
+const SceneQueries* CollisionDetection::GetSceneQueriesPtr() const
+{
+    return sceneQueries_uptr.get();
+}
+
+CollisionDetection::PairCollisionResult CollisionDetection::ExecutePairCollision(const std::pair<CollisionDetectionEntry, CollisionDetectionEntry>& entries_pair) const
+{
+    PairCollisionResult return_result;
+
+    const glm::mat4 relative_matrix = glm::inverse(entries_pair.first.currentGlobalMatrix) * entries_pair.second.currentGlobalMatrix;
+
+    const CollisionPairCache::Entry* cached_entry_ptr = nullptr;
+    if (pairCache_uptr)
+        return_result.cacheLookupResult = pairCache_uptr->Lookup(entries_pair, relative_matrix, cached_entry_ptr);
+
+    CDentriesUncollideRays created_uncollideRays;
+    const CDentriesUncollideRays* uncollideRays_ptr = &created_uncollideRays;
+
+    if (return_result.cacheLookupResult == CollisionPairCache::LookupResult::sameTransform)
+    {
+        uncollideRays_ptr = &cached_entry_ptr->uncollideRays;
+    }
+    else
+    {
+        CDentriesPairTrianglesPairs triangles_pairs;
+        if (return_result.cacheLookupResult == CollisionPairCache::LookupResult::revalidate)
+        {
+            // Leaf pairs of the last traversal
+            triangles_pairs = {entries_pair.first, entries_pair.second, cached_entry_ptr->OBBtreesIntersectInfoObj};
+            return_result.cacheEntry.traversalRelativeMatrix = cached_entry_ptr->traversalRelativeMatrix;
         }
         else
         {
-            first_collisionCallbackData.deltaVector = glm::vec3(0.f);
-            second_collisionCallbackData.deltaVector = glm::vec3(0.f);
+            // Mid phase collision (OBBtree vs OBBtree)
+            triangles_pairs = midPhaseCollision_uptr->ExecuteOBBtreesCollision(entries_pair);
+            return_result.cacheEntry.traversalRelativeMatrix = relative_matrix;
         }
-        
 
-        std::vector<Entity> first_ancestors = ECSwrapper_ptr->GetEntitiesHandler()->GetEntityAncestors(first_collisionCallbackData.familyEntity);
-        std::vector<Entity> second_ancestors = ECSwrapper_ptr->GetEntitiesHandler()->GetEntityAncestors(second_collisionCallbackData.familyEntity);
+        // Create rays phase (narrow phase)
+        if (not triangles_pairs.OBBtreesIntersectInfoObj.candidateTriangleRangeCombinations.empty())
+            created_uncollideRays = createUncollideRays_uptr->ExecuteCreateUncollideRays(triangles_pairs);
 
-        for(size_t index = 0; index != first_ancestors.size(); ++index)
+        if (pairCache_uptr)
         {
-            if(index >= second_ancestors.size() ||
-               first_ancestors[index] != second_ancestors[index])
-            {
-                callbacks_to_be_made[first_ancestors[index]].emplace_back(first_collisionCallbackData);
-            }
+            return_result.cacheEntry.firstOBBtree_ptr = entries_pair.first.OBBtree_ptr;
+            return_result.cacheEntry.secondOBBtree_ptr = entries_pair.second.OBBtree_ptr;
+            return_result.cacheEntry.OBBtreesIntersectInfoObj = std::move(triangles_pairs.OBBtreesIntersectInfoObj);
+            return_result.cacheEntry.raysRelativeMatrix = relative_matrix;
         }
+    }
+
+    if (uncollideRays_ptr->rays_from_first_to_second.empty() && uncollideRays_ptr->rays_from_second_to_first.empty())
+    {
+        if (pairCache_uptr && uncollideRays_ptr == &created_uncollideRays)
+            return_result.cacheEntry.uncollideRays = std::move(created_uncollideRays);
+
+        return return_result;
+    }
+
+    CollisionCallbackData& first_collisionCallbackData = return_result.firstCallbackData;
+    first_collisionCallbackData.familyEntity = entries_pair.first.entity;
+    first_collisionCallbackData.collideWithEntity = entries_pair.second.entity;
+
+    CollisionCallbackData& second_collisionCallbackData = return_result.secondCallbackData;
+    second_collisionCallbackData.familyEntity = entries_pair.second.entity;
+    second_collisionCallbackData.collideWithEntity = entries_pair.first.entity;
+
+    if(entries_pair.first.currentGlobalMatrix != entries_pair.first.previousGlobalMatrix ||
+       entries_pair.second.currentGlobalMatrix != entries_pair.second.previousGlobalMatrix)
+    {
+        // Cached rays are at the same relative transform, the entries give this frame's matrices
+        CDentriesUncollideRays this_uncollideRaysResult = *uncollideRays_ptr;
+        this_uncollideRaysResult.firstEntry = entries_pair.first;
+        this_uncollideRaysResult.secondEntry = entries_pair.second;
+
+        // Shoot the rays!
+        glm::vec3 delta = shootDeltaUncollide_uptr->ExecuteShootUncollideRays(this_uncollideRaysResult);
+
+        float first_movement_between_frames = PointMovementBetweenFrames(this_uncollideRaysResult.average_point_first_modelspace,
+                                                                         this_uncollideRaysResult.firstEntry.currentGlobalMatrix,
+                                                                         this_uncollideRaysResult.firstEntry.previousGlobalMatrix);
+
+        float second_movement_between_frames = PointMovementBetweenFrames(this_uncollideRaysResult.average_point_second_modelspace,
+                                                                          this_uncollideRaysResult.secondEntry.currentGlobalMatrix,
+                                                                          this_uncollideRaysResult.secondEntry.previousGlobalMatrix);
+
+        float total_movement = first_movement_between_frames + second_movement_between_frames;
 
-        for(size_t index = 0; index != second_ancestors.size(); ++index)
+        first_collisionCallbackData.deltaVector = - delta * (first_movement_between_frames / total_movement);
+        second_collisionCallbackData.deltaVector = + delta * (second_movement_between_frames / total_movement);
+    }
+    else
+    {
+        first_collisionCallbackData.deltaVector = glm::vec3(0.f);
+        second_collisionCallbackData.deltaVector = glm::vec3(0.f);
+    }
+
+    if (pairCache_uptr && uncollideRays_ptr == &created_uncollideRays)
+        return_result.cacheEntry.uncollideRays = std::move(created_uncollideRays);
+
+    return_result.hasCollided = true;
+    return return_result;
+}
+
+void CollisionDetection::AddPairCallbacks(const CollisionCallbackData& first_collisionCallbackData,
+                                          const CollisionCallbackData& second_collisionCallbackData,
+                                          std::map<Entity, std::vector<CollisionCallbackData>>& callbacks_to_be_made) const
+{
+    std::vector<Entity> first_ancestors = ECSwrapper_ptr->GetEntitiesHandler()->GetEntityAncestors(first_collisionCallbackData.familyEntity);
+    std::vector<Entity> second_ancestors = ECSwrapper_ptr->GetEntitiesHandler()->GetEntityAncestors(second_collisionCallbackData.familyEntity);
+
+    for(size_t index = 0; index != first_ancestors.size(); ++index)
+    {
+        if(index >= second_ancestors.size() ||
+           first_ancestors[index] != second_ancestors[index])
         {
-            if(index >= first_ancestors.size() ||
-               first_ancestors[index] != second_ancestors[index])
-            {
-                callbacks_to_be_made[second_ancestors[index]].emplace_back(second_collisionCallbackData);
-            }
+            callbacks_to_be_made[first_ancestors[index]].emplace_back(first_collisionCallbackData);
         }
     }
 
-    MakeCallbacks(std::move(callbacks_to_be_made));
+    for(size_t index = 0; index != second_ancestors.size(); ++index)
+    {
+        if(index >= first_ancestors.size() ||
+           first_ancestors[index] != second_ancestors[index])
+        {
+            callbacks_to_be_made[second_ancestors[index]].emplace_back(second_collisionCallbackData);
+        }
+    }
 }
 
-void CollisionDetection::MakeCallbacks(std::unordered_map<Entity, std::vector<CollisionCallbackData>>&& callbacks_to_be_made) const
+void CollisionDetection::MakeCallbacks(std::map<Entity, std::vector<CollisionCallbackData>>&& callbacks_to_be_made) const
 {
     std::vector<std::pair<Entity, std::vector<CollisionCallbackData>>> callbacks_to_be_made_vector(std::make_move_iterator(callbacks_to_be_made.begin()),
                                                                                                    std::make_move_iterator(callbacks_to_be_made.end()));
@@ -140,7 +395,7 @@ void CollisionDetection::MakeCallbacks(std::unordered_map<Entity, std::vector<Co
     }
 }
 
-float CollisionDetection::PointMovementBetweenFrames(const glm::vec3 point, const glm::mat4& m_first, const glm::mat4& m_second)
+float CollisionDetection::PointMovementBetweenFrames(const glm::vec3 point, const glm::mat4& m_first, const glm::mat4& m_second) const
 {
     glm::vec3 p_first = glm::vec3(m_first * glm::vec4(point, 1.f));
     glm::vec3 p_second = glm::vec3(m_second * glm::vec4(point, 1.f));
@@ -148,4 +403,29 @@ float CollisionDetection::PointMovementBetweenFrames(const glm::vec3 point, cons
     glm::vec3 v_diff = p_first - p_second;
 
     return glm::length(v_diff);
-}
\ No newline at end of file
+}
+
+uint64_t CollisionDetection::GetCallbacksHash(const std::map<Entity, std::vector<CollisionCallbackData>>& callbacks_to_be_made)
+{
+    uint64_t hash = 0xcbf29ce484222325;
+    auto add_to_hash = [&hash](uint32_t value)
+    {
+        hash = (hash ^ value) * 0x100000001b3;
+    };
+
+    for (const auto& [this_entity, this_callbacks_data] : callbacks_to_be_made)
+    {
+        add_to_hash(this_entity);
+        for (const CollisionCallbackData& this_callbackData : this_callbacks_data)
+        {
+            add_to_hash(this_callbackData.familyEntity);
+            add_to_hash(this_callbackData.collideWithEntity);
+            for (size_t i = 0; i != 3; ++i)
+                add_to_hash(std::bit_cast<uint32_t>(this_callbackData.deltaVector[i]));
+            add_to_hash(uint32_t(this_callbackData.hasTimeOfImpact));
+            add_to_hash(std::bit_cast<uint32_t>(this_callbackData.timeOfImpact));
+        }
+    }
+
+    return hash;
+}
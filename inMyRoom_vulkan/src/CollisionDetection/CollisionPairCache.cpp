@@ -0,0 +1,93 @@
+#include "CollisionDetection/CollisionPairCache.h"
+
+#include <algorithm>
+
+CollisionPairCache::CollisionPairCache(float in_revalidateMaxMovement)
+    :revalidateMaxMovement(in_revalidateMaxMovement)
+{
+}
+
+CollisionPairCache::LookupResult CollisionPairCache::Lookup(const std::pair<CollisionDetectionEntry, CollisionDetectionEntry>& entries_pair,
+                                                            const glm::mat4x4& relative_matrix,
+                                                            const Entry*& cached_entry_ptr) const
+{
+    cached_entry_ptr = nullptr;
+
+    auto search = entries.find(GetKey(entries_pair.first.entity, entries_pair.second.entity));
+    if (search == entries.end())
+        return LookupResult::miss;
+
+    const Entry& cached_entry = search->second;
+    if (cached_entry.firstOBBtree_ptr != entries_pair.first.OBBtree_ptr ||
+        cached_entry.secondOBBtree_ptr != entries_pair.second.OBBtree_ptr)
+        return LookupResult::miss;
+
+    cached_entry_ptr = &cached_entry;
+
+    if (cached_entry.raysRelativeMatrix == relative_matrix)
+        return LookupResult::sameTransform;
+
+    // Pairs that were apart have no leaf pairs to check again
+    if (revalidateMaxMovement > 0.f && not cached_entry.OBBtreesIntersectInfoObj.candidateTriangleRangeCombinations.empty())
+    {
+        const OBB second_root_obb = entries_pair.second.OBBtree_ptr->GetRootOBB();
+        float second_size = 2.f * (glm::length(second_root_obb.GetSideDirectionU()) +
+                                   glm::length(second_root_obb.GetSideDirectionV()) +
+                                   glm::length(second_root_obb.GetSideDirectionW()));
+
+        if (GetMaxOBBcornersMovement(second_root_obb, cached_entry.traversalRelativeMatrix, relative_matrix) <= revalidateMaxMovement * second_size)
+            return LookupResult::revalidate;
+    }
+
+    cached_entry_ptr = nullptr;
+    return LookupResult::miss;
+}
+
+void CollisionPairCache::Update(std::vector<std::pair<std::pair<Entity, Entity>, Entry>>&& new_entries,
+                                const std::vector<std::pair<Entity, Entity>>& kept_entries_pairs)
+{
+    std::unordered_map<uint64_t, Entry> updated_entries;
+    updated_entries.reserve(new_entries.size() + kept_entries_pairs.size());
+
+    for (const std::pair<Entity, Entity>& this_entities_pair : kept_entries_pairs)
+    {
+        uint64_t key = GetKey(this_entities_pair.first, this_entities_pair.second);
+
+        auto search = entries.find(key);
+        if (search != entries.end())
+            updated_entries.insert_or_assign(key, std::move(search->second));
+    }
+
+    for (auto& this_pair_entry : new_entries)
+        updated_entries.insert_or_assign(GetKey(this_pair_entry.first.first, this_pair_entry.first.second), std::move(this_pair_entry.second));
+
+    entries = std::move(updated_entries);
+}
+
+void CollisionPairCache::AddLookupResult(LookupResult lookup_result)
+{
+    ++stats.lookupsCount;
+
+    if (lookup_result == LookupResult::sameTransform)
+        ++stats.sameTransformHitsCount;
+    else if (lookup_result == LookupResult::revalidate)
+        ++stats.revalidateHitsCount;
+}
+
+float CollisionPairCache::GetMaxOBBcornersMovement(const OBB& obb, const glm::mat4x4& lhs_matrix, const glm::mat4x4& rhs_matrix)
+{
+    float max_movement = 0.f;
+    for (size_t corner_index = 0; corner_index != 8; ++corner_index)
+    {
+        glm::vec3 corner = obb.GetCenter() + ((corner_index & 1) ? +1.f : -1.f) * obb.GetSideDirectionU()
+                                           + ((corner_index & 2) ? +1.f : -1.f) * obb.GetSideDirectionV()
+                                           + ((corner_index & 4) ? +1.f : -1.f) * obb.GetSideDirectionW();
+
+        glm::vec3 lhs_corner = glm::vec3(lhs_matrix * glm::vec4(corner, 1.f));
+        glm::vec3 rhs_corner = glm::vec3(rhs_matrix * glm::vec4(corner, 1.f));
+
+        max_movement = std::max(max_movement, glm::length(lhs_corner - rhs_corner));
+    }
+
+    return max_movement;
+}
@@ -0,0 +1,140 @@
+#include "CollisionDetection/ContinuousCollision.h"
+
+#include <algorithm>
+
+#include "glm/gtc/matrix_inverse.hpp"
+
+ContinuousCollision::ContinuousCollision(float in_minMovementFactor)
+    :minMovementFactor(in_minMovementFactor)
+{
+}
+
+std::vector<std::pair<CollisionDetectionEntry, CollisionDetectionEntry>> ContinuousCollision::FindSweptPairs(const std::vector<CollisionDetectionEntry>& collisionDetectionEntries) const
+{
+    std::vector<std::pair<CollisionDetectionEntry, CollisionDetectionEntry>> return_vector;
+
+    std::vector<size_t> swept_indices;
+    for (size_t index = 0; index != collisionDetectionEntries.size(); ++index)
+    {
+        const CollisionDetectionEntry& this_entry = collisionDetectionEntries[index];
+        if (not this_entry.isContinuous)
+            continue;
+
+        Paralgram this_root_paralgram = this_entry.currentGlobalMatrix * this_entry.OBBtree_ptr->GetRootOBB();
+        glm::vec3 this_movement = glm::vec3(this_entry.currentGlobalMatrix * glm::vec4(this_entry.OBBtree_ptr->GetRootOBB().GetCenter(), 1.f)) -
+                                  glm::vec3(this_entry.previousGlobalMatrix * glm::vec4(this_entry.OBBtree_ptr->GetRootOBB().GetCenter(), 1.f));
+
+        if (HasMovedEnough(this_root_paralgram, this_movement))
+            swept_indices.emplace_back(index);
+    }
+
+    if (swept_indices.empty())
+        return return_vector;
+
+    // Few fast movers, so each one is checked against every entry
+    std::vector<std::pair<glm::vec3, glm::vec3>> entries_min_max;
+    entries_min_max.reserve(collisionDetectionEntries.size());
+    for (const CollisionDetectionEntry& this_entry : collisionDetectionEntries)
+        entries_min_max.emplace_back(GetSweptMinMax(this_entry));
+
+    std::vector<bool> is_swept(collisionDetectionEntries.size(), false);
+    for (size_t swept_index : swept_indices)
+        is_swept[swept_index] = true;
+
+    for (size_t swept_index : swept_indices)
+    {
+        const CollisionDetectionEntry& swept_entry = collisionDetectionEntries[swept_index];
+        const std::pair<glm::vec3, glm::vec3>& swept_min_max = entries_min_max[swept_index];
+
+        for (size_t index = 0; index != collisionDetectionEntries.size(); ++index)
+        {
+            // Two fast movers are paired once
+            if (index == swept_index || (is_swept[index] && index < swept_index))
+                continue;
+
+            const CollisionDetectionEntry& other_entry = collisionDetectionEntries[index];
+            if (not swept_entry.shouldCallback && not other_entry.shouldCallback)
+                continue;
+
+            const std::pair<glm::vec3, glm::vec3>& other_min_max = entries_min_max[index];
+            bool do_overlap = true;
+            for (int axis = 0; axis != 3; ++axis)
+                do_overlap &= swept_min_max.first[axis] <= other_min_max.second[axis] && other_min_max.first[axis] <= swept_min_max.second[axis];
+
+            if (do_overlap)
+                return_vector.emplace_back(swept_entry, other_entry);
+        }
+    }
+
+    return return_vector;
+}
+
+CDentriesTimeOfImpact ContinuousCollision::ExecuteTimeOfImpact(const std::pair<CollisionDetectionEntry, CollisionDetectionEntry>& entries_pair) const
+{
+    CDentriesTimeOfImpact return_info;
+    return_info.firstEntry = entries_pair.first;
+    return_info.secondEntry = entries_pair.second;
+
+    const glm::mat4 previous_relative_matrix = glm::inverse(entries_pair.second.previousGlobalMatrix) * entries_pair.first.previousGlobalMatrix;
+    const glm::mat4 current_relative_matrix = glm::inverse(entries_pair.second.currentGlobalMatrix) * entries_pair.first.currentGlobalMatrix;
+
+    const OBB first_root_obb = entries_pair.first.OBBtree_ptr->GetRootOBB();
+    glm::vec3 displacement = glm::vec3(current_relative_matrix * glm::vec4(first_root_obb.GetCenter(), 1.f)) -
+                             glm::vec3(previous_relative_matrix * glm::vec4(first_root_obb.GetCenter(), 1.f));
+
+    if (not HasMovedEnough(previous_relative_matrix * first_root_obb, displacement))
+        return return_info;
+
+    OBBtreesSweepInfo sweep_info;
+    OBBtree::SweepOBBtrees(*entries_pair.first.OBBtree_ptr, previous_relative_matrix, displacement, *entries_pair.second.OBBtree_ptr, sweep_info);
+
+    if (not sweep_info.doIntersect)
+        return return_info;
+
+    return_info.doImpact = true;
+    return_info.timeOfImpact = sweep_info.timeOfImpact;
+    return_info.relativeDisplacement = glm::mat3(entries_pair.second.currentGlobalMatrix) * displacement;
+
+    if (sweep_info.normal != glm::vec3(0.f))
+    {
+        // The adjoint flips normals of mirroring matrices
+        glm::mat3 normal_matrix = TriangleNormal::GetNormalCorrectedMatrixUnormalized(entries_pair.second.currentGlobalMatrix);
+        float determinant_sign = glm::determinant(glm::mat3(entries_pair.second.currentGlobalMatrix)) < 0.f ? -1.f : +1.f;
+
+        return_info.normal = glm::normalize(determinant_sign * (normal_matrix * sweep_info.normal));
+    }
+
+    return return_info;
+}
+
+bool ContinuousCollision::HasMovedEnough(const Paralgram& root_paralgram, const glm::vec3& movement) const
+{
+    float thinnest_side = 2.f * std::min({glm::length(root_paralgram.GetSideDirectionU()),
+                                          glm::length(root_paralgram.GetSideDirectionV()),
+                                          glm::length(root_paralgram.GetSideDirectionW())});
+
+    return glm::length(movement) > minMovementFactor * thinnest_side;
+}
+
+std::pair<glm::vec3, glm::vec3> ContinuousCollision::GetSweptMinMax(const CollisionDetectionEntry& entry)
+{
+    glm::vec3 min = glm::vec3(+std::numeric_limits<float>::infinity());
+    glm::vec3 max = glm::vec3(-std::numeric_limits<float>::infinity());
+
+    const OBB root_obb = entry.OBBtree_ptr->GetRootOBB();
+    for (const glm::mat4& this_matrix : {entry.previousGlobalMatrix, entry.currentGlobalMatrix})
+    {
+        for (size_t corner_index = 0; corner_index != 8; ++corner_index)
+        {
+            glm::vec3 corner = root_obb.GetCenter() + ((corner_index & 1) ? +1.f : -1.f) * root_obb.GetSideDirectionU()
+                                                    + ((corner_index & 2) ? +1.f : -1.f) * root_obb.GetSideDirectionV()
+                                                    + ((corner_index & 4) ? +1.f : -1.f) * root_obb.GetSideDirectionW();
+
+            glm::vec3 world_corner = glm::vec3(this_matrix * glm::vec4(corner, 1.f));
+            min = glm::min(min, world_corner);
+            max = glm::max(max, world_corner);
+        }
+    }
+
+    return {min, max};
+}
@@ -1,5 +1,6 @@
 #include "CollisionDetection/CreateUncollideRays.h"
 #include "Geometry/Plane.h"
+#include "Geometry/TriangleBatch.h"
 
 #include <bitset>
 #include <numeric>
@@ -10,6 +11,8 @@ CreateUncollideRays::CreateUncollideRays()
 {
 }
 
+static_assert(OBBtree::GetMaxNumberOfTrianglesPerNode() <= TriangleBatch::width, "A leaf's triangles should fit in one TriangleBatch");
+
 struct TriangleCandidateRays
 {
     std::bitset<3> point_is_not_outside = -1;
@@ -76,17 +79,26 @@ CDentriesUncollideRays CreateUncollideRays::ExecuteCreateUncollideRays(const CDe
         std::array<TriangleCandidateRays, OBBtree::GetMaxNumberOfTrianglesPerNode()> this_first_candidateRays;
         std::array<TriangleCandidateRays, OBBtree::GetMaxNumberOfTrianglesPerNode()> this_second_candidateRays;
 
+        // The second's leaf triangles are moved to first's space once and tested against each of the first's leaf triangles at once
+        TriangleBatch seconds_triangles;
+        for(size_t j = 0; j != this_trianglesPair.second_obbtree_count; ++j)
+            seconds_triangles.Add(second_to_first_space_matrix * second_OBBtree_ptr->GetTrianglePosition(j + this_trianglesPair.second_obbtree_offset));
+
         for(size_t i = 0; i != this_trianglesPair.first_obbtree_count; ++i)
         {
-            for(size_t j = 0; j != this_trianglesPair.second_obbtree_count; ++j)
-            {
-                TrianglePosition firsts_triangle = first_OBBtree_ptr->GetTrianglePosition(i + this_trianglesPair.first_obbtree_offset);
-                TrianglePosition seconds_triangle = second_to_first_space_matrix * second_OBBtree_ptr->GetTrianglePosition(j + this_trianglesPair.second_obbtree_offset);
+            TrianglePosition firsts_triangle = first_OBBtree_ptr->GetTrianglePosition(i + this_trianglesPair.first_obbtree_offset);
 
-                TrianglesIntersectionInfo this_intersect = Triangle::IntersectTriangles(firsts_triangle, seconds_triangle);
+            std::array<TrianglesIntersectionInfo, TriangleBatch::width> intersections_info;
+            uint32_t intersect_mask = seconds_triangles.IntersectTriangle(firsts_triangle, intersections_info);
+
+            for(size_t j = 0; intersect_mask != 0 && j != this_trianglesPair.second_obbtree_count; ++j)
+            {
+                const TrianglesIntersectionInfo& this_intersect = intersections_info[j];
 
                 if(this_intersect.doIntersept && not this_intersect.areCoplanar)
                 {
+                    TrianglePosition seconds_triangle = seconds_triangles.GetTriangle(j);
+
                     Plane firsts_triangle_plane = Plane::CreatePlaneFromTriangle(firsts_triangle);
                     Plane seconds_triangle_plane = Plane::CreatePlaneFromTriangle(seconds_triangle);
 
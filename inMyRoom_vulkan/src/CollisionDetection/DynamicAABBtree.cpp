@@ -0,0 +1,458 @@
+#include "CollisionDetection/DynamicAABBtree.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <limits>
+
+bool BroadPhaseAABB::DoesOverlap(const BroadPhaseAABB& other) const
+{
+    for (size_t i = 0; i != 3; ++i)
+    {
+        if (max[i] < other.min[i] || other.max[i] < min[i])
+            return false;
+    }
+
+    return true;
+}
+
+bool BroadPhaseAABB::DoesContain(const BroadPhaseAABB& other) const
+{
+    for (size_t i = 0; i != 3; ++i)
+    {
+        if (other.min[i] < min[i] || max[i] < other.max[i])
+            return false;
+    }
+
+    return true;
+}
+
+float BroadPhaseAABB::GetSurfaceArea() const
+{
+    float dx = max[0] - min[0];
+    float dy = max[1] - min[1];
+    float dz = max[2] - min[2];
+
+    return 2.f * (dx * dy + dy * dz + dz * dx);
+}
+
+float BroadPhaseAABB::GetDistanceSquared(const std::array<float, 3>& point) const
+{
+    float distance_squared = 0.f;
+    for (size_t i = 0; i != 3; ++i)
+    {
+        float outside = std::max(min[i] - point[i], 0.f) + std::max(point[i] - max[i], 0.f);
+        distance_squared += outside * outside;
+    }
+
+    return distance_squared;
+}
+
+float BroadPhaseAABB::GetRayEnterDistance(const std::array<float, 3>& origin, const std::array<float, 3>& inverse_direction, float max_distance) const
+{
+    float enter_distance = 0.f;
+    float exit_distance = max_distance;
+    for (size_t i = 0; i != 3; ++i)
+    {
+        float t1 = (min[i] - origin[i]) * inverse_direction[i];
+        float t2 = (max[i] - origin[i]) * inverse_direction[i];
+
+        enter_distance = std::max(enter_distance, std::min(t1, t2));
+        exit_distance = std::min(exit_distance, std::max(t1, t2));
+    }
+
+    if (enter_distance <= exit_distance)
+        return enter_distance;
+    else
+        return std::numeric_limits<float>::infinity();
+}
+
+BroadPhaseAABB BroadPhaseAABB::GetUnion(const BroadPhaseAABB& lhs, const BroadPhaseAABB& rhs)
+{
+    BroadPhaseAABB return_aabb;
+    for (size_t i = 0; i != 3; ++i)
+    {
+        return_aabb.min[i] = std::min(lhs.min[i], rhs.min[i]);
+        return_aabb.max[i] = std::max(lhs.max[i], rhs.max[i]);
+    }
+
+    return return_aabb;
+}
+
+DynamicAABBtree::DynamicAABBtree(glm::vec3 in_U_axis, glm::vec3 in_V_axis, glm::vec3 in_W_axis)
+    :axes({in_U_axis, in_V_axis, in_W_axis})
+{
+}
+
+std::vector<std::pair<CollisionDetectionEntry, CollisionDetectionEntry>> DynamicAABBtree::ExecuteBroadPhaseCollision(const std::vector<CollisionDetectionEntry>& collisionDetectionEntries)
+{
+    UpdateTree(collisionDetectionEntries);
+
+    std::vector<uint64_t> pairs;
+    std::vector<int32_t> stack;
+    for (const CollisionDetectionEntry& this_collisionDetectionEntry : collisionDetectionEntries)
+    {
+        if (not this_collisionDetectionEntry.shouldCallback || rootIndex == -1)
+            continue;
+
+        const Entity this_entity = this_collisionDetectionEntry.entity;
+        const DynamicAABBtreeProxy& this_proxy = proxiesOfEntities[this_entity];
+
+        stack.clear();
+        stack.emplace_back(rootIndex);
+        while (stack.size())
+        {
+            const DynamicAABBtreeNode& this_node = nodes[stack.back()];
+            stack.pop_back();
+
+            if (not this_node.fatAABB.DoesOverlap(this_proxy.tightAABB))
+                continue;
+
+            if (this_node.IsLeaf())
+            {
+                Entity other_entity = this_node.entity;
+                const DynamicAABBtreeProxy& other_proxy = proxiesOfEntities[other_entity];
+
+                // Pairs of two callback entries are found from both sides, keep only one
+                if (other_entity == this_entity || (other_proxy.shouldCallback && other_entity < this_entity))
+                    continue;
+
+                if (this_proxy.tightAABB.DoesOverlap(other_proxy.tightAABB))
+                    pairs.emplace_back((uint64_t(std::min(this_entity, other_entity)) << 32) | uint64_t(std::max(this_entity, other_entity)));
+            }
+            else
+            {
+                stack.emplace_back(this_node.child1);
+                stack.emplace_back(this_node.child2);
+            }
+        }
+    }
+
+    // Sorted, so results do not depend on tree's shape
+    std::sort(pairs.begin(), pairs.end());
+
+    std::vector<std::pair<CollisionDetectionEntry, CollisionDetectionEntry>> return_vector;
+    return_vector.reserve(pairs.size());
+    for (uint64_t this_pair : pairs)
+    {
+        const DynamicAABBtreeProxy& first_proxy = proxiesOfEntities[Entity(this_pair >> 32)];
+        const DynamicAABBtreeProxy& second_proxy = proxiesOfEntities[Entity(this_pair & 0xFFFFFFFF)];
+
+        return_vector.emplace_back(collisionDetectionEntries[first_proxy.entryIndex], collisionDetectionEntries[second_proxy.entryIndex]);
+    }
+
+    return return_vector;
+}
+
+void DynamicAABBtree::UpdateTree(const std::vector<CollisionDetectionEntry>& collisionDetectionEntries)
+{
+    ++frameIndex;
+
+    UpdateProxies(collisionDetectionEntries);
+}
+
+int32_t DynamicAABBtree::GetHeight() const
+{
+    if (rootIndex == -1)
+        return 0;
+    else
+        return nodes[rootIndex].height;
+}
+
+void DynamicAABBtree::UpdateProxies(const std::vector<CollisionDetectionEntry>& collisionDetectionEntries)
+{
+    for (size_t index = 0; index < collisionDetectionEntries.size(); index++)
+    {
+        const CollisionDetectionEntry& this_collisionDetectionEntry = collisionDetectionEntries[index];
+
+        if (this_collisionDetectionEntry.entity >= proxiesOfEntities.size())
+            proxiesOfEntities.resize(size_t(this_collisionDetectionEntry.entity) + 1);
+
+        DynamicAABBtreeProxy& this_proxy = proxiesOfEntities[this_collisionDetectionEntry.entity];
+        assert(this_proxy.lastFrame != frameIndex);
+
+        if (this_proxy.leafIndex == -1)
+        {
+            this_proxy.tightAABB = GetTightAABB(this_collisionDetectionEntry);
+
+            this_proxy.leafIndex = AllocateNode();
+            nodes[this_proxy.leafIndex].fatAABB = GetFatAABB(this_proxy.tightAABB, this_collisionDetectionEntry);
+            nodes[this_proxy.leafIndex].entity = this_collisionDetectionEntry.entity;
+            nodes[this_proxy.leafIndex].height = 0;
+            InsertLeaf(this_proxy.leafIndex);
+        }
+        else if (not this_collisionDetectionEntry.isStatic)
+        {
+            this_proxy.tightAABB = GetTightAABB(this_collisionDetectionEntry);
+
+            if (not nodes[this_proxy.leafIndex].fatAABB.DoesContain(this_proxy.tightAABB))
+            {
+                RemoveLeaf(this_proxy.leafIndex);
+                nodes[this_proxy.leafIndex].fatAABB = GetFatAABB(this_proxy.tightAABB, this_collisionDetectionEntry);
+                InsertLeaf(this_proxy.leafIndex);
+            }
+        }
+
+        this_proxy.entryIndex = index;
+        this_proxy.lastFrame = frameIndex;
+        this_proxy.shouldCallback = this_collisionDetectionEntry.shouldCallback;
+    }
+
+    for (Entity this_entity : activeEntities)
+    {
+        DynamicAABBtreeProxy& this_proxy = proxiesOfEntities[this_entity];
+        if (this_proxy.lastFrame != frameIndex)
+        {
+            RemoveLeaf(this_proxy.leafIndex);
+            FreeNode(this_proxy.leafIndex);
+            this_proxy.leafIndex = -1;
+        }
+    }
+
+    activeEntities.clear();
+    for (const CollisionDetectionEntry& this_collisionDetectionEntry : collisionDetectionEntries)
+        activeEntities.emplace_back(this_collisionDetectionEntry.entity);
+}
+
+BroadPhaseAABB DynamicAABBtree::GetTightAABB(const CollisionDetectionEntry& collisionDetectionEntry) const
+{
+    Paralgram this_paralgram = collisionDetectionEntry.currentGlobalMatrix * collisionDetectionEntry.OBBtree_ptr->GetRootOBB();
+
+    return GetParalgramAABB(this_paralgram);
+}
+
+BroadPhaseAABB DynamicAABBtree::GetParalgramAABB(const Paralgram& paralgram) const
+{
+    BroadPhaseAABB return_aabb;
+    for (size_t i = 0; i != 3; ++i)
+    {
+        std::pair<float, float> this_projection = paralgram.GetMinMaxProjectionToAxis(axes[i]);
+        return_aabb.min[i] = this_projection.first;
+        return_aabb.max[i] = this_projection.second;
+    }
+
+    return return_aabb;
+}
+
+std::array<float, 3> DynamicAABBtree::GetAxesProjections(const glm::vec3& vector) const
+{
+    return {glm::dot(vector, axes[0]), glm::dot(vector, axes[1]), glm::dot(vector, axes[2])};
+}
+
+BroadPhaseAABB DynamicAABBtree::GetFatAABB(const BroadPhaseAABB& tight_aabb, const CollisionDetectionEntry& collisionDetectionEntry) const
+{
+    // Expect it to keep moving as it did since previous frame
+    glm::vec3 displacement = glm::vec3(collisionDetectionEntry.currentGlobalMatrix[3] - collisionDetectionEntry.previousGlobalMatrix[3]);
+
+    BroadPhaseAABB return_aabb;
+    for (size_t i = 0; i != 3; ++i)
+    {
+        float axis_displacement = displacementMultiplier * glm::dot(displacement, axes[i]);
+
+        return_aabb.min[i] = tight_aabb.min[i] - fatMargin + std::min(axis_displacement, 0.f);
+        return_aabb.max[i] = tight_aabb.max[i] + fatMargin + std::max(axis_displacement, 0.f);
+    }
+
+    return return_aabb;
+}
+
+int32_t DynamicAABBtree::AllocateNode()
+{
+    if (freeListIndex == -1)
+    {
+        nodes.emplace_back();
+        return int32_t(nodes.size() - 1);
+    }
+
+    int32_t node_index = freeListIndex;
+    freeListIndex = nodes[node_index].parent;
+
+    nodes[node_index] = DynamicAABBtreeNode();
+    return node_index;
+}
+
+void DynamicAABBtree::FreeNode(int32_t node_index)
+{
+    nodes[node_index].parent = freeListIndex;
+    nodes[node_index].height = -1;
+    freeListIndex = node_index;
+}
+
+void DynamicAABBtree::InsertLeaf(int32_t leaf_index)
+{
+    if (rootIndex == -1)
+    {
+        rootIndex = leaf_index;
+        nodes[rootIndex].parent = -1;
+        return;
+    }
+
+    // Find best sibling by surface area heuristic
+    const BroadPhaseAABB leaf_aabb = nodes[leaf_index].fatAABB;
+    int32_t index = rootIndex;
+    while (not nodes[index].IsLeaf())
+    {
+        int32_t child1 = nodes[index].child1;
+        int32_t child2 = nodes[index].child2;
+
+        float area = nodes[index].fatAABB.GetSurfaceArea();
+        float combined_area = BroadPhaseAABB::GetUnion(nodes[index].fatAABB, leaf_aabb).GetSurfaceArea();
+
+        // Cost of making a new parent for this node and the leaf
+        float cost = 2.f * combined_area;
+        // Minimum cost of pushing the leaf further down the tree
+        float inheritance_cost = 2.f * (combined_area - area);
+
+        auto get_descend_cost = [this, &leaf_aabb, inheritance_cost](int32_t child)
+        {
+            float new_area = BroadPhaseAABB::GetUnion(leaf_aabb, nodes[child].fatAABB).GetSurfaceArea();
+            if (nodes[child].IsLeaf())
+                return new_area + inheritance_cost;
+            else
+                return new_area - nodes[child].fatAABB.GetSurfaceArea() + inheritance_cost;
+        };
+
+        float cost1 = get_descend_cost(child1);
+        float cost2 = get_descend_cost(child2);
+
+        if (cost < cost1 && cost < cost2)
+            break;
+
+        index = cost1 < cost2 ? child1 : child2;
+    }
+
+    int32_t sibling = index;
+
+    // New parent
+    int32_t old_parent = nodes[sibling].parent;
+    int32_t new_parent = AllocateNode();
+    nodes[new_parent].parent = old_parent;
+    nodes[new_parent].fatAABB = BroadPhaseAABB::GetUnion(leaf_aabb, nodes[sibling].fatAABB);
+    nodes[new_parent].height = nodes[sibling].height + 1;
+    nodes[new_parent].child1 = sibling;
+    nodes[new_parent].child2 = leaf_index;
+    nodes[sibling].parent = new_parent;
+    nodes[leaf_index].parent = new_parent;
+
+    if (old_parent != -1)
+    {
+        if (nodes[old_parent].child1 == sibling)
+            nodes[old_parent].child1 = new_parent;
+        else
+            nodes[old_parent].child2 = new_parent;
+    }
+    else
+    {
+        rootIndex = new_parent;
+    }
+
+    RefitAncestors(nodes[leaf_index].parent);
+}
+
+void DynamicAABBtree::RemoveLeaf(int32_t leaf_index)
+{
+    if (leaf_index == rootIndex)
+    {
+        rootIndex = -1;
+        return;
+    }
+
+    int32_t parent = nodes[leaf_index].parent;
+    int32_t grand_parent = nodes[parent].parent;
+    int32_t sibling = nodes[parent].child1 == leaf_index ? nodes[parent].child2 : nodes[parent].child1;
+
+    if (grand_parent != -1)
+    {
+        if (nodes[grand_parent].child1 == parent)
+            nodes[grand_parent].child1 = sibling;
+        else
+            nodes[grand_parent].child2 = sibling;
+
+        nodes[sibling].parent = grand_parent;
+        FreeNode(parent);
+
+        RefitAncestors(grand_parent);
+    }
+    else
+    {
+        rootIndex = sibling;
+        nodes[sibling].parent = -1;
+        FreeNode(parent);
+    }
+}
+
+void DynamicAABBtree::RefitAncestors(int32_t node_index)
+{
+    while (node_index != -1)
+    {
+        node_index = Balance(node_index);
+
+        DynamicAABBtreeNode& this_node = nodes[node_index];
+        const DynamicAABBtreeNode& child1_node = nodes[this_node.child1];
+        const DynamicAABBtreeNode& child2_node = nodes[this_node.child2];
+
+        this_node.height = 1 + std::max(child1_node.height, child2_node.height);
+        this_node.fatAABB = BroadPhaseAABB::GetUnion(child1_node.fatAABB, child2_node.fatAABB);
+
+        node_index = this_node.parent;
+    }
+}
+
+int32_t DynamicAABBtree::Balance(int32_t a_index)
+{
+    // Rotates the higher grandchild up if a's children differ in height by more than one. Returns the new root of the subtree
+    DynamicAABBtreeNode& a_node = nodes[a_index];
+    if (a_node.IsLeaf() || a_node.height < 2)
+        return a_index;
+
+    int32_t b_index = a_node.child1;
+    int32_t c_index = a_node.child2;
+
+    int32_t balance = nodes[c_index].height - nodes[b_index].height;
+    if (std::abs(balance) <= 1)
+        return a_index;
+
+    // Higher child goes up
+    int32_t up_index = balance > 0 ? c_index : b_index;
+    int32_t down_index = balance > 0 ? b_index : c_index;
+    DynamicAABBtreeNode& up_node = nodes[up_index];
+
+    int32_t f_index = up_node.child1;
+    int32_t g_index = up_node.child2;
+
+    // Swap a and up
+    up_node.child1 = a_index;
+    up_node.parent = a_node.parent;
+    a_node.parent = up_index;
+
+    if (up_node.parent != -1)
+    {
+        if (nodes[up_node.parent].child1 == a_index)
+            nodes[up_node.parent].child1 = up_index;
+        else
+            nodes[up_node.parent].child2 = up_index;
+    }
+    else
+    {
+        rootIndex = up_index;
+    }
+
+    // Higher grandchild stays with up, the other goes to a
+    int32_t keep_index = nodes[f_index].height > nodes[g_index].height ? f_index : g_index;
+    int32_t move_index = keep_index == f_index ? g_index : f_index;
+
+    up_node.child2 = keep_index;
+    if (balance > 0)
+        a_node.child2 = move_index;
+    else
+        a_node.child1 = move_index;
+    nodes[move_index].parent = a_index;
+
+    a_node.fatAABB = BroadPhaseAABB::GetUnion(nodes[down_index].fatAABB, nodes[move_index].fatAABB);
+    up_node.fatAABB = BroadPhaseAABB::GetUnion(a_node.fatAABB, nodes[keep_index].fatAABB);
+
+    a_node.height = 1 + std::max(nodes[down_index].height, nodes[move_index].height);
+    up_node.height = 1 + std::max(a_node.height, nodes[keep_index].height);
+
+    return up_index;
+}
@@ -0,0 +1,245 @@
+#include "CollisionDetection/SceneQueries.h"
+
+#include "Geometry/Ray.h"
+#include "Geometry/Sphere.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace
+{
+    bool DoProjectionsOverlap(const std::pair<float, float>& lhs, const std::pair<float, float>& rhs)
+    {
+        return not (lhs.second < rhs.first || rhs.second < lhs.first);
+    }
+
+    // Separating axis test over the paralgram's faces, the triangle's face and the 9 cross products of their edges
+    bool IntersectParalgramTriangle(const Paralgram& paralgram, const TrianglePosition& triangle)
+    {
+        const glm::vec3 paralgram_sides[3] = {paralgram.GetSideDirectionU(), paralgram.GetSideDirectionV(), paralgram.GetSideDirectionW()};
+        const glm::vec3 triangle_edges[3] = {triangle.GetP(1) - triangle.GetP(0), triangle.GetP(2) - triangle.GetP(1), triangle.GetP(0) - triangle.GetP(2)};
+
+        auto is_separating = [&paralgram, &triangle](const glm::vec3& axis)
+        {
+            return not DoProjectionsOverlap(paralgram.GetMinMaxProjectionToAxis(axis), triangle.GetMinMaxProjectionToAxis(axis));
+        };
+
+        if (is_separating(glm::cross(paralgram_sides[1], paralgram_sides[2]))) return false;
+        if (is_separating(glm::cross(paralgram_sides[2], paralgram_sides[0]))) return false;
+        if (is_separating(glm::cross(paralgram_sides[0], paralgram_sides[1]))) return false;
+        if (is_separating(glm::cross(triangle_edges[0], triangle_edges[1]))) return false;
+
+        for (const glm::vec3& this_side : paralgram_sides)
+            for (const glm::vec3& this_edge : triangle_edges)
+                if (is_separating(glm::cross(this_side, this_edge))) return false;
+
+        return true;
+    }
+
+    // Whether a triangle of the entry's mesh passes "triangle_test", descending only the nodes that pass "paralgram_test". Both get world space shapes
+    template<typename ParalgramTest, typename TriangleTest>
+    bool DoesAnyTriangleOverlap(const CollisionDetectionEntry& entry, ParalgramTest&& paralgram_test, TriangleTest&& triangle_test)
+    {
+        const OBBtree& this_OBBtree = *entry.OBBtree_ptr;
+
+        std::vector<OBBtree::OBBtreeTraveler> stack;
+        stack.emplace_back(this_OBBtree.GetRootTraveler());
+        while (stack.size())
+        {
+            OBBtree::OBBtreeTraveler this_traveler = stack.back();
+            stack.pop_back();
+
+            if (not paralgram_test(entry.currentGlobalMatrix * this_traveler.GetOBB()))
+                continue;
+
+            if (this_traveler.IsLeaf())
+            {
+                for (size_t index = this_traveler.GetTrianglesOffset(); index != this_traveler.GetTrianglesOffset() + this_traveler.GetTrianglesCount(); ++index)
+                    if (triangle_test(entry.currentGlobalMatrix * this_OBBtree.GetTrianglePosition(index)))
+                        return true;
+            }
+            else
+            {
+                stack.emplace_back(this_traveler.GetLeftChildTraveler());
+                stack.emplace_back(this_traveler.GetRightChildTraveler());
+            }
+        }
+
+        return false;
+    }
+
+    // Exact when the matrix has no shear, else the distance to a point of the OBB that is close to the nearest
+    float GetDistanceToRootOBB(const CollisionDetectionEntry& entry, const glm::vec3& point)
+    {
+        const OBB root_OBB = entry.OBBtree_ptr->GetRootOBB();
+        const glm::vec3 local_point = glm::vec3(glm::inverse(entry.currentGlobalMatrix) * glm::vec4(point, 1.f));
+        const glm::vec3 local_offset = local_point - root_OBB.GetCenter();
+
+        glm::vec3 local_closest_point = root_OBB.GetCenter();
+        for (const glm::vec3& this_side : {root_OBB.GetSideDirectionU(), root_OBB.GetSideDirectionV(), root_OBB.GetSideDirectionW()})
+        {
+            float side_length_squared = glm::dot(this_side, this_side);
+            if (side_length_squared > 0.f)
+                local_closest_point += this_side * std::clamp(glm::dot(local_offset, this_side) / side_length_squared, -1.f, 1.f);
+        }
+
+        return glm::length(point - glm::vec3(entry.currentGlobalMatrix * glm::vec4(local_closest_point, 1.f)));
+    }
+}
+
+SceneQueries::SceneQueries(glm::vec3 in_U_axis, glm::vec3 in_V_axis, glm::vec3 in_W_axis)
+    :ownAABBtree_uptr(std::make_unique<DynamicAABBtree>(in_U_axis, in_V_axis, in_W_axis)),
+     AABBtree_ptr(ownAABBtree_uptr.get())
+{
+}
+
+SceneQueries::SceneQueries(const DynamicAABBtree* in_broadPhaseAABBtree_ptr)
+    :AABBtree_ptr(in_broadPhaseAABBtree_ptr)
+{
+}
+
+void SceneQueries::Update(const std::vector<CollisionDetectionEntry>& in_collisionDetectionEntries)
+{
+    collisionDetectionEntries = in_collisionDetectionEntries;
+
+    if (ownAABBtree_uptr)
+        ownAABBtree_uptr->UpdateTree(collisionDetectionEntries);
+}
+
+std::vector<SceneRaycastHit> SceneQueries::Raycast(const glm::vec3& origin, const glm::vec3& direction, float max_distance, SceneRaycastMode mode) const
+{
+    assert(glm::dot(direction, direction) > 0.f);
+
+    const glm::vec3 normalized_direction = glm::normalize(direction);
+    const Ray this_ray(origin, normalized_direction);
+
+    std::vector<SceneRaycastHit> hits;
+    std::vector<std::pair<size_t, RayOBBtreeIntersectInfo>> entries_intersections;
+    AABBtree_ptr->QueryRay(origin, normalized_direction, max_distance,
+                           [this, &this_ray, &entries_intersections, &max_distance, mode](size_t entry_index) -> float
+                           {
+                               const CollisionDetectionEntry& this_entry = collisionDetectionEntries[entry_index];
+                               RayOBBtreeIntersectInfo this_intersection = this_ray.IntersectOBBtree(*this_entry.OBBtree_ptr, this_entry.currentGlobalMatrix);
+
+                               if (not this_intersection.doIntersect || this_intersection.distanceFromOrigin > max_distance)
+                                   return max_distance;
+
+                               if (mode == SceneRaycastMode::All)
+                               {
+                                   entries_intersections.emplace_back(entry_index, this_intersection);
+                                   return max_distance;
+                               }
+
+                               entries_intersections.assign(1, {entry_index, this_intersection});
+                               if (mode == SceneRaycastMode::Any)
+                                   return -1.f;
+
+                               // Closest, farther entries cannot beat this one
+                               max_distance = this_intersection.distanceFromOrigin;
+                               return max_distance;
+                           });
+
+    std::sort(entries_intersections.begin(), entries_intersections.end(),
+              [](const auto& lhs, const auto& rhs) {return lhs.second.distanceFromOrigin < rhs.second.distanceFromOrigin;});
+
+    hits.reserve(entries_intersections.size());
+    for (const auto& [entry_index, this_intersection] : entries_intersections)
+    {
+        const CollisionDetectionEntry& this_entry = collisionDetectionEntries[entry_index];
+        TrianglePosition this_triangle = this_entry.currentGlobalMatrix * this_entry.OBBtree_ptr->GetTrianglePosition(this_intersection.triangle_index);
+
+        SceneRaycastHit this_hit;
+        this_hit.entity = this_entry.entity;
+        this_hit.distance = this_intersection.distanceFromOrigin;
+        this_hit.position = origin + normalized_direction * this_intersection.distanceFromOrigin;
+        this_hit.normal = this_triangle.GetTriangleFaceNormal();
+        if (glm::dot(this_hit.normal, normalized_direction) > 0.f)
+            this_hit.normal = -this_hit.normal;
+
+        hits.emplace_back(this_hit);
+    }
+
+    return hits;
+}
+
+std::vector<Entity> SceneQueries::OverlapBox(const glm::vec3& center, const glm::vec3& half_side_u, const glm::vec3& half_side_v, const glm::vec3& half_side_w) const
+{
+    const Paralgram box(center, half_side_u, half_side_v, half_side_w);
+
+    std::vector<Entity> return_entities;
+    AABBtree_ptr->QueryAABB(AABBtree_ptr->GetParalgramAABB(box),
+                            [this, &box, &return_entities](size_t entry_index)
+                            {
+                                const CollisionDetectionEntry& this_entry = collisionDetectionEntries[entry_index];
+                                if (DoesAnyTriangleOverlap(this_entry,
+                                                           [&box](const Paralgram& node_paralgram) {return Paralgram::IntersectParalgramsBoolean(box, node_paralgram);},
+                                                           [&box](const TrianglePosition& triangle) {return IntersectParalgramTriangle(box, triangle);}))
+                                    return_entities.emplace_back(this_entry.entity);
+
+                                return true;
+                            });
+
+    std::sort(return_entities.begin(), return_entities.end());
+    return return_entities;
+}
+
+std::vector<Entity> SceneQueries::OverlapSphere(const glm::vec3& center, float radius) const
+{
+    const Sphere sphere(center, radius);
+
+    BroadPhaseAABB sphere_aabb;
+    std::array<float, 3> uvw_center = AABBtree_ptr->GetAxesProjections(center);
+    for (size_t i = 0; i != 3; ++i)
+    {
+        sphere_aabb.min[i] = uvw_center[i] - radius;
+        sphere_aabb.max[i] = uvw_center[i] + radius;
+    }
+
+    std::vector<Entity> return_entities;
+    AABBtree_ptr->QueryAABB(sphere_aabb,
+                            [this, &sphere, &return_entities](size_t entry_index)
+                            {
+                                const CollisionDetectionEntry& this_entry = collisionDetectionEntries[entry_index];
+                                if (DoesAnyTriangleOverlap(this_entry,
+                                                           [&sphere](const Paralgram& node_paralgram) {return sphere.IntersectParalgram(node_paralgram);},
+                                                           [&sphere](const TrianglePosition& triangle) {return sphere.IntersectTriangle(triangle);}))
+                                    return_entities.emplace_back(this_entry.entity);
+
+                                return true;
+                            });
+
+    std::sort(return_entities.begin(), return_entities.end());
+    return return_entities;
+}
+
+std::vector<SceneNearestEntity> SceneQueries::NearestEntities(const glm::vec3& point, size_t count) const
+{
+    std::vector<SceneNearestEntity> nearest_entities;
+    if (count == 0)
+        return nearest_entities;
+
+    nearest_entities.reserve(count + 1);
+    AABBtree_ptr->QueryNearest(point,
+                               [this, &point, &nearest_entities, count](size_t entry_index, float) -> float
+                               {
+                                   const CollisionDetectionEntry& this_entry = collisionDetectionEntries[entry_index];
+
+                                   SceneNearestEntity this_nearest;
+                                   this_nearest.entity = this_entry.entity;
+                                   this_nearest.distance = GetDistanceToRootOBB(this_entry, point);
+
+                                   // Kept sorted, count is expected to be small
+                                   auto position = std::upper_bound(nearest_entities.begin(), nearest_entities.end(), this_nearest,
+                                                                    [](const SceneNearestEntity& lhs, const SceneNearestEntity& rhs) {return lhs.distance < rhs.distance;});
+                                   nearest_entities.insert(position, this_nearest);
+                                   if (nearest_entities.size() > count)
+                                       nearest_entities.pop_back();
+
+                                   if (nearest_entities.size() == count)
+                                       return nearest_entities.back().distance;
+                                   else
+                                       return std::numeric_limits<float>::infinity();
+                               });
+
+    return nearest_entities;
+}
@@ -1,6 +1,8 @@
 #include "CollisionDetection/ShootUncollideRays.h"
 #include <algorithm>
 
+#include "Geometry/RayPacket.h"
+
 ShootUncollideRays::ShootUncollideRays(float max_cos_from_force_response_smoothstep_start,
                                        float max_cos_from_force_response_smoothstep_finish,
                                        float in_ray_distance_bias_multiplier)
@@ -24,67 +26,62 @@ glm::vec3 ShootUncollideRays::ExecuteShootUncollideRays(const CDentriesUncollide
     glm::vec3 average_force_responses = glm::vec3(0.f);
     std::vector<glm::vec3> ray_responses;
 
-    auto first_to_second_ray_execute = [&](const Ray& ray)
+    auto first_to_second_passes = [&](const std::vector<Ray>& rays)
     {
-        HermannPassResult pass_result = HermannPass(first_OBBtree_ptr,
-                                                    second_OBBtree_ptr,
-                                                    glm::mat4(1.f),
-                                                    second_to_first_space_matrix,
-                                                    second_to_first_space_normal_matrix,
-                                                    ray);
-
-        if(pass_result.successful_ray)
-        {
-            average_force_responses -= CalcForceResponse(pass_result);
-            ray_responses.emplace_back(-pass_result.response);
-
-            return std::make_pair(true, ReflectHermannResult(pass_result, ray));
-        }
-        else
-        {
-            return std::make_pair(false, Ray());
-        }
+        return HermannPasses(first_OBBtree_ptr,
+                             second_OBBtree_ptr,
+                             glm::mat4(1.f),
+                             second_to_first_space_matrix,
+                             second_to_first_space_normal_matrix,
+                             rays);
     };
 
-    auto second_to_first_ray_execute = [&](const Ray& ray)
+    auto second_to_first_passes = [&](const std::vector<Ray>& rays)
     {
-        HermannPassResult pass_result = HermannPass(second_OBBtree_ptr,
-                                                    first_OBBtree_ptr,
-                                                    second_to_first_space_matrix,
-                                                    glm::mat4(1.f),
-                                                    glm::mat3(1.f),
-                                                    ray);
-
-        if (pass_result.successful_ray)
-        {
-            average_force_responses += CalcForceResponse(pass_result);
-            ray_responses.emplace_back(pass_result.response);
-
-            return std::make_pair(true, ReflectHermannResult(pass_result, ray));
-        }
-        else
-        {
-            return std::make_pair(false, Ray());
-        }
+        return HermannPasses(second_OBBtree_ptr,
+                             first_OBBtree_ptr,
+                             second_to_first_space_matrix,
+                             glm::mat4(1.f),
+                             glm::mat3(1.f),
+                             rays);
     };
 
-    for(const Ray& this_ray : entriesUncollideRaysPair.rays_from_first_to_second)
+    // "sign" is -1 for passes from first to second
+    auto add_response = [&](const HermannPassResult& pass_result, float sign)
     {
-        std::pair<bool, Ray> ray_1_result = first_to_second_ray_execute(this_ray);
-        if(ray_1_result.first)
-        {
-            second_to_first_ray_execute(ray_1_result.second);
-        }
-    }
+        average_force_responses += sign * CalcForceResponse(pass_result);
+        ray_responses.emplace_back(sign * pass_result.response);
+    };
 
-    for (const Ray& this_ray : entriesUncollideRaysPair.rays_from_second_to_first)
+    // The rays and then the reflected rays of their successful passes are traced as batches. Responses are still added
+    // ray by ray, each followed by its reflection's, so the sums round the same as when every ray was traced on its own
+    auto rays_execute = [&](const std::vector<Ray>& rays, auto passes, auto reflected_passes, float sign)
     {
-        std::pair<bool, Ray> ray_1_result = second_to_first_ray_execute(this_ray);
-        if (ray_1_result.first)
+        std::vector<HermannPassResult> pass_results = passes(rays);
+
+        std::vector<Ray> reflected_rays;
+        for (size_t i = 0; i < rays.size(); ++i)
+            if (pass_results[i].successful_ray)
+                reflected_rays.emplace_back(ReflectHermannResult(pass_results[i], rays[i]));
+
+        std::vector<HermannPassResult> reflected_pass_results = reflected_passes(reflected_rays);
+
+        size_t j = 0;
+        for (size_t i = 0; i < rays.size(); ++i)
         {
-            first_to_second_ray_execute(ray_1_result.second);
+            if (pass_results[i].successful_ray)
+            {
+                add_response(pass_results[i], sign);
+
+                if (reflected_pass_results[j].successful_ray)
+                    add_response(reflected_pass_results[j], -sign);
+                ++j;
+            }
         }
-    }
+    };
+
+    rays_execute(entriesUncollideRaysPair.rays_from_first_to_second, first_to_second_passes, second_to_first_passes, -1.f);
+    rays_execute(entriesUncollideRaysPair.rays_from_second_to_first, second_to_first_passes, first_to_second_passes, +1.f);
 
     if (average_force_responses != glm::vec3(0.f))
     {
@@ -118,37 +115,53 @@ glm::vec3 ShootUncollideRays::CalcForceResponse(const HermannPassResult& hermann
     return response_direction * (cos_angle_with_normal_squared * response_length);
 }
 
-ShootUncollideRays::HermannPassResult ShootUncollideRays::HermannPass(const OBBtree* objA_OBBtree_ptr,
-                                                                      const OBBtree* objB_OBBtree_ptr,
-                                                                      const glm::mat4& objA_mat,
-                                                                      const glm::mat4& objB_mat,
-                                                                      const glm::mat3& objB_normalCorrected_mat,
-                                                                      Ray ray)
+std::vector<ShootUncollideRays::HermannPassResult> ShootUncollideRays::HermannPasses(const OBBtree* objA_OBBtree_ptr,
+                                                                                    const OBBtree* objB_OBBtree_ptr,
+                                                                                    const glm::mat4& objA_mat,
+                                                                                    const glm::mat4& objB_mat,
+                                                                                    const glm::mat3& objB_normalCorrected_mat,
+                                                                                    const std::vector<Ray>& rays)
 {
-    ShootUncollideRays::HermannPassResult return_result;
+    std::vector<ShootUncollideRays::HermannPassResult> return_results(rays.size());
 
-    RayOBBtreeIntersectInfo point2_ray_result = ray.IntersectOBBtree(*objB_OBBtree_ptr, objB_mat);
-    if (point2_ray_result.doIntersect && point2_ray_result.itBackfaces)
+    std::vector<RayOBBtreeIntersectInfo> point2_rays_results = RayPacket::IntersectRaysOBBtree(rays, *objB_OBBtree_ptr, objB_mat);
+
+    std::vector<Ray> moved_rays;
+    std::vector<size_t> moved_rays_indices;
+    for (size_t i = 0; i < rays.size(); ++i)
     {
+        if (point2_rays_results[i].doIntersect && point2_rays_results[i].itBackfaces)
+        {
+            Ray moved_ray = rays[i];
+            moved_ray.MoveOriginEpsilonTowardsDirection(4.f);
+
+            moved_rays.emplace_back(moved_ray);
+            moved_rays_indices.emplace_back(i);
+        }
+    }
 
-        glm::vec3 original_ray_origin = ray.GetOrigin();
+    std::vector<RayOBBtreeIntersectInfo> point3_rays_results = RayPacket::IntersectRaysOBBtree(moved_rays, *objA_OBBtree_ptr, objA_mat);
 
-        ray.MoveOriginEpsilonTowardsDirection(4.f);
-        float epsilon_distance = glm::length(ray.GetOrigin() - original_ray_origin);
+    for (size_t j = 0; j < moved_rays.size(); ++j)
+    {
+        size_t i = moved_rays_indices[j];
+        const RayOBBtreeIntersectInfo& point2_ray_result = point2_rays_results[i];
+        const RayOBBtreeIntersectInfo& point3_ray_result = point3_rays_results[j];
 
-        RayOBBtreeIntersectInfo point3_ray_result = ray.IntersectOBBtree(*objA_OBBtree_ptr, objA_mat);
+        float epsilon_distance = glm::length(moved_rays[j].GetOrigin() - rays[i].GetOrigin());
 
         if (point2_ray_result.distanceFromOrigin <= point3_ray_result.distanceFromOrigin + epsilon_distance)
         {
-            return_result.successful_ray = true;
-            return_result.response = point2_ray_result.distanceFromOrigin * ray.GetDirection();
+            HermannPassResult& this_result = return_results[i];
+            this_result.successful_ray = true;
+            this_result.response = point2_ray_result.distanceFromOrigin * moved_rays[j].GetDirection();
 
             TriangleNormal triangle_normal = objB_OBBtree_ptr->GetTriangleNormal(point2_ray_result.triangle_index);
-            return_result.point_objB_normal = triangle_normal.GetNormal(point2_ray_result.baryPosition, objB_normalCorrected_mat);
+            this_result.point_objB_normal = triangle_normal.GetNormal(point2_ray_result.baryPosition, objB_normalCorrected_mat);
         }
     }
 
-    return return_result;
+    return return_results;
 }
 
 glm::vec3 ShootUncollideRays::FindResponse(const std::vector<glm::vec3>& ray_responses, const glm::vec3& normalized_force_response) const
@@ -1,88 +1,233 @@
 #include "CollisionDetection/SweepAndPrune.h"
 
 #include <vector>
-#include <list>
 #include <algorithm>
 #include <utility>
+#include <cassert>
 
 SweepAndPrune::SweepAndPrune(glm::vec3 in_U_axis, glm::vec3 in_V_axis, glm::vec3 in_W_axis)
-    :U_axis(in_U_axis),
-     V_axis(in_V_axis),
-     W_axis(in_W_axis)
+    :axes({in_U_axis, in_V_axis, in_W_axis})
 {
 }
 
-std::vector<std::pair<CollisionDetectionEntry, CollisionDetectionEntry>> SweepAndPrune::ExecuteSweepAndPrune(const std::vector<CollisionDetectionEntry>& collisionDetectionEntries)
+std::vector<std::pair<CollisionDetectionEntry, CollisionDetectionEntry>> SweepAndPrune::ExecuteBroadPhaseCollision(const std::vector<CollisionDetectionEntry>& collisionDetectionEntries)
 {
-    std::vector<SweepAndPruneEntry> U_axis_entries;
-    std::vector<SweepAndPruneEntry> V_axis_entries;
-    std::vector<SweepAndPruneEntry> W_axis_entries;
+    ++frameIndex;
+
+    if (UpdateProxies(collisionDetectionEntries))
+    {
+        RebuildEndpointsAndPairs();
+    }
+    else
+    {
+        for (size_t axis_index = 0; axis_index != 3; ++axis_index)
+            SortAxisEndpoints(axis_index);
+    }
+
+    // Sorted, so results do not depend on hashing
+    std::vector<uint64_t> sorted_pairs(overlappingPairs.begin(), overlappingPairs.end());
+    std::sort(sorted_pairs.begin(), sorted_pairs.end());
+
+    std::vector<std::pair<CollisionDetectionEntry, CollisionDetectionEntry>> return_vector;
+    return_vector.reserve(sorted_pairs.size());
+    for (uint64_t this_pair : sorted_pairs)
+    {
+        const SweepAndPruneProxy& first_proxy = proxiesOfEntities[Entity(this_pair >> 32)];
+        const SweepAndPruneProxy& second_proxy = proxiesOfEntities[Entity(this_pair & 0xFFFFFFFF)];
+
+        return_vector.emplace_back(collisionDetectionEntries[first_proxy.entryIndex], collisionDetectionEntries[second_proxy.entryIndex]);
+    }
+
+    return return_vector;
+}
+
+bool SweepAndPrune::UpdateProxies(const std::vector<CollisionDetectionEntry>& collisionDetectionEntries)
+{
+    std::vector<Entity> added_entities;
+    std::vector<Entity> removed_entities;
 
     for (size_t index = 0; index < collisionDetectionEntries.size(); index++)
     {
-        Paralgram this_paralgram = collisionDetectionEntries[index].currentGlobalMatrix * collisionDetectionEntries[index].OBBtree_ptr->GetRootOBB();
+        const CollisionDetectionEntry& this_collisionDetectionEntry = collisionDetectionEntries[index];
+
+        if (this_collisionDetectionEntry.entity >= proxiesOfEntities.size())
+            proxiesOfEntities.resize(size_t(this_collisionDetectionEntry.entity) + 1);
 
-        SweepAndPruneEntry this_entry;
-        this_entry.index = index;
-        this_entry.shouldCallback = collisionDetectionEntries[index].shouldCallback;
+        SweepAndPruneProxy& this_proxy = proxiesOfEntities[this_collisionDetectionEntry.entity];
+        assert(this_proxy.lastFrame != frameIndex);
+
+        if (not this_proxy.isActive)
         {
-            this_entry.minMaxProjection = this_paralgram.GetMinMaxProjectionToAxis(U_axis);
-            U_axis_entries.emplace_back(this_entry);
+            added_entities.emplace_back(this_collisionDetectionEntry.entity);
         }
+        else if (this_proxy.shouldCallback != this_collisionDetectionEntry.shouldCallback)
         {
-            this_entry.minMaxProjection = this_paralgram.GetMinMaxProjectionToAxis(V_axis);
-            V_axis_entries.emplace_back(this_entry);
+            // Pairs it makes change, so re-add it
+            removed_entities.emplace_back(this_collisionDetectionEntry.entity);
+            added_entities.emplace_back(this_collisionDetectionEntry.entity);
         }
+
+        if (not this_proxy.isActive || not this_collisionDetectionEntry.isStatic)
         {
-            this_entry.minMaxProjection = this_paralgram.GetMinMaxProjectionToAxis(W_axis);
-            W_axis_entries.emplace_back(this_entry);
-        }     
+            Paralgram this_paralgram = this_collisionDetectionEntry.currentGlobalMatrix * this_collisionDetectionEntry.OBBtree_ptr->GetRootOBB();
+
+            for (size_t axis_index = 0; axis_index != 3; ++axis_index)
+                this_proxy.minMaxProjections[axis_index] = this_paralgram.GetMinMaxProjectionToAxis(axes[axis_index]);
+        }
+
+        this_proxy.entryIndex = index;
+        this_proxy.lastFrame = frameIndex;
+        this_proxy.shouldCallback = this_collisionDetectionEntry.shouldCallback;
     }
 
-    std::sort(U_axis_entries.begin(), U_axis_entries.end(), 
-              [](const SweepAndPruneEntry& a, const SweepAndPruneEntry& b) {return a.minMaxProjection.first < b.minMaxProjection.first; });
-    std::sort(V_axis_entries.begin(), V_axis_entries.end(),
-              [](const SweepAndPruneEntry& a, const SweepAndPruneEntry& b) {return a.minMaxProjection.first < b.minMaxProjection.first; });
-    std::sort(W_axis_entries.begin(), W_axis_entries.end(),
-              [](const SweepAndPruneEntry& a, const SweepAndPruneEntry& b) {return a.minMaxProjection.first < b.minMaxProjection.first; });
+    for (Entity this_entity : activeEntities)
+    {
+        if (proxiesOfEntities[this_entity].lastFrame != frameIndex)
+            removed_entities.emplace_back(this_entity);
+    }
+
+    if (removed_entities.size())
+        RemoveEndpointsAndPairsOf(removed_entities);
 
+    // New endpoints start at the end, as if they were at infinity, so insertion sort brings their overlaps as well
+    for (Entity this_entity : added_entities)
+    {
+        SweepAndPruneProxy& this_proxy = proxiesOfEntities[this_entity];
+        this_proxy.isActive = true;
 
-    std::unordered_map<std::pair<size_t ,size_t>, uint32_t, hash_pair, commutative_equal_pair> common_collision_umap;
-    std::vector<SweepAndPruneEntry> active_list;
-    auto sweepAndPrune = [&](const std::vector<SweepAndPruneEntry>& axis_entries, const bool first_axis) {
-        active_list.clear();
-        for (const SweepAndPruneEntry& this_sweepAndPruneEntry : axis_entries)
+        for (size_t axis_index = 0; axis_index != 3; ++axis_index)
         {
-            for (auto& active_elem : active_list )
-            {
-                if (active_elem.minMaxProjection.second < this_sweepAndPruneEntry.minMaxProjection.first)
-                    active_elem.index = -1;
-                else if (active_elem.shouldCallback || this_sweepAndPruneEntry.shouldCallback)
-                {
-                    if (first_axis)
-                        common_collision_umap.emplace(std::make_pair(active_elem.index, this_sweepAndPruneEntry.index), 1);
-                    else
-                    {
-                        auto search = common_collision_umap.find(std::make_pair(active_elem.index, this_sweepAndPruneEntry.index));
-                        if (search != common_collision_umap.end())
-                            search->second++;
-                    }
-                }
-            }
-
-            std::erase_if(active_list, [](const auto& elem) {return elem.index == Entity(-1);});
-            active_list.emplace_back(this_sweepAndPruneEntry);
+            axisEndpoints[axis_index].emplace_back(SweepAndPruneEndpoint{this_proxy.minMaxProjections[axis_index].first, this_entity, true});
+            axisEndpoints[axis_index].emplace_back(SweepAndPruneEndpoint{this_proxy.minMaxProjections[axis_index].second, this_entity, false});
         }
-    };
+    }
 
-    sweepAndPrune(U_axis_entries, true);
-    sweepAndPrune(V_axis_entries, false);
-    sweepAndPrune(W_axis_entries, false);
+    activeEntities.clear();
+    for (const CollisionDetectionEntry& this_collisionDetectionEntry : collisionDetectionEntries)
+        activeEntities.emplace_back(this_collisionDetectionEntry.entity);
 
-    std::vector<std::pair<CollisionDetectionEntry, CollisionDetectionEntry>> return_vector;
-    for (auto& it : common_collision_umap)
-        if (it.second == 3)
-            return_vector.emplace_back(collisionDetectionEntries[it.first.first], collisionDetectionEntries[it.first.second]);
+    return added_entities.size() * rebuildAddedFraction > activeEntities.size();
+}
 
-    return return_vector;
+void SweepAndPrune::RemoveEndpointsAndPairsOf(const std::vector<Entity>& removed_entities)
+{
+    for (Entity this_entity : removed_entities)
+        proxiesOfEntities[this_entity].isActive = false;
+
+    for (auto& this_axis_endpoints : axisEndpoints)
+        std::erase_if(this_axis_endpoints,
+                      [this](const SweepAndPruneEndpoint& this_endpoint) {return not proxiesOfEntities[this_endpoint.entity].isActive;});
+
+    std::erase_if(overlappingPairs,
+                  [this](uint64_t this_pair) {return not proxiesOfEntities[Entity(this_pair >> 32)].isActive ||
+                                                     not proxiesOfEntities[Entity(this_pair & 0xFFFFFFFF)].isActive;});
+}
+
+void SweepAndPrune::UpdateAxisEndpointsValues(size_t axis_index)
+{
+    for (SweepAndPruneEndpoint& this_endpoint : axisEndpoints[axis_index])
+    {
+        const std::pair<float, float>& this_projection = proxiesOfEntities[this_endpoint.entity].minMaxProjections[axis_index];
+        this_endpoint.value = this_endpoint.isMin ? this_projection.first : this_projection.second;
+    }
+}
+
+void SweepAndPrune::SortAxisEndpoints(size_t axis_index)
+{
+    std::vector<SweepAndPruneEndpoint>& endpoints = axisEndpoints[axis_index];
+
+    UpdateAxisEndpointsValues(axis_index);
+
+    // Every swap is a change of order since previous frame: a min passing a max may start an overlap, a max passing a min ends one
+    for (size_t i = 1; i < endpoints.size(); ++i)
+    {
+        SweepAndPruneEndpoint this_endpoint = endpoints[i];
+
+        size_t j = i;
+        for (; j != 0 && IsEndpointAfter(endpoints[j - 1], this_endpoint); --j)
+        {
+            const SweepAndPruneEndpoint& passed_endpoint = endpoints[j - 1];
+            if (this_endpoint.isMin && not passed_endpoint.isMin)
+                OnOverlapBegin(this_endpoint.entity, passed_endpoint.entity);
+            else if (not this_endpoint.isMin && passed_endpoint.isMin)
+                OnOverlapEnd(this_endpoint.entity, passed_endpoint.entity);
+
+            endpoints[j] = passed_endpoint;
+        }
+
+        endpoints[j] = this_endpoint;
+    }
+}
+
+void SweepAndPrune::RebuildEndpointsAndPairs()
+{
+    for (size_t axis_index = 0; axis_index != 3; ++axis_index)
+    {
+        UpdateAxisEndpointsValues(axis_index);
+        std::sort(axisEndpoints[axis_index].begin(), axisEndpoints[axis_index].end(),
+                  [](const SweepAndPruneEndpoint& lhs, const SweepAndPruneEndpoint& rhs) {return IsEndpointAfter(rhs, lhs);});
+    }
+
+    // Sweep of the first axis: an entity's min meets the entities whose interval is open, mins go first at touching values
+    overlappingPairs.clear();
+
+    std::vector<Entity> open_entities;
+    for (const SweepAndPruneEndpoint& this_endpoint : axisEndpoints[0])
+    {
+        if (this_endpoint.isMin)
+        {
+            for (Entity this_open_entity : open_entities)
+                OnOverlapBegin(this_endpoint.entity, this_open_entity);
+
+            open_entities.emplace_back(this_endpoint.entity);
+        }
+        else
+        {
+            auto search = std::find(open_entities.begin(), open_entities.end(), this_endpoint.entity);
+            assert(search != open_entities.end());
+
+            *search = open_entities.back();
+            open_entities.pop_back();
+        }
+    }
+}
+
+void SweepAndPrune::OnOverlapBegin(Entity lhs, Entity rhs)
+{
+    const SweepAndPruneProxy& lhs_proxy = proxiesOfEntities[lhs];
+    const SweepAndPruneProxy& rhs_proxy = proxiesOfEntities[rhs];
+
+    if ((lhs_proxy.shouldCallback || rhs_proxy.shouldCallback) && DoProxiesOverlap(lhs_proxy, rhs_proxy))
+        overlappingPairs.emplace(GetPairKey(lhs, rhs));
+}
+
+void SweepAndPrune::OnOverlapEnd(Entity lhs, Entity rhs)
+{
+    overlappingPairs.erase(GetPairKey(lhs, rhs));
+}
+
+bool SweepAndPrune::DoProxiesOverlap(const SweepAndPruneProxy& lhs, const SweepAndPruneProxy& rhs) const
+{
+    for (size_t axis_index = 0; axis_index != 3; ++axis_index)
+    {
+        if (lhs.minMaxProjections[axis_index].second < rhs.minMaxProjections[axis_index].first ||
+            rhs.minMaxProjections[axis_index].second < lhs.minMaxProjections[axis_index].first)
+            return false;
+    }
+
+    return true;
+}
+
+bool SweepAndPrune::IsEndpointAfter(const SweepAndPruneEndpoint& lhs, const SweepAndPruneEndpoint& rhs)
+{
+    // Touching counts as overlap, so at equal values mins go first
+    return lhs.value > rhs.value || (lhs.value == rhs.value && not lhs.isMin && rhs.isMin);
+}
+
+uint64_t SweepAndPrune::GetPairKey(Entity lhs, Entity rhs)
+{
+    if (lhs > rhs)
+        std::swap(lhs, rhs);
+
+    return (uint64_t(lhs) << 32) | uint64_t(rhs);
 }
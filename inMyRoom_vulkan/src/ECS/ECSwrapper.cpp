@@ -1,5 +1,9 @@
  #include "ECS/ECSwrapper.h"
 
+#include <algorithm>
+
+#include "WorkersPool.h"
+
 ECSwrapper::ECSwrapper(ExportedFunctions* in_enginesExportedFunctions_ptr)
     :exportedFunctions_ptr(in_enginesExportedFunctions_ptr)
 {
@@ -76,17 +80,13 @@ std::vector<std::string> ECSwrapper::GetComponentsNames() const
 
 void ECSwrapper::AddComponent(ComponentBaseClass* this_component_ptr)
 {
-    {
-        auto search = componentIDtoComponentBaseClass_map.find(this_component_ptr->GetComponentID());
-        assert(search == componentIDtoComponentBaseClass_map.end());
-    }
-    {
-        auto search = componentNameToComponentID_umap.find(this_component_ptr->GetComponentName());
-        assert(search == componentNameToComponentID_umap.end());
-    }
+    assert(componentIDtoComponentBaseClass_map.find(this_component_ptr->GetComponentID()) == componentIDtoComponentBaseClass_map.end());
+    assert(componentNameToComponentID_umap.find(this_component_ptr->GetComponentName()) == componentNameToComponentID_umap.end());
 
     componentIDtoComponentBaseClass_map.emplace(this_component_ptr->GetComponentID(), this_component_ptr);
     componentNameToComponentID_umap.emplace(this_component_ptr->GetComponentName(), this_component_ptr->GetComponentID());
+
+    updateStagesDirty = true;
 }
 
 void ECSwrapper::AddComponentAndOwnership(std::unique_ptr<ComponentBaseClass> this_component_uptr)
@@ -311,6 +311,16 @@ void ECSwrapper::RemoveInstance(InstanceInfo* instance_info_ptr)
     }
 }
 
+EntityHandle ECSwrapper::GetEntityHandle(Entity entity) const
+{
+    return entitiesHandler_uptr->GetEntityHandle(entity);
+}
+
+Entity ECSwrapper::ResolveEntityHandle(const EntityHandle& handle) const
+{
+    return entitiesHandler_uptr->ResolveEntityHandle(handle);
+}
+
 void ECSwrapper::Update()
 {
     std::lock_guard<std::mutex> lock(controlMutex);
@@ -324,7 +334,14 @@ void ECSwrapper::Update()
             this_component.second->NewUpdateSession();
     }
 
-    // Update
+    if (workersPool_ptr == nullptr)
+        UpdateSequential();
+    else
+        UpdateScheduled();
+}
+
+void ECSwrapper::UpdateSequential()
+{
     size_t additionsUpdated = 0;
     for (auto it = componentIDtoComponentBaseClass_map.begin(); it != componentIDtoComponentBaseClass_map.end(); ++it)
     {
@@ -348,13 +365,111 @@ void ECSwrapper::Update()
     }
 }
 
-void ECSwrapper::AsyncInput(InputType input_type, void* struct_data)
+void ECSwrapper::UpdateScheduled()
+{
+    if (updateStagesDirty)
+        BuildUpdateStages();
+
+    // Same as sequential, but stages instead of components
+    size_t additionsUpdated = 0;
+    for (size_t stage_index = 0; stage_index != updateStages.size(); ++stage_index)
+    {
+        while (additionsUpdated != additionInfoUptrs.size())
+        {
+            additionsUpdated = additionInfoUptrs.size();
+            for (size_t reupdate_stage_index = 0; reupdate_stage_index != stage_index; ++reupdate_stage_index)
+                UpdateStage(updateStages[reupdate_stage_index]);
+        }
+
+        UpdateStage(updateStages[stage_index]);
+    }
+}
+
+void ECSwrapper::UpdateStage(const std::vector<ComponentBaseClass*>& stage)
+{
+    if (stage.size() == 1)
+    {
+        stage.front()->Update();
+    }
+    else
+    {
+        std::vector<std::function<void()>> tasks;
+        tasks.reserve(stage.size());
+        for (ComponentBaseClass* this_component_ptr : stage)
+            tasks.emplace_back([this_component_ptr]() {this_component_ptr->Update();});
+
+        workersPool_ptr->RunTasks(tasks);
+    }
+
+    MakeToBeRemovedCallbacks();
+}
+
+void ECSwrapper::BuildUpdateStages()
+{
+    // Stages are runs of consecutive (at componentID order) components whose accesses do not conflict.
+    // Components with a custom Update are not schedulable and get a stage of their own, so order is kept
+    updateStages.clear();
+
+    std::vector<UpdateAccess> current_stage_accesses;
+    for (const auto& this_compID_component_pair : componentIDtoComponentBaseClass_map)
+    {
+        ComponentBaseClass* this_component_ptr = this_compID_component_pair.second;
+        if (this_component_ptr == nullptr)
+            continue;
+
+        UpdateAccess this_update_access = this_component_ptr->GetUpdateAccess();
+
+        bool fits_current_stage = this_update_access.isSchedulable && not current_stage_accesses.empty();
+        for (size_t i = 0; fits_current_stage && i != current_stage_accesses.size(); ++i)
+            fits_current_stage = not DoUpdateAccessesConflict(this_update_access, current_stage_accesses[i]);
+
+        if (fits_current_stage)
+        {
+            updateStages.back().emplace_back(this_component_ptr);
+            current_stage_accesses.emplace_back(std::move(this_update_access));
+        }
+        else
+        {
+            updateStages.emplace_back().emplace_back(this_component_ptr);
+
+            current_stage_accesses.clear();
+            if (this_update_access.isSchedulable)
+                current_stage_accesses.emplace_back(std::move(this_update_access));
+        }
+    }
+
+    updateStagesDirty = false;
+}
+
+bool ECSwrapper::DoUpdateAccessesConflict(const UpdateAccess& lhs, const UpdateAccess& rhs)
+{
+    if ((lhs.writesEntitiesHandler && (rhs.readsEntitiesHandler || rhs.writesEntitiesHandler)) ||
+        (rhs.writesEntitiesHandler && lhs.readsEntitiesHandler))
+        return true;
+
+    auto contains = [](const std::vector<componentID>& ids, componentID id)
+    {
+        return std::find(ids.begin(), ids.end(), id) != ids.end();
+    };
+
+    for (componentID this_write_id : lhs.writeComponentIDs)
+        if (contains(rhs.readComponentIDs, this_write_id) || contains(rhs.writeComponentIDs, this_write_id))
+            return true;
+
+    for (componentID this_write_id : rhs.writeComponentIDs)
+        if (contains(lhs.readComponentIDs, this_write_id))
+            return true;
+
+    return false;
+}
+
+void ECSwrapper::AsyncInput(InputType input_type, void* struct_data, std::chrono::steady_clock::time_point event_timePoint)
 {
     std::lock_guard<std::mutex> lock(controlMutex);
 
     for (auto& this_component : componentIDtoComponentBaseClass_map)
         if (this_component.second != nullptr)
-            this_component.second->AsyncInput(input_type, struct_data);
+            this_component.second->AsyncInput(input_type, struct_data, event_timePoint);
 }
 
 void ECSwrapper::CompleteAddsAndRemoves()
@@ -368,6 +483,17 @@ ExportedFunctions* ECSwrapper::GetEnginesExportedFunctions() const
     return exportedFunctions_ptr;
 }
 
+void ECSwrapper::SetWorkersPool(WorkersPool* in_workersPool_ptr)
+{
+    std::lock_guard<std::mutex> lock(controlMutex);
+    workersPool_ptr = in_workersPool_ptr;
+}
+
+WorkersPool* ECSwrapper::GetWorkersPool() const
+{
+    return workersPool_ptr;
+}
+
 void ECSwrapper::MakeToBeRemovedCallbacks()
 {
     std::map<ComponentBaseClass *, std::vector<std::pair<Entity, Entity>>> component_to_ranges_to_callback_toBeRemoved_map;
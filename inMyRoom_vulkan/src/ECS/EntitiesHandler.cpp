@@ -10,10 +10,12 @@ EntitiesHandler::EntitiesHandler()
 
     parentOfEachEntity.emplace_back(0);
     containerIndexOfEachEntity.emplace_back(0);
+    generationOfEachEntity.emplace_back(0);
     instancePtrOfEachEntity.emplace_back(root_instance_ptr);
     nameToInstancePtr_umap.emplace(root_instance_ptr->instanceName, root_instance_ptr);
 
-    availableRanges.emplace(size_t(-1) - 1, std::pair<Entity, Entity>(1, -1));
+    // Entity(-1) is reserved as "no entity"
+    availableRanges.emplace(size_t(Entity(-1)) - 1, std::pair<Entity, Entity>(1, Entity(-1) - 1));
 }
 
 EntitiesHandler::~EntitiesHandler()
@@ -67,7 +69,7 @@ InstanceInfo* EntitiesHandler::AddInstanceEntities(const FabInfo* fab_info_ptr,
     additionsNotCompletedRanges.emplace_back(range);
     for(size_t index = 0; index != instance_info_ptr->fabInfo->size; index++)
     {
-        containerIndexOfEachEntity[index + instance_info_ptr->entityOffset] = Entity(additionsNotCompletedRanges.size());
+        containerIndexOfEachEntity[index + instance_info_ptr->entityOffset] = uint32_t(additionsNotCompletedRanges.size());
     }
 
     nameToInstancePtr_umap.emplace(instance_name, instance_info_ptr);
@@ -113,6 +115,7 @@ void EntitiesHandler::RemoveInstancesEntities(const std::unordered_set<InstanceI
             parentOfEachEntity[index] = -1;
             instancePtrOfEachEntity[index] = nullptr;
             containerIndexOfEachEntity[index] = -1;
+            ++generationOfEachEntity[index];
         }
 
         {
@@ -227,6 +230,13 @@ void EntitiesHandler::ChangeParentOfInstance(InstanceInfo* instance_ptr, Entity
         instance_ptr->parent_instance = new_parent_instance_info_ptr;
         parentOfEachEntity[instance_ptr->entityOffset] = Entity(new_parent);
     }
+
+    ++parentChangesCount;
+}
+
+size_t EntitiesHandler::GetParentChangesCount() const
+{
+    return parentChangesCount;
 }
 
 size_t EntitiesHandler::GetContainerIndexOfEntity(Entity entity) const
@@ -235,6 +245,26 @@ size_t EntitiesHandler::GetContainerIndexOfEntity(Entity entity) const
     return containerIndexOfEachEntity[entity];
 }
 
+EntityHandle EntitiesHandler::GetEntityHandle(Entity entity) const
+{
+    assert(entity < instancePtrOfEachEntity.size());
+    assert(instancePtrOfEachEntity[entity] != nullptr);
+
+    return EntityHandle{entity, generationOfEachEntity[entity]};
+}
+
+bool EntitiesHandler::IsEntityHandleValid(const EntityHandle& handle) const
+{
+    return handle.entity < instancePtrOfEachEntity.size() &&
+           instancePtrOfEachEntity[handle.entity] != nullptr &&
+           generationOfEachEntity[handle.entity] == handle.generation;
+}
+
+Entity EntitiesHandler::ResolveEntityHandle(const EntityHandle& handle) const
+{
+    return IsEntityHandleValid(handle) ? handle.entity : Entity(-1);
+}
+
 std::pair<Entity, Entity> EntitiesHandler::GetRange(size_t size)
 {
     auto search_bigger_than_size = availableRanges.lower_bound(size);
@@ -296,5 +326,6 @@ void EntitiesHandler::ExtentVectors(size_t max_index)
         parentOfEachEntity.resize(max_index + 1, -1);
         instancePtrOfEachEntity.resize(max_index + 1, nullptr);
         containerIndexOfEachEntity.resize(max_index + 1, -1);
+        generationOfEachEntity.resize(max_index + 1, 0);
     }
 }
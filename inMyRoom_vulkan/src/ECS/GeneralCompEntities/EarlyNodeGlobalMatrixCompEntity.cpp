@@ -60,22 +60,45 @@ EarlyNodeGlobalMatrixCompEntity EarlyNodeGlobalMatrixCompEntity::CreateComponent
     return this_earlyNodeGlobalMatrixCompEntity;
 }
 
-void EarlyNodeGlobalMatrixCompEntity::Update(EntitiesHandler* const entities_handler_ptr,
-                                             NodeDataComp* const nodeDataComp_ptr,
+void EarlyNodeGlobalMatrixCompEntity::Update(const EntitiesHandler* const entities_handler_ptr,
+                                             const NodeDataComp* const nodeDataComp_ptr,
                                              EarlyNodeGlobalMatrixComp* const earlyNodeGlobalMatrixComp_ptr)
 {
     Entity parent_entity = entities_handler_ptr->GetParentOfEntity(thisEntity);
-    NodeDataCompEntity& this_node_data = nodeDataComp_ptr->GetComponentEntity(thisEntity);
+    const NodeDataCompEntity& this_node_data = nodeDataComp_ptr->GetComponentEntity(thisEntity);
 
     if (parent_entity != 0)
     {
         EarlyNodeGlobalMatrixCompEntity& parent_nodeGlobalMatrix_componentEntity = earlyNodeGlobalMatrixComp_ptr->GetComponentEntity(parent_entity);
-        globalMatrix = this_node_data.GetGlobalMatrix(parent_nodeGlobalMatrix_componentEntity.globalMatrix);
+        UpdateGlobalMatrix(this_node_data, parent_entity, parent_nodeGlobalMatrix_componentEntity.globalMatrix, parent_nodeGlobalMatrix_componentEntity.matrixVersion);
     }
     else
     {
-        globalMatrix = this_node_data.GetGlobalMatrix(glm::mat4(1.f));
+        UpdateGlobalMatrix(this_node_data, 0, glm::mat4(1.f), 0);
     }
 }
 
+bool EarlyNodeGlobalMatrixCompEntity::UpdateGlobalMatrix(const NodeDataCompEntity& node_data,
+                                                         const Entity parent_entity,
+                                                         const glm::mat4x4& parent_global_matrix,
+                                                         const uint32_t parent_matrix_version)
+{
+    NodeDataCompEntity::LocalTransform this_local_transform = node_data.GetLocalTransform();
+
+    if (matrixVersion != 0 &&
+        parent_entity == calculatedParentEntity &&
+        parent_matrix_version == calculatedParentMatrixVersion &&
+        this_local_transform == calculatedLocalTransform)
+        return false;
+
+    globalMatrix = node_data.GetGlobalMatrix(parent_global_matrix);
+
+    calculatedLocalTransform = this_local_transform;
+    calculatedParentEntity = parent_entity;
+    calculatedParentMatrixVersion = parent_matrix_version;
+    ++matrixVersion;
+
+    return true;
+}
+
 #endif
\ No newline at end of file
@@ -16,7 +16,7 @@ LateNodeGlobalMatrixCompEntity LateNodeGlobalMatrixCompEntity::GetEmpty()
     return this_nodeGlobalMatrixCompEntity;
 }
 
-LateNodeGlobalMatrixCompEntity LateNodeGlobalMatrixCompEntity::CreateComponentEntityByMap(const Entity in_entity, std::string entity_name, const CompEntityInitMap& in_map)
+LateNodeGlobalMatrixCompEntity LateNodeGlobalMatrixCompEntity::CreateComponentEntityByMap(const Entity in_entity, std::string /*entity_name*/, const CompEntityInitMap& in_map)
 {
     LateNodeGlobalMatrixCompEntity this_lateNodeGlobalMatrixCompEntity(in_entity);
 
@@ -60,22 +60,45 @@ LateNodeGlobalMatrixCompEntity LateNodeGlobalMatrixCompEntity::CreateComponentEn
     return this_lateNodeGlobalMatrixCompEntity;
 }
 
-void LateNodeGlobalMatrixCompEntity::Update(EntitiesHandler* const entities_handler_ptr,
-                                            NodeDataComp* const nodeDataComp_ptr,
+void LateNodeGlobalMatrixCompEntity::Update(const EntitiesHandler* const entities_handler_ptr,
+                                            const NodeDataComp* const nodeDataComp_ptr,
                                             LateNodeGlobalMatrixComp* const lateNodeGlobalMatrixComp_ptr)
 {
     Entity parent_entity = entities_handler_ptr->GetParentOfEntity(thisEntity);
-    NodeDataCompEntity& this_node_data = nodeDataComp_ptr->GetComponentEntity(thisEntity);
+    const NodeDataCompEntity& this_node_data = nodeDataComp_ptr->GetComponentEntity(thisEntity);
 
     if (parent_entity != 0)
     {
         LateNodeGlobalMatrixCompEntity& parent_nodeGlobalMatrix_componentEntity = lateNodeGlobalMatrixComp_ptr->GetComponentEntity(parent_entity);
-        globalMatrix = this_node_data.GetGlobalMatrix(parent_nodeGlobalMatrix_componentEntity.globalMatrix);
+        UpdateGlobalMatrix(this_node_data, parent_entity, parent_nodeGlobalMatrix_componentEntity.globalMatrix, parent_nodeGlobalMatrix_componentEntity.matrixVersion);
     }
     else
     {
-        globalMatrix = this_node_data.GetGlobalMatrix(glm::mat4(1.f));
+        UpdateGlobalMatrix(this_node_data, 0, glm::mat4(1.f), 0);
     }
 }
 
+bool LateNodeGlobalMatrixCompEntity::UpdateGlobalMatrix(const NodeDataCompEntity& node_data,
+                                                        const Entity parent_entity,
+                                                        const glm::mat4x4& parent_global_matrix,
+                                                        const uint32_t parent_matrix_version)
+{
+    NodeDataCompEntity::LocalTransform this_local_transform = node_data.GetLocalTransform();
+
+    if (matrixVersion != 0 &&
+        parent_entity == calculatedParentEntity &&
+        parent_matrix_version == calculatedParentMatrixVersion &&
+        this_local_transform == calculatedLocalTransform)
+        return false;
+
+    globalMatrix = node_data.GetGlobalMatrix(parent_global_matrix);
+
+    calculatedLocalTransform = this_local_transform;
+    calculatedParentEntity = parent_entity;
+    calculatedParentMatrixVersion = parent_matrix_version;
+    ++matrixVersion;
+
+    return true;
+}
+
 #endif
\ No newline at end of file
@@ -49,6 +49,15 @@ ModelCollisionCompEntity ModelCollisionCompEntity::CreateComponentEntityByMap(co
             this_modelCollisionCompEntity.shouldCallback = static_cast<bool>(this_int);
         }
     }
+    // "ContinuousCollision", continuousCollision = int  (optional)
+    {
+        auto search = in_map.intMap.find("ContinuousCollision");
+        if (search != in_map.intMap.end())
+        {
+            int this_int = search->second;
+            this_modelCollisionCompEntity.continuousCollision = static_cast<bool>(this_int);
+        }
+    }
 
     return this_modelCollisionCompEntity;
 }
@@ -56,7 +65,7 @@ ModelCollisionCompEntity ModelCollisionCompEntity::CreateComponentEntityByMap(co
 void ModelCollisionCompEntity::AddCollisionDetectionEntryToVector(EarlyNodeGlobalMatrixComp* thisFrameNodeGlobalMatrix_ptr,
                                                                   LateNodeGlobalMatrixComp* previousFrameNodeGlobalMatrix_ptr,
                                                                   MeshesOfNodes* meshesOfNodes_ptr,
-                                                                  CollisionDetection* collisionDetection_ptr) const
+                                                                  CollisionDetection* collisionDetection_ptr)
 {
     if (!disableCollision)
     {
@@ -70,10 +79,16 @@ void ModelCollisionCompEntity::AddCollisionDetectionEntryToVector(EarlyNodeGloba
         this_collisionDetectionEntry.currentGlobalMatrix = this_frame_global_matrix;
         this_collisionDetectionEntry.previousGlobalMatrix = previous_frame_global_matrix;
         this_collisionDetectionEntry.shouldCallback = shouldCallback;
+        this_collisionDetectionEntry.isContinuous = continuousCollision;
+        this_collisionDetectionEntry.isStatic = this_thisFrameNodeGlobalMatrix_ptr.matrixVersion == lastThisFrameMatrixVersion &&
+                                                this_previousFrameNodeGlobalMatrix_ptr.matrixVersion == lastPreviousFrameMatrixVersion;
         this_collisionDetectionEntry.OBBtree_ptr = &(meshesOfNodes_ptr->GetMeshInfo(meshIndex).boundBoxTree);
         this_collisionDetectionEntry.entity = thisEntity;
 
         collisionDetection_ptr->AddCollisionDetectionEntry(this_collisionDetectionEntry);
+
+        lastThisFrameMatrixVersion = this_thisFrameNodeGlobalMatrix_ptr.matrixVersion;
+        lastPreviousFrameMatrixVersion = this_previousFrameNodeGlobalMatrix_ptr.matrixVersion;
     }
 }
 
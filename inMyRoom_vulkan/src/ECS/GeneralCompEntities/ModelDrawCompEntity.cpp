@@ -84,8 +84,10 @@ void ModelDrawCompEntity::AddDrawInfo(const LateNodeGlobalMatrixComp* nodeGlobal
                                       const DynamicMeshComp* dynamicMeshComp_ptr,
                                       const LightComp* lightComp_ptr,
                                       const glm::mat4& viewport_matrix,
+                                      const bool is_viewport_unchanged,
                                       std::vector<ModelMatrices>& model_matrices,
-                                      std::vector<DrawInfo>& draw_infos)
+                                      std::vector<DrawInfo>& draw_infos,
+                                      std::vector<float>& morph_weights)
 {
     if (shouldDraw)
     {
@@ -113,9 +115,15 @@ void ModelDrawCompEntity::AddDrawInfo(const LateNodeGlobalMatrixComp* nodeGlobal
         } else if (not isSkin && not hasMorphTargets) {
             this_draw_info.matricesOffset = model_matrices.size();
             this_draw_info.prevMatricesOffset = lastMatricesOffset;
-            glm::mat4 pos_matrix = viewport_matrix * nodeGlobalMatrix_ptr->GetComponentEntity(thisEntity).globalMatrix;
-            glm::mat4 normal_matrix = glm::adjointTranspose(pos_matrix);
-            model_matrices.emplace_back(ModelMatrices({pos_matrix, normal_matrix}));
+
+            const LateNodeGlobalMatrixCompEntity& node_global_matrix_entity = nodeGlobalMatrix_ptr->GetComponentEntity(thisEntity);
+            if (not is_viewport_unchanged || node_global_matrix_entity.matrixVersion != cachedMatrixVersion) {
+                glm::mat4 pos_matrix = viewport_matrix * node_global_matrix_entity.globalMatrix;
+                glm::mat4 normal_matrix = glm::adjointTranspose(pos_matrix);
+                cachedMatrices = ModelMatrices({pos_matrix, normal_matrix});
+                cachedMatrixVersion = node_global_matrix_entity.matrixVersion;
+            }
+            model_matrices.emplace_back(cachedMatrices);
         } else {
             this_draw_info.matricesOffset = model_matrices.size();
             this_draw_info.prevMatricesOffset = lastMatricesOffset;
@@ -138,7 +146,9 @@ void ModelDrawCompEntity::AddDrawInfo(const LateNodeGlobalMatrixComp* nodeGlobal
                 }
             }
             if (hasMorphTargets) {
-                this_draw_info.weights = dynamic_mesh_entity.morphTargetsWeights;
+                this_draw_info.weightsOffset = morph_weights.size();
+                this_draw_info.weightsCount = dynamic_mesh_entity.morphTargetsWeights.size();
+                morph_weights.insert(morph_weights.end(), dynamic_mesh_entity.morphTargetsWeights.begin(), dynamic_mesh_entity.morphTargetsWeights.end());
                 this_draw_info.hasMorphTargets = true;
             }
         }
@@ -1,6 +1,7 @@
 #include "ECS/GeneralCompEntities/NodeDataCompEntity.h"
 
 #include "ECS/ECSwrapper.h"
+#include "Geometry/FloatLanes.h"
 
 #ifndef GAME_DLL
 
@@ -16,7 +17,7 @@ NodeDataCompEntity NodeDataCompEntity::GetEmpty()
     return this_positionCompEntity;
 }
 
-NodeDataCompEntity NodeDataCompEntity::CreateComponentEntityByMap(const Entity in_entity, std::string entity_name, const CompEntityInitMap& in_map)
+NodeDataCompEntity NodeDataCompEntity::CreateComponentEntityByMap(const Entity in_entity, std::string /*entity_name*/, const CompEntityInitMap& in_map)
 {
     NodeDataCompEntity this_positionCompEntity(in_entity);
 
@@ -62,15 +63,24 @@ NodeDataCompEntity NodeDataCompEntity::CreateComponentEntityByMap(const Entity i
 
 glm::mat4x4 NodeDataCompEntity::GetGlobalMatrix(const glm::mat4x4 parent_global_matrix) const
 {
-    glm::mat4 S_matrix = glm::scale(glm::mat4(1.0f), localScale);
-    glm::mat4 R_matrix = glm::toMat4(localRotation);
-    glm::mat4 T_matrix = glm::translate(glm::mat4(1.0f), localTranslation);
+    // T * R * S in place, as products by a scale or a translation only touch R's columns or the last one
+    glm::mat4 TRS_matrix = glm::toMat4(localRotation);
+    TRS_matrix[0] *= localScale.x;
+    TRS_matrix[1] *= localScale.y;
+    TRS_matrix[2] *= localScale.z;
+    TRS_matrix[3] = glm::vec4(localTranslation, 1.f);
+
     glm::mat4 gT_matrix = glm::translate(glm::mat4(1.0f), globalTranslation);
-    glm::mat4 gTTRS_matrix_in_global_space = gT_matrix * parent_global_matrix * T_matrix * R_matrix * S_matrix;
+    glm::mat4 gTTRS_matrix_in_global_space = MultiplyMat4(gT_matrix, MultiplyMat4(parent_global_matrix, TRS_matrix));
 
     return gTTRS_matrix_in_global_space;
 }
 
+NodeDataCompEntity::LocalTransform NodeDataCompEntity::GetLocalTransform() const
+{
+    return LocalTransform({localScale, localRotation, localTranslation, globalTranslation});
+}
+
 void NodeDataCompEntity::Update()
 {
     localScale_old = localScale;
@@ -81,6 +91,14 @@ void NodeDataCompEntity::Update()
 
 #endif
 
+bool NodeDataCompEntity::LocalTransform::operator==(const LocalTransform& rhs) const
+{
+    return scale == rhs.scale &&
+           rotation == rhs.rotation &&
+           translation == rhs.translation &&
+           globalTranslation == rhs.globalTranslation;
+}
+
 void NodeDataCompEntity::LocalScale(const glm::vec3 in_scale)
 {
     localScale *= in_scale;
@@ -26,4 +26,10 @@ void AnimationActorComp::Update() //ComponentSparseBaseClass
         for(auto& this_comp_entity: this_container)
             this_comp_entity.Update(positionComp_ptr, animationsDataOfNodes_ptr, delta_time);
     }
-}
\ No newline at end of file
+}
+
+// Writes NodeData. AnimationsDataOfNodes is only read, and the delta time stays the same during updates
+UpdateAccess AnimationActorComp::GetUpdateAccess() const
+{
+    return GetUpdateAccessOfArguments(component_ID, &AnimationActorCompEntity::Update);
+}
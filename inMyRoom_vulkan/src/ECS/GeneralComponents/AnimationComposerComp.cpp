@@ -10,3 +10,9 @@ AnimationComposerComp::AnimationComposerComp(ECSwrapper* const in_ecs_wrapper_pt
 AnimationComposerComp::~AnimationComposerComp()
 {
 }
+
+// Writes NodeData and AnimationActor entities of the animations it starts
+UpdateAccess AnimationComposerComp::GetUpdateAccess() const
+{
+    return GetUpdateAccessOfCompEntities();
+}
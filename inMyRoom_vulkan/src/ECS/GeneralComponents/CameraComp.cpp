@@ -27,6 +27,12 @@ void CameraComp::Update()
     }
 }
 
+// Own entities only
+UpdateAccess CameraComp::GetUpdateAccess() const
+{
+    return GetUpdateAccessOfArguments(component_ID, &CameraCompEntity::Update);
+}
+
 void CameraComp::BindCameraEntity(Entity this_camera_entity)
 {
     camera_entity = this_camera_entity;
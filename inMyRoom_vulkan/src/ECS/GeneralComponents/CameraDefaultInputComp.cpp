@@ -2,6 +2,8 @@
 
 #include "ECS/ECSwrapper.h"
 
+#include <algorithm>
+
 CameraDefaultInputComp::CameraDefaultInputComp(ECSwrapper* const in_ecs_wrapper_ptr, float default_speed)
     :ComponentDataClass<CameraDefaultInputCompEntity, static_cast<componentID>(componentIDenum::CameraDefaultInput), "CameraDefaultInput", sparse_set>(in_ecs_wrapper_ptr),
      default_speed(default_speed)
@@ -33,10 +35,17 @@ void CameraDefaultInputComp::Update()
     lastSnapTimePoint = next_snap_timePoint;
 }
 
-void CameraDefaultInputComp::AsyncInput(InputType input_type, void* struct_data)
+// Writes Camera. Inputs arrive under ECSwrapper's lock, so never during updates
+UpdateAccess CameraDefaultInputComp::GetUpdateAccess() const
 {
+    return GetUpdateAccessOfArguments(component_ID, &CameraDefaultInputCompEntity::Update);
+}
+
+void CameraDefaultInputComp::AsyncInput(InputType input_type, void* struct_data, std::chrono::steady_clock::time_point event_timePoint)
+{
+    // Integrate up to when the input happened. Inputs before the last snap can only count from it
     auto previous_snap_timePoint = lastSnapTimePoint;
-    auto next_snap_timePoint = std::chrono::steady_clock::now();
+    auto next_snap_timePoint = std::max(event_timePoint, previous_snap_timePoint);
 
     std::chrono::duration<float> duration = next_snap_timePoint - previous_snap_timePoint;
 
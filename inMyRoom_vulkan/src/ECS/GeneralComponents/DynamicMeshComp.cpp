@@ -27,6 +27,15 @@ void DynamicMeshComp::Update()
     }
 }
 
+// DynamicMeshes is not a component and only this one adds to it, an entity at a time
+UpdateAccess DynamicMeshComp::GetUpdateAccess() const
+{
+    UpdateAccess update_access = GetUpdateAccessOfArguments(component_ID, &DynamicMeshCompEntity::Update);
+    update_access.isEntitiesParallel = false;
+
+    return update_access;
+}
+
 void DynamicMeshComp::ToBeRemovedCallback(const std::vector<std::pair<Entity, Entity>> &callback_ranges)
 {
     size_t containers_count_when_start = GetContainersCount();
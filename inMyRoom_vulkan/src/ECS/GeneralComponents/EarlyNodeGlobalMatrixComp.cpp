@@ -3,7 +3,8 @@
 #include "ECS/ECSwrapper.h"
 
 EarlyNodeGlobalMatrixComp::EarlyNodeGlobalMatrixComp(ECSwrapper* const in_ecs_wrapper_ptr)
-    :ComponentDataClass<EarlyNodeGlobalMatrixCompEntity, static_cast<componentID>(componentIDenum::EarlyNodeGlobalMatrix), "EarlyNodeGlobalMatrix", dense_set>(in_ecs_wrapper_ptr)
+    :ComponentDataClass<EarlyNodeGlobalMatrixCompEntity, static_cast<componentID>(componentIDenum::EarlyNodeGlobalMatrix), "EarlyNodeGlobalMatrix", dense_set>(in_ecs_wrapper_ptr),
+     hierarchyLevels(entitiesHandler_ptr)
 {
 }
 
@@ -11,3 +12,111 @@ EarlyNodeGlobalMatrixComp::~EarlyNodeGlobalMatrixComp()
 {
 }
 
+void EarlyNodeGlobalMatrixComp::Update()
+{
+    const NodeDataComp* const nodeDataComp_ptr = static_cast<const NodeDataComp*>(ecsWrapper_ptr->GetComponentByID(static_cast<componentID>(componentIDenum::NodeData)));
+
+    if (containersUpdated == 0)
+    {
+        UpdateByLevels(nodeDataComp_ptr);
+        updatedEntitiesCount += componentEntities.size();
+        containersUpdated = 1;
+    }
+
+    // Added instances are still at their fab containers, where parents come before children
+    size_t containers_count_when_start = GetContainersCount();
+    for (; containersUpdated != containers_count_when_start; ++containersUpdated)
+    {
+        auto& this_container = GetContainerByIndex(containersUpdated);
+        for (auto& this_comp_entity : this_container)
+            UpdateCompEntity(this_comp_entity, entitiesHandler_ptr->GetParentOfEntity(this_comp_entity.thisEntity), nodeDataComp_ptr);
+
+        updatedEntitiesCount += this_container.size();
+    }
+}
+
+UpdateAccess EarlyNodeGlobalMatrixComp::GetUpdateAccess() const
+{
+    return GetUpdateAccessOfCompEntities();
+}
+
+void EarlyNodeGlobalMatrixComp::RemoveInstancesByRanges(const std::vector<std::pair<Entity, Entity>>& ranges)
+{
+    ComponentDataClass<EarlyNodeGlobalMatrixCompEntity, static_cast<componentID>(componentIDenum::EarlyNodeGlobalMatrix), "EarlyNodeGlobalMatrix", dense_set>::RemoveInstancesByRanges(ranges);
+    hierarchyLevels.RemoveEntitiesByRanges(ranges);
+}
+
+void EarlyNodeGlobalMatrixComp::AddInitializedFabs()
+{
+    std::vector<Entity> added_entities;
+    for (const auto& this_inited_fab : initialized_fabs)
+    {
+        if (this_inited_fab.size() == 0 || entitiesHandler_ptr->GetInstanceInfo(this_inited_fab.begin()->thisEntity) == nullptr)
+            continue;
+
+        for (const auto& this_comp_entity : this_inited_fab)
+            added_entities.emplace_back(this_comp_entity.thisEntity);
+    }
+
+    ComponentDataClass<EarlyNodeGlobalMatrixCompEntity, static_cast<componentID>(componentIDenum::EarlyNodeGlobalMatrix), "EarlyNodeGlobalMatrix", dense_set>::AddInitializedFabs();
+    hierarchyLevels.AddEntities(added_entities);
+}
+
+void EarlyNodeGlobalMatrixComp::NewUpdateSession()
+{
+    ComponentDataClass<EarlyNodeGlobalMatrixCompEntity, static_cast<componentID>(componentIDenum::EarlyNodeGlobalMatrix), "EarlyNodeGlobalMatrix", dense_set>::NewUpdateSession();
+
+    dirtyEntitiesCount.store(0, std::memory_order_relaxed);
+    updatedEntitiesCount = 0;
+}
+
+size_t EarlyNodeGlobalMatrixComp::GetDirtyEntitiesCount() const
+{
+    return dirtyEntitiesCount.load(std::memory_order_relaxed);
+}
+
+size_t EarlyNodeGlobalMatrixComp::GetCleanEntitiesCount() const
+{
+    return updatedEntitiesCount - GetDirtyEntitiesCount();
+}
+
+void EarlyNodeGlobalMatrixComp::UpdateByLevels(const NodeDataComp* const nodeDataComp_ptr)
+{
+    if (hierarchyLevels.IsOutdated())
+    {
+        std::vector<Entity> all_entities;
+        all_entities.reserve(componentEntities.size());
+        for (const auto& this_comp_entity : componentEntities)
+            all_entities.emplace_back(this_comp_entity.thisEntity);
+
+        hierarchyLevels.Clear();
+        hierarchyLevels.AddEntities(all_entities);
+    }
+
+    // Parents are at previous levels, so entities of the same level are independent.
+    // mat4 products are MultiplyMat4's, of NodeDataCompEntity::GetGlobalMatrix
+    hierarchyLevels.ForEachByLevels(ecsWrapper_ptr->GetWorkersPool(),
+                                    [this, nodeDataComp_ptr](const HierarchyLevels::LevelEntry& this_entry)
+                                    {
+                                        UpdateCompEntity(componentEntities[this_entry.entity], this_entry.parent, nodeDataComp_ptr);
+                                    });
+}
+
+void EarlyNodeGlobalMatrixComp::UpdateCompEntity(EarlyNodeGlobalMatrixCompEntity& this_comp_entity, const Entity parent_entity, const NodeDataComp* const nodeDataComp_ptr)
+{
+    const NodeDataCompEntity& this_node_data = nodeDataComp_ptr->GetComponentEntity(this_comp_entity.thisEntity);
+
+    bool is_dirty;
+    if (parent_entity != 0)
+    {
+        const EarlyNodeGlobalMatrixCompEntity& parent_comp_entity = GetComponentEntity(parent_entity);
+        is_dirty = this_comp_entity.UpdateGlobalMatrix(this_node_data, parent_entity, parent_comp_entity.globalMatrix, parent_comp_entity.matrixVersion);
+    }
+    else
+    {
+        is_dirty = this_comp_entity.UpdateGlobalMatrix(this_node_data, 0, glm::mat4(1.f), 0);
+    }
+
+    if (is_dirty)
+        dirtyEntitiesCount.fetch_add(1, std::memory_order_relaxed);
+}
@@ -19,6 +19,15 @@ void LightComp::Update()
     }
 }
 
+// Lights is not a component and only this one adds to it, an entity at a time
+UpdateAccess LightComp::GetUpdateAccess() const
+{
+    UpdateAccess update_access = GetUpdateAccessOfArguments(component_ID, &LightCompEntity::Update);
+    update_access.isEntitiesParallel = false;
+
+    return update_access;
+}
+
 void LightComp::ToBeRemovedCallback(const std::vector<std::pair<Entity, Entity>> &callback_ranges)
 {
     size_t containers_count_when_start = GetContainersCount();
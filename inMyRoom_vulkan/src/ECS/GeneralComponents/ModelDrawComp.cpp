@@ -2,8 +2,10 @@
 
 #include "ECS/ECSwrapper.h"
 
-ModelDrawComp::ModelDrawComp(ECSwrapper* const in_ecs_wrapper_ptr)
-    :ComponentDataClass<ModelDrawCompEntity, static_cast<componentID>(componentIDenum::ModelDraw), "ModelDraw", sparse_set>(in_ecs_wrapper_ptr)
+ModelDrawComp::ModelDrawComp(ECSwrapper* const in_ecs_wrapper_ptr,
+                             MeshesOfNodes* in_meshesOfNodes_ptr)
+    :ComponentDataClass<ModelDrawCompEntity, static_cast<componentID>(componentIDenum::ModelDraw), "ModelDraw", sparse_set>(in_ecs_wrapper_ptr),
+     meshesOfNodes_ptr(in_meshesOfNodes_ptr)
 {
 }
 
@@ -13,7 +15,8 @@ ModelDrawComp::~ModelDrawComp()
 
 void ModelDrawComp::AddDrawInfos(const glm::mat4& viewport_matrix,
                                  std::vector<ModelMatrices>& matrices,
-                                 std::vector<DrawInfo>& draw_infos)
+                                 std::vector<DrawInfo>& draw_infos,
+                                 std::vector<float>& morph_weights)
 {
     auto nodeGlobalMatrix_componentID = static_cast<componentID>(componentIDenum::LateNodeGlobalMatrix);
     auto nodeGlobalMatrixComp_ptr = static_cast<const LateNodeGlobalMatrixComp*>(ecsWrapper_ptr->GetComponentByID(nodeGlobalMatrix_componentID));
@@ -24,20 +27,81 @@ void ModelDrawComp::AddDrawInfos(const glm::mat4& viewport_matrix,
     auto light_componentID = static_cast<componentID>(componentIDenum::Light);
     auto lightComp_ptr = static_cast<const LightComp*>(ecsWrapper_ptr->GetComponentByID(light_componentID));
 
+    bool is_viewport_unchanged = (viewport_matrix == lastViewportMatrix);
+    lastViewportMatrix = viewport_matrix;
+
+    frameCullableInstances.clear();
+    frameCullableDrawInfos.clear();
+
     size_t containers_count = GetContainersCount();
     for(size_t i = 0; i != containers_count; ++i)
     {
         auto& this_container = GetContainerByIndex(i);
-        for(auto& this_comp_entity: this_container)
+        for(auto& this_comp_entity: this_container) {
+            size_t draw_infos_count = draw_infos.size();
             this_comp_entity.AddDrawInfo(nodeGlobalMatrixComp_ptr,
                                          dynamicMeshComp_ptr,
                                          lightComp_ptr,
                                          viewport_matrix,
+                                         is_viewport_unchanged,
                                          matrices,
-                                         draw_infos);
+                                         draw_infos,
+                                         morph_weights);
+
+            if (draw_infos.size() != draw_infos_count) {
+                const DrawInfo& this_draw_info = draw_infos.back();
+                if (not this_draw_info.isLightSource && not this_draw_info.isSkin && not this_draw_info.hasMorphTargets && not this_draw_info.dontCull) {
+                    frameCullableInstances.emplace_back(CullingInstancesBVH::InstanceKey{entitiesHandler_ptr->GetEntityHandle(this_comp_entity.thisEntity),
+                                                                                         this_draw_info.meshIndex});
+                    frameCullableDrawInfos.emplace_back(uint32_t(draw_infos_count));
+                }
+            }
+        }
     }
 }
 
+void ModelDrawComp::CullDrawInfos(const std::array<Plane, 6>& world_frustum_planes,
+                                  const std::vector<DrawInfo>& draw_infos,
+                                  std::vector<uint32_t>& visible_draw_infos)
+{
+    auto nodeGlobalMatrix_componentID = static_cast<componentID>(componentIDenum::LateNodeGlobalMatrix);
+    auto nodeGlobalMatrixComp_ptr = static_cast<const LateNodeGlobalMatrixComp*>(ecsWrapper_ptr->GetComponentByID(nodeGlobalMatrix_componentID));
+
+    auto get_node_global_matrix_entity = [this, nodeGlobalMatrixComp_ptr](size_t index) -> const LateNodeGlobalMatrixCompEntity&
+    {
+        return nodeGlobalMatrixComp_ptr->GetComponentEntity(frameCullableInstances[index].entityHandle.entity);
+    };
+    cullingBVH.Update(frameCullableInstances,
+                      [&get_node_global_matrix_entity](size_t index)
+                      {
+                          return get_node_global_matrix_entity(index).matrixVersion;
+                      },
+                      [this, &get_node_global_matrix_entity](size_t index)
+                      {
+                          return GetWorldParalgram(frameCullableInstances[index].meshIndex, get_node_global_matrix_entity(index).globalMatrix);
+                      });
+
+    cullingBVH.Cull(world_frustum_planes, visibleInstances);
+
+    isDrawInfoVisible.assign(draw_infos.size(), 1);
+    for (uint32_t this_draw_info_index : frameCullableDrawInfos)
+        isDrawInfoVisible[this_draw_info_index] = 0;
+    for (uint32_t this_instance : visibleInstances)
+        isDrawInfoVisible[frameCullableDrawInfos[this_instance]] = 1;
+
+    visible_draw_infos.clear();
+    for (size_t index = 0; index != draw_infos.size(); ++index)
+        if (isDrawInfoVisible[index])
+            visible_draw_infos.emplace_back(uint32_t(index));
+}
+
+Paralgram ModelDrawComp::GetWorldParalgram(size_t mesh_index, const glm::mat4& global_matrix) const
+{
+    const MeshInfo& this_mesh_info = meshesOfNodes_ptr->GetMeshInfo(mesh_index);
+
+    return global_matrix * this_mesh_info.boundBoxTree.GetRootOBB();
+}
+
 void ModelDrawComp::ToBeRemovedCallback(const std::vector<std::pair<Entity, Entity>> &callback_ranges)
 {
     size_t containers_count_when_start = GetContainersCount();
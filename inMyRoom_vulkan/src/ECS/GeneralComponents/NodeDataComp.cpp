@@ -9,4 +9,9 @@ NodeDataComp::NodeDataComp(ECSwrapper* const in_ecs_wrapper_ptr)
 
 NodeDataComp::~NodeDataComp()
 {
-}
\ No newline at end of file
+}
+
+UpdateAccess NodeDataComp::GetUpdateAccess() const
+{
+    return GetUpdateAccessOfCompEntities();
+}
@@ -0,0 +1,139 @@
+#include "ECS/HierarchyLevels.h"
+
+#include "ECS/EntitiesHandler.h"
+
+#include <cassert>
+#include <algorithm>
+
+HierarchyLevels::HierarchyLevels(const EntitiesHandler* in_entitiesHandler_ptr)
+    :entitiesHandler_ptr(in_entitiesHandler_ptr)
+{
+    parentChangesCountWhenBuilt = entitiesHandler_ptr->GetParentChangesCount();
+}
+
+void HierarchyLevels::AddEntities(const std::vector<Entity>& entities)
+{
+    if (entities.empty())
+        return;
+
+    ExtentVectors(*std::max_element(entities.begin(), entities.end()));
+
+    // Levels first, as parents may come after their children
+    for (Entity this_entity : entities)
+    {
+        assert(positionInLevelOfEachEntity[this_entity] == uint32_t(-1));
+        levelOfEachEntity[this_entity] = GetLevelOfEntity(this_entity);
+    }
+
+    std::vector<size_t> old_sizes_of_levels;
+    for (const auto& this_level : levels)
+        old_sizes_of_levels.emplace_back(this_level.size());
+
+    for (Entity this_entity : entities)
+    {
+        uint32_t this_level = levelOfEachEntity[this_entity];
+        if (this_level >= levels.size())
+            levels.resize(this_level + 1);
+
+        levels[this_level].emplace_back(LevelEntry{this_entity, entitiesHandler_ptr->GetParentOfEntity(this_entity)});
+    }
+
+    // Recycled entities can be lower than the ones already there
+    old_sizes_of_levels.resize(levels.size(), 0);
+    for (size_t level = 0; level != levels.size(); ++level)
+    {
+        std::vector<LevelEntry>& this_level = levels[level];
+        if (this_level.size() == old_sizes_of_levels[level])
+            continue;
+
+        auto by_entity = [](const LevelEntry& lhs, const LevelEntry& rhs) {return lhs.entity < rhs.entity;};
+        std::sort(this_level.begin() + old_sizes_of_levels[level], this_level.end(), by_entity);
+        std::inplace_merge(this_level.begin(), this_level.begin() + old_sizes_of_levels[level], this_level.end(), by_entity);
+
+        RefreshPositionsInLevel(level);
+    }
+}
+
+void HierarchyLevels::RemoveEntitiesByRanges(const std::vector<std::pair<Entity, Entity>>& ranges)
+{
+    std::vector<bool> is_level_touched(levels.size(), false);
+    for (const auto& this_range : ranges)
+    {
+        for (size_t this_entity = this_range.first; this_entity <= this_range.second && this_entity < positionInLevelOfEachEntity.size(); ++this_entity)
+        {
+            if (positionInLevelOfEachEntity[this_entity] == uint32_t(-1))
+                continue;
+
+            is_level_touched[levelOfEachEntity[this_entity]] = true;
+
+            levelOfEachEntity[this_entity] = uint32_t(-1);
+            positionInLevelOfEachEntity[this_entity] = uint32_t(-1);
+        }
+    }
+
+    // Erased in place, so the rest keep their order
+    for (size_t level = 0; level != levels.size(); ++level)
+    {
+        if (not is_level_touched[level])
+            continue;
+
+        std::erase_if(levels[level], [this](const LevelEntry& this_entry) {return positionInLevelOfEachEntity[this_entry.entity] == uint32_t(-1);});
+        RefreshPositionsInLevel(level);
+    }
+
+    while (not levels.empty() && levels.back().empty())
+        levels.pop_back();
+}
+
+void HierarchyLevels::Clear()
+{
+    levels.clear();
+    std::fill(levelOfEachEntity.begin(), levelOfEachEntity.end(), uint32_t(-1));
+    std::fill(positionInLevelOfEachEntity.begin(), positionInLevelOfEachEntity.end(), uint32_t(-1));
+
+    parentChangesCountWhenBuilt = entitiesHandler_ptr->GetParentChangesCount();
+}
+
+bool HierarchyLevels::IsOutdated() const
+{
+    return parentChangesCountWhenBuilt != entitiesHandler_ptr->GetParentChangesCount();
+}
+
+size_t HierarchyLevels::GetLevelsCount() const
+{
+    return levels.size();
+}
+
+const std::vector<HierarchyLevels::LevelEntry>& HierarchyLevels::GetLevel(size_t level) const
+{
+    assert(level < levels.size());
+    return levels[level];
+}
+
+uint32_t HierarchyLevels::GetLevelOfEntity(Entity entity) const
+{
+    if (entity < levelOfEachEntity.size() && levelOfEachEntity[entity] != uint32_t(-1))
+        return levelOfEachEntity[entity];
+
+    Entity parent = entitiesHandler_ptr->GetParentOfEntity(entity);
+    if (parent == 0)
+        return 0;
+    else
+        return GetLevelOfEntity(parent) + 1;
+}
+
+void HierarchyLevels::ExtentVectors(Entity max_entity)
+{
+    if (max_entity >= levelOfEachEntity.size())
+    {
+        levelOfEachEntity.resize(size_t(max_entity) + 1, uint32_t(-1));
+        positionInLevelOfEachEntity.resize(size_t(max_entity) + 1, uint32_t(-1));
+    }
+}
+
+void HierarchyLevels::RefreshPositionsInLevel(size_t level)
+{
+    const std::vector<LevelEntry>& this_level = levels[level];
+    for (size_t position = 0; position != this_level.size(); ++position)
+        positionInLevelOfEachEntity[this_level[position].entity] = uint32_t(position);
+}
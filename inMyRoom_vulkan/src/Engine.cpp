@@ -22,8 +22,14 @@ Engine::Engine(configuru::Config& in_cfgFile)
         exportedFunctionsConstructor_uptr = std::make_unique<ExportedFunctionsConstructor>(this);
     }
 
+    {   // Initializing workers pool
+        workersPool_uptr = std::make_unique<WorkersPool>(cfgFile["engineSettings"]["workerThreads"].as_integer<size_t>());
+    }
+
     {   // Initializing ECS
         ECSwrapper_uptr = std::make_unique<ECSwrapper>(exportedFunctionsConstructor_uptr.get());
+        if (cfgFile["engineSettings"]["parallelECSupdate"].as_bool())
+            ECSwrapper_uptr->SetWorkersPool(workersPool_uptr.get());
 
         std::unique_ptr<AnimationComposerComp> animationComposer_comp_uptr = std::make_unique<AnimationComposerComp>(ECSwrapper_uptr.get());
         ECSwrapper_uptr->AddComponentAndOwnership(std::move(animationComposer_comp_uptr));
@@ -47,7 +53,8 @@ Engine::Engine(configuru::Config& in_cfgFile)
     }
 
     {   // Initializing collision detection
-        collisionDetection_uptr = std::make_unique<CollisionDetection>(ECSwrapper_uptr.get());
+        WorkersPool* collision_workers_pool_ptr = cfgFile["collisionSettings"]["parallelExecution"].as_bool() ? workersPool_uptr.get() : nullptr;
+        collisionDetection_uptr = std::make_unique<CollisionDetection>(ECSwrapper_uptr.get(), cfgFile, collision_workers_pool_ptr);
 
         std::unique_ptr<ModelCollisionComp> modelCollision_comp_uptr = std::make_unique<ModelCollisionComp>(ECSwrapper_uptr.get(), collisionDetection_uptr.get(), graphics_uptr->GetMeshesOfNodesPtr());
         ECSwrapper_uptr->AddComponentAndOwnership(std::move(modelCollision_comp_uptr));
@@ -66,6 +73,7 @@ Engine::Engine(configuru::Config& in_cfgFile)
         GetWindowPtr()->AddCallbackKeyPressLambda([this](int key) {this->inputManager_uptr->KeyPressed(key);});
         GetWindowPtr()->AddCallbackKeyReleaseLambda([this](int key) {this->inputManager_uptr->KeyReleased(key);});
         GetWindowPtr()->AddCallbackMouseMoveLambda([this](long dx, long dy) {this->inputManager_uptr->MouseMoved(dx, dy);});
+        GetWindowPtr()->AddCallbackAfterEventsLambda([this]() {return this->inputManager_uptr->FlushPendingEvents();});
     }
 
     std::cout << "Live!\n";
@@ -98,6 +106,16 @@ ECSwrapper* Engine::GetECSwrapperPtr()
     return ECSwrapper_uptr.get();
 }
 
+WorkersPool* Engine::GetWorkersPoolPtr()
+{
+    return workersPool_uptr.get();
+}
+
+CollisionDetection* Engine::GetCollisionDetectionPtr()
+{
+    return collisionDetection_uptr.get();
+}
+
 void Engine::Run()
 {
     ECSwrapper_uptr->RefreshUpdateDeltaTime();  // In order to make 1st frame delta time about 0.
@@ -130,6 +148,8 @@ void Engine::Run()
             breakMainLoop = true;
         }
 
+        inputManager_uptr->DispatchInputEvents();
+
         ECSwrapper_uptr->Update();
         graphics_uptr->DrawFrame();
         ECSwrapper_uptr->CompleteAddsAndRemoves();
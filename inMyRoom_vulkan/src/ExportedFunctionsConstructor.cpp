@@ -19,6 +19,16 @@ void ExportedFunctionsConstructor::BindCameraEntity(Entity this_camera_entity) c
     cameraComp_ptr->BindCameraEntity(this_camera_entity);
 }
 
+EntityHandle ExportedFunctionsConstructor::GetEntityHandle(Entity entity) const
+{
+    return engine_ptr->GetECSwrapperPtr()->GetEntityHandle(entity);
+}
+
+Entity ExportedFunctionsConstructor::ResolveEntityHandle(const EntityHandle& handle) const
+{
+    return engine_ptr->GetECSwrapperPtr()->ResolveEntityHandle(handle);
+}
+
 size_t ExportedFunctionsConstructor::GetSphereMeshIndex() const
 {
     size_t mesh_index = engine_ptr->GetGraphicsPtr()->GetMeshesOfNodesPtr()->GetSphereMeshIndex();
@@ -31,4 +41,22 @@ size_t ExportedFunctionsConstructor::GetCylinderMeshIndex() const
     return mesh_index;
 }
 
+std::vector<SceneRaycastHit> ExportedFunctionsConstructor::Raycast(const glm::vec3& origin, const glm::vec3& direction, float max_distance, SceneRaycastMode mode) const
+{
+    return engine_ptr->GetCollisionDetectionPtr()->GetSceneQueriesPtr()->Raycast(origin, direction, max_distance, mode);
+}
+
+std::vector<Entity> ExportedFunctionsConstructor::OverlapBox(const glm::vec3& center, const glm::vec3& half_side_u, const glm::vec3& half_side_v, const glm::vec3& half_side_w) const
+{
+    return engine_ptr->GetCollisionDetectionPtr()->GetSceneQueriesPtr()->OverlapBox(center, half_side_u, half_side_v, half_side_w);
+}
+
+std::vector<Entity> ExportedFunctionsConstructor::OverlapSphere(const glm::vec3& center, float radius) const
+{
+    return engine_ptr->GetCollisionDetectionPtr()->GetSceneQueriesPtr()->OverlapSphere(center, radius);
+}
 
+std::vector<SceneNearestEntity> ExportedFunctionsConstructor::NearestEntities(const glm::vec3& point, size_t count) const
+{
+    return engine_ptr->GetCollisionDetectionPtr()->GetSceneQueriesPtr()->NearestEntities(point, count);
+}
@@ -0,0 +1,284 @@
+#include "Geometry/FrustumCullingBVH.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+#include "glm/common.hpp"
+
+#include "Geometry/FloatLanes.h"
+
+namespace
+{
+    // Parents' half extents grow by this much of their coordinates' magnitude, so rounding of the plane tests
+    // never culls a parent whose child would pass, nor takes a parent as inside when a child is not
+    constexpr float conservativeMargin = 1.e-5f;
+
+    void GetAxisAlignedBox(const Paralgram& paralgram, glm::vec3& center, glm::vec3& half_extents)
+    {
+        center = paralgram.GetCenter();
+        half_extents = glm::abs(paralgram.GetSideDirectionU()) + glm::abs(paralgram.GetSideDirectionV()) + glm::abs(paralgram.GetSideDirectionW());
+    }
+
+    // Spreads the 10 low bits of "value" to every third bit
+    uint32_t ExpandBits(uint32_t value)
+    {
+        value = (value * 0x00010001u) & 0xFF0000FFu;
+        value = (value * 0x00000101u) & 0x0F00F00Fu;
+        value = (value * 0x00000011u) & 0xC30C30C3u;
+        value = (value * 0x00000005u) & 0x49249249u;
+        return value;
+    }
+
+    uint32_t GetMortonCode(const glm::vec3& normalized_position)
+    {
+        auto quantize = [](float coordinate) -> uint32_t
+        {
+            return uint32_t(std::clamp(coordinate * 1024.f, 0.f, 1023.f));
+        };
+
+        return (ExpandBits(quantize(normalized_position.x)) << 2)
+             | (ExpandBits(quantize(normalized_position.y)) << 1)
+             |  ExpandBits(quantize(normalized_position.z));
+    }
+
+    // Plane::IntersectParalgram with sides (hx,0,0), (0,hy,0) and (0,0,hz) over every lane, returns early when every lane of "lanes_mask" is outside
+    template<typename F>
+    void TestBoxesLanes(const LanesVec3<F>& centers,
+                        const LanesVec3<F>& half_extents,
+                        const std::array<Plane, 6>& frustum_planes,
+                        uint32_t lanes_mask,
+                        uint32_t& outside_mask,
+                        uint32_t& inside_mask)
+    {
+        const F zero = F::Broadcast(0.f);
+
+        outside_mask = 0;
+        inside_mask = lanes_mask;
+        for (const Plane& this_plane : frustum_planes)
+        {
+            const glm::vec3& normal = this_plane.GetNormal();
+            LanesVec3<F> normal_lanes = LanesVec3<F>::Broadcast(normal);
+
+            F e = Abs(normal_lanes.x * half_extents.x) + Abs(normal_lanes.y * half_extents.y) + Abs(normal_lanes.z * half_extents.z);
+            F s = Dot(centers, normal_lanes) + F::Broadcast(this_plane.GetD());
+
+            outside_mask |= MoveMask(s - e > zero) & lanes_mask;
+            inside_mask &= MoveMask(s + e < zero);
+
+            if (outside_mask == lanes_mask)
+                break;
+        }
+
+        inside_mask &= ~outside_mask;
+    }
+}
+
+void FrustumCullingBVH::Build(const std::vector<Paralgram>& instances_paralgrams)
+{
+    size_t instances_count = instances_paralgrams.size();
+    assert(instances_count <= std::numeric_limits<uint32_t>::max());
+
+    std::vector<glm::vec3> centers(instances_count);
+    std::vector<glm::vec3> half_extents(instances_count);
+    glm::vec3 min_center = glm::vec3(std::numeric_limits<float>::max());
+    glm::vec3 max_center = glm::vec3(std::numeric_limits<float>::lowest());
+    for (size_t index = 0; index != instances_count; ++index)
+    {
+        GetAxisAlignedBox(instances_paralgrams[index], centers[index], half_extents[index]);
+        min_center = glm::min(min_center, centers[index]);
+        max_center = glm::max(max_center, centers[index]);
+    }
+
+    // Morton order of the centers, so consecutive instances are near each other
+    std::vector<std::pair<uint32_t, uint32_t>> codes_instances(instances_count);
+    glm::vec3 centers_extent = max_center - min_center;
+    for (size_t index = 0; index != instances_count; ++index)
+    {
+        glm::vec3 normalized_center = centers[index] - min_center;
+        for (int axis = 0; axis != 3; ++axis)
+            normalized_center[axis] = centers_extent[axis] > 0.f ? normalized_center[axis] / centers_extent[axis] : 0.f;
+
+        codes_instances[index] = {GetMortonCode(normalized_center), uint32_t(index)};
+    }
+    std::sort(codes_instances.begin(), codes_instances.end());
+
+    sortedInstances.resize(instances_count);
+    instancesLanes.resize(instances_count);
+    for (size_t lane = 0; lane != instances_count; ++lane)
+    {
+        sortedInstances[lane] = codes_instances[lane].second;
+        instancesLanes[codes_instances[lane].second] = uint32_t(lane);
+    }
+
+    // Levels from the leaves up to the single root
+    nodes.clear();
+    levelsOffsets.assign(1, 0);
+    size_t children_count = instances_count;
+    while (children_count)
+    {
+        size_t level_nodes_count = (children_count + width - 1) / width;
+        for (size_t index = 0; index != level_nodes_count; ++index)
+        {
+            Node& this_node = nodes.emplace_back();
+            this_node.childrenCount = uint32_t(std::min(width, children_count - index * width));
+        }
+        levelsOffsets.emplace_back(nodes.size());
+
+        children_count = level_nodes_count > 1 ? level_nodes_count : 0;
+    }
+
+    for (size_t lane = 0; lane != instances_count; ++lane)
+    {
+        uint32_t this_instance = sortedInstances[lane];
+        SetLane(GetNode(0, lane / width), lane % width, centers[this_instance], half_extents[this_instance]);
+    }
+
+    dirtyNodes.assign(nodes.size(), 1);
+    Refit();
+}
+
+void FrustumCullingBVH::SetInstance(size_t instance_index, const Paralgram& paralgram)
+{
+    assert(instance_index < instancesLanes.size());
+
+    glm::vec3 center, half_extents;
+    GetAxisAlignedBox(paralgram, center, half_extents);
+
+    size_t lane = instancesLanes[instance_index];
+    SetLane(GetNode(0, lane / width), lane % width, center, half_extents);
+    dirtyNodes[lane / width] = 1;
+}
+
+void FrustumCullingBVH::Refit()
+{
+    for (size_t level = 0; level + 1 < GetLevelsCount(); ++level)
+    {
+        size_t level_nodes_count = levelsOffsets[level + 1] - levelsOffsets[level];
+        for (size_t index = 0; index != level_nodes_count; ++index)
+        {
+            uint8_t& is_dirty = dirtyNodes[levelsOffsets[level] + index];
+            if (not is_dirty)
+                continue;
+            is_dirty = 0;
+
+            const Node& this_node = GetNode(level, index);
+            glm::vec3 min_coords = glm::vec3(std::numeric_limits<float>::max());
+            glm::vec3 max_coords = glm::vec3(std::numeric_limits<float>::lowest());
+            for (size_t lane = 0; lane != this_node.childrenCount; ++lane)
+            {
+                glm::vec3 center = glm::vec3(this_node.centers.x.values[lane], this_node.centers.y.values[lane], this_node.centers.z.values[lane]);
+                glm::vec3 half_extents = glm::vec3(this_node.halfExtents.x.values[lane], this_node.halfExtents.y.values[lane], this_node.halfExtents.z.values[lane]);
+
+                min_coords = glm::min(min_coords, center - half_extents);
+                max_coords = glm::max(max_coords, center + half_extents);
+            }
+
+            glm::vec3 center = (min_coords + max_coords) * 0.5f;
+            glm::vec3 half_extents = (max_coords - min_coords) * 0.5f + (glm::abs(min_coords) + glm::abs(max_coords)) * conservativeMargin;
+
+            SetLane(GetNode(level + 1, index / width), index % width, center, half_extents);
+            dirtyNodes[levelsOffsets[level + 1] + index / width] = 1;
+        }
+    }
+
+    if (nodes.size())
+        dirtyNodes.back() = 0;
+}
+
+void FrustumCullingBVH::Cull(const std::array<Plane, 6>& frustum_planes, std::vector<uint32_t>& visible_instances)
+{
+    visible_instances.clear();
+    if (sortedInstances.empty())
+        return;
+
+    cullStack.clear();
+    cullStack.emplace_back(NodeAtLevel{GetLevelsCount() - 1, 0});
+    while (cullStack.size())
+    {
+        NodeAtLevel this_node_at_level = cullStack.back();
+        cullStack.pop_back();
+
+        const Node& this_node = GetNode(this_node_at_level.level, this_node_at_level.index);
+        uint32_t outside_mask, inside_mask;
+        TestNode(this_node, frustum_planes, outside_mask, inside_mask);
+
+        // A child of a level above the leaves covers a contiguous range of leaves' lanes
+        size_t child_lanes_count = 1;
+        for (size_t level = 0; level != this_node_at_level.level; ++level)
+            child_lanes_count *= width;
+
+        for (size_t lane = 0; lane != this_node.childrenCount; ++lane)
+        {
+            if (outside_mask & (1u << lane))
+                continue;
+
+            size_t child_index = this_node_at_level.index * width + lane;
+            if (this_node_at_level.level == 0)
+            {
+                visible_instances.emplace_back(sortedInstances[child_index]);
+            }
+            else if (inside_mask & (1u << lane))
+            {
+                size_t first_lane = child_index * child_lanes_count;
+                size_t last_lane = std::min(first_lane + child_lanes_count, sortedInstances.size());
+                visible_instances.insert(visible_instances.end(), sortedInstances.begin() + first_lane, sortedInstances.begin() + last_lane);
+            }
+            else
+            {
+                cullStack.emplace_back(NodeAtLevel{this_node_at_level.level - 1, child_index});
+            }
+        }
+    }
+
+    std::sort(visible_instances.begin(), visible_instances.end());
+}
+
+void FrustumCullingBVH::SetLane(Node& node, size_t lane, const glm::vec3& center, const glm::vec3& half_extents)
+{
+    assert(lane < node.childrenCount);
+
+    node.centers.x.values[lane] = center.x;
+    node.centers.y.values[lane] = center.y;
+    node.centers.z.values[lane] = center.z;
+    node.halfExtents.x.values[lane] = half_extents.x;
+    node.halfExtents.y.values[lane] = half_extents.y;
+    node.halfExtents.z.values[lane] = half_extents.z;
+}
+
+void FrustumCullingBVH::TestNode(const Node& node, const std::array<Plane, 6>& frustum_planes, uint32_t& outside_mask, uint32_t& inside_mask)
+{
+#if defined(__AVX__) || defined(__SSE__)
+    auto load_vec3 = [](const Vec3Lanes& lanes) -> LanesVec3<SimdFloat>
+    {
+        return {SimdFloat::Load(lanes.x.values), SimdFloat::Load(lanes.y.values), SimdFloat::Load(lanes.z.values)};
+    };
+
+    uint32_t lanes_mask = (1u << node.childrenCount) - 1u;
+
+    TestBoxesLanes(load_vec3(node.centers), load_vec3(node.halfExtents), frustum_planes, lanes_mask, outside_mask, inside_mask);
+#else
+    TestNodeScalar(node, frustum_planes, outside_mask, inside_mask);
+#endif
+}
+
+void FrustumCullingBVH::TestNodeScalar(const Node& node, const std::array<Plane, 6>& frustum_planes, uint32_t& outside_mask, uint32_t& inside_mask)
+{
+    outside_mask = 0;
+    inside_mask = 0;
+    for (size_t lane = 0; lane != node.childrenCount; ++lane)
+    {
+        auto load_vec3 = [lane](const Vec3Lanes& lanes) -> LanesVec3<ScalarFloat>
+        {
+            return {ScalarFloat::Load(&lanes.x.values[lane]), ScalarFloat::Load(&lanes.y.values[lane]), ScalarFloat::Load(&lanes.z.values[lane])};
+        };
+
+        uint32_t lane_outside_mask, lane_inside_mask;
+        TestBoxesLanes(load_vec3(node.centers), load_vec3(node.halfExtents), frustum_planes, 1u, lane_outside_mask, lane_inside_mask);
+
+        outside_mask |= lane_outside_mask << lane;
+        inside_mask |= lane_inside_mask << lane;
+    }
+}
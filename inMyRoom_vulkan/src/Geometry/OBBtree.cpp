@@ -1,4 +1,5 @@
 #include "Geometry/OBBtree.h"
+#include "Geometry/OBBtreeSAHbuilder.h"
 
 #include <algorithm>
 #include <iterator>
@@ -318,8 +319,86 @@ size_t OBBtree::OBBtreeTraveler::GetTrianglesCount() const
     return triangles_count;
 }
 
-OBBtree::OBBtree(std::vector<Triangle>&& in_triangles)
+OBBtree::QuantizedOBBtreeTraveler::QuantizedOBBtreeTraveler(const OBB& root_obb, const std::vector<QuantizedOBBtreeNode>& quantized_obb_tree_nodes, size_t in_triangles_count)
+    : paralgram(root_obb),
+      quantizedOBBtreeNodes_ptr(&quantized_obb_tree_nodes)
 {
+    if(quantized_obb_tree_nodes.size())
+    {
+        isLeaf = false;
+
+        quantizedOBBtreeNode_ptr = &quantized_obb_tree_nodes[0];
+    }
+    else
+    {
+        isLeaf = true;
+
+        triangles_offset = 0;
+        triangles_count = in_triangles_count;
+    }
+}
+
+OBBtree::QuantizedOBBtreeTraveler OBBtree::QuantizedOBBtreeTraveler::GetLeftChildTraveler() const
+{
+    assert(IsLeaf() == false);
+
+    return GetChildTraveler(quantizedOBBtreeNode_ptr->left_child_obb,
+                            quantizedOBBtreeNode_ptr->left_child_index_or_triangle_offset,
+                            quantizedOBBtreeNode_ptr->left_triangles_count);
+}
+
+OBBtree::QuantizedOBBtreeTraveler OBBtree::QuantizedOBBtreeTraveler::GetRightChildTraveler() const
+{
+    assert(IsLeaf() == false);
+
+    return GetChildTraveler(quantizedOBBtreeNode_ptr->right_child_obb,
+                            quantizedOBBtreeNode_ptr->right_child_index_or_triangle_offset,
+                            quantizedOBBtreeNode_ptr->right_triangles_count);
+}
+
+OBBtree::QuantizedOBBtreeTraveler OBBtree::QuantizedOBBtreeTraveler::GetChildTraveler(const QuantizedOBB& child_obb,
+                                                                                      uint32_t child_index_or_triangle_offset,
+                                                                                      uint16_t child_triangles_count) const
+{
+    QuantizedOBBtreeTraveler return_traveler{*quantizedOBBtreeNodes_ptr};
+    return_traveler.paralgram = child_obb.Dequantize(paralgram.GetCenter(), quantizedOBBtreeNode_ptr->quantization_scale);
+
+    if(child_triangles_count == 0) [[likely]]
+    {
+        return_traveler.isLeaf = false;
+        return_traveler.quantizedOBBtreeNode_ptr = &(*quantizedOBBtreeNodes_ptr)[size_t(child_index_or_triangle_offset)];
+    }
+    else
+    {
+        return_traveler.isLeaf = true;
+        return_traveler.triangles_offset = child_index_or_triangle_offset;
+        return_traveler.triangles_count = child_triangles_count;
+    }
+
+    return return_traveler;
+}
+
+size_t OBBtree::QuantizedOBBtreeTraveler::GetTrianglesOffset() const
+{
+    assert(IsLeaf() == true);
+    return triangles_offset;
+}
+
+size_t OBBtree::QuantizedOBBtreeTraveler::GetTrianglesCount() const
+{
+    assert(IsLeaf() == true);
+    return triangles_count;
+}
+
+OBBtree::OBBtree(std::vector<Triangle>&& in_triangles, OBBtreeBuilder builder, WorkersPool* workers_pool_ptr)
+{
+    if (builder == OBBtreeBuilder::SAH)
+    {
+        OBBtreeSAHbuilder SAH_builder(std::move(in_triangles), workers_pool_ptr);
+        SAH_builder.FlattenToOBBtree(*this);
+        return;
+    }
+
     size_t triangles_count = in_triangles.size();
 
     std::unique_ptr<OBBtree::OBBtreeSplitBuildNode> obb_split_build_node_root = std::make_unique<OBBtree::OBBtreeSplitBuildNode>(nullptr, false, std::move(in_triangles));
@@ -367,6 +446,58 @@ OBBtree::OBBtreeTraveler OBBtree::GetRootTraveler() const
     return OBBtreeTraveler(&root_obb, OBBtreeNodes, triangles_position.size());
 }
 
+OBBtree::QuantizedOBBtreeTraveler OBBtree::GetRootQuantizedTraveler() const
+{
+    assert(HasQuantizedNodes());
+    return QuantizedOBBtreeTraveler(root_obb, quantizedOBBtreeNodes, triangles_position.size());
+}
+
+void OBBtree::QuantizeNodes()
+{
+    static_assert(sizeof(QuantizedOBBtreeNode) == 56);
+
+    quantizedOBBtreeNodes.clear();
+    quantizedOBBtreeNodes.resize(OBBtreeNodes.size());
+
+    if (OBBtreeNodes.size())
+        QuantizeNodesRecursive(0, root_obb);
+}
+
+// Children get quantized relative to this node's box as traversal will dequantize it, not as it was before quantization
+void OBBtree::QuantizeNodesRecursive(size_t node_index, const Paralgram& node_paralgram)
+{
+    const OBBtreeNode& this_node = OBBtreeNodes[node_index];
+    QuantizedOBBtreeNode& this_quantized_node = quantizedOBBtreeNodes[node_index];
+
+    glm::vec3 node_center = node_paralgram.GetCenter();
+    float scale = std::max(QuantizedOBB::GetQuantizationScale(this_node.left_child_obb, node_center),
+                           QuantizedOBB::GetQuantizationScale(this_node.right_child_obb, node_center));
+
+    this_quantized_node.left_child_obb = QuantizedOBB::Quantize(this_node.left_child_obb, node_center, scale);
+    this_quantized_node.right_child_obb = QuantizedOBB::Quantize(this_node.right_child_obb, node_center, scale);
+    this_quantized_node.quantization_scale = scale;
+    this_quantized_node.left_child_index_or_triangle_offset = this_node.left_child_index_or_triangle_offset;
+    this_quantized_node.right_child_index_or_triangle_offset = this_node.right_child_index_or_triangle_offset;
+    this_quantized_node.left_triangles_count = this_node.left_triangles_count;
+    this_quantized_node.right_triangles_count = this_node.right_triangles_count;
+
+    if (this_node.left_triangles_count == 0)
+        QuantizeNodesRecursive(this_node.left_child_index_or_triangle_offset, this_quantized_node.left_child_obb.Dequantize(node_center, scale));
+    if (this_node.right_triangles_count == 0)
+        QuantizeNodesRecursive(this_node.right_child_index_or_triangle_offset, this_quantized_node.right_child_obb.Dequantize(node_center, scale));
+}
+
+bool OBBtree::HasQuantizedNodes() const
+{
+    return quantizedOBBtreeNodes.size() == OBBtreeNodes.size();
+}
+
+size_t OBBtree::GetNodesMemorySize() const
+{
+    return OBBtreeNodes.size() * sizeof(OBBtreeNode) +
+           quantizedOBBtreeNodes.size() * sizeof(QuantizedOBBtreeNode);
+}
+
 TrianglePosition OBBtree::GetTrianglePosition(size_t index) const
 {
     return triangles_position[index];
@@ -400,78 +531,207 @@ void OBBtree::IntersectOBBtrees(const OBBtree& first_tree,
 {
     intesection_info.candidateTriangleRangeCombinations.clear();
 
-    OBBtreeTraveler first_tree_traveler = first_tree.GetRootTraveler();
-    OBBtreeTraveler second_tree_traveler = second_tree.GetRootTraveler();
+    auto intersect_from_roots = [&](const auto& first_tree_traveler, const auto& second_tree_traveler)
+    {
+        Paralgram first_paralgram = first_tree_traveler.GetOBB();
+        Paralgram second_paralgram = second_tree_matrix * second_tree_traveler.GetOBB();
 
-    IntersectOBBtreesRecursive(first_tree_traveler,
-                               second_tree_traveler,
-                               second_tree_matrix,
-                               intesection_info);
-}
+        if (Paralgram::IntersectParalgramsBoolean(first_paralgram, second_paralgram))
+        {
+            IntersectOBBtreesRecursive(first_tree_traveler,
+                                       first_paralgram,
+                                       second_tree_traveler,
+                                       second_paralgram,
+                                       second_tree_matrix,
+                                       intesection_info);
+        }
+    };
 
+    if (first_tree.HasQuantizedNodes() && second_tree.HasQuantizedNodes())
+        intersect_from_roots(first_tree.GetRootQuantizedTraveler(), second_tree.GetRootQuantizedTraveler());
+    else
+        intersect_from_roots(first_tree.GetRootTraveler(), second_tree.GetRootTraveler());
+}
 
-// TODO likely and reorder
-void OBBtree::IntersectOBBtreesRecursive(const OBBtreeTraveler& first_tree_traveler,
-                                         const OBBtreeTraveler& second_tree_traveler,
-                                         const glm::mat4x4& second_tree_matrix,
-                                         OBBtreesIntersectInfo& intesection_info)
+void OBBtree::SweepOBBtrees(const OBBtree& moving_tree,
+                            const glm::mat4x4& moving_tree_matrix,
+                            const glm::vec3& displacement,
+                            const OBBtree& tree,
+                            OBBtreesSweepInfo& sweep_info)
 {
-    Paralgram first_paralgram = first_tree_traveler.GetOBB();
-    Paralgram second_paralgram = second_tree_matrix * second_tree_traveler.GetOBB();
+    sweep_info = OBBtreesSweepInfo();
 
-    if (Paralgram::IntersectParalgramsBoolean(first_paralgram, second_paralgram))
+    struct StackEntry
+    {
+        OBBtreeTraveler moving_traveler;
+        Paralgram moving_paralgram;
+        OBBtreeTraveler traveler;
+        Paralgram paralgram;
+        float timeOfImpact;
+    };
+
+    OBBtreeTraveler moving_root_traveler = moving_tree.GetRootTraveler();
+    OBBtreeTraveler root_traveler = tree.GetRootTraveler();
+    Paralgram moving_root_paralgram = moving_tree_matrix * moving_root_traveler.GetOBB();
+    Paralgram root_paralgram = root_traveler.GetOBB();
+
+    SweepIntersectInfo roots_sweep = Paralgram::SweepParalgrams(moving_root_paralgram, displacement, root_paralgram);
+    if (not roots_sweep.doIntersect)
+        return;
+
+    // Earliest contact first, pairs that cannot come before the best contact so far are skipped
+    std::vector<StackEntry> stack;
+    stack.push_back({moving_root_traveler, moving_root_paralgram, root_traveler, root_paralgram, roots_sweep.timeOfImpact});
+
+    while (not stack.empty())
     {
-        if (not first_tree_traveler.IsLeaf() && not second_tree_traveler.IsLeaf()) [[likely]]
+        StackEntry this_entry = stack.back();
+        stack.pop_back();
+
+        if (this_entry.timeOfImpact > sweep_info.timeOfImpact)
+            continue;
+
+        if (this_entry.moving_traveler.IsLeaf() && this_entry.traveler.IsLeaf())
         {
-            if (first_paralgram.GetSurface() >= second_paralgram.GetSurface())
+            for (size_t i = 0; i != this_entry.moving_traveler.GetTrianglesCount(); ++i)
             {
-                IntersectOBBtreesRecursive(first_tree_traveler.GetLeftChildTraveler(),
-                                           second_tree_traveler,
-                                           second_tree_matrix,
-                                           intesection_info);
-                IntersectOBBtreesRecursive(first_tree_traveler.GetRightChildTraveler(),
-                                           second_tree_traveler,
-                                           second_tree_matrix,
-                                           intesection_info);
+                size_t moving_triangle_index = this_entry.moving_traveler.GetTrianglesOffset() + i;
+                TrianglePosition moving_triangle = moving_tree_matrix * moving_tree.GetTrianglePosition(moving_triangle_index);
+
+                for (size_t j = 0; j != this_entry.traveler.GetTrianglesCount(); ++j)
+                {
+                    size_t triangle_index = this_entry.traveler.GetTrianglesOffset() + j;
+                    SweepIntersectInfo triangles_sweep = TrianglePosition::SweepTriangles(moving_triangle, displacement, tree.GetTrianglePosition(triangle_index));
+
+                    if (triangles_sweep.doIntersect && triangles_sweep.timeOfImpact < sweep_info.timeOfImpact)
+                    {
+                        sweep_info.doIntersect = true;
+                        sweep_info.timeOfImpact = triangles_sweep.timeOfImpact;
+                        sweep_info.normal = triangles_sweep.normal;
+                        sweep_info.moving_triangle_index = moving_triangle_index;
+                        sweep_info.triangle_index = triangle_index;
+                    }
+                }
+            }
+
+            continue;
+        }
+
+        // Same split choice as IntersectOBBtreesRecursive
+        bool should_split_moving = this_entry.traveler.IsLeaf() ||
+                                   (not this_entry.moving_traveler.IsLeaf() && this_entry.moving_paralgram.GetSurface() >= this_entry.paralgram.GetSurface());
+
+        // Later contact is pushed first, so the earlier one is popped first
+        auto push_children = [&](StackEntry left_child_entry, StackEntry right_child_entry)
+        {
+            SweepIntersectInfo left_child_sweep = Paralgram::SweepParalgrams(left_child_entry.moving_paralgram, displacement, left_child_entry.paralgram);
+            SweepIntersectInfo right_child_sweep = Paralgram::SweepParalgrams(right_child_entry.moving_paralgram, displacement, right_child_entry.paralgram);
+
+            left_child_entry.timeOfImpact = left_child_sweep.timeOfImpact;
+            right_child_entry.timeOfImpact = right_child_sweep.timeOfImpact;
+
+            auto push_child = [&](const StackEntry& child_entry, const SweepIntersectInfo& child_sweep)
+            {
+                if (child_sweep.doIntersect && child_sweep.timeOfImpact <= sweep_info.timeOfImpact)
+                    stack.push_back(child_entry);
+            };
+
+            if (right_child_sweep.timeOfImpact < left_child_sweep.timeOfImpact)
+            {
+                push_child(left_child_entry, left_child_sweep);
+                push_child(right_child_entry, right_child_sweep);
             }
             else
             {
-                IntersectOBBtreesRecursive(first_tree_traveler,
-                                           second_tree_traveler.GetLeftChildTraveler(),
-                                           second_tree_matrix,
-                                           intesection_info);
-                IntersectOBBtreesRecursive(first_tree_traveler,
-                                           second_tree_traveler.GetRightChildTraveler(),
-                                           second_tree_matrix,
-                                           intesection_info);
+                push_child(right_child_entry, right_child_sweep);
+                push_child(left_child_entry, left_child_sweep);
             }
+        };
+
+        if (should_split_moving)
+        {
+            OBBtreeTraveler left_child_traveler = this_entry.moving_traveler.GetLeftChildTraveler();
+            OBBtreeTraveler right_child_traveler = this_entry.moving_traveler.GetRightChildTraveler();
+
+            push_children({left_child_traveler, moving_tree_matrix * left_child_traveler.GetOBB(), this_entry.traveler, this_entry.paralgram, 0.f},
+                          {right_child_traveler, moving_tree_matrix * right_child_traveler.GetOBB(), this_entry.traveler, this_entry.paralgram, 0.f});
         }
-        else if (first_tree_traveler.IsLeaf() && not second_tree_traveler.IsLeaf())
+        else
         {
-            IntersectOBBtreesRecursive(first_tree_traveler,
-                                       second_tree_traveler.GetLeftChildTraveler(),
+            OBBtreeTraveler left_child_traveler = this_entry.traveler.GetLeftChildTraveler();
+            OBBtreeTraveler right_child_traveler = this_entry.traveler.GetRightChildTraveler();
+
+            push_children({this_entry.moving_traveler, this_entry.moving_paralgram, left_child_traveler, left_child_traveler.GetOBB(), 0.f},
+                          {this_entry.moving_traveler, this_entry.moving_paralgram, right_child_traveler, right_child_traveler.GetOBB(), 0.f});
+        }
+    }
+}
+
+// The travelers' paralgrams are known to intersect. The bigger one (or the one that is not leaf) gets split,
+// and both of its children are tested against the other paralgram with one batched test
+template<typename Traveler>
+void OBBtree::IntersectOBBtreesRecursive(const Traveler& first_tree_traveler,
+                                         const Paralgram& first_paralgram,
+                                         const Traveler& second_tree_traveler,
+                                         const Paralgram& second_paralgram,
+                                         const glm::mat4x4& second_tree_matrix,
+                                         OBBtreesIntersectInfo& intesection_info)
+{
+    if (first_tree_traveler.IsLeaf() && second_tree_traveler.IsLeaf())
+    {
+        intesection_info.candidateTriangleRangeCombinations.emplace_back(first_tree_traveler.GetTrianglesOffset(), first_tree_traveler.GetTrianglesCount(),
+                                                                         second_tree_traveler.GetTrianglesOffset(), second_tree_traveler.GetTrianglesCount());
+        return;
+    }
+
+    bool should_split_first = second_tree_traveler.IsLeaf() ||
+                              (not first_tree_traveler.IsLeaf() && first_paralgram.GetSurface() >= second_paralgram.GetSurface());
+
+    ParalgramBatch children_batch;
+    if (should_split_first)
+    {
+        Traveler left_child_traveler = first_tree_traveler.GetLeftChildTraveler();
+        Traveler right_child_traveler = first_tree_traveler.GetRightChildTraveler();
+
+        Paralgram left_child_paralgram = left_child_traveler.GetOBB();
+        Paralgram right_child_paralgram = right_child_traveler.GetOBB();
+
+        children_batch.Add(left_child_paralgram);
+        children_batch.Add(right_child_paralgram);
+        uint32_t intersect_mask = children_batch.IntersectParalgramBoolean(second_paralgram);
+
+        if (intersect_mask & 0b01)
+            IntersectOBBtreesRecursive(left_child_traveler, left_child_paralgram,
+                                       second_tree_traveler, second_paralgram,
                                        second_tree_matrix,
                                        intesection_info);
-            IntersectOBBtreesRecursive(first_tree_traveler,
-                                       second_tree_traveler.GetRightChildTraveler(),
+        if (intersect_mask & 0b10)
+            IntersectOBBtreesRecursive(right_child_traveler, right_child_paralgram,
+                                       second_tree_traveler, second_paralgram,
                                        second_tree_matrix,
                                        intesection_info);
-        }
-        else if (not first_tree_traveler.IsLeaf() && second_tree_traveler.IsLeaf())
-        {
-            IntersectOBBtreesRecursive(first_tree_traveler.GetLeftChildTraveler(),
-                                       second_tree_traveler,
+    }
+    else
+    {
+        Traveler left_child_traveler = second_tree_traveler.GetLeftChildTraveler();
+        Traveler right_child_traveler = second_tree_traveler.GetRightChildTraveler();
+
+        Paralgram left_child_paralgram = second_tree_matrix * left_child_traveler.GetOBB();
+        Paralgram right_child_paralgram = second_tree_matrix * right_child_traveler.GetOBB();
+
+        children_batch.Add(left_child_paralgram);
+        children_batch.Add(right_child_paralgram);
+        uint32_t intersect_mask = children_batch.IntersectParalgramBoolean(first_paralgram);
+
+        if (intersect_mask & 0b01)
+            IntersectOBBtreesRecursive(first_tree_traveler, first_paralgram,
+                                       left_child_traveler, left_child_paralgram,
                                        second_tree_matrix,
                                        intesection_info);
-            IntersectOBBtreesRecursive(first_tree_traveler.GetRightChildTraveler(),
-                                       second_tree_traveler,
+        if (intersect_mask & 0b10)
+            IntersectOBBtreesRecursive(first_tree_traveler, first_paralgram,
+                                       right_child_traveler, right_child_paralgram,
                                        second_tree_matrix,
                                        intesection_info);
-        }
-        else
-        {
-            intesection_info.candidateTriangleRangeCombinations.emplace_back(first_tree_traveler.GetTrianglesOffset(), first_tree_traveler.GetTrianglesCount(),
-                                                                             second_tree_traveler.GetTrianglesOffset(), second_tree_traveler.GetTrianglesCount());
-        }
     }
-}
\ No newline at end of file
+}
@@ -0,0 +1,270 @@
+#include "Geometry/OBBtreeCache.h"
+
+#include <cassert>
+#include <cstring>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <type_traits>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    // Read only view of a whole file. Memory mapped, or read to memory when mmap is not available
+    class MappedFile
+    {
+    public:
+        explicit MappedFile(const std::string& path)
+        {
+#ifdef _WIN32
+            std::ifstream file(path, std::ios::binary | std::ios::ate);
+            if (not file.is_open())
+                return;
+
+            fileData.resize(size_t(file.tellg()));
+            file.seekg(0);
+            file.read(reinterpret_cast<char*>(fileData.data()), std::streamsize(fileData.size()));
+            if (not file)
+                return;
+
+            data_ptr = fileData.data();
+            size = fileData.size();
+#else
+            int file_descriptor = open(path.c_str(), O_RDONLY);
+            if (file_descriptor == -1)
+                return;
+
+            struct stat file_stat = {};
+            if (fstat(file_descriptor, &file_stat) == 0 && file_stat.st_size > 0)
+            {
+                void* mapped_ptr = mmap(nullptr, size_t(file_stat.st_size), PROT_READ, MAP_PRIVATE, file_descriptor, 0);
+                if (mapped_ptr != MAP_FAILED)
+                {
+                    data_ptr = static_cast<const std::byte*>(mapped_ptr);
+                    size = size_t(file_stat.st_size);
+                }
+            }
+            close(file_descriptor);
+#endif
+        }
+
+        ~MappedFile()
+        {
+#ifndef _WIN32
+            if (data_ptr != nullptr)
+                munmap(const_cast<std::byte*>(data_ptr), size);
+#endif
+        }
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        const std::byte* GetData() const {return data_ptr;}
+        size_t GetSize() const {return size;}
+
+    private:
+        const std::byte* data_ptr = nullptr;
+        size_t size = 0;
+#ifdef _WIN32
+        std::vector<std::byte> fileData;
+#endif
+    };
+
+    template<typename T>
+    void CopyArrayFromBytes(const std::byte*& read_ptr, size_t count, std::vector<T>& vector)
+    {
+        vector.resize(count);
+        if (count != 0)
+            std::memcpy(vector.data(), read_ptr, count * sizeof(T));
+        read_ptr += count * sizeof(T);
+    }
+
+    template<typename T>
+    void WriteArrayToFile(std::ofstream& file, const std::vector<T>& vector)
+    {
+        file.write(reinterpret_cast<const char*>(vector.data()), std::streamsize(vector.size() * sizeof(T)));
+    }
+}
+
+OBBtreeCache::OBBtreeCache(std::string in_cacheFolder)
+    :cacheFolder(std::move(in_cacheFolder))
+{
+    static_assert(std::is_trivially_copyable_v<OBB>);
+    static_assert(std::is_trivially_copyable_v<OBBtree::OBBtreeNode>);
+    static_assert(std::is_trivially_copyable_v<TrianglePosition>);
+    static_assert(std::is_trivially_copyable_v<TriangleNormal>);
+    static_assert(std::is_trivially_copyable_v<TriangleIndices>);
+
+    std::error_code error_code;
+    std::filesystem::create_directories(cacheFolder, error_code);
+    if (error_code || not std::filesystem::is_directory(cacheFolder, error_code))
+    {
+        printf("OBBtree cache: cannot create folder %s (%s), cache disabled\n", cacheFolder.c_str(), error_code.message().c_str());
+        isEnabled = false;
+    }
+}
+
+uint64_t OBBtreeCache::GetKey(const std::vector<Triangle>& triangles, OBBtreeBuilder builder)
+{
+    uint64_t hash = fnvOffsetBasis;
+
+    uint32_t builder_parameters[4] = {fileFormatVersion,
+                                      uint32_t(builder),
+                                      uint32_t(OBBtree::GetMaxNumberOfTrianglesPerNode()),
+                                      uint32_t(sizeof(OBBtree::OBBtreeNode))};
+    hash = HashBytes(builder_parameters, sizeof(builder_parameters), hash);
+
+    for (const Triangle& this_triangle : triangles)
+    {
+        TrianglePosition this_position = this_triangle.GetTrianglePosition();
+        TriangleNormal this_normal = this_triangle.GetTriangleNormal();
+        TriangleIndices this_indices = this_triangle.GetTriangleIndices();
+
+        hash = HashBytes(&this_position, sizeof(TrianglePosition), hash);
+        hash = HashBytes(&this_normal, sizeof(TriangleNormal), hash);
+        hash = HashBytes(&this_indices, sizeof(TriangleIndices), hash);
+    }
+
+    return hash;
+}
+
+std::optional<OBBtree> OBBtreeCache::Load(uint64_t key) const
+{
+    if (not isEnabled)
+        return std::nullopt;
+
+    std::string path = GetPathOfKey(key);
+    std::error_code error_code;
+    if (not std::filesystem::exists(path, error_code))
+        return std::nullopt;
+
+    MappedFile mapped_file(path);
+    if (mapped_file.GetData() == nullptr || mapped_file.GetSize() < sizeof(FileHeader))
+        return std::nullopt;
+
+    FileHeader header;
+    std::memcpy(&header, mapped_file.GetData(), sizeof(FileHeader));
+
+    size_t expected_payload_size = sizeof(OBB) +
+                                   header.nodesCount * sizeof(OBBtree::OBBtreeNode) +
+                                   header.trianglesCount * (sizeof(TrianglePosition) + sizeof(TriangleNormal) + sizeof(TriangleIndices));
+
+    if (std::memcmp(header.magic, fileMagic, sizeof(fileMagic)) != 0 ||
+        header.formatVersion != fileFormatVersion ||
+        header.headerSize != sizeof(FileHeader) ||
+        header.key != key ||
+        header.payloadSize != expected_payload_size ||
+        mapped_file.GetSize() != sizeof(FileHeader) + header.payloadSize)
+    {
+        printf("OBBtree cache: ignoring invalid file %s\n", path.c_str());
+        return std::nullopt;
+    }
+
+    const std::byte* payload_ptr = mapped_file.GetData() + sizeof(FileHeader);
+    if (HashBytes(payload_ptr, header.payloadSize) != header.payloadChecksum)
+    {
+        printf("OBBtree cache: checksum mismatch at %s\n", path.c_str());
+        return std::nullopt;
+    }
+
+    OBBtree return_obb_tree;
+
+    const std::byte* read_ptr = payload_ptr;
+    std::memcpy(&return_obb_tree.root_obb, read_ptr, sizeof(OBB));
+    read_ptr += sizeof(OBB);
+
+    CopyArrayFromBytes(read_ptr, header.nodesCount, return_obb_tree.OBBtreeNodes);
+    CopyArrayFromBytes(read_ptr, header.trianglesCount, return_obb_tree.triangles_position);
+    CopyArrayFromBytes(read_ptr, header.trianglesCount, return_obb_tree.triangles_normal);
+    CopyArrayFromBytes(read_ptr, header.trianglesCount, return_obb_tree.triangles_indices);
+    assert(read_ptr == payload_ptr + header.payloadSize);
+
+    return return_obb_tree;
+}
+
+void OBBtreeCache::Store(uint64_t key, const OBBtree& obb_tree) const
+{
+    if (not isEnabled)
+        return;
+
+    size_t triangles_count = obb_tree.triangles_position.size();
+    assert(obb_tree.triangles_normal.size() == triangles_count && obb_tree.triangles_indices.size() == triangles_count);
+
+    FileHeader header = {};
+    std::memcpy(header.magic, fileMagic, sizeof(fileMagic));
+    header.formatVersion = fileFormatVersion;
+    header.headerSize = sizeof(FileHeader);
+    header.key = key;
+    header.nodesCount = obb_tree.OBBtreeNodes.size();
+    header.trianglesCount = triangles_count;
+    header.payloadSize = sizeof(OBB) +
+                         header.nodesCount * sizeof(OBBtree::OBBtreeNode) +
+                         header.trianglesCount * (sizeof(TrianglePosition) + sizeof(TriangleNormal) + sizeof(TriangleIndices));
+
+    uint64_t checksum = fnvOffsetBasis;
+    checksum = HashBytes(&obb_tree.root_obb, sizeof(OBB), checksum);
+    checksum = HashBytes(obb_tree.OBBtreeNodes.data(), obb_tree.OBBtreeNodes.size() * sizeof(OBBtree::OBBtreeNode), checksum);
+    checksum = HashBytes(obb_tree.triangles_position.data(), triangles_count * sizeof(TrianglePosition), checksum);
+    checksum = HashBytes(obb_tree.triangles_normal.data(), triangles_count * sizeof(TriangleNormal), checksum);
+    checksum = HashBytes(obb_tree.triangles_indices.data(), triangles_count * sizeof(TriangleIndices), checksum);
+    header.payloadChecksum = checksum;
+
+    // Written to a temporary file first, so a killed process does not leave a half written cache file
+    std::string path = GetPathOfKey(key);
+    std::string temporary_path = path + ".tmp";
+    std::error_code error_code;
+    {
+        std::ofstream file(temporary_path, std::ios::binary | std::ios::trunc);
+        if (not file.is_open())
+        {
+            std::filesystem::remove(temporary_path, error_code);
+            return;
+        }
+
+        file.write(reinterpret_cast<const char*>(&header), sizeof(FileHeader));
+        file.write(reinterpret_cast<const char*>(&obb_tree.root_obb), sizeof(OBB));
+        WriteArrayToFile(file, obb_tree.OBBtreeNodes);
+        WriteArrayToFile(file, obb_tree.triangles_position);
+        WriteArrayToFile(file, obb_tree.triangles_normal);
+        WriteArrayToFile(file, obb_tree.triangles_indices);
+
+        file.close();
+        if (not file)
+        {
+            printf("OBBtree cache: failed to write %s\n", temporary_path.c_str());
+            std::filesystem::remove(temporary_path, error_code);
+            return;
+        }
+    }
+
+    std::filesystem::rename(temporary_path, path, error_code);
+    if (error_code)
+        std::filesystem::remove(temporary_path, error_code);
+}
+
+std::string OBBtreeCache::GetPathOfKey(uint64_t key) const
+{
+    char key_hex[17];
+    snprintf(key_hex, sizeof(key_hex), "%016llx", static_cast<unsigned long long>(key));
+
+    return cacheFolder + "/" + key_hex + ".obbtree";
+}
+
+// FNV-1a
+uint64_t OBBtreeCache::HashBytes(const void* data, size_t size, uint64_t hash)
+{
+    const auto* bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; ++i)
+    {
+        hash ^= uint64_t(bytes[i]);
+        hash *= fnvPrime;
+    }
+
+    return hash;
+}
@@ -0,0 +1,270 @@
+#include "Geometry/OBBtreeSAHbuilder.h"
+
+#include <algorithm>
+#include <cassert>
+#include <limits>
+#include <numeric>
+
+#include "WorkersPool.h"
+
+OBBtreeSAHbuilder::Bin::Bin()
+{
+    min.fill(std::numeric_limits<float>::max());
+    max.fill(std::numeric_limits<float>::lowest());
+}
+
+void OBBtreeSAHbuilder::Bin::Grow(const Bin& other)
+{
+    for (size_t i = 0; i < 3; ++i)
+    {
+        min[i] = std::min(min[i], other.min[i]);
+        max[i] = std::max(max[i], other.max[i]);
+    }
+    count += other.count;
+}
+
+float OBBtreeSAHbuilder::Bin::GetSurface() const
+{
+    assert(count > 0);
+
+    float x = max[0] - min[0];
+    float y = max[1] - min[1];
+    float z = max[2] - min[2];
+
+    return 2.f * (x * y + y * z + z * x);
+}
+
+OBBtreeSAHbuilder::OBBtreeSAHbuilder(std::vector<Triangle>&& in_triangles, WorkersPool* in_workersPool_ptr)
+    :triangles(std::move(in_triangles)),
+     workersPool_ptr(in_workersPool_ptr)
+{
+    trianglesCentroid.reserve(triangles.size());
+    for (const Triangle& this_triangle : triangles)
+        trianglesCentroid.emplace_back((this_triangle.GetP(0) + this_triangle.GetP(1) + this_triangle.GetP(2)) / 3.f);
+
+    trianglesIndices.resize(triangles.size());
+    std::iota(trianglesIndices.begin(), trianglesIndices.end(), 0);
+
+    root_uptr = BuildRecursive(0, triangles.size());
+}
+
+std::unique_ptr<OBBtreeSAHbuilder::BuildNode> OBBtreeSAHbuilder::BuildRecursive(size_t first_index, size_t count)
+{
+    std::unique_ptr<BuildNode> node_uptr = std::make_unique<BuildNode>();
+    node_uptr->firstIndex = first_index;
+    node_uptr->count = count;
+    node_uptr->OBBvolume = CreateOBBofRange(first_index, count);
+
+    if (count <= OBBtree::GetMaxNumberOfTrianglesPerNode())
+        return node_uptr;
+
+    size_t left_count = PartitionBySAH(*node_uptr);
+    assert(left_count > 0 && left_count < count);
+
+    if (workersPool_ptr != nullptr && count >= parallelBuildMinTrianglesCount)
+    {
+        // Children own disjoint ranges of trianglesIndices
+        workersPool_ptr->RunTasks({[&]() {node_uptr->leftChild_uptr = BuildRecursive(first_index, left_count);},
+                                   [&]() {node_uptr->rightChild_uptr = BuildRecursive(first_index + left_count, count - left_count);}});
+    }
+    else
+    {
+        node_uptr->leftChild_uptr = BuildRecursive(first_index, left_count);
+        node_uptr->rightChild_uptr = BuildRecursive(first_index + left_count, count - left_count);
+    }
+
+    // left child should the highest ray-hit chance
+    if (node_uptr->rightChild_uptr->OBBvolume.GetSurface() > node_uptr->leftChild_uptr->OBBvolume.GetSurface())
+        std::swap(node_uptr->leftChild_uptr, node_uptr->rightChild_uptr);
+
+    return node_uptr;
+}
+
+// Returns the triangles count of the left part. Boxes of bins are at node's OBB axes, so their surfaces
+// approximate the surfaces of the children's OBBs without running PCA for every candidate split
+size_t OBBtreeSAHbuilder::PartitionBySAH(const BuildNode& node)
+{
+    std::array<glm::vec3, 3> node_axes = {node.OBBvolume.GetSideDirectionU(),
+                                          node.OBBvolume.GetSideDirectionV(),
+                                          node.OBBvolume.GetSideDirectionW()};
+    for (glm::vec3& this_axis : node_axes)
+    {
+        float length = glm::length(this_axis);
+        this_axis = (length > 0.f) ? this_axis / length : glm::vec3(0.f, 0.f, 0.f);
+    }
+
+    std::vector<Bin> triangles_boxes(node.count);
+    for (size_t i = 0; i < node.count; ++i)
+    {
+        const Triangle& this_triangle = triangles[trianglesIndices[node.firstIndex + i]];
+        for (size_t axis_index = 0; axis_index < 3; ++axis_index)
+        {
+            std::pair<float, float> min_max_projection = this_triangle.GetMinMaxProjectionToAxis(node_axes[axis_index]);
+            triangles_boxes[i].min[axis_index] = min_max_projection.first;
+            triangles_boxes[i].max[axis_index] = min_max_projection.second;
+        }
+        triangles_boxes[i].count = 1;
+    }
+
+    std::array<SplitAxis, 3> split_axes;
+    float best_cost = std::numeric_limits<float>::max();
+    size_t best_axis_index = std::numeric_limits<size_t>::max();
+    size_t best_bin_index = -1;
+
+    for (size_t axis_index = 0; axis_index < 3; ++axis_index)
+    {
+        float min_centroid_projection = std::numeric_limits<float>::max();
+        float max_centroid_projection = std::numeric_limits<float>::lowest();
+        for (size_t i = 0; i < node.count; ++i)
+        {
+            float centroid_projection = glm::dot(trianglesCentroid[trianglesIndices[node.firstIndex + i]], node_axes[axis_index]);
+            min_centroid_projection = std::min(min_centroid_projection, centroid_projection);
+            max_centroid_projection = std::max(max_centroid_projection, centroid_projection);
+        }
+
+        if (max_centroid_projection - min_centroid_projection <= 0.f)
+            continue;
+
+        SplitAxis& this_split_axis = split_axes[axis_index];
+        this_split_axis.axis = node_axes[axis_index];
+        this_split_axis.minCentroidProjection = min_centroid_projection;
+        this_split_axis.binsPerLength = float(binsCount) / (max_centroid_projection - min_centroid_projection);
+
+        std::array<Bin, binsCount> bins;
+        for (size_t i = 0; i < node.count; ++i)
+            bins[GetBinIndex(this_split_axis, trianglesIndices[node.firstIndex + i])].Grow(triangles_boxes[i]);
+
+        // Sweep from the left, then evaluate each split from the right
+        std::array<Bin, binsCount - 1> left_parts;
+        Bin left_accumulated;
+        for (size_t bin_index = 0; bin_index < binsCount - 1; ++bin_index)
+        {
+            left_accumulated.Grow(bins[bin_index]);
+            left_parts[bin_index] = left_accumulated;
+        }
+
+        Bin right_accumulated;
+        for (size_t bin_index = binsCount - 1; bin_index > 0; --bin_index)
+        {
+            right_accumulated.Grow(bins[bin_index]);
+
+            const Bin& left_part = left_parts[bin_index - 1];
+            if (left_part.count == 0 || right_accumulated.count == 0)
+                continue;
+
+            float cost = left_part.GetSurface() * float(left_part.count) + right_accumulated.GetSurface() * float(right_accumulated.count);
+            if (cost < best_cost)
+            {
+                best_cost = cost;
+                best_axis_index = axis_index;
+                best_bin_index = bin_index - 1;
+            }
+        }
+    }
+
+    // All centroids at the same point, fall back to halving the range
+    if (best_axis_index == std::numeric_limits<size_t>::max())
+        return node.count / 2;
+
+    auto begin_it = trianglesIndices.begin() + node.firstIndex;
+    auto middle_it = std::partition(begin_it, begin_it + node.count,
+                                    [&](uint32_t triangle_index) {return GetBinIndex(split_axes[best_axis_index], triangle_index) <= best_bin_index;});
+
+    return size_t(std::distance(begin_it, middle_it));
+}
+
+OBB OBBtreeSAHbuilder::CreateOBBofRange(size_t first_index, size_t count) const
+{
+    std::vector<glm::vec3> points;
+    points.reserve(3 * count);
+
+    for (size_t i = first_index; i < first_index + count; ++i)
+    {
+        const Triangle& this_triangle = triangles[trianglesIndices[i]];
+        points.emplace_back(this_triangle.GetP(0));
+        points.emplace_back(this_triangle.GetP(1));
+        points.emplace_back(this_triangle.GetP(2));
+    }
+
+    return OBB::CreateOBBfromPoints(points);
+}
+
+size_t OBBtreeSAHbuilder::GetBinIndex(const SplitAxis& split_axis, uint32_t triangle_index) const
+{
+    float centroid_projection = glm::dot(trianglesCentroid[triangle_index], split_axis.axis);
+    float bin_position = (centroid_projection - split_axis.minCentroidProjection) * split_axis.binsPerLength;
+
+    return std::min(size_t(std::max(bin_position, 0.f)), binsCount - 1);
+}
+
+void OBBtreeSAHbuilder::FlattenToOBBtree(OBBtree& obb_tree) const
+{
+    obb_tree.root_obb = root_uptr->OBBvolume;
+
+    obb_tree.triangles_position.reserve(triangles.size());
+    obb_tree.triangles_normal.reserve(triangles.size());
+    obb_tree.triangles_indices.reserve(triangles.size());
+
+    if (not root_uptr->IsLeaf())
+    {
+        obb_tree.OBBtreeNodes.emplace_back();
+
+        FlattenRecursive(*root_uptr->leftChild_uptr, 0, false, obb_tree);
+        FlattenRecursive(*root_uptr->rightChild_uptr, 0, true, obb_tree);
+    }
+    else
+    {
+        AddTrianglesOfLeaf(*root_uptr, obb_tree);
+    }
+}
+
+// Same depth-first order as OBBtree::ConstructDFSrecursive
+void OBBtreeSAHbuilder::FlattenRecursive(const BuildNode& node, size_t parent_index, bool is_right_child, OBBtree& obb_tree) const
+{
+    uint32_t index_or_triangle_offset;
+    uint16_t triangles_count;
+
+    if (not node.IsLeaf())
+    {
+        index_or_triangle_offset = uint32_t(obb_tree.OBBtreeNodes.size());
+        triangles_count = 0;
+        obb_tree.OBBtreeNodes.emplace_back();
+    }
+    else
+    {
+        index_or_triangle_offset = uint32_t(obb_tree.triangles_position.size());
+        triangles_count = uint16_t(node.count);
+        AddTrianglesOfLeaf(node, obb_tree);
+    }
+
+    OBBtree::OBBtreeNode& parent_node = obb_tree.OBBtreeNodes[parent_index];
+    if (not is_right_child)
+    {
+        parent_node.left_child_index_or_triangle_offset = index_or_triangle_offset;
+        parent_node.left_triangles_count = triangles_count;
+        parent_node.left_child_obb = node.OBBvolume;
+    }
+    else
+    {
+        parent_node.right_child_index_or_triangle_offset = index_or_triangle_offset;
+        parent_node.right_triangles_count = triangles_count;
+        parent_node.right_child_obb = node.OBBvolume;
+    }
+
+    if (not node.IsLeaf())
+    {
+        FlattenRecursive(*node.leftChild_uptr, index_or_triangle_offset, false, obb_tree);
+        FlattenRecursive(*node.rightChild_uptr, index_or_triangle_offset, true, obb_tree);
+    }
+}
+
+void OBBtreeSAHbuilder::AddTrianglesOfLeaf(const BuildNode& node, OBBtree& obb_tree) const
+{
+    for (size_t i = node.firstIndex; i < node.firstIndex + node.count; ++i)
+    {
+        const Triangle& this_triangle = triangles[trianglesIndices[i]];
+        obb_tree.triangles_position.emplace_back(this_triangle.GetTrianglePosition());
+        obb_tree.triangles_normal.emplace_back(this_triangle.GetTriangleNormal());
+        obb_tree.triangles_indices.emplace_back(this_triangle.GetTriangleIndices());
+    }
+}
@@ -1,6 +1,12 @@
 #include "Geometry/Paralgram.h"
 
 
+Paralgram::Paralgram(glm::vec3 in_center, glm::vec3 in_side_direction_u, glm::vec3 in_side_direction_v, glm::vec3 in_side_direction_w)
+    :center(in_center),
+     sideDirections{in_side_direction_u, in_side_direction_v, in_side_direction_w}
+{
+}
+
 Paralgram Paralgram::MultiplyBy4x4Matrix(const glm::mat4x4& in_matrix, const Paralgram& rhs)
 {
     Paralgram return_paralgram;
@@ -172,6 +178,29 @@ bool Paralgram::IntersectParalgramsBoolean(const Paralgram& lhs, const Paralgram
     return true;
 }
 
+SweepIntersectInfo Paralgram::SweepParalgrams(const Paralgram& lhs, const glm::vec3& lhs_displacement, const Paralgram& rhs)
+{
+    SweepInterval sweep_interval(lhs_displacement);
+
+    const glm::vec3 lhs_sides[3] = {lhs.sideDirections.u, lhs.sideDirections.v, lhs.sideDirections.w};
+    const glm::vec3 rhs_sides[3] = {rhs.sideDirections.u, rhs.sideDirections.v, rhs.sideDirections.w};
+
+    // lhs and rhs faces
+    if (not sweep_interval.AddAxis(glm::cross(lhs_sides[1], lhs_sides[2]), lhs, rhs)) return {};
+    if (not sweep_interval.AddAxis(glm::cross(lhs_sides[0], lhs_sides[2]), lhs, rhs)) return {};
+    if (not sweep_interval.AddAxis(glm::cross(lhs_sides[0], lhs_sides[1]), lhs, rhs)) return {};
+    if (not sweep_interval.AddAxis(glm::cross(rhs_sides[1], rhs_sides[2]), lhs, rhs)) return {};
+    if (not sweep_interval.AddAxis(glm::cross(rhs_sides[0], rhs_sides[2]), lhs, rhs)) return {};
+    if (not sweep_interval.AddAxis(glm::cross(rhs_sides[0], rhs_sides[1]), lhs, rhs)) return {};
+
+    // cross products of sides
+    for (const glm::vec3& lhs_side : lhs_sides)
+        for (const glm::vec3& rhs_side : rhs_sides)
+            if (not sweep_interval.AddCrossAxis(lhs_side, rhs_side, lhs, rhs)) return {};
+
+    return sweep_interval.GetInfo();
+}
+
 std::pair<float, float> Paralgram::GetMinMaxProjectionToAxis(const glm::vec3& in_axis) const
 {
     float center_projection = GetCenterProjectionToAxis(in_axis);
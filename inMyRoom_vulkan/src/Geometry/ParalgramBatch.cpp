@@ -0,0 +1,151 @@
+#include "Geometry/ParalgramBatch.h"
+
+#include <cassert>
+#include <cmath>
+
+#include "Geometry/FloatLanes.h"
+
+namespace
+{
+    template<typename F>
+    struct ParalgramLanes
+    {
+        LanesVec3<F> center;
+        LanesVec3<F> u;
+        LanesVec3<F> v;
+        LanesVec3<F> w;
+
+        void GetMinMaxProjectionToAxis(const LanesVec3<F>& axis, F& min, F& max) const
+        {
+            F center_projection = Dot(center, axis);
+            F directions_projections_sum = Abs(Dot(axis, u)) + Abs(Dot(axis, v)) + Abs(Dot(axis, w));
+
+            min = center_projection - directions_projections_sum;
+            max = center_projection + directions_projections_sum;
+        }
+    };
+
+    // The 15 axes of Paralgram::IntersectParalgramsBoolean, returns early when no lane of "lanes_mask" is left
+    template<typename F>
+    uint32_t IntersectParalgramLanes(const ParalgramLanes<F>& lhs, const ParalgramLanes<F>& rhs, uint32_t lanes_mask)
+    {
+        auto is_any_lane_left_at_axis = [&](const LanesVec3<F>& axis) -> bool
+        {
+            F lhs_min, lhs_max, rhs_min, rhs_max;
+            lhs.GetMinMaxProjectionToAxis(axis, lhs_min, lhs_max);
+            rhs.GetMinMaxProjectionToAxis(axis, rhs_min, rhs_max);
+
+            lanes_mask &= OverlapMask(lhs_min, lhs_max, rhs_min, rhs_max);
+            return lanes_mask != 0;
+        };
+
+        // lhs based tests
+        if (not is_any_lane_left_at_axis(Cross(lhs.v, lhs.w))) return 0;
+        if (not is_any_lane_left_at_axis(Cross(lhs.u, lhs.w))) return 0;
+        if (not is_any_lane_left_at_axis(Cross(lhs.u, lhs.v))) return 0;
+
+        // rhs based tests
+        if (not is_any_lane_left_at_axis(Cross(rhs.v, rhs.w))) return 0;
+        if (not is_any_lane_left_at_axis(Cross(rhs.u, rhs.w))) return 0;
+        if (not is_any_lane_left_at_axis(Cross(rhs.u, rhs.v))) return 0;
+
+        // cross product based tests
+        if (not is_any_lane_left_at_axis(Cross(lhs.u, rhs.u))) return 0;
+        if (not is_any_lane_left_at_axis(Cross(lhs.u, rhs.v))) return 0;
+        if (not is_any_lane_left_at_axis(Cross(lhs.u, rhs.w))) return 0;
+        if (not is_any_lane_left_at_axis(Cross(lhs.v, rhs.u))) return 0;
+        if (not is_any_lane_left_at_axis(Cross(lhs.v, rhs.v))) return 0;
+        if (not is_any_lane_left_at_axis(Cross(lhs.v, rhs.w))) return 0;
+        if (not is_any_lane_left_at_axis(Cross(lhs.w, rhs.u))) return 0;
+        if (not is_any_lane_left_at_axis(Cross(lhs.w, rhs.v))) return 0;
+        if (not is_any_lane_left_at_axis(Cross(lhs.w, rhs.w))) return 0;
+
+        return lanes_mask;
+    }
+
+    template<typename F>
+    ParalgramLanes<F> BroadcastParalgram(const Paralgram& paralgram)
+    {
+        return {LanesVec3<F>::Broadcast(paralgram.GetCenter()),
+                LanesVec3<F>::Broadcast(paralgram.GetSideDirectionU()),
+                LanesVec3<F>::Broadcast(paralgram.GetSideDirectionV()),
+                LanesVec3<F>::Broadcast(paralgram.GetSideDirectionW())};
+    }
+}
+
+void ParalgramBatch::Clear()
+{
+    size = 0;
+}
+
+void ParalgramBatch::Add(const Paralgram& paralgram)
+{
+    assert(size < width);
+
+    Set(size++, paralgram);
+}
+
+void ParalgramBatch::Set(size_t index, const Paralgram& paralgram)
+{
+    assert(index < size);
+
+    auto set_vec3 = [index](Vec3Lanes& lanes, const glm::vec3& in_vec)
+    {
+        lanes.x.values[index] = in_vec.x;
+        lanes.y.values[index] = in_vec.y;
+        lanes.z.values[index] = in_vec.z;
+    };
+
+    set_vec3(centers, paralgram.GetCenter());
+    set_vec3(sideDirectionsU, paralgram.GetSideDirectionU());
+    set_vec3(sideDirectionsV, paralgram.GetSideDirectionV());
+    set_vec3(sideDirectionsW, paralgram.GetSideDirectionW());
+}
+
+uint32_t ParalgramBatch::IntersectParalgramBoolean(const Paralgram& lhs) const
+{
+    if (size == 0)
+        return 0;
+
+#if defined(__AVX__) || defined(__SSE__)
+    auto load_vec3 = [](const Vec3Lanes& lanes) -> LanesVec3<SimdFloat>
+    {
+        return {SimdFloat::Load(lanes.x.values), SimdFloat::Load(lanes.y.values), SimdFloat::Load(lanes.z.values)};
+    };
+
+    ParalgramLanes<SimdFloat> lhs_lanes = BroadcastParalgram<SimdFloat>(lhs);
+    ParalgramLanes<SimdFloat> rhs_lanes = {load_vec3(centers),
+                                           load_vec3(sideDirectionsU),
+                                           load_vec3(sideDirectionsV),
+                                           load_vec3(sideDirectionsW)};
+
+    uint32_t lanes_mask = (1u << size) - 1u;
+
+    return IntersectParalgramLanes(lhs_lanes, rhs_lanes, lanes_mask);
+#else
+    return IntersectParalgramBooleanScalar(lhs);
+#endif
+}
+
+uint32_t ParalgramBatch::IntersectParalgramBooleanScalar(const Paralgram& lhs) const
+{
+    ParalgramLanes<ScalarFloat> lhs_lane = BroadcastParalgram<ScalarFloat>(lhs);
+
+    uint32_t return_mask = 0;
+    for (size_t index = 0; index < size; ++index)
+    {
+        auto load_vec3 = [index](const Vec3Lanes& lanes) -> LanesVec3<ScalarFloat>
+        {
+            return {ScalarFloat::Load(&lanes.x.values[index]), ScalarFloat::Load(&lanes.y.values[index]), ScalarFloat::Load(&lanes.z.values[index])};
+        };
+
+        ParalgramLanes<ScalarFloat> rhs_lane = {load_vec3(centers),
+                                                load_vec3(sideDirectionsU),
+                                                load_vec3(sideDirectionsV),
+                                                load_vec3(sideDirectionsW)};
+
+        return_mask |= IntersectParalgramLanes(lhs_lane, rhs_lane, 1u) << index;
+    }
+
+    return return_mask;
+}
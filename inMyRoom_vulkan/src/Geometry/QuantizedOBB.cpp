@@ -0,0 +1,149 @@
+#include "Geometry/QuantizedOBB.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace
+{
+    constexpr float snormMax = 32767.f;
+    constexpr float unormMax = 65535.f;
+    constexpr float minScale = 1.e-20f;
+
+    // Orthonormal U, V of the paralgram's frame, longest side first. Flat or empty paralgrams get any perpendicular axes
+    void GetOrthonormalAxes(const Paralgram& paralgram, glm::vec3& axis_u, glm::vec3& axis_v)
+    {
+        std::array<glm::vec3, 3> sides = {paralgram.GetSideDirectionU(), paralgram.GetSideDirectionV(), paralgram.GetSideDirectionW()};
+        std::sort(sides.begin(), sides.end(),
+                  [](const glm::vec3& lhs, const glm::vec3& rhs) {return glm::dot(lhs, lhs) > glm::dot(rhs, rhs);});
+
+        float longest_length = glm::length(sides[0]);
+        axis_u = (longest_length > 0.f) ? sides[0] / longest_length : glm::vec3(1.f, 0.f, 0.f);
+
+        for (size_t i = 1; i < 3; ++i)
+        {
+            glm::vec3 perpendicular = sides[i] - glm::dot(sides[i], axis_u) * axis_u;
+            float perpendicular_length = glm::length(perpendicular);
+            if (perpendicular_length > 1.e-4f * longest_length && perpendicular_length > 0.f)
+            {
+                axis_v = perpendicular / perpendicular_length;
+                return;
+            }
+        }
+
+        glm::vec3 helper = (std::abs(axis_u.x) < 0.9f) ? glm::vec3(1.f, 0.f, 0.f) : glm::vec3(0.f, 1.f, 0.f);
+        axis_v = glm::normalize(helper - glm::dot(helper, axis_u) * axis_u);
+    }
+
+    int16_t QuantizeSnorm(float value)
+    {
+        return int16_t(std::lround(std::clamp(value, -1.f, 1.f) * snormMax));
+    }
+}
+
+QuantizedOBB QuantizedOBB::Quantize(const Paralgram& paralgram, glm::vec3 parent_center, float scale)
+{
+    assert(scale > 0.f);
+
+    QuantizedOBB return_quantized_obb;
+
+    glm::vec3 center_offset = (paralgram.GetCenter() - parent_center) / scale;
+    return_quantized_obb.centerOffset = {QuantizeSnorm(center_offset.x), QuantizeSnorm(center_offset.y), QuantizeSnorm(center_offset.z)};
+
+    glm::vec3 axis_u, axis_v;
+    GetOrthonormalAxes(paralgram, axis_u, axis_v);
+    return_quantized_obb.axisU = EncodeOctahedral(axis_u);
+    return_quantized_obb.axisV = EncodeOctahedral(axis_v);
+
+    // Half lengths that make the quantized frame contain the original paralgram
+    glm::vec3 dequantized_center = parent_center + glm::vec3(float(return_quantized_obb.centerOffset[0]),
+                                                             float(return_quantized_obb.centerOffset[1]),
+                                                             float(return_quantized_obb.centerOffset[2])) * (scale / snormMax);
+    glm::vec3 center_error = paralgram.GetCenter() - dequantized_center;
+
+    std::array<glm::vec3, 3> dequantized_axes;
+    DequantizeAxes(return_quantized_obb.axisU, return_quantized_obb.axisV, dequantized_axes[0], dequantized_axes[1], dequantized_axes[2]);
+
+    for (size_t i = 0; i < 3; ++i)
+    {
+        float needed_half_length = std::abs(glm::dot(center_error, dequantized_axes[i]))
+                                   + std::abs(glm::dot(paralgram.GetSideDirectionU(), dequantized_axes[i]))
+                                   + std::abs(glm::dot(paralgram.GetSideDirectionV(), dequantized_axes[i]))
+                                   + std::abs(glm::dot(paralgram.GetSideDirectionW(), dequantized_axes[i]));
+
+        float quantized_half_length = std::ceil(needed_half_length / scale * unormMax) + 1.f;
+        assert(quantized_half_length <= unormMax);
+        return_quantized_obb.halfLengths[i] = uint16_t(std::min(quantized_half_length, unormMax));
+    }
+
+    return return_quantized_obb;
+}
+
+Paralgram QuantizedOBB::Dequantize(glm::vec3 parent_center, float scale) const
+{
+    glm::vec3 center = parent_center + glm::vec3(float(centerOffset[0]),
+                                                 float(centerOffset[1]),
+                                                 float(centerOffset[2])) * (scale / snormMax);
+
+    glm::vec3 u, v, w;
+    DequantizeAxes(axisU, axisV, u, v, w);
+
+    float half_length_factor = scale / unormMax;
+    return Paralgram(center,
+                     u * (float(halfLengths[0]) * half_length_factor),
+                     v * (float(halfLengths[1]) * half_length_factor),
+                     w * (float(halfLengths[2]) * half_length_factor));
+}
+
+// Fits center offset and half lengths (with margin for quantization errors) of the paralgram
+float QuantizedOBB::GetQuantizationScale(const Paralgram& paralgram, glm::vec3 parent_center)
+{
+    glm::vec3 center_offset = paralgram.GetCenter() - parent_center;
+    float max_center_offset = std::max({std::abs(center_offset.x), std::abs(center_offset.y), std::abs(center_offset.z)});
+
+    float sides_length_sum = glm::length(paralgram.GetSideDirectionU())
+                             + glm::length(paralgram.GetSideDirectionV())
+                             + glm::length(paralgram.GetSideDirectionW());
+
+    return std::max({max_center_offset, sides_length_sum * 1.001f, minScale});
+}
+
+std::array<int16_t, 2> QuantizedOBB::EncodeOctahedral(glm::vec3 unit_vector)
+{
+    float l1_norm = std::abs(unit_vector.x) + std::abs(unit_vector.y) + std::abs(unit_vector.z);
+    float x = unit_vector.x / l1_norm;
+    float y = unit_vector.y / l1_norm;
+
+    if (unit_vector.z < 0.f)
+    {
+        float folded_x = (1.f - std::abs(y)) * (x >= 0.f ? 1.f : -1.f);
+        float folded_y = (1.f - std::abs(x)) * (y >= 0.f ? 1.f : -1.f);
+        x = folded_x;
+        y = folded_y;
+    }
+
+    return {QuantizeSnorm(x), QuantizeSnorm(y)};
+}
+
+glm::vec3 QuantizedOBB::DecodeOctahedral(std::array<int16_t, 2> encoded)
+{
+    float x = float(encoded[0]) / snormMax;
+    float y = float(encoded[1]) / snormMax;
+    float z = 1.f - std::abs(x) - std::abs(y);
+
+    float fold = std::max(-z, 0.f);
+    x += (x >= 0.f) ? -fold : fold;
+    y += (y >= 0.f) ? -fold : fold;
+
+    return glm::normalize(glm::vec3(x, y, z));
+}
+
+// Decoded V is made orthogonal to U again, as quantization bends it slightly
+void QuantizedOBB::DequantizeAxes(const std::array<int16_t, 2>& axis_u, const std::array<int16_t, 2>& axis_v,
+                                  glm::vec3& u, glm::vec3& v, glm::vec3& w)
+{
+    u = DecodeOctahedral(axis_u);
+    v = DecodeOctahedral(axis_v);
+    v = glm::normalize(v - glm::dot(v, u) * u);
+    w = glm::cross(u, v);
+}
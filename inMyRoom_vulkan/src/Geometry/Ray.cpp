@@ -2,6 +2,10 @@
 #include "glm/gtx/intersect.hpp"
 
 #include <algorithm>
+#include <array>
+#include <vector>
+
+#include "glm/gtc/matrix_inverse.hpp"
 
 Ray::Ray(const glm::vec3& in_origin, const glm::vec3& in_direction)
     :
@@ -132,106 +136,174 @@ std::pair<bool, std::pair<float, float>> Ray::IntersectParalgram(const Paralgram
     return {true, {min_distance, max_distance}};
 }
 
+// The ray is moved to the tree's space once, instead of moving every visited OBB and triangle to world space.
+// Direction is not normalized there, so distances along it stay the same under non-uniform scale
 RayOBBtreeIntersectInfo Ray::IntersectOBBtree(const OBBtree& obb_tree, const glm::mat4x4& matrix) const
 {
+    glm::mat4x4 inverse_matrix = glm::inverse(matrix);
 
-    if (origin == glm::vec3(0.f, 0.f, 0.f)) {
-        RayOBBtreeIntersectInfo return_intersect_info = {};
+    Ray local_ray = {glm::vec3(inverse_matrix * glm::vec4(origin, 1.f)),
+                     glm::vec3(inverse_matrix * glm::vec4(direction, 0.f))};
 
-        OBBtree::OBBtreeTraveler root_traveler = obb_tree.GetRootTraveler();
+    RayOBBtreeIntersectInfo return_intersect_info = local_ray.IntersectOBBtreeLocal(obb_tree);
 
-        Paralgram root_paralgram = matrix * root_traveler.GetOBB();
-        std::pair<bool, std::pair<float, float>> root_paralgram_intersect = IntersectParalgram(root_paralgram);
+    // Mirroring matrices flip the winding of the triangles
+    if (glm::determinant(glm::mat3(matrix)) < 0.f)
+        return_intersect_info.itBackfaces = not return_intersect_info.itBackfaces;
 
-        if (root_paralgram_intersect.first && root_paralgram_intersect.second.second >= 0.f) {
-            IntersectOBBtreeRecursive(root_traveler, obb_tree, matrix, return_intersect_info);
-        }
+    return return_intersect_info;
+}
+
+RayOBBtreeIntersectInfo Ray::IntersectOBBtreeLocal(const OBBtree& obb_tree) const
+{
+    RayOBBtreeIntersectInfo return_intersect_info = {};
 
+    std::pair<bool, std::pair<float, float>> root_paralgram_intersect = IntersectOBB(obb_tree.root_obb);
+    if (not root_paralgram_intersect.first || root_paralgram_intersect.second.second < 0.f)
         return return_intersect_info;
-    } else {
-        Ray centered_ray = {glm::vec3(0.f, 0.f, 0.f) , direction};
-        glm::mat4x4 centered_matrix = matrix;
-        centered_matrix[3] -= glm::vec4(origin, 0.f);
 
-        return centered_ray.IntersectOBBtree(obb_tree, centered_matrix);
+    if (obb_tree.OBBtreeNodes.empty())
+    {
+        IntersectTrianglesRange(obb_tree, 0, obb_tree.triangles_position.size(), return_intersect_info);
+        return return_intersect_info;
     }
-   
 
-}
+    struct StackEntry
+    {
+        uint32_t index_or_triangle_offset;
+        uint16_t triangles_count;
+        float min_distance;
+    };
 
-void Ray::IntersectOBBtreeRecursive(const OBBtree::OBBtreeTraveler& obb_tree_traveler,
-                           const OBBtree& obb_tree,
-                           const glm::mat4x4& matrix,
-                           RayOBBtreeIntersectInfo& best_intersection_so_far_info) const
-{
-    if (not obb_tree_traveler.IsLeaf())
+    // Only far children are pushed, so the stack stays as deep as the tree. Kept per thread to not allocate at every ray
+    thread_local std::vector<StackEntry> stack;
+    stack.clear();
+    stack.push_back({0, 0, root_paralgram_intersect.second.first});
+
+    while (not stack.empty())
     {
-        OBBtree::OBBtreeTraveler left_child_traveler = obb_tree_traveler.GetLeftChildTraveler();
-        OBBtree::OBBtreeTraveler right_child_traveler = obb_tree_traveler.GetRightChildTraveler();
+        StackEntry this_entry = stack.back();
+        stack.pop_back();
+
+        // Boxes entered exactly at the best distance may still hold a lower indexed triangle of the same distance
+        if (this_entry.min_distance > return_intersect_info.distanceFromOrigin)
+            continue;
+
+        if (this_entry.triangles_count != 0)
+        {
+            IntersectTrianglesRange(obb_tree, this_entry.index_or_triangle_offset, this_entry.triangles_count, return_intersect_info);
+            continue;
+        }
 
-        Paralgram left_paralgram = matrix * left_child_traveler.GetOBB();
-        Paralgram right_paralgram = matrix * right_child_traveler.GetOBB();
+        const OBBtree::OBBtreeNode& this_node = obb_tree.OBBtreeNodes[this_entry.index_or_triangle_offset];
 
-        std::pair<bool, std::pair<float, float>> left_paralgram_booleanMinMax = IntersectParalgram(left_paralgram);
-        std::pair<bool, std::pair<float, float>> right_paralgram_booleanMinMax = IntersectParalgram(right_paralgram);
+        std::pair<bool, std::pair<float, float>> left_paralgram_booleanMinMax = IntersectOBB(this_node.left_child_obb);
+        std::pair<bool, std::pair<float, float>> right_paralgram_booleanMinMax = IntersectOBB(this_node.right_child_obb);
 
-        if (left_paralgram_booleanMinMax.first && right_paralgram_booleanMinMax.first)
+        bool should_visit_left = left_paralgram_booleanMinMax.first &&
+                                 left_paralgram_booleanMinMax.second.second >= 0.f &&
+                                 left_paralgram_booleanMinMax.second.first <= return_intersect_info.distanceFromOrigin;
+        bool should_visit_right = right_paralgram_booleanMinMax.first &&
+                                  right_paralgram_booleanMinMax.second.second >= 0.f &&
+                                  right_paralgram_booleanMinMax.second.first <= return_intersect_info.distanceFromOrigin;
+
+        StackEntry left_entry = {this_node.left_child_index_or_triangle_offset, this_node.left_triangles_count, left_paralgram_booleanMinMax.second.first};
+        StackEntry right_entry = {this_node.right_child_index_or_triangle_offset, this_node.right_triangles_count, right_paralgram_booleanMinMax.second.first};
+
+        if (should_visit_left && should_visit_right)
         {
-            if (left_paralgram_booleanMinMax.second.first < right_paralgram_booleanMinMax.second.first)
+            // Nearest child on top
+            if (left_entry.min_distance < right_entry.min_distance)
             {
-                if (left_paralgram_booleanMinMax.second.first < best_intersection_so_far_info.distanceFromOrigin && left_paralgram_booleanMinMax.second.second >= 0.f)
-                {
-                    IntersectOBBtreeRecursive(left_child_traveler, obb_tree, matrix, best_intersection_so_far_info);
-                }
-                if (right_paralgram_booleanMinMax.second.first < best_intersection_so_far_info.distanceFromOrigin && right_paralgram_booleanMinMax.second.second >= 0.f)
-                {
-                    IntersectOBBtreeRecursive(right_child_traveler, obb_tree, matrix, best_intersection_so_far_info);
-                }
+                stack.push_back(right_entry);
+                stack.push_back(left_entry);
             }
             else
             {
-                if (right_paralgram_booleanMinMax.second.first < best_intersection_so_far_info.distanceFromOrigin && right_paralgram_booleanMinMax.second.second >= 0.f)
-                {
-                    IntersectOBBtreeRecursive(right_child_traveler, obb_tree, matrix, best_intersection_so_far_info);
-                }
-                if (left_paralgram_booleanMinMax.second.first < best_intersection_so_far_info.distanceFromOrigin && left_paralgram_booleanMinMax.second.second >= 0.f)
-                {
-                    IntersectOBBtreeRecursive(left_child_traveler, obb_tree, matrix, best_intersection_so_far_info);
-                }
+                stack.push_back(left_entry);
+                stack.push_back(right_entry);
             }
         }
-        else if (left_paralgram_booleanMinMax.first)
+        else if (should_visit_left)
         {
-            if (left_paralgram_booleanMinMax.second.first < best_intersection_so_far_info.distanceFromOrigin && left_paralgram_booleanMinMax.second.second >= 0.f)
-            {
-                IntersectOBBtreeRecursive(left_child_traveler, obb_tree, matrix, best_intersection_so_far_info);
-            }
+            stack.push_back(left_entry);
         }
-        else if (right_paralgram_booleanMinMax.first)
+        else if (should_visit_right)
         {
-            if (right_paralgram_booleanMinMax.second.first < best_intersection_so_far_info.distanceFromOrigin && right_paralgram_booleanMinMax.second.second >= 0.f)
-            {
-                IntersectOBBtreeRecursive(right_child_traveler, obb_tree, matrix, best_intersection_so_far_info);
-            }
+            stack.push_back(right_entry);
         }
     }
-    else
+
+    return return_intersect_info;
+}
+
+// OBBs keep their sides orthogonal in the tree's space, so each side is the normal of its own pair of planes.
+// Distances are measured along the unnormalized side, which avoids the cross products and square roots.
+// Slabs are widened by a few rounding errors: triangles lie on their boxes' faces, and a ray along a face or through a
+// shared edge must still reach every triangle that it hits, else ties would depend on which boxes rounded in
+std::pair<bool, std::pair<float, float>> Ray::IntersectOBB(const OBB& obb) const
+{
+    constexpr float slab_margin = 1.e-5f;
+
+    float min_distance = -std::numeric_limits<float>::infinity();
+    float max_distance = +std::numeric_limits<float>::infinity();
+
+    glm::vec3 ray_origin = origin - obb.GetCenter();
+
+    std::array<glm::vec3, 3> sides = {obb.GetSideDirectionU(), obb.GetSideDirectionV(), obb.GetSideDirectionW()};
+    for (size_t i = 0; i < 3; ++i)
     {
-        for (size_t i = obb_tree_traveler.GetTrianglesOffset(); i != obb_tree_traveler.GetTrianglesOffset() + obb_tree_traveler.GetTrianglesCount(); ++i)
-        {
-            TrianglePosition this_triangle = matrix * obb_tree.GetTrianglePosition(i);
-            RayTriangleIntersectInfo interseption_result = IntersectTriangle(this_triangle);
+        glm::vec3 plane_dir = sides[i];
+        float half_length = glm::dot(plane_dir, plane_dir);
 
-            if (interseption_result.doIntersect &&
-                interseption_result.distanceFromOrigin > 0.f &&
-                interseption_result.distanceFromOrigin < best_intersection_so_far_info.distanceFromOrigin )
-            {
-                best_intersection_so_far_info.doIntersect = true;
-                best_intersection_so_far_info.itBackfaces = interseption_result.itBackfaces;
-                best_intersection_so_far_info.distanceFromOrigin = interseption_result.distanceFromOrigin;
-                best_intersection_so_far_info.triangle_index = i;
-                best_intersection_so_far_info.baryPosition = interseption_result.baryPosition;
-            }             
+        // Flat side, the slab is the plane of the other two
+        if (half_length == 0.f)
+            plane_dir = glm::cross(sides[(i + 1) % 3], sides[(i + 2) % 3]);
+
+        float plane_has_center_dist = glm::dot(plane_dir, ray_origin);
+        float vd = glm::dot(plane_dir, direction);
+
+        float slab_half_length = half_length + slab_margin * (half_length + std::abs(plane_has_center_dist));
+
+        if (vd != 0.f) [[likely]] {
+
+            float vd_inv = 1.f / vd;
+            float t1 = (- slab_half_length - plane_has_center_dist) * vd_inv;
+            float t2 = (+ slab_half_length - plane_has_center_dist) * vd_inv;
+
+            if (t1 > t2) std::swap(t1, t2);
+
+            min_distance = std::max(t1, min_distance);
+            max_distance = std::min(t2, max_distance);
+
+            if (min_distance > max_distance || max_distance < 0.f)
+                return {false, {0.f, 0.f}};
+
+        } else if (std::abs(plane_has_center_dist) > slab_half_length)
+            return {false, {0.f, 0.f}};
+    }
+
+    return {true, {min_distance, max_distance}};
+}
+
+// Nearest distance wins, ties go to the lowest triangle index, so the hit does not depend on the order nodes are visited
+void Ray::IntersectTrianglesRange(const OBBtree& obb_tree, size_t triangles_offset, size_t triangles_count,
+                                  RayOBBtreeIntersectInfo& best_intersection_so_far_info) const
+{
+    for (size_t i = triangles_offset; i != triangles_offset + triangles_count; ++i)
+    {
+        RayTriangleIntersectInfo interseption_result = IntersectTriangle(obb_tree.triangles_position[i]);
+
+        if (interseption_result.doIntersect &&
+            interseption_result.distanceFromOrigin > 0.f &&
+            (interseption_result.distanceFromOrigin < best_intersection_so_far_info.distanceFromOrigin ||
+             (interseption_result.distanceFromOrigin == best_intersection_so_far_info.distanceFromOrigin && i < best_intersection_so_far_info.triangle_index)))
+        {
+            best_intersection_so_far_info.doIntersect = true;
+            best_intersection_so_far_info.itBackfaces = interseption_result.itBackfaces;
+            best_intersection_so_far_info.distanceFromOrigin = interseption_result.distanceFromOrigin;
+            best_intersection_so_far_info.triangle_index = i;
+            best_intersection_so_far_info.baryPosition = interseption_result.baryPosition;
         }
     }
-}
\ No newline at end of file
+}
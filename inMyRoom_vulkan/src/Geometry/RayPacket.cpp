@@ -0,0 +1,372 @@
+#include "Geometry/RayPacket.h"
+
+#include <bit>
+#include <cassert>
+#include <limits>
+
+#include "glm/gtc/matrix_inverse.hpp"
+
+#include "Geometry/FloatLanes.h"
+
+namespace
+{
+    template<typename F>
+    struct RayLanes
+    {
+        LanesVec3<F> origin;
+        LanesVec3<F> direction;
+    };
+
+    // Same as Ray::IntersectOBB for every lane, widened slabs included. Returns the lanes that enter the box not after
+    // "best_distances", and their entry distances
+    template<typename F>
+    uint32_t IntersectOBBLanes(const OBB& obb, const RayLanes<F>& rays, F best_distances, F& min_distances)
+    {
+        const F slab_margin = F::Broadcast(1.e-5f);
+
+        F min_distance = F::Broadcast(-std::numeric_limits<float>::infinity());
+        F max_distance = F::Broadcast(+std::numeric_limits<float>::infinity());
+        typename F::Mask parallel_outside_mask = F::MaskFromBits(0);
+
+        LanesVec3<F> ray_origin = rays.origin - LanesVec3<F>::Broadcast(obb.GetCenter());
+
+        std::array<glm::vec3, 3> sides = {obb.GetSideDirectionU(), obb.GetSideDirectionV(), obb.GetSideDirectionW()};
+        for (size_t i = 0; i < 3; ++i)
+        {
+            glm::vec3 plane_dir = sides[i];
+            float half_length = glm::dot(plane_dir, plane_dir);
+
+            if (half_length == 0.f)
+                plane_dir = glm::cross(sides[(i + 1) % 3], sides[(i + 2) % 3]);
+
+            LanesVec3<F> plane_dir_lanes = LanesVec3<F>::Broadcast(plane_dir);
+            F half_length_lanes = F::Broadcast(half_length);
+
+            F plane_has_center_dist = Dot(plane_dir_lanes, ray_origin);
+            F vd = Dot(plane_dir_lanes, rays.direction);
+
+            F slab_half_length = half_length_lanes + slab_margin * (half_length_lanes + Abs(plane_has_center_dist));
+
+            // Parallel lanes miss when outside the slab, otherwise the slab does not limit them
+            typename F::Mask is_parallel = (vd >= F::Broadcast(0.f)) & (vd <= F::Broadcast(0.f));
+            parallel_outside_mask = parallel_outside_mask | (is_parallel & (Abs(plane_has_center_dist) > slab_half_length));
+
+            F vd_inv = F::Broadcast(1.f) / vd;
+            F t1 = (F::Broadcast(0.f) - slab_half_length - plane_has_center_dist) * vd_inv;
+            F t2 = (slab_half_length - plane_has_center_dist) * vd_inv;
+
+            F near_t = Select(is_parallel, F::Broadcast(-std::numeric_limits<float>::infinity()), Min(t1, t2));
+            F far_t = Select(is_parallel, F::Broadcast(+std::numeric_limits<float>::infinity()), Max(t1, t2));
+
+            min_distance = Max(near_t, min_distance);
+            max_distance = Min(far_t, max_distance);
+        }
+
+        min_distances = min_distance;
+
+        uint32_t miss_bits = MoveMask((min_distance > max_distance) | (max_distance < F::Broadcast(0.f)) | parallel_outside_mask);
+        uint32_t before_best_bits = MoveMask(min_distance <= best_distances);
+
+        return before_best_bits & ~miss_bits;
+    }
+
+    // Same operations as glm::intersectRayTriangle for every lane. Returns the hits not farther than "best_distances",
+    // the caller breaks the ties
+    template<typename F>
+    uint32_t IntersectTriangleLanes(const TrianglePosition& triangle, const RayLanes<F>& rays, F best_distances,
+                                    F& distances, F& bary_x, F& bary_y, uint32_t& backfaces_bits)
+    {
+        const F zero = F::Broadcast(0.f);
+        const F epsilon = F::Broadcast(std::numeric_limits<float>::epsilon());
+
+        LanesVec3<F> vert0 = LanesVec3<F>::Broadcast(triangle.GetP(0));
+        LanesVec3<F> edge1 = LanesVec3<F>::Broadcast(triangle.GetP(1) - triangle.GetP(0));
+        LanesVec3<F> edge2 = LanesVec3<F>::Broadcast(triangle.GetP(2) - triangle.GetP(0));
+
+        LanesVec3<F> p = Cross(rays.direction, edge2);
+        F det = Dot(edge1, p);
+
+        LanesVec3<F> dist = rays.origin - vert0;
+        F u = Dot(dist, p);
+        LanesVec3<F> perpendicular = Cross(dist, edge1);
+        F v = Dot(rays.direction, perpendicular);
+        F u_plus_v = u + v;
+
+        typename F::Mask is_frontface = det > epsilon;
+        typename F::Mask is_backface = det < zero - epsilon;
+
+        typename F::Mask front_inside = is_frontface & (u >= zero) & (u <= det) & (v >= zero) & (u_plus_v <= det);
+        typename F::Mask back_inside = is_backface & (u <= zero) & (u >= det) & (v <= zero) & (u_plus_v >= det);
+
+        F inv_det = F::Broadcast(1.f) / det;
+        distances = Dot(edge2, perpendicular) * inv_det;
+        bary_x = u * inv_det;
+        bary_y = v * inv_det;
+        backfaces_bits = MoveMask(is_backface);
+
+        return MoveMask((front_inside | back_inside) & (distances > zero) & (distances <= best_distances));
+    }
+
+    template<typename F>
+    struct alignas(32) LanesStore
+    {
+        float values[sizeof(F) / sizeof(float)];
+
+        explicit LanesStore(F lanes) {lanes.Store(values);}
+    };
+
+    // Lanes not in "lanes_bits" are not traced. "return_infos" has one info per lane
+    template<typename F>
+    void IntersectOBBtreeLanes(const OBBtree& obb_tree, const RayLanes<F>& rays, uint32_t lanes_bits, RayOBBtreeIntersectInfo* return_infos)
+    {
+        F best_distances = F::Broadcast(std::numeric_limits<float>::infinity());
+
+        auto intersect_triangles = [&](size_t triangles_offset, size_t triangles_count, uint32_t active_bits)
+        {
+            for (size_t i = triangles_offset; i != triangles_offset + triangles_count; ++i)
+            {
+                F distances, bary_x, bary_y;
+                uint32_t backfaces_bits;
+                uint32_t hit_bits = active_bits & IntersectTriangleLanes(obb_tree.GetTrianglePosition(i), rays, best_distances,
+                                                                         distances, bary_x, bary_y, backfaces_bits);
+                if (hit_bits == 0) [[likely]]
+                    continue;
+
+                // Ties go to the lowest triangle index, as at Ray::IntersectTrianglesRange
+                for (uint32_t bits = hit_bits & MoveMask(distances >= best_distances); bits != 0; bits &= bits - 1)
+                {
+                    size_t lane = size_t(std::countr_zero(bits));
+                    if (i >= return_infos[lane].triangle_index)
+                        hit_bits &= ~(1u << lane);
+                }
+                if (hit_bits == 0)
+                    continue;
+
+                best_distances = Select(F::MaskFromBits(hit_bits), distances, best_distances);
+
+                LanesStore<F> distances_store(distances);
+                LanesStore<F> bary_x_store(bary_x);
+                LanesStore<F> bary_y_store(bary_y);
+                for (uint32_t bits = hit_bits; bits != 0; bits &= bits - 1)
+                {
+                    size_t lane = size_t(std::countr_zero(bits));
+
+                    RayOBBtreeIntersectInfo& this_info = return_infos[lane];
+                    this_info.doIntersect = true;
+                    this_info.itBackfaces = (backfaces_bits >> lane) & 1u;
+                    this_info.distanceFromOrigin = distances_store.values[lane];
+                    this_info.triangle_index = i;
+                    this_info.baryPosition = glm::vec2(bary_x_store.values[lane], bary_y_store.values[lane]);
+                }
+            }
+        };
+
+        OBBtree::OBBtreeTraveler root_traveler = obb_tree.GetRootTraveler();
+
+        F root_min_distances;
+        uint32_t root_bits = lanes_bits & IntersectOBBLanes(root_traveler.GetOBB(), rays, best_distances, root_min_distances);
+        if (root_bits == 0)
+            return;
+
+        if (root_traveler.IsLeaf())
+        {
+            intersect_triangles(root_traveler.GetTrianglesOffset(), root_traveler.GetTrianglesCount(), root_bits);
+            return;
+        }
+
+        struct StackEntry
+        {
+            F min_distances;
+            uint32_t lanes_bits;
+            OBBtree::OBBtreeTraveler traveler;
+        };
+
+        // Only far children are pushed, so the stack stays as deep as the tree
+        thread_local std::vector<StackEntry> stack;
+        stack.clear();
+        stack.push_back({root_min_distances, root_bits, root_traveler});
+
+        while (not stack.empty())
+        {
+            StackEntry this_entry = stack.back();
+            stack.pop_back();
+
+            uint32_t active_bits = this_entry.lanes_bits & MoveMask(this_entry.min_distances <= best_distances);
+            if (active_bits == 0)
+                continue;
+
+            if (this_entry.traveler.IsLeaf())
+            {
+                intersect_triangles(this_entry.traveler.GetTrianglesOffset(), this_entry.traveler.GetTrianglesCount(), active_bits);
+                continue;
+            }
+
+            OBBtree::OBBtreeTraveler left_traveler = this_entry.traveler.GetLeftChildTraveler();
+            OBBtree::OBBtreeTraveler right_traveler = this_entry.traveler.GetRightChildTraveler();
+
+            F left_min_distances, right_min_distances;
+            uint32_t left_bits = active_bits & IntersectOBBLanes(left_traveler.GetOBB(), rays, best_distances, left_min_distances);
+            uint32_t right_bits = active_bits & IntersectOBBLanes(right_traveler.GetOBB(), rays, best_distances, right_min_distances);
+
+            if (left_bits != 0 && right_bits != 0)
+            {
+                // The child nearer for most of the common lanes on top
+                uint32_t common_bits = left_bits & right_bits;
+                uint32_t left_nearer_bits = common_bits & MoveMask(left_min_distances < right_min_distances);
+                if (2 * std::popcount(left_nearer_bits) >= std::popcount(common_bits))
+                {
+                    stack.push_back({right_min_distances, right_bits, right_traveler});
+                    stack.push_back({left_min_distances, left_bits, left_traveler});
+                }
+                else
+                {
+                    stack.push_back({left_min_distances, left_bits, left_traveler});
+                    stack.push_back({right_min_distances, right_bits, right_traveler});
+                }
+            }
+            else if (left_bits != 0)
+            {
+                stack.push_back({left_min_distances, left_bits, left_traveler});
+            }
+            else if (right_bits != 0)
+            {
+                stack.push_back({right_min_distances, right_bits, right_traveler});
+            }
+        }
+    }
+}
+
+void RayPacket::Clear()
+{
+    size = 0;
+}
+
+void RayPacket::Add(const Ray& ray)
+{
+    assert(size < width);
+
+    auto set_vec3 = [index = size](Vec3Lanes& lanes, const glm::vec3& in_vec)
+    {
+        lanes.x.values[index] = in_vec.x;
+        lanes.y.values[index] = in_vec.y;
+        lanes.z.values[index] = in_vec.z;
+    };
+
+    set_vec3(origins, ray.GetOrigin());
+    set_vec3(directions, ray.GetDirection());
+
+    ++size;
+}
+
+std::array<RayOBBtreeIntersectInfo, RayPacket::width> RayPacket::IntersectOBBtree(const OBBtree& obb_tree, const glm::mat4x4& matrix) const
+{
+    std::array<RayOBBtreeIntersectInfo, width> return_infos = {};
+    if (size == 0)
+        return return_infos;
+
+    // Rays to the tree's space, as at Ray::IntersectOBBtree
+    glm::mat4x4 inverse_matrix = glm::inverse(matrix);
+
+    Vec3Lanes local_origins;
+    Vec3Lanes local_directions;
+    for (size_t index = 0; index < size; ++index)
+    {
+        glm::vec3 origin = {origins.x.values[index], origins.y.values[index], origins.z.values[index]};
+        glm::vec3 direction = {directions.x.values[index], directions.y.values[index], directions.z.values[index]};
+
+        glm::vec3 local_origin = glm::vec3(inverse_matrix * glm::vec4(origin, 1.f));
+        glm::vec3 local_direction = glm::vec3(inverse_matrix * glm::vec4(direction, 0.f));
+
+        local_origins.x.values[index] = local_origin.x;
+        local_origins.y.values[index] = local_origin.y;
+        local_origins.z.values[index] = local_origin.z;
+        local_directions.x.values[index] = local_direction.x;
+        local_directions.y.values[index] = local_direction.y;
+        local_directions.z.values[index] = local_direction.z;
+    }
+
+#if defined(__AVX__) || defined(__SSE__)
+    auto load_vec3 = [](const Vec3Lanes& lanes) -> LanesVec3<SimdFloat>
+    {
+        return {SimdFloat::Load(lanes.x.values), SimdFloat::Load(lanes.y.values), SimdFloat::Load(lanes.z.values)};
+    };
+
+    RayLanes<SimdFloat> rays_lanes = {load_vec3(local_origins), load_vec3(local_directions)};
+    uint32_t lanes_bits = (1u << size) - 1u;
+
+    IntersectOBBtreeLanes(obb_tree, rays_lanes, lanes_bits, return_infos.data());
+#else
+    for (size_t index = 0; index < size; ++index)
+    {
+        auto load_vec3 = [index](const Vec3Lanes& lanes) -> LanesVec3<ScalarFloat>
+        {
+            return {ScalarFloat::Load(&lanes.x.values[index]), ScalarFloat::Load(&lanes.y.values[index]), ScalarFloat::Load(&lanes.z.values[index])};
+        };
+
+        RayLanes<ScalarFloat> ray_lane = {load_vec3(local_origins), load_vec3(local_directions)};
+
+        IntersectOBBtreeLanes(obb_tree, ray_lane, 1u, &return_infos[index]);
+    }
+#endif
+
+    if (glm::determinant(glm::mat3(matrix)) < 0.f)
+        for (size_t index = 0; index < size; ++index)
+            return_infos[index].itBackfaces = not return_infos[index].itBackfaces;
+
+    return return_infos;
+}
+
+std::vector<RayOBBtreeIntersectInfo> RayPacket::IntersectRaysOBBtree(const std::vector<Ray>& rays, const OBBtree& obb_tree, const glm::mat4x4& matrix)
+{
+    std::vector<RayOBBtreeIntersectInfo> return_infos(rays.size());
+
+    std::array<std::vector<uint32_t>, 8> octants_rays_indices;
+    for (size_t i = 0; i < rays.size(); ++i)
+    {
+        glm::vec3 direction = rays[i].GetDirection();
+        size_t octant = size_t(direction.x < 0.f) | (size_t(direction.y < 0.f) << 1) | (size_t(direction.z < 0.f) << 2);
+
+        octants_rays_indices[octant].emplace_back(uint32_t(i));
+    }
+
+    RayPacket packet;
+    for (const std::vector<uint32_t>& this_octant_rays_indices : octants_rays_indices)
+    {
+        for (size_t first = 0; first < this_octant_rays_indices.size(); first += width)
+        {
+            size_t last = std::min(first + width, this_octant_rays_indices.size());
+
+            packet.Clear();
+            for (size_t i = first; i < last; ++i)
+                packet.Add(rays[this_octant_rays_indices[i]]);
+
+            if (packet.GetSize() > 1 && packet.IsCoherent())
+            {
+                std::array<RayOBBtreeIntersectInfo, width> packet_infos = packet.IntersectOBBtree(obb_tree, matrix);
+                for (size_t i = first; i < last; ++i)
+                    return_infos[this_octant_rays_indices[i]] = packet_infos[i - first];
+            }
+            else
+            {
+                for (size_t i = first; i < last; ++i)
+                    return_infos[this_octant_rays_indices[i]] = rays[this_octant_rays_indices[i]].IntersectOBBtree(obb_tree, matrix);
+            }
+        }
+    }
+
+    return return_infos;
+}
+
+// Rays of incoherent packets split at different nodes, and then the packet travels the union of their paths
+bool RayPacket::IsCoherent() const
+{
+    glm::vec3 first_direction = glm::normalize(glm::vec3(directions.x.values[0], directions.y.values[0], directions.z.values[0]));
+    for (size_t index = 1; index < size; ++index)
+    {
+        glm::vec3 this_direction = glm::normalize(glm::vec3(directions.x.values[index], directions.y.values[index], directions.z.values[index]));
+        if (glm::dot(first_direction, this_direction) < minCoherentDirectionsCos)
+            return false;
+    }
+
+    return true;
+}
@@ -1,5 +1,6 @@
 #include "Geometry/Sphere.h"
 
+#include <limits>
 #include <numbers>
 
 Sphere::Sphere(const glm::vec3 &in_origin, float in_radius)
@@ -9,50 +10,98 @@ Sphere::Sphere(const glm::vec3 &in_origin, float in_radius)
 {
 }
 
+ParalgramSlabs::ParalgramSlabs(const Paralgram& paralgram)
+    :center(paralgram.GetCenter())
+{
+    const std::array<glm::vec3, 3> sides = {paralgram.GetSideDirectionU(), paralgram.GetSideDirectionV(), paralgram.GetSideDirectionW()};
+
+    // U, V and W slabs. A zero side (flat or line-like paralgrams) leaves the slabs of the other two without a normal,
+    // they stay unbounded and pass every sphere, instead of NaN normals whose comparisons differ with fast math
+    for (size_t i = 0; i != 3; ++i) {
+        glm::vec3 plane_normal = glm::cross(sides[(i + 1) % 3], sides[(i + 2) % 3]);
+        if (glm::dot(plane_normal, plane_normal) > 0.f) {
+            planesDirections[i] = glm::normalize(plane_normal);
+            planesD[i] = - std::abs(glm::dot(planesDirections[i], sides[i]));
+        } else {
+            planesDirections[i] = glm::vec3(0.f);
+            planesD[i] = - std::numeric_limits<float>::max();
+        }
+    }
+}
+
 bool Sphere::IntersectParalgram(const Paralgram& paralgram) const
 {
-    glm::vec3 sphere_origin = origin - paralgram.GetCenter();
+    return IntersectParalgramSlabs(ParalgramSlabs(paralgram));
+}
 
-    // U test
-    {
-        glm::vec3 plane_dir = glm::normalize(glm::cross(paralgram.GetSideDirectionV(), paralgram.GetSideDirectionW()));
-        float d = - std::abs(glm::dot(plane_dir, paralgram.GetSideDirectionU()));
+bool Sphere::IntersectParalgramSlabs(const ParalgramSlabs& slabs) const
+{
+    glm::vec3 sphere_origin = origin - slabs.center;
 
-        float plane_has_center_dist = glm::dot(plane_dir, sphere_origin);
-        float v_n1 = + plane_has_center_dist + d;
-        float v_n2 = - plane_has_center_dist + d;
+    for (size_t i = 0; i != 3; ++i)
+    {
+        float plane_has_center_dist = glm::dot(slabs.planesDirections[i], sphere_origin);
+        float v_n1 = + plane_has_center_dist + slabs.planesD[i];
+        float v_n2 = - plane_has_center_dist + slabs.planesD[i];
 
         if (v_n1 - radius > 0 || v_n2 - radius > 0)
             return false;
     }
 
-    // V test
-    {
-        glm::vec3 plane_dir = glm::normalize(glm::cross(paralgram.GetSideDirectionW(), paralgram.GetSideDirectionU()));
-        float d = - std::abs(glm::dot(plane_dir, paralgram.GetSideDirectionV()));
-
-        float plane_has_center_dist = glm::dot(plane_dir, sphere_origin);
-        float v_n1 = + plane_has_center_dist + d;
-        float v_n2 = - plane_has_center_dist + d;
+    return true;
+}
 
-        if (v_n1 - radius > 0 || v_n2 - radius > 0)
-            return false;
+bool Sphere::IntersectTriangle(const TrianglePosition& triangle) const
+{
+    // Closest point of the triangle, by the Voronoi region of the origin (Ericson, Real-Time Collision Detection, 5.1.5)
+    const glm::vec3 a = triangle.GetP(0);
+    const glm::vec3 b = triangle.GetP(1);
+    const glm::vec3 c = triangle.GetP(2);
+
+    const glm::vec3 ab = b - a;
+    const glm::vec3 ac = c - a;
+    const glm::vec3 ap = origin - a;
+
+    glm::vec3 closest_point;
+    float d1 = glm::dot(ab, ap);
+    float d2 = glm::dot(ac, ap);
+    if (d1 <= 0.f && d2 <= 0.f)
+    {
+        closest_point = a;
     }
-
-    // W test
+    else
     {
-        glm::vec3 plane_dir = glm::normalize(glm::cross(paralgram.GetSideDirectionU(), paralgram.GetSideDirectionV()));
-        float d = - std::abs(glm::dot(plane_dir, paralgram.GetSideDirectionW()));
-
-        float plane_has_center_dist = glm::dot(plane_dir, sphere_origin);
-        float v_n1 = + plane_has_center_dist + d;
-        float v_n2 = - plane_has_center_dist + d;
-
-        if (v_n1 - radius > 0 || v_n2 - radius > 0)
-            return false;
+        const glm::vec3 bp = origin - b;
+        float d3 = glm::dot(ab, bp);
+        float d4 = glm::dot(ac, bp);
+
+        const glm::vec3 cp = origin - c;
+        float d5 = glm::dot(ab, cp);
+        float d6 = glm::dot(ac, cp);
+
+        float va = d3 * d6 - d5 * d4;
+        float vb = d5 * d2 - d1 * d6;
+        float vc = d1 * d4 - d3 * d2;
+
+        if (d3 >= 0.f && d4 <= d3)
+            closest_point = b;
+        else if (d6 >= 0.f && d5 <= d6)
+            closest_point = c;
+        else if (vc <= 0.f && d1 >= 0.f && d3 <= 0.f)
+            closest_point = a + ab * (d1 / (d1 - d3));
+        else if (vb <= 0.f && d2 >= 0.f && d6 <= 0.f)
+            closest_point = a + ac * (d2 / (d2 - d6));
+        else if (va <= 0.f && (d4 - d3) >= 0.f && (d5 - d6) >= 0.f)
+            closest_point = b + (c - b) * ((d4 - d3) / ((d4 - d3) + (d5 - d6)));
+        else
+        {
+            float denom = 1.f / (va + vb + vc);
+            closest_point = a + ab * (vb * denom) + ac * (vc * denom);
+        }
     }
 
-    return true;
+    glm::vec3 offset = origin - closest_point;
+    return glm::dot(offset, offset) <= radius * radius;
 }
 
 std::pair<std::vector<uint32_t>, std::vector<glm::vec3>> Sphere::GetSphereMesh(size_t quality)
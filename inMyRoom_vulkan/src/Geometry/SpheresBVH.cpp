@@ -0,0 +1,119 @@
+#include "Geometry/SpheresBVH.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+
+#include "glm/common.hpp"
+#include "glm/geometric.hpp"
+
+namespace
+{
+    // Nodes' radii grow by this much of their magnitude, so rounding of the slabs test never rejects a node whose sphere would pass
+    constexpr float conservativeMargin = 1.e-5f;
+}
+
+void SpheresBVH::Build(const std::vector<Sphere>& spheres, const std::vector<uint32_t>& spheres_indices)
+{
+    entries.clear();
+    for (uint32_t this_index : spheres_indices)
+    {
+        assert(this_index < spheres.size());
+        entries.emplace_back(SphereEntry{spheres[this_index], this_index});
+    }
+
+    nodes.clear();
+    if (entries.size())
+        BuildNode(0, entries.size());
+}
+
+uint32_t SpheresBVH::BuildNode(size_t first, size_t last)
+{
+    glm::vec3 min_coords = glm::vec3(std::numeric_limits<float>::max());
+    glm::vec3 max_coords = glm::vec3(std::numeric_limits<float>::lowest());
+    glm::vec3 min_origins = glm::vec3(std::numeric_limits<float>::max());
+    glm::vec3 max_origins = glm::vec3(std::numeric_limits<float>::lowest());
+    for (size_t i = first; i != last; ++i)
+    {
+        const Sphere& this_sphere = entries[i].sphere;
+        min_coords = glm::min(min_coords, this_sphere.GetOrigin() - glm::vec3(this_sphere.GetRadius()));
+        max_coords = glm::max(max_coords, this_sphere.GetOrigin() + glm::vec3(this_sphere.GetRadius()));
+        min_origins = glm::min(min_origins, this_sphere.GetOrigin());
+        max_origins = glm::max(max_origins, this_sphere.GetOrigin());
+    }
+
+    Node this_node = {};
+    this_node.center = (min_coords + max_coords) * 0.5f;
+    this_node.radius = 0.f;
+    for (size_t i = first; i != last; ++i)
+    {
+        const Sphere& this_sphere = entries[i].sphere;
+        this_node.radius = std::max(this_node.radius, glm::length(this_sphere.GetOrigin() - this_node.center) + this_sphere.GetRadius());
+    }
+    glm::vec3 abs_center = glm::abs(this_node.center);
+    this_node.radius += (std::max({abs_center.x, abs_center.y, abs_center.z}) + this_node.radius) * conservativeMargin;
+
+    uint32_t node_index = uint32_t(nodes.size());
+    nodes.emplace_back(this_node);
+
+    if (last - first <= leafSize)
+    {
+        nodes[node_index].offset = uint32_t(first);
+        nodes[node_index].count = uint32_t(last - first);
+        return node_index;
+    }
+
+    // Median split at the longest axis of the origins
+    glm::vec3 origins_extent = max_origins - min_origins;
+    int axis = 0;
+    if (origins_extent.y > origins_extent[axis]) axis = 1;
+    if (origins_extent.z > origins_extent[axis]) axis = 2;
+
+    size_t middle = first + (last - first) / 2;
+    std::nth_element(entries.begin() + first, entries.begin() + middle, entries.begin() + last,
+                     [axis](const SphereEntry& lhs, const SphereEntry& rhs) {return lhs.sphere.GetOrigin()[axis] < rhs.sphere.GetOrigin()[axis];});
+
+    BuildNode(first, middle);
+    uint32_t right_index = BuildNode(middle, last);
+
+    nodes[node_index].offset = right_index;
+    nodes[node_index].count = 0;
+    return node_index;
+}
+
+void SpheresBVH::CollideParalgram(const Paralgram& paralgram, std::vector<uint32_t>& collided_indices, std::vector<uint32_t>& traversal_stack) const
+{
+    collided_indices.clear();
+    if (nodes.empty())
+        return;
+
+    const ParalgramSlabs slabs(paralgram);
+
+    traversal_stack.clear();
+    traversal_stack.emplace_back(0);
+    while (traversal_stack.size())
+    {
+        uint32_t this_node_index = traversal_stack.back();
+        traversal_stack.pop_back();
+
+        const Node& this_node = nodes[this_node_index];
+
+        if (not Sphere(this_node.center, this_node.radius).IntersectParalgramSlabs(slabs))
+            continue;
+
+        if (this_node.count)
+        {
+            for (size_t i = this_node.offset; i != this_node.offset + this_node.count; ++i)
+                if (entries[i].sphere.IntersectParalgramSlabs(slabs))
+                    collided_indices.emplace_back(entries[i].index);
+        }
+        else
+        {
+            traversal_stack.emplace_back(this_node.offset);
+            traversal_stack.emplace_back(this_node_index + 1);
+        }
+    }
+
+    std::sort(collided_indices.begin(), collided_indices.end());
+}
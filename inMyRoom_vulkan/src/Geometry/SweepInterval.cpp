@@ -0,0 +1,58 @@
+#include "Geometry/SweepInterval.h"
+
+#include <algorithm>
+
+#include "glm/geometric.hpp"
+
+SweepInterval::SweepInterval(const glm::vec3& in_displacement)
+    :displacement(in_displacement)
+{
+}
+
+bool SweepInterval::AddAxis(const glm::vec3& axis, std::pair<float, float> lhs_min_max, std::pair<float, float> rhs_min_max)
+{
+    float speed = glm::dot(axis, displacement);
+
+    if (speed == 0.f)
+    {
+        // Overlap along this axis does not change with time
+        if (lhs_min_max.second < rhs_min_max.first || rhs_min_max.second < lhs_min_max.first)
+            leaveTime = -std::numeric_limits<float>::infinity();
+
+        return enterTime <= leaveTime;
+    }
+
+    float speed_inv = 1.f / speed;
+    float enter_time = (rhs_min_max.first - lhs_min_max.second) * speed_inv;
+    float leave_time = (rhs_min_max.second - lhs_min_max.first) * speed_inv;
+    if (enter_time > leave_time)
+        std::swap(enter_time, leave_time);
+
+    if (enter_time > enterTime)
+    {
+        enterTime = enter_time;
+        enterNormal = speed > 0.f ? -axis : +axis;
+    }
+    leaveTime = std::min(leaveTime, leave_time);
+
+    return enterTime <= leaveTime && enterTime <= 1.f && leaveTime >= 0.f;
+}
+
+SweepIntersectInfo SweepInterval::GetInfo() const
+{
+    SweepIntersectInfo return_info;
+
+    if (enterTime <= leaveTime && enterTime <= 1.f && leaveTime >= 0.f)
+    {
+        return_info.doIntersect = true;
+        return_info.timeOfImpact = std::max(enterTime, 0.f);
+        return_info.normal = enterTime >= 0.f ? enterNormal : glm::vec3(0.f);
+    }
+
+    return return_info;
+}
+
+bool SweepInterval::IsCrossAxisDegenerate(const glm::vec3& axis, const glm::vec3& lhs_edge, const glm::vec3& rhs_edge)
+{
+    return glm::dot(axis, axis) <= minCrossAxisSin2 * glm::dot(lhs_edge, lhs_edge) * glm::dot(rhs_edge, rhs_edge);
+}
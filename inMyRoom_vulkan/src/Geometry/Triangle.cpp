@@ -56,6 +56,8 @@ std::vector<T_return> CreateIndicesTriplets(const std::vector<T_data>& data, con
 
             break;
         }
+        case glTFmode::line_loop:
+            break;
     }
 
     return return_vector;
@@ -110,6 +112,25 @@ TrianglesIntersectionInfo TrianglePosition::IntersectTriangles(const TrianglePos
 }
 
 
+SweepIntersectInfo TrianglePosition::SweepTriangles(const TrianglePosition& lhs, const glm::vec3& lhs_displacement, const TrianglePosition& rhs)
+{
+    SweepInterval sweep_interval(lhs_displacement);
+
+    const glm::vec3 lhs_edges[3] = {lhs.GetP(1) - lhs.GetP(0), lhs.GetP(2) - lhs.GetP(1), lhs.GetP(0) - lhs.GetP(2)};
+    const glm::vec3 rhs_edges[3] = {rhs.GetP(1) - rhs.GetP(0), rhs.GetP(2) - rhs.GetP(1), rhs.GetP(0) - rhs.GetP(2)};
+
+    // faces
+    if (not sweep_interval.AddAxis(glm::cross(lhs_edges[0], lhs_edges[1]), lhs, rhs)) return {};
+    if (not sweep_interval.AddAxis(glm::cross(rhs_edges[0], rhs_edges[1]), lhs, rhs)) return {};
+
+    // cross products of edges
+    for (const glm::vec3& lhs_edge : lhs_edges)
+        for (const glm::vec3& rhs_edge : rhs_edges)
+            if (not sweep_interval.AddCrossAxis(lhs_edge, rhs_edge, lhs, rhs)) return {};
+
+    return sweep_interval.GetInfo();
+}
+
 std::pair<float, float> TrianglePosition::GetMinMaxProjectionToAxis(const glm::vec3& in_axis) const
 {
     float min = +std::numeric_limits<float>::infinity();
@@ -871,9 +892,9 @@ int tri_tri_intersect_with_isectline(float V0[3], float V1[3], float V2[3],
     float N1[3], N2[3], d1, d2;
     float du0, du1, du2, dv0, dv1, dv2;
     float D[3];
-    float isect1[2], isect2[2];
+    float isect1[2], isect2[2] = {};
     float isectpointA1[3], isectpointA2[3];
-    float isectpointB1[3], isectpointB2[3];
+    float isectpointB1[3] = {}, isectpointB2[3] = {};
     float du0du1, du0du2, dv0dv1, dv0dv2;
     short index;
     float vp0, vp1, vp2;
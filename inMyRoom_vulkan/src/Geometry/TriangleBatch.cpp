@@ -0,0 +1,338 @@
+#include "Geometry/TriangleBatch.h"
+
+#include <cassert>
+
+#include "Geometry/FloatLanes.h"
+
+namespace
+{
+    template<typename F>
+    struct TriangleLanes
+    {
+        LanesVec3<F> p0;
+        LanesVec3<F> p1;
+        LanesVec3<F> p2;
+    };
+
+    template<typename F>
+    struct IntervalLanes
+    {
+        F isect0;
+        F isect1;
+        LanesVec3<F> point0;
+        LanesVec3<F> point1;
+        uint32_t coplanarMask;
+    };
+
+    template<typename F>
+    struct TrianglesIntersectionLanes
+    {
+        uint32_t intersectMask = 0;
+        uint32_t fallbackMask = 0;
+        LanesVec3<F> source;
+        LanesVec3<F> target;
+    };
+
+    // tri_tri_intersect_with_isectline's epsilon test. Its "fabs(x) < EPSILON" compares as double, same as "<=" to the float below 1e-6
+    template<typename F>
+    F SnapToZero(F distance)
+    {
+        return Select(Abs(distance) <= F::Broadcast(0.000001f), F::Broadcast(0.f), distance);
+    }
+
+    // compute_intervals_isectline and isect2 of Triangle.cpp. The branches only pick which vertex is alone at its side of
+    // the other plane, so every lane rotates its vertices to put that one first
+    template<typename F>
+    IntervalLanes<F> ComputeIntervalLanes(const TriangleLanes<F>& triangle,
+                                          F vv0, F vv1, F vv2,
+                                          F d0, F d1, F d2,
+                                          F d0d1, F d0d2,
+                                          uint32_t lanes_mask)
+    {
+        const F zero = F::Broadcast(0.f);
+
+        uint32_t d0d1_positive_bits = MoveMask(d0d1 > zero);
+        uint32_t d0d2_positive_bits = MoveMask(d0d2 > zero);
+        uint32_t d0_alone_bits = MoveMask((d1 * d2 > zero) | (d0 < zero) | (d0 > zero));
+        uint32_t d1_nonzero_bits = MoveMask((d1 < zero) | (d1 > zero));
+        uint32_t d2_nonzero_bits = MoveMask((d2 < zero) | (d2 > zero));
+
+        // (2, 0, 1) and (1, 0, 2) orders, the rest of the lanes keep (0, 1, 2) or are coplanar
+        uint32_t rotate_bits = d0d1_positive_bits |
+                               (~d0d1_positive_bits & ~d0d2_positive_bits & ~d0_alone_bits & ~d1_nonzero_bits & d2_nonzero_bits);
+        uint32_t swap_bits = ~d0d1_positive_bits & (d0d2_positive_bits | (~d0_alone_bits & d1_nonzero_bits));
+
+        typename F::Mask rotate = F::MaskFromBits(rotate_bits);
+        typename F::Mask swap = F::MaskFromBits(swap_bits);
+        typename F::Mask rotate_or_swap = F::MaskFromBits(rotate_bits | swap_bits);
+
+        LanesVec3<F> vert0 = Select(rotate, triangle.p2, Select(swap, triangle.p1, triangle.p0));
+        LanesVec3<F> vert1 = Select(rotate_or_swap, triangle.p0, triangle.p1);
+        LanesVec3<F> vert2 = Select(rotate, triangle.p1, triangle.p2);
+
+        F sorted_vv0 = Select(rotate, vv2, Select(swap, vv1, vv0));
+        F sorted_vv1 = Select(rotate_or_swap, vv0, vv1);
+        F sorted_vv2 = Select(rotate, vv1, vv2);
+
+        F sorted_d0 = Select(rotate, d2, Select(swap, d1, d0));
+        F sorted_d1 = Select(rotate_or_swap, d0, d1);
+        F sorted_d2 = Select(rotate, d1, d2);
+
+        IntervalLanes<F> return_lanes;
+
+        F tmp = sorted_d0 / (sorted_d0 - sorted_d1);
+        return_lanes.isect0 = sorted_vv0 + (sorted_vv1 - sorted_vv0) * tmp;
+        return_lanes.point0 = tmp * (vert1 - vert0) + vert0;
+
+        tmp = sorted_d0 / (sorted_d0 - sorted_d2);
+        return_lanes.isect1 = sorted_vv0 + (sorted_vv2 - sorted_vv0) * tmp;
+        return_lanes.point1 = vert0 + tmp * (vert2 - vert0);
+
+        return_lanes.coplanarMask = ~(d0d1_positive_bits | d0d2_positive_bits | d0_alone_bits | d1_nonzero_bits | d2_nonzero_bits) & lanes_mask;
+
+        return return_lanes;
+    }
+
+    // tri_tri_intersect_with_isectline of Triangle.cpp, "v" against every lane of "u".
+    // Coplanar lanes are left to the scalar test at "fallbackMask"
+    template<typename F>
+    TrianglesIntersectionLanes<F> IntersectTrianglesLanes(const TriangleLanes<F>& v, const TriangleLanes<F>& u, uint32_t lanes_mask)
+    {
+        const F zero = F::Broadcast(0.f);
+
+        TrianglesIntersectionLanes<F> return_lanes;
+
+        // plane of v, then distances of u to it
+        LanesVec3<F> n1 = Cross(v.p1 - v.p0, v.p2 - v.p0);
+        F d1 = zero - Dot(n1, v.p0);
+
+        F du0 = SnapToZero(Dot(n1, u.p0) + d1);
+        F du1 = SnapToZero(Dot(n1, u.p1) + d1);
+        F du2 = SnapToZero(Dot(n1, u.p2) + d1);
+
+        F du0du1 = du0 * du1;
+        F du0du2 = du0 * du2;
+
+        lanes_mask &= ~MoveMask((du0du1 > zero) & (du0du2 > zero));
+        if (lanes_mask == 0)
+            return return_lanes;
+
+        // plane of u, then distances of v to it
+        LanesVec3<F> n2 = Cross(u.p1 - u.p0, u.p2 - u.p0);
+        F d2 = zero - Dot(n2, u.p0);
+
+        F dv0 = SnapToZero(Dot(n2, v.p0) + d2);
+        F dv1 = SnapToZero(Dot(n2, v.p1) + d2);
+        F dv2 = SnapToZero(Dot(n2, v.p2) + d2);
+
+        F dv0dv1 = dv0 * dv1;
+        F dv0dv2 = dv0 * dv2;
+
+        lanes_mask &= ~MoveMask((dv0dv1 > zero) & (dv0dv2 > zero));
+        if (lanes_mask == 0)
+            return return_lanes;
+
+        // project to the largest component of the intersection line direction
+        LanesVec3<F> direction = Cross(n1, n2);
+
+        F max = Abs(direction.x);
+        F b = Abs(direction.y);
+        F c = Abs(direction.z);
+
+        typename F::Mask is_y_largest = b > max;
+        max = Select(is_y_largest, b, max);
+        typename F::Mask is_z_largest = c > max;
+
+        auto project = [&](const LanesVec3<F>& point) -> F
+        {
+            return Select(is_z_largest, point.z, Select(is_y_largest, point.y, point.x));
+        };
+
+        IntervalLanes<F> interval1 = ComputeIntervalLanes(v, project(v.p0), project(v.p1), project(v.p2),
+                                                          dv0, dv1, dv2, dv0dv1, dv0dv2, lanes_mask);
+        IntervalLanes<F> interval2 = ComputeIntervalLanes(u, project(u.p0), project(u.p1), project(u.p2),
+                                                          du0, du1, du2, du0du1, du0du2, lanes_mask);
+
+        return_lanes.fallbackMask = interval1.coplanarMask | interval2.coplanarMask;
+        lanes_mask &= ~return_lanes.fallbackMask;
+
+        // SORT2
+        typename F::Mask smallest1 = interval1.isect0 > interval1.isect1;
+        typename F::Mask smallest2 = interval2.isect0 > interval2.isect1;
+
+        F isect1_min = Select(smallest1, interval1.isect1, interval1.isect0);
+        F isect1_max = Select(smallest1, interval1.isect0, interval1.isect1);
+        F isect2_min = Select(smallest2, interval2.isect1, interval2.isect0);
+        F isect2_max = Select(smallest2, interval2.isect0, interval2.isect1);
+
+        lanes_mask &= ~MoveMask((isect1_max < isect2_min) | (isect2_max < isect1_min));
+        if (lanes_mask == 0)
+            return return_lanes;
+
+        LanesVec3<F> point_a_min = Select(smallest1, interval1.point1, interval1.point0);
+        LanesVec3<F> point_a_max = Select(smallest1, interval1.point0, interval1.point1);
+        LanesVec3<F> point_b_min = Select(smallest2, interval2.point1, interval2.point0);
+        LanesVec3<F> point_b_max = Select(smallest2, interval2.point0, interval2.point1);
+
+        typename F::Mask is_b_first = isect2_min < isect1_min;
+
+        return_lanes.source = Select(is_b_first, point_a_min, point_b_min);
+        return_lanes.target = Select(is_b_first,
+                                     Select(isect2_max < isect1_max, point_b_max, point_a_max),
+                                     Select(isect2_max > isect1_max, point_a_max, point_b_max));
+        return_lanes.intersectMask = lanes_mask;
+
+        return return_lanes;
+    }
+
+    template<typename F>
+    TriangleLanes<F> BroadcastTriangle(const TrianglePosition& triangle)
+    {
+        return {LanesVec3<F>::Broadcast(triangle.GetP(0)),
+                LanesVec3<F>::Broadcast(triangle.GetP(1)),
+                LanesVec3<F>::Broadcast(triangle.GetP(2))};
+    }
+}
+
+void TriangleBatch::Clear()
+{
+    size = 0;
+}
+
+void TriangleBatch::Add(const TrianglePosition& triangle)
+{
+    assert(size < width);
+
+    Set(size++, triangle);
+}
+
+void TriangleBatch::Set(size_t index, const TrianglePosition& triangle)
+{
+    assert(index < size);
+
+    auto set_vec3 = [index](Vec3Lanes& lanes, const glm::vec3& in_vec)
+    {
+        lanes.x.values[index] = in_vec.x;
+        lanes.y.values[index] = in_vec.y;
+        lanes.z.values[index] = in_vec.z;
+    };
+
+    set_vec3(points0, triangle.GetP(0));
+    set_vec3(points1, triangle.GetP(1));
+    set_vec3(points2, triangle.GetP(2));
+}
+
+TrianglePosition TriangleBatch::GetTriangle(size_t index) const
+{
+    assert(index < size);
+
+    auto get_vec3 = [index](const Vec3Lanes& lanes) -> glm::vec3
+    {
+        return glm::vec3(lanes.x.values[index], lanes.y.values[index], lanes.z.values[index]);
+    };
+
+    return TrianglePosition(get_vec3(points0), get_vec3(points1), get_vec3(points2));
+}
+
+uint32_t TriangleBatch::IntersectTriangle(const TrianglePosition& lhs, std::array<TrianglesIntersectionInfo, width>& intersections_info) const
+{
+    if (size == 0)
+        return 0;
+
+#if defined(__AVX__) || defined(__SSE__)
+    auto load_vec3 = [](const Vec3Lanes& lanes) -> LanesVec3<SimdFloat>
+    {
+        return {SimdFloat::Load(lanes.x.values), SimdFloat::Load(lanes.y.values), SimdFloat::Load(lanes.z.values)};
+    };
+
+    TriangleLanes<SimdFloat> lhs_lanes = BroadcastTriangle<SimdFloat>(lhs);
+    TriangleLanes<SimdFloat> rhs_lanes = {load_vec3(points0),
+                                          load_vec3(points1),
+                                          load_vec3(points2)};
+
+    TrianglesIntersectionLanes<SimdFloat> intersection_lanes = IntersectTrianglesLanes(lhs_lanes, rhs_lanes, (1u << size) - 1u);
+
+    uint32_t return_mask = intersection_lanes.intersectMask;
+    if (return_mask != 0)
+    {
+        Vec3Lanes sources;
+        Vec3Lanes targets;
+
+        auto store_vec3 = [](const LanesVec3<SimdFloat>& in_lanes, Vec3Lanes& lanes)
+        {
+            in_lanes.x.Store(lanes.x.values);
+            in_lanes.y.Store(lanes.y.values);
+            in_lanes.z.Store(lanes.z.values);
+        };
+
+        store_vec3(intersection_lanes.source, sources);
+        store_vec3(intersection_lanes.target, targets);
+
+        for (size_t index = 0; index < size; ++index)
+        {
+            intersections_info[index].source = glm::vec3(sources.x.values[index], sources.y.values[index], sources.z.values[index]);
+            intersections_info[index].target = glm::vec3(targets.x.values[index], targets.y.values[index], targets.z.values[index]);
+        }
+    }
+
+    for (size_t index = 0; index < size; ++index)
+    {
+        if (intersection_lanes.fallbackMask & (1u << index))
+        {
+            intersections_info[index] = TrianglePosition::IntersectTriangles(lhs, GetTriangle(index));
+            if (intersections_info[index].doIntersept)
+                return_mask |= 1u << index;
+        }
+        else
+        {
+            intersections_info[index].doIntersept = (return_mask & (1u << index)) != 0;
+            intersections_info[index].areCoplanar = false;
+        }
+    }
+
+    return return_mask;
+#else
+    return IntersectTriangleScalar(lhs, intersections_info);
+#endif
+}
+
+uint32_t TriangleBatch::IntersectTriangleScalar(const TrianglePosition& lhs, std::array<TrianglesIntersectionInfo, width>& intersections_info) const
+{
+    TriangleLanes<ScalarFloat> lhs_lane = BroadcastTriangle<ScalarFloat>(lhs);
+
+    uint32_t return_mask = 0;
+    for (size_t index = 0; index < size; ++index)
+    {
+        auto load_vec3 = [index](const Vec3Lanes& lanes) -> LanesVec3<ScalarFloat>
+        {
+            return {ScalarFloat::Load(&lanes.x.values[index]), ScalarFloat::Load(&lanes.y.values[index]), ScalarFloat::Load(&lanes.z.values[index])};
+        };
+
+        TriangleLanes<ScalarFloat> rhs_lane = {load_vec3(points0),
+                                               load_vec3(points1),
+                                               load_vec3(points2)};
+
+        TrianglesIntersectionLanes<ScalarFloat> intersection_lane = IntersectTrianglesLanes(lhs_lane, rhs_lane, 1u);
+
+        if (intersection_lane.fallbackMask)
+        {
+            intersections_info[index] = TrianglePosition::IntersectTriangles(lhs, GetTriangle(index));
+        }
+        else
+        {
+            intersections_info[index].doIntersept = intersection_lane.intersectMask != 0;
+            intersections_info[index].areCoplanar = false;
+
+            if (intersections_info[index].doIntersept)
+            {
+                intersections_info[index].source = glm::vec3(intersection_lane.source.x.value, intersection_lane.source.y.value, intersection_lane.source.z.value);
+                intersections_info[index].target = glm::vec3(intersection_lane.target.x.value, intersection_lane.target.y.value, intersection_lane.target.z.value);
+            }
+        }
+
+        if (intersections_info[index].doIntersept)
+            return_mask |= 1u << index;
+    }
+
+    return return_mask;
+}
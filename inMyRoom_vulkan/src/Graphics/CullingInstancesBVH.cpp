@@ -0,0 +1,31 @@
+#include "Graphics/CullingInstancesBVH.h"
+
+void CullingInstancesBVH::Update(const std::vector<InstanceKey>& instances_keys,
+                                 const std::function<uint32_t(size_t)>& get_matrix_version,
+                                 const std::function<Paralgram(size_t)>& get_world_paralgram)
+{
+    if (instances_keys != instancesKeys) {
+        instancesKeys = instances_keys;
+        matrixVersions.resize(instancesKeys.size());
+
+        instancesParalgrams.clear();
+        for (size_t index = 0; index != instancesKeys.size(); ++index) {
+            matrixVersions[index] = get_matrix_version(index);
+            instancesParalgrams.emplace_back(get_world_paralgram(index));
+        }
+        bvh.Build(instancesParalgrams);
+        ++buildsCount;
+    } else {
+        bool has_any_moved = false;
+        for (size_t index = 0; index != instancesKeys.size(); ++index) {
+            uint32_t matrix_version = get_matrix_version(index);
+            if (matrix_version != matrixVersions[index]) {
+                matrixVersions[index] = matrix_version;
+                bvh.SetInstance(index, get_world_paralgram(index));
+                has_any_moved = true;
+            }
+        }
+        if (has_any_moved)
+            bvh.Refit();
+    }
+}
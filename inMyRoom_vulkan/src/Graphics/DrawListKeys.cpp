@@ -0,0 +1,32 @@
+#include "Graphics/DrawListKeys.h"
+
+bool DrawListKeys::AreOf(const std::vector<DrawInfo>& draw_infos) const
+{
+    if (keys.size() != draw_infos.size())
+        return false;
+
+    for (size_t draw_index = 0; draw_index != draw_infos.size(); ++draw_index) {
+        const DrawInfo& this_draw_info = draw_infos[draw_index];
+        const Key& this_key = keys[draw_index];
+        if (this_key.meshIndex != this_draw_info.meshIndex
+         || this_key.dynamicMeshIndex != this_draw_info.dynamicMeshIndex
+         || this_key.lightIndex != this_draw_info.lightIndex
+         || this_key.isLightSource != this_draw_info.isLightSource)
+            return false;
+    }
+
+    return true;
+}
+
+void DrawListKeys::Assign(const std::vector<DrawInfo>& draw_infos)
+{
+    keys.clear();
+    for (const DrawInfo& this_draw_info : draw_infos) {
+        Key this_key;
+        this_key.meshIndex = this_draw_info.meshIndex;
+        this_key.dynamicMeshIndex = this_draw_info.dynamicMeshIndex;
+        this_key.lightIndex = this_draw_info.lightIndex;
+        this_key.isLightSource = this_draw_info.isLightSource;
+        keys.emplace_back(this_key);
+    }
+}
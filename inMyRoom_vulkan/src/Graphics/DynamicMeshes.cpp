@@ -2,6 +2,7 @@
 #include "Graphics/Graphics.h"
 #include "Graphics/HelperUtils.h"
 #include <iostream>
+#include <span>
 
 #include "common/structs/AABB.h"
 #include "common/FloatComperableUsingInt.h"
@@ -670,7 +671,8 @@ void DynamicMeshes::CompleteRemovesSafe()
 }
 
 void DynamicMeshes::RecordTransformations(vk::CommandBuffer command_buffer,
-                                          const std::vector<DrawInfo>& draw_infos)
+                                          const std::vector<DrawInfo>& draw_infos,
+                                          const std::vector<float>& morph_weights)
 {
     assert(hasBeenFlashed);
     size_t device_buffer_index = frameIndex % 3;
@@ -723,6 +725,9 @@ void DynamicMeshes::RecordTransformations(vk::CommandBuffer command_buffer,
 
     for (const auto &draw_info: draw_infos) {
         DynamicMeshInfo& dynamic_mesh_info = GetDynamicMeshInfoPriv(draw_info.dynamicMeshIndex);
+        std::span<const float> draw_weights;
+        if (draw_info.weightsCount)
+            draw_weights = std::span<const float>(morph_weights.data() + draw_info.weightsOffset, draw_info.weightsCount);
         assert(dynamic_mesh_info.lastUpdateFrameIndex != frameIndex);
         dynamic_mesh_info.lastUpdateFrameIndex = frameIndex;
         dynamic_mesh_info.inRowUpdatedFrames += 1;
@@ -749,14 +754,14 @@ void DynamicMeshes::RecordTransformations(vk::CommandBuffer command_buffer,
                 push_constants.jointsOffset = uint32_t(this_primitive.jointsByteOffset / (sizeof(uint16_t) * 4));
                 push_constants.weightsOffset = uint32_t(this_primitive.weightsByteOffset / (sizeof(float) * 4));
                 push_constants.jointsGroupsCount = uint32_t(this_primitive.jointsCount);
-                push_constants.morphTargets = std::min(uint32_t(draw_info.weights.size()), maxMorphWeights);
+                push_constants.morphTargets = std::min(uint32_t(draw_weights.size()), maxMorphWeights);
                 push_constants.size_x = uint32_t(this_primitive.verticesCount);
                 push_constants.step_multiplier = 1;
                 push_constants.resultDescriptorIndex = uint32_t(dynamic_mesh_info.descriptorIndexOffset);
                 push_constants.resultOffset = uint32_t(this_dynamic_primitive.positionByteOffset / (sizeof(float) * 4));
                 push_constants.AABBresultOffset = uint32_t(i);
-                std::copy(draw_info.weights.begin(),
-                          draw_info.weights.begin() + std::min(draw_info.weights.size(), push_constants.morph_weights.size()),
+                std::copy(draw_weights.begin(),
+                          draw_weights.begin() + std::min(draw_weights.size(), push_constants.morph_weights.size()),
                           push_constants.morph_weights.begin());
                 command_buffer.pushConstants(position_computeLayout, vk::ShaderStageFlagBits::eCompute, 0, sizeof(DynamicMeshComputePushConstants), &push_constants);
 
@@ -779,13 +784,13 @@ void DynamicMeshes::RecordTransformations(vk::CommandBuffer command_buffer,
                 push_constants.jointsOffset = uint32_t(this_primitive.jointsByteOffset / (sizeof(uint16_t) * 4));
                 push_constants.weightsOffset = uint32_t(this_primitive.weightsByteOffset / (sizeof(float) * 4));
                 push_constants.jointsGroupsCount = uint32_t(this_primitive.jointsCount);
-                push_constants.morphTargets = std::min(uint32_t(draw_info.weights.size()), maxMorphWeights);
+                push_constants.morphTargets = std::min(uint32_t(draw_weights.size()), maxMorphWeights);
                 push_constants.size_x = uint32_t(this_primitive.verticesCount);
                 push_constants.step_multiplier = 1;
                 push_constants.resultDescriptorIndex = uint32_t(dynamic_mesh_info.descriptorIndexOffset);
                 push_constants.resultOffset = uint32_t(this_dynamic_primitive.normalByteOffset / (sizeof(float) * 4));
-                std::copy(draw_info.weights.begin(),
-                          draw_info.weights.begin() + std::min(draw_info.weights.size(), push_constants.morph_weights.size()),
+                std::copy(draw_weights.begin(),
+                          draw_weights.begin() + std::min(draw_weights.size(), push_constants.morph_weights.size()),
                           push_constants.morph_weights.begin());
                 command_buffer.pushConstants(generic_computeLayout, vk::ShaderStageFlagBits::eCompute, 0, sizeof(DynamicMeshComputePushConstants), &push_constants);
 
@@ -807,13 +812,13 @@ void DynamicMeshes::RecordTransformations(vk::CommandBuffer command_buffer,
                 push_constants.jointsOffset = uint32_t(this_primitive.jointsByteOffset / (sizeof(uint16_t) * 4));
                 push_constants.weightsOffset = uint32_t(this_primitive.weightsByteOffset / (sizeof(float) * 4));
                 push_constants.jointsGroupsCount = uint32_t(this_primitive.jointsCount);
-                push_constants.morphTargets = std::min(uint32_t(draw_info.weights.size()), maxMorphWeights);
+                push_constants.morphTargets = std::min(uint32_t(draw_weights.size()), maxMorphWeights);
                 push_constants.size_x = uint32_t(this_primitive.verticesCount);
                 push_constants.step_multiplier = 1;
                 push_constants.resultDescriptorIndex = uint32_t(dynamic_mesh_info.descriptorIndexOffset);
                 push_constants.resultOffset = uint32_t(this_dynamic_primitive.tangentByteOffset / (sizeof(float) * 4));
-                std::copy(draw_info.weights.begin(),
-                          draw_info.weights.begin() + std::min(draw_info.weights.size(), push_constants.morph_weights.size()),
+                std::copy(draw_weights.begin(),
+                          draw_weights.begin() + std::min(draw_weights.size(), push_constants.morph_weights.size()),
                           push_constants.morph_weights.begin());
                 command_buffer.pushConstants(generic_computeLayout, vk::ShaderStageFlagBits::eCompute, 0, sizeof(DynamicMeshComputePushConstants), &push_constants);
 
@@ -833,13 +838,13 @@ void DynamicMeshes::RecordTransformations(vk::CommandBuffer command_buffer,
                 push_constants.jointsOffset = 0;
                 push_constants.weightsOffset = 0;
                 push_constants.jointsGroupsCount = 0;
-                push_constants.morphTargets = std::min(uint32_t(draw_info.weights.size()), maxMorphWeights);
+                push_constants.morphTargets = std::min(uint32_t(draw_weights.size()), maxMorphWeights);
                 push_constants.size_x = uint32_t(this_primitive.verticesCount);
                 push_constants.step_multiplier = 1;
                 push_constants.resultDescriptorIndex = uint32_t(dynamic_mesh_info.descriptorIndexOffset);
                 push_constants.resultOffset = uint32_t(this_dynamic_primitive.colorByteOffset / (sizeof(float) * 4));
-                std::copy(draw_info.weights.begin(),
-                          draw_info.weights.begin() + std::min(draw_info.weights.size(), push_constants.morph_weights.size()),
+                std::copy(draw_weights.begin(),
+                          draw_weights.begin() + std::min(draw_weights.size(), push_constants.morph_weights.size()),
                           push_constants.morph_weights.begin());
                 command_buffer.pushConstants(generic_computeLayout, vk::ShaderStageFlagBits::eCompute, 0, sizeof(DynamicMeshComputePushConstants), &push_constants);
 
@@ -860,13 +865,13 @@ void DynamicMeshes::RecordTransformations(vk::CommandBuffer command_buffer,
                     push_constants.jointsOffset = 0;
                     push_constants.weightsOffset = 0;
                     push_constants.jointsGroupsCount = 0;
-                    push_constants.morphTargets = std::min(uint32_t(draw_info.weights.size()), maxMorphWeights);
+                    push_constants.morphTargets = std::min(uint32_t(draw_weights.size()), maxMorphWeights);
                     push_constants.size_x = uint32_t(this_primitive.verticesCount);
                     push_constants.step_multiplier = uint32_t(this_dynamic_primitive.texcoordsCount);
                     push_constants.resultDescriptorIndex = uint32_t(dynamic_mesh_info.descriptorIndexOffset);
                     push_constants.resultOffset = uint32_t(this_dynamic_primitive.texcoordsByteOffset / (sizeof(float) * 4) + j);
-                    std::copy(draw_info.weights.begin(),
-                              draw_info.weights.begin() + std::min(draw_info.weights.size(), push_constants.morph_weights.size()),
+                    std::copy(draw_weights.begin(),
+                              draw_weights.begin() + std::min(draw_weights.size(), push_constants.morph_weights.size()),
                               push_constants.morph_weights.begin());
                     command_buffer.pushConstants(generic_computeLayout, vk::ShaderStageFlagBits::eCompute, 0, sizeof(DynamicMeshComputePushConstants), &push_constants);
 
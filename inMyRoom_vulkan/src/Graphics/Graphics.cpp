@@ -20,6 +20,9 @@ Graphics::Graphics(Engine* in_engine_ptr, configuru::Config& in_cfgFile, vk::Dev
     graphicsQueue = engine_ptr->GetQueuesList().graphicsQueues[0];
     computeQueue = engine_ptr->GetQueuesList().dedicatedComputeQueues[0];
 
+    if (cfgFile["graphicsSettings"]["parallelDrawList"].as_bool())
+        drawListWorkersPool_ptr = engine_ptr->GetWorkersPoolPtr();
+
     std::cout << "Initializing camera buffers\n";
     InitBuffers();
     std::cout << "Initializing camera descriptor set\n";
@@ -363,6 +366,18 @@ void Graphics::InitMeshesTree()
     materialsOfPrimitives_uptr = std::make_unique<MaterialsOfPrimitives>(texturesOfMaterials_uptr.get(), device, vma_allocator);
 
     primitivesOfMeshes_uptr = std::make_unique<PrimitivesOfMeshes>(materialsOfPrimitives_uptr.get(), device, vma_allocator);
+    if (cfgFile["collisionSettings"]["OBBtreeBuilder"].as_string() == "SAH") {
+        printf("OBBtree builder: SAH\n");
+        primitivesOfMeshes_uptr->SetOBBtreeBuilder(OBBtreeBuilder::SAH, engine_ptr->GetWorkersPoolPtr());
+    }
+    else {
+        printf("OBBtree builder: midpoint\n");
+        primitivesOfMeshes_uptr->SetOBBtreeBuilder(OBBtreeBuilder::midpoint);
+    }
+    if (not cfgFile["collisionSettings"]["OBBtreeCacheFolder"].as_string().empty()) {
+        primitivesOfMeshes_uptr->EnableOBBtreeCache(cfgFile["collisionSettings"]["OBBtreeCacheFolder"].as_string());
+    }
+    primitivesOfMeshes_uptr->SetQuantizeOBBtreeNodes(cfgFile["collisionSettings"]["quantizedOBBtreeNodes"].as_bool());
 
     skinsOfMeshes_uptr = std::make_unique<SkinsOfMeshes>(device, vma_allocator);
 
@@ -401,7 +416,8 @@ void Graphics::InitGraphicsComponents()
     }
 
     {
-        modelDrawComp_uptr = std::make_unique<ModelDrawComp>(engine_ptr->GetECSwrapperPtr());
+        modelDrawComp_uptr = std::make_unique<ModelDrawComp>(engine_ptr->GetECSwrapperPtr(),
+                                                             meshesOfNodes_uptr.get());
         engine_ptr->GetECSwrapperPtr()->AddComponent(modelDrawComp_uptr.get());
     }
 
@@ -473,14 +489,31 @@ void Graphics::EndModelsLoad()
 void Graphics::DrawFrame()
 {
     ViewportFrustum camera_viewport = cameraComp_uptr->GetBindedCameraEntity()->cameraViewportFrustum;
-
-    std::vector<ModelMatrices> matrices;
-    std::vector<LightInfo> light_infos;
-    std::vector<DrawInfo> draw_infos;
-    lightComp_uptr->AddLightInfos(camera_viewport.GetViewMatrix(), matrices, light_infos);
-    modelDrawComp_uptr->AddDrawInfos(camera_viewport.GetViewMatrix(), matrices, draw_infos);
-
-    renderer_uptr->DrawFrame(camera_viewport, std::move(matrices), std::move(light_infos), std::move(draw_infos));
+    const ViewportFrustum& culling_viewport = cameraComp_uptr->GetBindedCameraEntity()->cullingViewportFrustum;
+
+    auto build_start = std::chrono::steady_clock::now();
+
+    frameDrawData.Clear();
+    const std::array<size_t, 5> capacities = {frameDrawData.matrices.capacity(), frameDrawData.lightInfos.capacity(),
+                                              frameDrawData.drawInfos.capacity(), frameDrawData.morphWeights.capacity(),
+                                              frameDrawData.visibleDrawInfos.capacity()};
+
+    lightComp_uptr->AddLightInfos(camera_viewport.GetViewMatrix(), frameDrawData.matrices, frameDrawData.lightInfos);
+    modelDrawComp_uptr->AddDrawInfos(camera_viewport.GetViewMatrix(), frameDrawData.matrices, frameDrawData.drawInfos, frameDrawData.morphWeights);
+    modelDrawComp_uptr->CullDrawInfos(culling_viewport.GetWorldSpacePlanesOfFrustum(), frameDrawData.drawInfos, frameDrawData.visibleDrawInfos);
+
+    const std::array<size_t, 5> built_capacities = {frameDrawData.matrices.capacity(), frameDrawData.lightInfos.capacity(),
+                                                    frameDrawData.drawInfos.capacity(), frameDrawData.morphWeights.capacity(),
+                                                    frameDrawData.visibleDrawInfos.capacity()};
+    ++frameDrawDataGrowthStats.framesCount;
+    frameDrawDataGrowthStats.lastFrameGrownBuffersCount = 0;
+    for (size_t i = 0; i != capacities.size(); ++i)
+        if (built_capacities[i] != capacities[i])
+            ++frameDrawDataGrowthStats.lastFrameGrownBuffersCount;
+    frameDrawDataGrowthStats.grownBuffersCount += frameDrawDataGrowthStats.lastFrameGrownBuffersCount;
+    frameDrawDataGrowthStats.lastFrameBuildDuration = std::chrono::steady_clock::now() - build_start;
+
+    renderer_uptr->DrawFrame(camera_viewport, frameDrawData);
 
     if (not renderer_uptr->IsFreezed()) {
         dynamicMeshes_uptr->CompleteRemovesSafe();
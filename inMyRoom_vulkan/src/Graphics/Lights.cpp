@@ -193,8 +193,7 @@ void Lights::PrepareNewFrame(size_t frame_index)
     lightParameters.clear();
     lightsSpheres.clear();
 
-    combinationToLightsIndicesRange.clear();
-    lightsCombinationsIndices.clear();
+    lightsCombinations.Clear();
 
     uniformLuminance = glm::vec3(0.f);
 }
@@ -232,6 +231,12 @@ void Lights::AddLights(std::vector<LightInfo>& light_infos,
             uniformLuminance += this_light_info.luminance;
         }
     }
+
+    localLightsIndices.clear();
+    for (size_t i = 0; i != lightParameters.size(); ++i)
+        if (lightParameters[i].lightType != uint8_t(LightType::Cone))
+            localLightsIndices.emplace_back(uint32_t(i));
+    localLightsBVH.Build(lightsSpheres, localLightsIndices);
 }
 
 LightsIndicesRange Lights::CreateLightsConesRange()
@@ -244,40 +249,24 @@ LightsIndicesRange Lights::CreateLightsConesRange()
         }
     }
 
-    LightsIndicesRange return_range = {};
-    return_range.offset = uint32_t(lightsCombinationsIndices.size());
-    return_range.size = uint32_t(cone_lights_indices.size());
-
-    std::copy(cone_lights_indices.begin(), cone_lights_indices.end(),
-              std::back_inserter(lightsCombinationsIndices));
-
-    return return_range;
+    return lightsCombinations.AddRange(cone_lights_indices);
 }
 
-LightsIndicesRange Lights::CreateCollidedLightsRange(const Paralgram& paralgram)
+LightsIndicesRange Lights::CreateCollidedLightsRange(const Paralgram& paralgram, CollidedLightsChunk& chunk) const
 {
-    std::vector<uint16_t> collided_lights = CollideParalgramWithLocalLights(paralgram);
+    CollideParalgramWithLocalLights(paralgram, chunk);
 
     LightsIndicesRange return_range = {};
-    if (collided_lights.size() == 0)
+    if (chunk.collidedLightsCombination.size() == 0)
         return return_range;
 
-    auto search = combinationToLightsIndicesRange.find(collided_lights);
-    if (search != combinationToLightsIndicesRange.end()) {
-        return_range = search->second;
-    } else {
-        return_range.offset = uint32_t(lightsCombinationsIndices.size());
-        return_range.size = uint32_t(collided_lights.size());
-
-        std::copy(collided_lights.begin(), collided_lights.end(),
-                  std::back_inserter(lightsCombinationsIndices));
-
-        assert(lightsCombinationsIndices.size() <= max_lightCombinationsSize);
-
-        combinationToLightsIndicesRange.emplace(std::move(collided_lights), return_range);
-    }
+    return chunk.combinations.FindOrAddCombination(chunk.collidedLightsCombination);
+}
 
-    return return_range;
+void Lights::MergeCollidedLightsChunk(CollidedLightsChunk& chunk)
+{
+    lightsCombinations.MergeCombinations(chunk.combinations, chunk.mergedOffsets);
+    assert(lightsCombinations.GetIndices().size() <= max_lightCombinationsSize);
 }
 
 void Lights::WriteLightsBuffers() const
@@ -293,27 +282,22 @@ void Lights::WriteLightsBuffers() const
 
     { // Lights combinations
         memcpy((std::byte*)(lightsCombinationsAllocInfo.pMappedData) + hostVisible_buffer_index * lightsCombinationsRangeSize,
-               lightsCombinationsIndices.data(),
-               sizeof(uint16_t) * lightsCombinationsIndices.size());
+               lightsCombinations.GetIndices().data(),
+               sizeof(uint16_t) * lightsCombinations.GetIndices().size());
         vma_allocator.flushAllocation(lightsCombinationsAllocation, hostVisible_buffer_index * lightsCombinationsRangeSize, lightsCombinationsRangeSize);
     }
 }
 
-std::vector<uint16_t> Lights::CollideParalgramWithLocalLights(const Paralgram &paralgram)
+void Lights::CollideParalgramWithLocalLights(const Paralgram& paralgram, CollidedLightsChunk& chunk) const
 {
     assert(lightsSpheres.size() < std::numeric_limits<uint16_t>::max());
 
-    std::vector<uint16_t> return_vector;
-    for (size_t i = 0; i != lightsSpheres.size(); ++i) {
-        const auto& this_lightParameters = lightParameters[i];
-        const auto& this_sphere = lightsSpheres[i];
-        if (this_lightParameters.lightType != uint8_t(LightType::Cone)
-         && this_sphere.IntersectParalgram(paralgram)) {
-            return_vector.emplace_back(uint16_t(i));
-        }
-    }
+    // Ascending, same as testing every local light in order
+    localLightsBVH.CollideParalgram(paralgram, chunk.collidedLights, chunk.traversalStack);
 
-    return return_vector;
+    chunk.collidedLightsCombination.clear();
+    for (uint32_t this_light : chunk.collidedLights)
+        chunk.collidedLightsCombination.emplace_back(uint16_t(this_light));
 }
 
 const LightInfo &Lights::GetLightInfo(size_t light_index) const
@@ -0,0 +1,115 @@
+#include "Graphics/LightsCombinations.h"
+
+#include <algorithm>
+#include <cassert>
+
+LightsCombinations::LightsCombinations()
+    :slots(initialSlotsCount, Slot{})
+{
+}
+
+void LightsCombinations::Clear()
+{
+    indices.clear();
+    ranges.clear();
+
+    std::fill(slots.begin(), slots.end(), Slot{});
+    combinationsCount = 0;
+}
+
+LightsIndicesRange LightsCombinations::FindOrAddCombination(std::span<const uint16_t> combination)
+{
+    assert(combination.size());
+
+    size_t hash = GetHash(combination);
+    size_t mask = slots.size() - 1;
+    for (size_t slot_index = hash & mask; ; slot_index = (slot_index + 1) & mask) {
+        const Slot& this_slot = slots[slot_index];
+        if (this_slot.range.size == 0)
+            break;
+
+        if (this_slot.hash == hash
+         && this_slot.range.size == combination.size()
+         && std::equal(combination.begin(), combination.end(), indices.begin() + this_slot.range.offset))
+            return this_slot.range;
+    }
+
+    LightsIndicesRange return_range = AddRange(combination);
+
+    // At most half full, so probing stays short
+    if (2 * (combinationsCount + 1) > slots.size())
+        Grow();
+
+    mask = slots.size() - 1;
+    size_t slot_index = hash & mask;
+    while (slots[slot_index].range.size != 0)
+        slot_index = (slot_index + 1) & mask;
+
+    slots[slot_index] = Slot{hash, return_range};
+    ++combinationsCount;
+
+    return return_range;
+}
+
+LightsIndicesRange LightsCombinations::AddRange(std::span<const uint16_t> in_indices)
+{
+    LightsIndicesRange return_range = {};
+    return_range.offset = uint32_t(indices.size());
+    return_range.size = uint32_t(in_indices.size());
+
+    indices.insert(indices.end(), in_indices.begin(), in_indices.end());
+    ranges.emplace_back(return_range);
+
+    return return_range;
+}
+
+void LightsCombinations::MergeCombinations(const LightsCombinations& other, std::vector<uint32_t>& merged_offsets)
+{
+    merged_offsets.resize(other.indices.size());
+    for (const LightsIndicesRange& other_range : other.ranges) {
+        if (other_range.size == 0)
+            continue;
+
+        std::span<const uint16_t> combination(other.indices.data() + other_range.offset, other_range.size);
+        merged_offsets[other_range.offset] = FindOrAddCombination(combination).offset;
+    }
+}
+
+size_t LightsCombinations::GetHash(std::span<const uint16_t> combination)
+{
+    // FNV-1a over the indices two at a time, then a finalizer so the low bits, which pick the slot, depend on every index
+    size_t hash = 14695981039346656037ull ^ combination.size();
+    size_t i = 0;
+    for (; i + 1 < combination.size(); i += 2) {
+        hash ^= size_t(combination[i]) | (size_t(combination[i + 1]) << 16);
+        hash *= 1099511628211ull;
+    }
+    if (i < combination.size()) {
+        hash ^= size_t(combination[i]);
+        hash *= 1099511628211ull;
+    }
+
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdull;
+    hash ^= hash >> 33;
+
+    return hash;
+}
+
+void LightsCombinations::Grow()
+{
+    std::vector<Slot> old_slots(slots.size() * 2, Slot{});
+    old_slots.swap(slots);
+
+    size_t mask = slots.size() - 1;
+    for (const Slot& this_slot : old_slots) {
+        if (this_slot.range.size == 0)
+            continue;
+
+        size_t slot_index = this_slot.hash & mask;
+        while (slots[slot_index].range.size != 0)
+            slot_index = (slot_index + 1) & mask;
+
+        slots[slot_index] = this_slot;
+    }
+}
@@ -832,6 +832,24 @@ size_t PrimitivesOfMeshes::AddPrimitive(const std::vector<uint32_t> &indices, co
     return index;
 }
 
+void PrimitivesOfMeshes::SetOBBtreeBuilder(OBBtreeBuilder builder, WorkersPool* workers_pool_ptr)
+{
+    obbTreeBuilder = builder;
+    obbTreeBuildWorkersPool_ptr = workers_pool_ptr;
+}
+
+void PrimitivesOfMeshes::EnableOBBtreeCache(std::string cache_folder)
+{
+    obbTreeCache_uptr = std::make_unique<OBBtreeCache>(std::move(cache_folder));
+    if (not obbTreeCache_uptr->IsEnabled())
+        obbTreeCache_uptr.reset();
+}
+
+void PrimitivesOfMeshes::SetQuantizeOBBtreeNodes(bool should_quantize)
+{
+    quantizeOBBtreeNodes = should_quantize;
+}
+
 void PrimitivesOfMeshes::StartRecordOBBtree()
 {
     recordingOBBtree = true;
@@ -854,7 +872,23 @@ OBBtree PrimitivesOfMeshes::GetOBBtreeAndReset()
         }
     }
 
-    OBBtree return_OBBtree(std::move(triangles));
+    OBBtree return_OBBtree;
+    if (obbTreeCache_uptr) {
+        uint64_t cache_key = OBBtreeCache::GetKey(triangles, obbTreeBuilder);
+
+        std::optional<OBBtree> cached_OBBtree = obbTreeCache_uptr->Load(cache_key);
+        if (cached_OBBtree.has_value()) {
+            return_OBBtree = std::move(cached_OBBtree.value());
+        } else {
+            return_OBBtree = OBBtree(std::move(triangles), obbTreeBuilder, obbTreeBuildWorkersPool_ptr);
+            obbTreeCache_uptr->Store(cache_key, return_OBBtree);
+        }
+    } else {
+        return_OBBtree = OBBtree(std::move(triangles), obbTreeBuilder, obbTreeBuildWorkersPool_ptr);
+    }
+
+    if (quantizeOBBtreeNodes)
+        return_OBBtree.QuantizeNodes();
 
     recorderPrimitivesOBBtreeDatas.clear();
     recordingOBBtree = false;
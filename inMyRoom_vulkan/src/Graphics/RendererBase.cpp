@@ -1,21 +1,111 @@
 #include "Graphics/RendererBase.h"
 
 #include "Graphics/Graphics.h"
+#include "WorkersPool.h"
 
-std::vector<RendererBase::PrimitiveInstanceParameters> RendererBase::CreatePrimitivesInstanceParameters()
+#include <algorithm>
+#include <functional>
+#include <tuple>
+
+void RendererBase::SwapFrameDrawData(FrameDrawData& frame_draw_data)
 {
-    std::vector<PrimitiveInstanceParameters> return_vector;
+    matrices.swap(frame_draw_data.matrices);
+    lightInfos.swap(frame_draw_data.lightInfos);
+    drawInfos.swap(frame_draw_data.drawInfos);
+    morphWeights.swap(frame_draw_data.morphWeights);
+    visibleDrawInfos.swap(frame_draw_data.visibleDrawInfos);
+}
+
+void RendererBase::UpdateDrawList(const std::vector<vk::Pipeline>& primitives_pipelines,
+                                  std::vector<PrimitiveInstanceParameters>& primitive_instance_parameters)
+{
+    ++drawListStats.framesCount;
+    if (not drawListKeys.AreOf(drawInfos)) {
+        RebuildDrawList(primitives_pipelines);
+        ++drawListStats.rebuildsCount;
+    }
+
+    primitive_instance_parameters.assign(drawListInstanceParameters.begin(), drawListInstanceParameters.end());
+
+    SplitDrawListChunks();
+
+    WorkersPool* workers_pool_ptr = graphics_ptr->GetDrawListWorkersPool();
+    auto for_chunks = [this, workers_pool_ptr](const std::function<void(size_t, size_t)>& chunks_func)
+    {
+        if (workers_pool_ptr != nullptr && drawListChunks.size() > 1)
+            workers_pool_ptr->ParallelFor(drawListChunks.size(), 1, chunks_func);
+        else
+            chunks_func(0, drawListChunks.size());
+    };
+
+    // Every chunk writes its primitives with lights ranges at its own combinations
+    for_chunks([this, &primitive_instance_parameters](size_t first_chunk, size_t last_chunk)
+    {
+        for (size_t chunk_index = first_chunk; chunk_index != last_chunk; ++chunk_index) {
+            DrawListChunk& this_chunk = drawListChunks[chunk_index];
+            this_chunk.collidedLightsChunk.combinations.Clear();
+
+            for (size_t draw_index = this_chunk.firstDrawIndex; draw_index != this_chunk.lastDrawIndex; ++draw_index) {
+                DrawInfo& this_draw_info = drawInfos[draw_index];
+                this_draw_info.primitivesInstanceOffset = drawListInstanceOffsets[draw_index];
+
+                PrimitiveInstanceParameters* parameters_ptr = primitive_instance_parameters.data() + this_draw_info.primitivesInstanceOffset;
+                if (this_draw_info.dynamicMeshIndex != -1)
+                    WritePrimitivesStaticParameters(this_draw_info, parameters_ptr);
+                WritePrimitivesFrameParameters(this_draw_info, parameters_ptr, this_chunk.collidedLightsChunk);
+            }
+        }
+    });
+
+    // Merging at the chunks' order adds the combinations at the order of their first primitive, same as a serial pass
+    for (DrawListChunk& this_chunk : drawListChunks)
+        graphics_ptr->GetLights()->MergeCollidedLightsChunk(this_chunk.collidedLightsChunk);
+
+    for_chunks([this, &primitive_instance_parameters](size_t first_chunk, size_t last_chunk)
+    {
+        for (size_t chunk_index = first_chunk; chunk_index != last_chunk; ++chunk_index) {
+            const DrawListChunk& this_chunk = drawListChunks[chunk_index];
+            if (this_chunk.firstDrawIndex == this_chunk.lastDrawIndex)
+                continue;
+
+            const std::vector<uint32_t>& merged_offsets = this_chunk.collidedLightsChunk.mergedOffsets;
+
+            size_t first_instance = drawListInstanceOffsets[this_chunk.firstDrawIndex];
+            size_t last_instance = this_chunk.lastDrawIndex != drawInfos.size() ? drawListInstanceOffsets[this_chunk.lastDrawIndex]
+                                                                                 : primitive_instance_parameters.size();
+            for (size_t instance_index = first_instance; instance_index != last_instance; ++instance_index) {
+                PrimitiveInstanceParameters& this_parameters = primitive_instance_parameters[instance_index];
+                if (this_parameters.lightsCombinationsCount != 0)
+                    this_parameters.lightsCombinationsOffset = merged_offsets[this_parameters.lightsCombinationsOffset];
+            }
+        }
+    });
+
+    // Culled instances keep their parameters, ray tracing still sees them
+    isDrawInfoVisible.assign(drawInfos.size(), false);
+    for (uint32_t this_draw_index : visibleDrawInfos)
+        isDrawInfoVisible[this_draw_index] = true;
+
+    visiblePrimitiveDraws.clear();
+    for (const PrimitiveDraw& this_primitive_draw : sortedPrimitiveDraws)
+        if (isDrawInfoVisible[this_primitive_draw.drawInfoIndex])
+            visiblePrimitiveDraws.emplace_back(this_primitive_draw);
+}
+
+void RendererBase::RebuildDrawList(const std::vector<vk::Pipeline>& primitives_pipelines)
+{
+    const PrimitiveInfo& default_primitive_info = graphics_ptr->GetPrimitivesOfMeshes()->GetDefaultPrimitiveInfo();
 
     PrimitiveInstanceParameters default_instance_parameters = {};
-    default_instance_parameters.material = graphics_ptr->GetPrimitivesOfMeshes()->GetDefaultPrimitiveInfo().material;
+    default_instance_parameters.material = default_primitive_info.material;
     default_instance_parameters.matricesOffset = 0;
     default_instance_parameters.prevMatricesOffset = -1;
-    default_instance_parameters.indicesOffset = graphics_ptr->GetPrimitivesOfMeshes()->GetDefaultPrimitiveInfo().indicesByteOffset / sizeof(uint32_t);
-    default_instance_parameters.positionOffset = graphics_ptr->GetPrimitivesOfMeshes()->GetDefaultPrimitiveInfo().positionByteOffset / sizeof(glm::vec4);
-    default_instance_parameters.normalOffset = graphics_ptr->GetPrimitivesOfMeshes()->GetDefaultPrimitiveInfo().normalByteOffset / sizeof(glm::vec4);
-    default_instance_parameters.tangentOffset = graphics_ptr->GetPrimitivesOfMeshes()->GetDefaultPrimitiveInfo().tangentByteOffset / sizeof(glm::vec4);
-    default_instance_parameters.texcoordsOffset = graphics_ptr->GetPrimitivesOfMeshes()->GetDefaultPrimitiveInfo().texcoordsByteOffset / sizeof(glm::vec2);
-    default_instance_parameters.colorOffset = graphics_ptr->GetPrimitivesOfMeshes()->GetDefaultPrimitiveInfo().colorByteOffset / sizeof(glm::vec4);
+    default_instance_parameters.indicesOffset = default_primitive_info.indicesByteOffset / sizeof(uint32_t);
+    default_instance_parameters.positionOffset = default_primitive_info.positionByteOffset / sizeof(glm::vec4);
+    default_instance_parameters.normalOffset = default_primitive_info.normalByteOffset / sizeof(glm::vec4);
+    default_instance_parameters.tangentOffset = default_primitive_info.tangentByteOffset / sizeof(glm::vec4);
+    default_instance_parameters.texcoordsOffset = default_primitive_info.texcoordsByteOffset / sizeof(glm::vec2);
+    default_instance_parameters.colorOffset = default_primitive_info.colorByteOffset / sizeof(glm::vec4);
     default_instance_parameters.positionDescriptorIndex = 0;
     default_instance_parameters.normalDescriptorIndex = 0;
     default_instance_parameters.tangentDescriptorIndex = 0;
@@ -24,127 +114,209 @@ std::vector<RendererBase::PrimitiveInstanceParameters> RendererBase::CreatePrimi
     default_instance_parameters.indicesSetMultiplier = 3;
     default_instance_parameters.texcoordsStepMultiplier = 1;
     default_instance_parameters.colorStepMultiplier = 1;
-    return_vector.emplace_back(default_instance_parameters);
-
-    for (DrawInfo& this_draw_info : drawInfos) {
-        this_draw_info.primitivesInstanceOffset = return_vector.size();
-
-        std::vector<PrimitiveInfo> primitives_info;
-        std::vector<DynamicMeshInfo::DynamicPrimitiveInfo> dynamic_primitives_info;
-        uint32_t descriptor_index = 0;
-        if (this_draw_info.dynamicMeshIndex != -1) {
-            descriptor_index = graphics_ptr->GetDynamicMeshes()->GetDynamicMeshInfo(this_draw_info.dynamicMeshIndex).descriptorIndexOffset + 1;
-            dynamic_primitives_info = graphics_ptr->GetDynamicMeshes()->GetDynamicMeshInfo(this_draw_info.dynamicMeshIndex).dynamicPrimitives;
-            for (const auto& this_dynamic_primitive_info: dynamic_primitives_info) {
-                const PrimitiveInfo &this_primitive_info = graphics_ptr->GetPrimitivesOfMeshes()->GetPrimitiveInfo(this_dynamic_primitive_info.primitiveIndex);
-                primitives_info.emplace_back(this_primitive_info);
-            }
-        } else {
-            for (size_t primitive_index : graphics_ptr->GetMeshesOfNodesPtr()->GetMeshInfo(this_draw_info.meshIndex).primitivesIndex) {
-                const PrimitiveInfo& primitive_info = graphics_ptr->GetPrimitivesOfMeshes()->GetPrimitiveInfo(primitive_index);
-                primitives_info.emplace_back(primitive_info);
-                dynamic_primitives_info.emplace_back();
-            }
+
+    drawListKeys.Assign(drawInfos);
+    drawListInstanceOffsets.clear();
+    drawListInstanceParameters.assign(1, default_instance_parameters);
+    sortedPrimitiveDraws.clear();
+
+    for (size_t draw_index = 0; draw_index != drawInfos.size(); ++draw_index) {
+        const DrawInfo& this_draw_info = drawInfos[draw_index];
+
+        size_t instance_offset = drawListInstanceParameters.size();
+        drawListInstanceOffsets.emplace_back(instance_offset);
+        drawListInstanceParameters.resize(instance_offset + GetPrimitivesCount(this_draw_info));
+        WritePrimitivesStaticParameters(this_draw_info, drawListInstanceParameters.data() + instance_offset);
+
+        if (this_draw_info.isLightSource)
+            continue;
+
+        const std::vector<size_t>& primitives_index = graphics_ptr->GetMeshesOfNodesPtr()->GetMeshInfo(this_draw_info.meshIndex).primitivesIndex;
+        for (size_t i = 0; i != primitives_index.size(); ++i) {
+            // Transparent primitives have no visibility pipeline
+            if (not primitives_pipelines[primitives_index[i]])
+                continue;
+
+            PrimitiveDraw this_primitive_draw;
+            this_primitive_draw.pipeline = primitives_pipelines[primitives_index[i]];
+            this_primitive_draw.material = graphics_ptr->GetPrimitivesOfMeshes()->GetPrimitiveInfo(primitives_index[i]).material;
+            this_primitive_draw.meshIndex = this_draw_info.meshIndex;
+            this_primitive_draw.primitiveIndex = primitives_index[i];
+            this_primitive_draw.drawInfoIndex = draw_index;
+            this_primitive_draw.primitiveNumber = i;
+
+            sortedPrimitiveDraws.emplace_back(this_primitive_draw);
         }
+    }
 
-        for (size_t i = 0; i != primitives_info.size(); ++i) {
-            PrimitiveInstanceParameters this_primitiveInstanceParameters = {};
+    std::sort(sortedPrimitiveDraws.begin(), sortedPrimitiveDraws.end(), [](const PrimitiveDraw& lhs, const PrimitiveDraw& rhs)
+    {
+        return std::tie(lhs.pipeline, lhs.material, lhs.meshIndex, lhs.primitiveIndex, lhs.drawInfoIndex)
+             < std::tie(rhs.pipeline, rhs.material, rhs.meshIndex, rhs.primitiveIndex, rhs.drawInfoIndex);
+    });
+}
 
-            this_primitiveInstanceParameters.material = primitives_info[i].material;
-            this_primitiveInstanceParameters.matricesOffset = this_draw_info.matricesOffset;
-            this_primitiveInstanceParameters.prevMatricesOffset = this_draw_info.prevMatricesOffset;
+void RendererBase::SplitDrawListChunks()
+{
+    // Instance 0 is the default parameters, draw infos' primitives follow at drawListInstanceOffsets
+    size_t primitives_count = drawListInstanceParameters.size() - 1;
 
-            if (primitives_info[i].drawMode == vk::PrimitiveTopology::eTriangleList)
-                this_primitiveInstanceParameters.indicesSetMultiplier = 3;
-            else if (primitives_info[i].drawMode == vk::PrimitiveTopology::eLineList)
-                this_primitiveInstanceParameters.indicesSetMultiplier = 2;
-            else
-                this_primitiveInstanceParameters.indicesSetMultiplier = 1;
+    size_t chunks_count = 1;
+    WorkersPool* workers_pool_ptr = graphics_ptr->GetDrawListWorkersPool();
+    if (workers_pool_ptr != nullptr)
+        chunks_count = std::clamp(primitives_count / drawListChunkMinPrimitives, size_t(1), workers_pool_ptr->GetThreadsCount() * drawListChunksPerThread);
 
-            this_primitiveInstanceParameters.indicesOffset = primitives_info[i].indicesByteOffset / sizeof(uint32_t);
+    drawListChunks.resize(chunks_count);
+    size_t first_draw_index = 0;
+    for (size_t chunk_index = 0; chunk_index != chunks_count; ++chunk_index) {
+        size_t last_draw_index = drawInfos.size();
+        if (chunk_index + 1 != chunks_count) {
+            size_t chunk_end_instance = 1 + (primitives_count * (chunk_index + 1)) / chunks_count;
+            last_draw_index = std::lower_bound(drawListInstanceOffsets.begin(), drawListInstanceOffsets.end(), chunk_end_instance) - drawListInstanceOffsets.begin();
+            last_draw_index = std::max(last_draw_index, first_draw_index);
+        }
 
-            if (dynamic_primitives_info[i].positionByteOffset != -1) {
-                this_primitiveInstanceParameters.positionOffset = dynamic_primitives_info[i].positionByteOffset / sizeof(glm::vec4);
-                this_primitiveInstanceParameters.positionDescriptorIndex = descriptor_index;
-            } else {
-                this_primitiveInstanceParameters.positionOffset = primitives_info[i].positionByteOffset / sizeof(glm::vec4);
-                this_primitiveInstanceParameters.positionDescriptorIndex = 0;
-            }
+        drawListChunks[chunk_index].firstDrawIndex = first_draw_index;
+        drawListChunks[chunk_index].lastDrawIndex = last_draw_index;
+        first_draw_index = last_draw_index;
+    }
+}
 
-            if (dynamic_primitives_info[i].normalByteOffset != -1) {
-                this_primitiveInstanceParameters.normalOffset = dynamic_primitives_info[i].normalByteOffset / sizeof(glm::vec4);
-                this_primitiveInstanceParameters.normalDescriptorIndex = descriptor_index;
-            } else {
-                assert(this_draw_info.isLightSource || primitives_info[i].normalByteOffset != -1);
-                this_primitiveInstanceParameters.normalOffset = primitives_info[i].normalByteOffset / sizeof(glm::vec4);
-                this_primitiveInstanceParameters.normalDescriptorIndex = 0;
-            }
+size_t RendererBase::GetPrimitivesCount(const DrawInfo& draw_info) const
+{
+    if (draw_info.dynamicMeshIndex != -1)
+        return graphics_ptr->GetDynamicMeshes()->GetDynamicMeshInfo(draw_info.dynamicMeshIndex).dynamicPrimitives.size();
+    else
+        return graphics_ptr->GetMeshesOfNodesPtr()->GetMeshInfo(draw_info.meshIndex).primitivesIndex.size();
+}
 
-            if (dynamic_primitives_info[i].tangentByteOffset != -1) {
-                this_primitiveInstanceParameters.tangentOffset = dynamic_primitives_info[i].tangentByteOffset / sizeof(glm::vec4);
-                this_primitiveInstanceParameters.tangentDescriptorIndex = descriptor_index;
-            } else {
-                assert(this_draw_info.isLightSource || primitives_info[i].tangentByteOffset != -1);
-                this_primitiveInstanceParameters.tangentOffset = primitives_info[i].tangentByteOffset / sizeof(glm::vec4);
-                this_primitiveInstanceParameters.tangentDescriptorIndex = 0;
-            }
+void RendererBase::WritePrimitivesStaticParameters(const DrawInfo& draw_info, PrimitiveInstanceParameters* parameters_ptr) const
+{
+    const PrimitiveInfo& default_primitive_info = graphics_ptr->GetPrimitivesOfMeshes()->GetDefaultPrimitiveInfo();
+    const DynamicMeshInfo::DynamicPrimitiveInfo not_dynamic_primitive_info;
+
+    const DynamicMeshInfo* dynamic_mesh_info_ptr = nullptr;
+    uint32_t descriptor_index = 0;
+    if (draw_info.dynamicMeshIndex != -1) {
+        dynamic_mesh_info_ptr = &graphics_ptr->GetDynamicMeshes()->GetDynamicMeshInfo(draw_info.dynamicMeshIndex);
+        descriptor_index = dynamic_mesh_info_ptr->descriptorIndexOffset + 1;
+    }
+
+    size_t primitives_count = GetPrimitivesCount(draw_info);
+    for (size_t i = 0; i != primitives_count; ++i) {
+        const DynamicMeshInfo::DynamicPrimitiveInfo& dynamic_primitive_info = dynamic_mesh_info_ptr ? dynamic_mesh_info_ptr->dynamicPrimitives[i] : not_dynamic_primitive_info;
+        size_t primitive_index = dynamic_mesh_info_ptr ? dynamic_primitive_info.primitiveIndex
+                                                       : graphics_ptr->GetMeshesOfNodesPtr()->GetMeshInfo(draw_info.meshIndex).primitivesIndex[i];
+        const PrimitiveInfo& primitive_info = graphics_ptr->GetPrimitivesOfMeshes()->GetPrimitiveInfo(primitive_index);
+
+        PrimitiveInstanceParameters this_primitiveInstanceParameters = {};
+
+        this_primitiveInstanceParameters.material = primitive_info.material;
+
+        if (primitive_info.drawMode == vk::PrimitiveTopology::eTriangleList)
+            this_primitiveInstanceParameters.indicesSetMultiplier = 3;
+        else if (primitive_info.drawMode == vk::PrimitiveTopology::eLineList)
+            this_primitiveInstanceParameters.indicesSetMultiplier = 2;
+        else
+            this_primitiveInstanceParameters.indicesSetMultiplier = 1;
+
+        this_primitiveInstanceParameters.indicesOffset = primitive_info.indicesByteOffset / sizeof(uint32_t);
+
+        if (dynamic_primitive_info.positionByteOffset != -1) {
+            this_primitiveInstanceParameters.positionOffset = dynamic_primitive_info.positionByteOffset / sizeof(glm::vec4);
+            this_primitiveInstanceParameters.positionDescriptorIndex = descriptor_index;
+        } else {
+            this_primitiveInstanceParameters.positionOffset = primitive_info.positionByteOffset / sizeof(glm::vec4);
+            this_primitiveInstanceParameters.positionDescriptorIndex = 0;
+        }
 
-            if (dynamic_primitives_info[i].texcoordsByteOffset != -1) {
-                this_primitiveInstanceParameters.texcoordsStepMultiplier = dynamic_primitives_info[i].texcoordsCount;
-                this_primitiveInstanceParameters.texcoordsOffset = dynamic_primitives_info[i].texcoordsByteOffset / sizeof(glm::vec2);
-                this_primitiveInstanceParameters.texcoordsDescriptorIndex = descriptor_index;
+        if (dynamic_primitive_info.normalByteOffset != -1) {
+            this_primitiveInstanceParameters.normalOffset = dynamic_primitive_info.normalByteOffset / sizeof(glm::vec4);
+            this_primitiveInstanceParameters.normalDescriptorIndex = descriptor_index;
+        } else {
+            assert(draw_info.isLightSource || primitive_info.normalByteOffset != -1);
+            this_primitiveInstanceParameters.normalOffset = primitive_info.normalByteOffset / sizeof(glm::vec4);
+            this_primitiveInstanceParameters.normalDescriptorIndex = 0;
+        }
+
+        if (dynamic_primitive_info.tangentByteOffset != -1) {
+            this_primitiveInstanceParameters.tangentOffset = dynamic_primitive_info.tangentByteOffset / sizeof(glm::vec4);
+            this_primitiveInstanceParameters.tangentDescriptorIndex = descriptor_index;
+        } else {
+            assert(draw_info.isLightSource || primitive_info.tangentByteOffset != -1);
+            this_primitiveInstanceParameters.tangentOffset = primitive_info.tangentByteOffset / sizeof(glm::vec4);
+            this_primitiveInstanceParameters.tangentDescriptorIndex = 0;
+        }
+
+        if (dynamic_primitive_info.texcoordsByteOffset != -1) {
+            this_primitiveInstanceParameters.texcoordsStepMultiplier = dynamic_primitive_info.texcoordsCount;
+            this_primitiveInstanceParameters.texcoordsOffset = dynamic_primitive_info.texcoordsByteOffset / sizeof(glm::vec2);
+            this_primitiveInstanceParameters.texcoordsDescriptorIndex = descriptor_index;
+        } else {
+            if (primitive_info.texcoordsByteOffset != -1) {
+                this_primitiveInstanceParameters.texcoordsStepMultiplier = primitive_info.texcoordsCount;
+                this_primitiveInstanceParameters.texcoordsOffset = primitive_info.texcoordsByteOffset / sizeof(glm::vec2);
+                this_primitiveInstanceParameters.texcoordsDescriptorIndex = 0;
             } else {
-                if (primitives_info[i].texcoordsByteOffset != -1) {
-                    this_primitiveInstanceParameters.texcoordsStepMultiplier = primitives_info[i].texcoordsCount;
-                    this_primitiveInstanceParameters.texcoordsOffset = primitives_info[i].texcoordsByteOffset / sizeof(glm::vec2);
-                    this_primitiveInstanceParameters.texcoordsDescriptorIndex = 0;
-                } else {
-                    this_primitiveInstanceParameters.texcoordsStepMultiplier = 0;
-                    this_primitiveInstanceParameters.texcoordsOffset = graphics_ptr->GetPrimitivesOfMeshes()->GetDefaultPrimitiveInfo().texcoordsByteOffset / sizeof(glm::vec2);
-                    this_primitiveInstanceParameters.texcoordsDescriptorIndex = 0;
-                }
+                this_primitiveInstanceParameters.texcoordsStepMultiplier = 0;
+                this_primitiveInstanceParameters.texcoordsOffset = default_primitive_info.texcoordsByteOffset / sizeof(glm::vec2);
+                this_primitiveInstanceParameters.texcoordsDescriptorIndex = 0;
             }
+        }
 
-            if (dynamic_primitives_info[i].colorByteOffset != -1) {
+        if (dynamic_primitive_info.colorByteOffset != -1) {
+            this_primitiveInstanceParameters.colorStepMultiplier = 1;
+            this_primitiveInstanceParameters.colorOffset = dynamic_primitive_info.colorByteOffset / sizeof(glm::vec4);
+            this_primitiveInstanceParameters.colorDescriptorIndex = descriptor_index;
+        } else {
+            if (primitive_info.colorByteOffset != -1) {
                 this_primitiveInstanceParameters.colorStepMultiplier = 1;
-                this_primitiveInstanceParameters.colorOffset = dynamic_primitives_info[i].colorByteOffset / sizeof(glm::vec4);
-                this_primitiveInstanceParameters.colorDescriptorIndex = descriptor_index;
+                this_primitiveInstanceParameters.colorOffset = primitive_info.colorByteOffset / sizeof(glm::vec4);
+                this_primitiveInstanceParameters.colorDescriptorIndex = 0;
             } else {
-                if (primitives_info[i].colorByteOffset != -1) {
-                    this_primitiveInstanceParameters.colorStepMultiplier = 1;
-                    this_primitiveInstanceParameters.colorOffset = primitives_info[i].colorByteOffset / sizeof(glm::vec4);
-                    this_primitiveInstanceParameters.colorDescriptorIndex = 0;
-                } else {
-                    this_primitiveInstanceParameters.colorStepMultiplier = 0;
-                    this_primitiveInstanceParameters.colorOffset = graphics_ptr->GetPrimitivesOfMeshes()->GetDefaultPrimitiveInfo().colorByteOffset / sizeof(glm::vec4);
-                    this_primitiveInstanceParameters.colorDescriptorIndex = 0;
-                }
+                this_primitiveInstanceParameters.colorStepMultiplier = 0;
+                this_primitiveInstanceParameters.colorOffset = default_primitive_info.colorByteOffset / sizeof(glm::vec4);
+                this_primitiveInstanceParameters.colorDescriptorIndex = 0;
             }
+        }
 
-            if (this_draw_info.isLightSource) {
-                auto light_offset = uint16_t(graphics_ptr->GetLights()->GetLightInfo(this_draw_info.lightIndex).lightOffset);
-                this_primitiveInstanceParameters.light = light_offset;
+        parameters_ptr[i] = this_primitiveInstanceParameters;
+    }
+}
 
-                this_primitiveInstanceParameters.lightsCombinationsOffset = 0;
-                this_primitiveInstanceParameters.lightsCombinationsCount = 0;
-            } else {
-                this_primitiveInstanceParameters.light = -1;
-
-                LightsIndicesRange lights_range_indices;
-                glm::mat4 pos_matrix = matrices[this_draw_info.matricesOffset].positionMatrix;
-                if (this_draw_info.dynamicMeshIndex != -1) {
-                    lights_range_indices = graphics_ptr->GetLights()->CreateCollidedLightsRange(pos_matrix * dynamic_primitives_info[i].dynamicPrimitiveOBB);
-                } else {
-                    lights_range_indices = graphics_ptr->GetLights()->CreateCollidedLightsRange(pos_matrix * primitives_info[i].primitiveOBB);
-                }
-
-                this_primitiveInstanceParameters.lightsCombinationsOffset = lights_range_indices.offset;
-                this_primitiveInstanceParameters.lightsCombinationsCount = lights_range_indices.size;
-            }
+void RendererBase::WritePrimitivesFrameParameters(const DrawInfo& draw_info, PrimitiveInstanceParameters* parameters_ptr, CollidedLightsChunk& collided_lights_chunk) const
+{
+    size_t primitives_count = GetPrimitivesCount(draw_info);
 
-            return_vector.emplace_back(this_primitiveInstanceParameters);
+    if (draw_info.isLightSource) {
+        auto light_offset = uint16_t(graphics_ptr->GetLights()->GetLightInfo(draw_info.lightIndex).lightOffset);
+        for (size_t i = 0; i != primitives_count; ++i) {
+            parameters_ptr[i].matricesOffset = draw_info.matricesOffset;
+            parameters_ptr[i].prevMatricesOffset = draw_info.prevMatricesOffset;
+            parameters_ptr[i].light = light_offset;
+            parameters_ptr[i].lightsCombinationsOffset = 0;
+            parameters_ptr[i].lightsCombinationsCount = 0;
         }
+        return;
     }
 
-    return return_vector;
+    const glm::mat4& pos_matrix = matrices[draw_info.matricesOffset].positionMatrix;
+    for (size_t i = 0; i != primitives_count; ++i) {
+        LightsIndicesRange lights_range_indices;
+        if (draw_info.dynamicMeshIndex != -1) {
+            const DynamicMeshInfo& dynamic_mesh_info = graphics_ptr->GetDynamicMeshes()->GetDynamicMeshInfo(draw_info.dynamicMeshIndex);
+            lights_range_indices = graphics_ptr->GetLights()->CreateCollidedLightsRange(pos_matrix * dynamic_mesh_info.dynamicPrimitives[i].dynamicPrimitiveOBB,
+                                                                                        collided_lights_chunk);
+        } else {
+            size_t primitive_index = graphics_ptr->GetMeshesOfNodesPtr()->GetMeshInfo(draw_info.meshIndex).primitivesIndex[i];
+            lights_range_indices = graphics_ptr->GetLights()->CreateCollidedLightsRange(pos_matrix * graphics_ptr->GetPrimitivesOfMeshes()->GetPrimitiveInfo(primitive_index).primitiveOBB,
+                                                                                        collided_lights_chunk);
+        }
+
+        parameters_ptr[i].matricesOffset = draw_info.matricesOffset;
+        parameters_ptr[i].prevMatricesOffset = draw_info.prevMatricesOffset;
+        parameters_ptr[i].light = -1;
+        parameters_ptr[i].lightsCombinationsOffset = lights_range_indices.offset;
+        parameters_ptr[i].lightsCombinationsCount = lights_range_indices.size;
+    }
 }
@@ -1442,9 +1442,7 @@ void OfflineRenderer::InitToneMapPipeline()
 }
 
 void OfflineRenderer::DrawFrame(const ViewportFrustum& in_viewport,
-                                std::vector<ModelMatrices>&& in_matrices,
-                                std::vector<LightInfo>&& in_light_infos,
-                                std::vector<DrawInfo>&& in_draw_infos)
+                                FrameDrawData& frame_draw_data)
 {
     ++frameCount;
     if(viewportFreeze) {
@@ -1466,9 +1464,7 @@ void OfflineRenderer::DrawFrame(const ViewportFrustum& in_viewport,
     if (viewportFreezeState == ViewportFreezeStates::ready
       || viewportFreezeState == ViewportFreezeStates::next_frame_freeze) {
         viewport = in_viewport;
-        matrices = std::move(in_matrices);
-        lightInfos = std::move(in_light_infos);
-        drawInfos = std::move(in_draw_infos);
+        SwapFrameDrawData(frame_draw_data);
         viewportInRowFreezedFrameCount = 1;
     } else {
         ++viewportFreezedFrameCount;
@@ -1516,7 +1512,7 @@ void OfflineRenderer::DrawFrame(const ViewportFrustum& in_viewport,
 
         graphics_ptr->GetLights()->AddLights(lightInfos, matrices);
         coneLightsIndicesRange = graphics_ptr->GetLights()->CreateLightsConesRange();
-        primitive_instance_parameters = CreatePrimitivesInstanceParameters();
+        UpdateDrawList(primitivesPipelines, primitive_instance_parameters);
         AssortDrawInfos();
 
         std::vector<DrawInfo> TLAS_draw_infos;
@@ -1531,7 +1527,7 @@ void OfflineRenderer::DrawFrame(const ViewportFrustum& in_viewport,
             transform_command_buffer.begin(vk::CommandBufferBeginInfo(vk::CommandBufferUsageFlagBits::eOneTimeSubmit));
 
             if (frameCount > 3) graphics_ptr->GetDynamicMeshes()->ObtainTransformRanges(transform_command_buffer, drawDynamicMeshInfos, graphicsQueue.second);
-            graphics_ptr->GetDynamicMeshes()->RecordTransformations(transform_command_buffer, drawDynamicMeshInfos);
+            graphics_ptr->GetDynamicMeshes()->RecordTransformations(transform_command_buffer, drawDynamicMeshInfos, morphWeights);
 
             transform_command_buffer.end();
 
@@ -1624,16 +1620,12 @@ void OfflineRenderer::DrawFrame(const ViewportFrustum& in_viewport,
 
     std::vector<vk::SubmitInfo> graphics_submit_infos;
     {
-        FrustumCulling frustum_culling;
-        frustum_culling.SetFrustumPlanes(viewport.GetWorldSpacePlanesOfFrustum());
-
         vk::CommandBuffer& graphics_command_buffer = graphicsCommandBuffers[commandBuffer_index];
         graphics_command_buffer.reset();
         RecordGraphicsCommandBuffer(graphics_command_buffer,
                                     frameCount - viewportFreezedFrameCount,
                                     frameCount,
-                                    swapchain_index,
-                                    frustum_culling);
+                                    swapchain_index);
 
         vk::SubmitInfo graphics_submit_info;
         std::unique_ptr<vk::TimelineSemaphoreSubmitInfo> graphics_timeline_semaphore_info = std::make_unique<vk::TimelineSemaphoreSubmitInfo>();
@@ -1754,8 +1746,7 @@ void OfflineRenderer::DrawFrame(const ViewportFrustum& in_viewport,
 void OfflineRenderer::RecordGraphicsCommandBuffer(vk::CommandBuffer command_buffer,
                                                   uint32_t freezable_frame_index,
                                                   uint32_t frame_index,
-                                                  uint32_t swapchain_index,
-                                                  const FrustumCulling& frustum_culling)
+                                                  uint32_t swapchain_index)
 {
     command_buffer.begin(vk::CommandBufferBeginInfo(vk::CommandBufferUsageFlagBits::eOneTimeSubmit));
 
@@ -1823,62 +1814,29 @@ void OfflineRenderer::RecordGraphicsCommandBuffer(vk::CommandBuffer command_buff
     command_buffer.beginRenderPass(render_pass_begin_info, vk::SubpassContents::eInline);
 
     // Visibility pass
-    std::vector<DrawInfo> visibility_draw;
-    std::copy(drawStaticMeshInfos.begin(), drawStaticMeshInfos.end(), std::back_inserter(visibility_draw));
-    std::copy(drawDynamicMeshInfos.begin(), drawDynamicMeshInfos.end(), std::back_inserter(visibility_draw));
-    for (const DrawInfo& this_draw: visibility_draw) {
-        struct DrawPrimitiveInfo {
-            DrawPrimitiveInfo(size_t in_primitiveIndex,
-                              PrimitiveInfo in_primitiveInfo,
-                              DynamicMeshInfo::DynamicPrimitiveInfo in_dynamicPrimitiveInfo,
-                              vk::Buffer in_dynamicBuffer,
-                              uint32_t in_dynamicBufferRangeSize)
-                :
-                 primitiveIndex(in_primitiveIndex),
-                 primitiveInfo(in_primitiveInfo),
-                 dynamicPrimitiveInfo(in_dynamicPrimitiveInfo),
-                 dynamicBuffer(in_dynamicBuffer),
-                 dynamicBufferRangeSize(in_dynamicBufferRangeSize) {}
-            size_t primitiveIndex;
-
-            PrimitiveInfo primitiveInfo;
-
-            DynamicMeshInfo::DynamicPrimitiveInfo dynamicPrimitiveInfo;
-            vk::Buffer dynamicBuffer;
-            uint32_t dynamicBufferRangeSize;
-        };
-        std::vector<DrawPrimitiveInfo> draw_primitives_infos;
-
+    vk::Pipeline bound_pipeline = nullptr;
+    for (const PrimitiveDraw &this_primitive_draw: visiblePrimitiveDraws) {
+        const DrawInfo &this_draw = drawInfos[this_primitive_draw.drawInfoIndex];
+        const PrimitiveInfo &this_primitive_info = graphics_ptr->GetPrimitivesOfMeshes()->GetPrimitiveInfo(this_primitive_draw.primitiveIndex);
+
+        DynamicMeshInfo::DynamicPrimitiveInfo this_dynamic_primitive_info;
+        vk::Buffer dynamic_buffer;
+        uint32_t dynamic_buffer_range_size = -1;
         if (this_draw.dynamicMeshIndex != -1) {
             const auto &dynamic_mesh_info = graphics_ptr->GetDynamicMeshes()->GetDynamicMeshInfo(this_draw.dynamicMeshIndex);
-            for (const auto& this_dynamic_primitive_info: dynamic_mesh_info.dynamicPrimitives) {
-                const PrimitiveInfo &this_primitive_info = graphics_ptr->GetPrimitivesOfMeshes()->GetPrimitiveInfo(this_dynamic_primitive_info.primitiveIndex);
-                draw_primitives_infos.emplace_back(this_dynamic_primitive_info.primitiveIndex,
-                                                   this_primitive_info,
-                                                   this_dynamic_primitive_info,
-                                                   dynamic_mesh_info.buffer,
-                                                   dynamic_mesh_info.rangeSize);
-            }
-        } else {
-            for (size_t primitive_index : graphics_ptr->GetMeshesOfNodesPtr()->GetMeshInfo(this_draw.meshIndex).primitivesIndex) {
-                const PrimitiveInfo& primitive_info = graphics_ptr->GetPrimitivesOfMeshes()->GetPrimitiveInfo(primitive_index);
-                draw_primitives_infos.emplace_back(primitive_index,
-                                                   primitive_info,
-                                                   DynamicMeshInfo::DynamicPrimitiveInfo(),
-                                                   vk::Buffer(),
-                                                   -1);
-            }
+            this_dynamic_primitive_info = dynamic_mesh_info.dynamicPrimitives[this_primitive_draw.primitiveNumber];
+            dynamic_buffer = dynamic_mesh_info.buffer;
+            dynamic_buffer_range_size = dynamic_mesh_info.rangeSize;
         }
 
-        for (size_t i = 0; i != draw_primitives_infos.size(); ++i) {
-            const auto& this_draw_primitive_info = draw_primitives_infos[i];
-
-            const MaterialAbout& this_material = graphics_ptr->GetMaterialsOfPrimitives()->GetMaterialAbout(this_draw_primitive_info.primitiveInfo.material);
+        const MaterialAbout &this_material = graphics_ptr->GetMaterialsOfPrimitives()->GetMaterialAbout(this_primitive_info.material);
 
-            vk::Pipeline pipeline = primitivesPipelines[this_draw_primitive_info.primitiveIndex];
-            command_buffer.bindPipeline(vk::PipelineBindPoint::eGraphics, pipeline);
+        // Sorted by pipeline, so it and its descriptor sets are bound once per run of the same pipeline
+        vk::PipelineLayout pipeline_layout = primitivesPipelineLayouts[this_primitive_draw.primitiveIndex];
+        if (this_primitive_draw.pipeline != bound_pipeline) {
+            command_buffer.bindPipeline(vk::PipelineBindPoint::eGraphics, this_primitive_draw.pipeline);
+            bound_pipeline = this_primitive_draw.pipeline;
 
-            vk::PipelineLayout pipeline_layout = primitivesPipelineLayouts[this_draw_primitive_info.primitiveIndex];
             std::vector<vk::DescriptorSet> descriptor_sets;
             descriptor_sets.emplace_back(graphics_ptr->GetCameraDescriptionSet(freezable_frame_index));
             descriptor_sets.emplace_back(graphics_ptr->GetMatricesDescriptionSet(freezable_frame_index));
@@ -1890,49 +1848,49 @@ void OfflineRenderer::RecordGraphicsCommandBuffer(vk::CommandBuffer command_buff
                                               0,
                                               descriptor_sets,
                                               {});
+        }
 
-            std::array<uint32_t, 1> data_vertex = {uint32_t(this_draw.matricesOffset)};
-            command_buffer.pushConstants(pipeline_layout, vk::ShaderStageFlagBits::eVertex, 0, 4, data_vertex.data());
+        std::array<uint32_t, 1> data_vertex = {uint32_t(this_draw.matricesOffset)};
+        command_buffer.pushConstants(pipeline_layout, vk::ShaderStageFlagBits::eVertex, 0, 4, data_vertex.data());
 
-            std::array<uint32_t, 2> data_frag = {uint32_t(this_draw.primitivesInstanceOffset + i), uint32_t(this_draw_primitive_info.primitiveInfo.material)};
-            if (not this_material.masked)
-                command_buffer.pushConstants(pipeline_layout, vk::ShaderStageFlagBits::eFragment, 4, 4, data_frag.data());
-            else
-                command_buffer.pushConstants(pipeline_layout, vk::ShaderStageFlagBits::eFragment, 4, 8, data_frag.data());
+        std::array<uint32_t, 2> data_frag = {uint32_t(this_draw.primitivesInstanceOffset + this_primitive_draw.primitiveNumber), uint32_t(this_primitive_info.material)};
+        if (not this_material.masked)
+            command_buffer.pushConstants(pipeline_layout, vk::ShaderStageFlagBits::eFragment, 4, 4, data_frag.data());
+        else
+            command_buffer.pushConstants(pipeline_layout, vk::ShaderStageFlagBits::eFragment, 4, 8, data_frag.data());
 
-            vk::Buffer static_primitives_buffer = graphics_ptr->GetPrimitivesOfMeshes()->GetBuffer();
-            std::vector<vk::Buffer> buffers;
-            std::vector<vk::DeviceSize> offsets;
+        vk::Buffer static_primitives_buffer = graphics_ptr->GetPrimitivesOfMeshes()->GetBuffer();
+        std::vector<vk::Buffer> buffers;
+        std::vector<vk::DeviceSize> offsets;
+
+        // Position
+        if (this_dynamic_primitive_info.positionByteOffset != -1) {
+            offsets.emplace_back(this_dynamic_primitive_info.positionByteOffset + (freezable_frame_index % 3) * dynamic_buffer_range_size);
+            buffers.emplace_back(dynamic_buffer);
+        } else {
+            offsets.emplace_back(this_primitive_info.positionByteOffset);
+            buffers.emplace_back(static_primitives_buffer);
+        }
 
-            // Position
-            if (this_draw_primitive_info.dynamicPrimitiveInfo.positionByteOffset != -1) {
-                offsets.emplace_back(this_draw_primitive_info.dynamicPrimitiveInfo.positionByteOffset + (freezable_frame_index % 3) * this_draw_primitive_info.dynamicBufferRangeSize);
-                buffers.emplace_back(this_draw_primitive_info.dynamicBuffer);
+        // Color texcoords if material is masked
+        if (this_material.masked) {
+            if (this_dynamic_primitive_info.texcoordsByteOffset != -1) {
+                offsets.emplace_back(this_dynamic_primitive_info.texcoordsByteOffset + this_material.color_texcooord * sizeof(glm::vec2)
+                                     + (freezable_frame_index % 3) * dynamic_buffer_range_size);
+                buffers.emplace_back(dynamic_buffer);
             } else {
-                offsets.emplace_back(this_draw_primitive_info.primitiveInfo.positionByteOffset);
+                offsets.emplace_back(this_primitive_info.texcoordsByteOffset + this_material.color_texcooord * sizeof(glm::vec2));
                 buffers.emplace_back(static_primitives_buffer);
             }
+        }
 
-            // Color texcoords if material is masked
-            if (this_material.masked) {
-                if (this_draw_primitive_info.dynamicPrimitiveInfo.texcoordsByteOffset != -1) {
-                    offsets.emplace_back(this_draw_primitive_info.dynamicPrimitiveInfo.texcoordsByteOffset + this_material.color_texcooord * sizeof(glm::vec2)
-                                        + freezable_frame_index % 3 * this_draw_primitive_info.dynamicBufferRangeSize );
-                    buffers.emplace_back(this_draw_primitive_info.dynamicBuffer);
-                } else {
-                    offsets.emplace_back(this_draw_primitive_info.primitiveInfo.texcoordsByteOffset + this_material.color_texcooord * sizeof(glm::vec2) );
-                    buffers.emplace_back(static_primitives_buffer);
-                }
-            }
-            
-            command_buffer.bindVertexBuffers(0, buffers, offsets);
+        command_buffer.bindVertexBuffers(0, buffers, offsets);
 
-            command_buffer.bindIndexBuffer(graphics_ptr->GetPrimitivesOfMeshes()->GetBuffer(),
-                                           this_draw_primitive_info.primitiveInfo.indicesByteOffset,
-                                           vk::IndexType::eUint32);
+        command_buffer.bindIndexBuffer(graphics_ptr->GetPrimitivesOfMeshes()->GetBuffer(),
+                                       this_primitive_info.indicesByteOffset,
+                                       vk::IndexType::eUint32);
 
-            command_buffer.drawIndexed(uint32_t(this_draw_primitive_info.primitiveInfo.indicesCount), 1, 0, 0, 0);
-        }
+        command_buffer.drawIndexed(uint32_t(this_primitive_info.indicesCount), 1, 0, 0, 0);
     }
 
     command_buffer.nextSubpass(vk::SubpassContents::eInline);
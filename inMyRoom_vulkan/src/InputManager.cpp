@@ -6,8 +6,6 @@ InputManager::InputManager(Engine* engine_ptr, configuru::Config& in_cfgFile)
     :cfgFile(in_cfgFile),
      engine_ptr(engine_ptr)
 {
-    std::lock_guard<std::mutex> lock(controlMutex);
-
     for (auto const& bind : functionNameToFunction_map)
     {
         for (const configuru::Config& arrayIterator : cfgFile["inputSettings"]["keybinds"][bind.first.c_str()].as_array())
@@ -34,25 +32,35 @@ InputManager::InputManager(Engine* engine_ptr, configuru::Config& in_cfgFile)
 
 InputManager::~InputManager()
 {
-    std::lock_guard<std::mutex> lock(controlMutex);
-
     keyToFunction_onKeyReleased_umap.clear();
-    eventVector.clear();
 }
 
 std::vector<eventInputIDenums> InputManager::GrabAndResetEventVector()
 {
-    std::lock_guard<std::mutex> lock(controlMutex);
-
     std::vector<eventInputIDenums> returnVector;
-    returnVector.swap(eventVector);
+
+    eventInputIDenums this_event;
+    while (eventsRing.try_pop(this_event))
+        returnVector.emplace_back(this_event);
+
     return returnVector;
 }
 
-void InputManager::MouseMoved(const long xOffset, const long yOffset)
+void InputManager::DispatchInputEvents()
 {
-    std::lock_guard<std::mutex> lock(controlMutex);
+    // Only the main thread gets into ECS, so it is never locked against the input thread
+    ECSwrapper* const ECSwrapper_ptr = engine_ptr->GetECSwrapperPtr();
 
+    InputEvent this_input_event;
+    while (inputEventsRing.try_pop(this_input_event))
+    {
+        void* struct_data = this_input_event.inputType == InputType::MouseMove ? reinterpret_cast<void*>(&this_input_event.mouse) : nullptr;
+        ECSwrapper_ptr->AsyncInput(this_input_event.inputType, struct_data, this_input_event.timePoint);
+    }
+}
+
+void InputManager::MouseMoved(const long xOffset, const long yOffset)
+{
     float xRotation_rads = - xOffset * mouseSensitivity;
     float yRotation_rads = - yOffset * mouseSensitivity;
 
@@ -60,13 +68,11 @@ void InputManager::MouseMoved(const long xOffset, const long yOffset)
     this_input_data.x_axis = xRotation_rads;
     this_input_data.y_axis = yRotation_rads;
 
-    engine_ptr->GetECSwrapperPtr()->AsyncInput(InputType::MouseMove, reinterpret_cast<void*>(&this_input_data));
+    AddInputEvent(InputType::MouseMove, this_input_data);
 }
 
 void InputManager::KeyPressed(int key)
 {
-    std::lock_guard<std::mutex> lock(controlMutex);
-
     auto search = keyToFunction_onKeyPressed_umap.find(key);
     if (search != keyToFunction_onKeyPressed_umap.end())
         search->second();
@@ -75,25 +81,39 @@ void InputManager::KeyPressed(int key)
 
 void InputManager::KeyReleased(int key)
 {
-    std::lock_guard<std::mutex> lock(controlMutex);
-
     auto search = keyToFunction_onKeyReleased_umap.find(key);
     if (search != keyToFunction_onKeyReleased_umap.end())
         search->second();
 }
 
+bool InputManager::FlushPendingEvents()
+{
+    bool are_events_pending = push_pending(eventsRing, pendingEvents);
+    bool are_input_events_pending = push_pending(inputEventsRing, pendingInputEvents);
+
+    return are_events_pending || are_input_events_pending;
+}
+
 void InputManager::AddToQueue(eventInputIDenums event)
 {
-    // KeyPressed or keyReleased access this function that are have locked the mutex 2. wtf i sayy
+    push_or_keep_pending(eventsRing, pendingEvents, event);
+}
+
+void InputManager::AddInputEvent(InputType input_type, InputMouse mouse)
+{
+    InputEvent this_input_event;
+    this_input_event.inputType = input_type;
+    this_input_event.mouse = mouse;
+    this_input_event.timePoint = std::chrono::steady_clock::now();
 
-    eventVector.push_back(event);
+    push_or_keep_pending(inputEventsRing, pendingInputEvents, this_input_event);
 }
 
 void InputManager::MoveForward()
 {
     if (!forwardKeyIsPressed)
     {
-        engine_ptr->GetECSwrapperPtr()->AsyncInput(InputType::MoveForward, nullptr);
+        AddInputEvent(InputType::MoveForward);
         forwardKeyIsPressed = true;
     }
 }
@@ -102,7 +122,7 @@ void InputManager::MoveBackward()
 {
     if (!backwardKeyIsPressed)
     {
-        engine_ptr->GetECSwrapperPtr()->AsyncInput(InputType::MoveBackward, nullptr);
+        AddInputEvent(InputType::MoveBackward);
         backwardKeyIsPressed = true;
     }
 }
@@ -111,7 +131,7 @@ void InputManager::MoveLeft()
 {
     if (!leftKeyIsPressed)
     {
-        engine_ptr->GetECSwrapperPtr()->AsyncInput(InputType::MoveLeft, nullptr);
+        AddInputEvent(InputType::MoveLeft);
         leftKeyIsPressed = true;
     }
 }
@@ -120,7 +140,7 @@ void InputManager::MoveRight()
 {
     if (!rightKeyIsPressed)
     {
-        engine_ptr->GetECSwrapperPtr()->AsyncInput(InputType::MoveRight, nullptr);
+        AddInputEvent(InputType::MoveRight);
         rightKeyIsPressed = true;
     }
 }
@@ -129,7 +149,7 @@ void InputManager::MoveUp()
 {
     if (!upKeyIsPressed)
     {
-        engine_ptr->GetECSwrapperPtr()->AsyncInput(InputType::MoveUp, nullptr);
+        AddInputEvent(InputType::MoveUp);
         upKeyIsPressed = true;
     }
 }
@@ -138,7 +158,7 @@ void InputManager::MoveDown()
 {
     if (!downKeyIsPressed)
     {
-        engine_ptr->GetECSwrapperPtr()->AsyncInput(InputType::MoveDown, nullptr);
+        AddInputEvent(InputType::MoveDown);
         downKeyIsPressed = true;
     }
 }
@@ -148,7 +168,7 @@ void InputManager::StopMovingForward()
 {
     if (forwardKeyIsPressed)
     {
-        engine_ptr->GetECSwrapperPtr()->AsyncInput(InputType::StopMovingForward, nullptr);
+        AddInputEvent(InputType::StopMovingForward);
         forwardKeyIsPressed = false;
     }
 }
@@ -157,7 +177,7 @@ void InputManager::StopMovingBackward()
 {
     if (backwardKeyIsPressed)
     {
-        engine_ptr->GetECSwrapperPtr()->AsyncInput(InputType::StopMovingBackward, nullptr);
+        AddInputEvent(InputType::StopMovingBackward);
         backwardKeyIsPressed = false;
     }
 }
@@ -166,7 +186,7 @@ void InputManager::StopMovingLeft()
 {
     if (leftKeyIsPressed)
     {
-        engine_ptr->GetECSwrapperPtr()->AsyncInput(InputType::StopMovingLeft, nullptr);
+        AddInputEvent(InputType::StopMovingLeft);
         leftKeyIsPressed = false;
     }
 }
@@ -175,7 +195,7 @@ void InputManager::StopMovingRight()
 {
     if (rightKeyIsPressed)
     {
-        engine_ptr->GetECSwrapperPtr()->AsyncInput(InputType::StopMovingRight, nullptr);
+        AddInputEvent(InputType::StopMovingRight);
         rightKeyIsPressed = false;
     }
 }
@@ -184,7 +204,7 @@ void InputManager::StopMovingUp()
 {
     if (upKeyIsPressed)
     {
-        engine_ptr->GetECSwrapperPtr()->AsyncInput(InputType::StopMovingUp, nullptr);
+        AddInputEvent(InputType::StopMovingUp);
         upKeyIsPressed = false;
     }
 }
@@ -193,7 +213,7 @@ void InputManager::StopMovingDown()
 {
     if (downKeyIsPressed)
     {
-        engine_ptr->GetECSwrapperPtr()->AsyncInput(InputType::StopMovingDown, nullptr);
+        AddInputEvent(InputType::StopMovingDown);
         downKeyIsPressed = false;
     }
 }
\ No newline at end of file
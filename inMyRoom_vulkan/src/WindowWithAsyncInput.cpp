@@ -56,12 +56,20 @@ WindowWithAsyncInput::WindowWithAsyncInput(const std::string&             in_tit
             cv.notify_one();
 
             bool breakLoop = false;
+            bool hasWorkLeft = false;
             while(not breakLoop)
             {
-                glfwWaitEvents();
+                if (hasWorkLeft)
+                    glfwWaitEventsTimeout(afterEventsRetryTimeout);
+                else
+                    glfwWaitEvents();
                 {
                     std::lock_guard guard(controlMutex);
                     breakLoop = closeInputThread;
+
+                    hasWorkLeft = false;
+                    for (const auto& this_lambda : callbackListAfterEvents)
+                        hasWorkLeft = this_lambda() || hasWorkLeft;
                 }
             }
         });
@@ -184,12 +192,19 @@ void WindowWithAsyncInput::AddCallbackMouseMoveLambda(std::function<void(long, l
     callbackListOnMouseMove.emplace_back(lambda);
 }
 
+void WindowWithAsyncInput::AddCallbackAfterEventsLambda(std::function<bool()> lambda)
+{
+    std::lock_guard guard(controlMutex);
+    callbackListAfterEvents.emplace_back(lambda);
+}
+
 void WindowWithAsyncInput::DeleteCallbacks()
 {
     std::lock_guard guard(controlMutex);
     callbackListOnKeyPress.clear();
     callbackListOnKeyRelease.clear();
     callbackListOnMouseMove.clear();
+    callbackListAfterEvents.clear();
 }
 
 void key_glfw_callback(GLFWwindow* window, int key, int scancode, int action, int mods)
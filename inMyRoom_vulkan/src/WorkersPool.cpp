@@ -0,0 +1,145 @@
+#include "WorkersPool.h"
+
+#include <cassert>
+#include <algorithm>
+
+WorkersPool::WorkersPool(size_t threads_count)
+{
+    if (threads_count == 0)
+        threads_count = std::max(size_t(std::thread::hardware_concurrency()), size_t(1));
+
+    for (size_t i = 1; i < threads_count; ++i)
+        workerThreads.emplace_back([this]() {WorkerLoop();});
+}
+
+WorkersPool::~WorkersPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        stopWorkers = true;
+    }
+    queueCV.notify_all();
+
+    for (auto& this_thread : workerThreads)
+        this_thread.join();
+}
+
+size_t WorkersPool::GetThreadsCount() const
+{
+    return workerThreads.size() + 1;
+}
+
+void WorkersPool::RunTasks(const std::vector<std::function<void()>>& tasks)
+{
+    if (tasks.empty())
+        return;
+
+    if (tasks.size() == 1 || workerThreads.empty())
+    {
+        for (const auto& this_task : tasks)
+            this_task();
+
+        return;
+    }
+
+    std::atomic<size_t> remaining = tasks.size();
+
+    std::vector<Job> jobs;
+    jobs.reserve(tasks.size() - 1);
+    for (size_t i = 1; i < tasks.size(); ++i)
+        jobs.emplace_back(Job{tasks[i], &remaining});
+
+    PushJobs(std::move(jobs));
+
+    // First task goes to calling thread
+    tasks[0]();
+    remaining.fetch_sub(1, std::memory_order_acq_rel);
+
+    WaitAndHelp(remaining);
+}
+
+void WorkersPool::ParallelFor(size_t count, size_t min_batch_size, const std::function<void(size_t, size_t)>& batch_func)
+{
+    if (count == 0)
+        return;
+
+    min_batch_size = std::max(min_batch_size, size_t(1));
+
+    // Some more batches than threads, so uneven batches balance out
+    size_t batches_count = std::min((count + min_batch_size - 1) / min_batch_size, GetThreadsCount() * 4);
+    if (batches_count <= 1 || workerThreads.empty())
+    {
+        batch_func(0, count);
+        return;
+    }
+
+    size_t batch_size = (count + batches_count - 1) / batches_count;
+
+    std::vector<std::function<void()>> tasks;
+    tasks.reserve(batches_count);
+    for (size_t begin = 0; begin < count; begin += batch_size)
+    {
+        size_t end = std::min(begin + batch_size, count);
+        tasks.emplace_back([&batch_func, begin, end]() {batch_func(begin, end);});
+    }
+
+    RunTasks(tasks);
+}
+
+void WorkersPool::PushJobs(std::vector<Job>&& jobs)
+{
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        for (auto& this_job : jobs)
+            jobsQueue.emplace_back(std::move(this_job));
+    }
+    queueCV.notify_all();
+}
+
+bool WorkersPool::TryRunJob()
+{
+    Job this_job;
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        if (jobsQueue.empty())
+            return false;
+
+        this_job = std::move(jobsQueue.front());
+        jobsQueue.pop_front();
+    }
+
+    this_job.func();
+    this_job.remaining_ptr->fetch_sub(1, std::memory_order_acq_rel);
+
+    return true;
+}
+
+void WorkersPool::WaitAndHelp(const std::atomic<size_t>& remaining)
+{
+    while (remaining.load(std::memory_order_acquire) != 0)
+    {
+        if (not TryRunJob())
+            std::this_thread::yield();
+    }
+}
+
+void WorkersPool::WorkerLoop()
+{
+    while (true)
+    {
+        Job this_job;
+        {
+            std::unique_lock<std::mutex> lock(queueMutex);
+            queueCV.wait(lock, [this]() {return stopWorkers || not jobsQueue.empty();});
+
+            if (stopWorkers && jobsQueue.empty())
+                return;
+
+            this_job = std::move(jobsQueue.front());
+            jobsQueue.pop_front();
+        }
+
+        this_job.func();
+        this_job.remaining_ptr->fetch_sub(1, std::memory_order_acq_rel);
+    }
+}
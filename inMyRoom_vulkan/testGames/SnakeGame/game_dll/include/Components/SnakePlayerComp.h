@@ -13,7 +13,7 @@ public:
     ~SnakePlayerComp();
 
     void Update() override;
-    void AsyncInput(InputType input_type, void* struct_data = nullptr) override;
+    void AsyncInput(InputType input_type, void* struct_data, std::chrono::steady_clock::time_point event_timePoint) override;
 
     void CollisionCallback(const std::vector<std::pair<Entity, std::vector<CollisionCallbackData>>>& callback_entity_data_pairs) override;
 
@@ -2,6 +2,8 @@
 
 #include "ECS/ECSwrapper.h" 
 
+#include <algorithm>
+
 
 SnakePlayerComp::SnakePlayerComp(ECSwrapper* const in_ecs_wrapper_ptr)
     :ComponentDataClass<SnakePlayerCompEntity, static_cast<componentID>(componentIDenum::SnakePlayer), "SnakePlayer", sparse_set>(in_ecs_wrapper_ptr)
@@ -49,10 +51,11 @@ void SnakePlayerComp::Update()
     lastSnapTimePoint = next_snap_timePoint;
 }
 
-void SnakePlayerComp::AsyncInput(InputType input_type, void* struct_data)
+void SnakePlayerComp::AsyncInput(InputType input_type, void* struct_data, std::chrono::steady_clock::time_point event_timePoint)
 {
+    // Integrate up to when the input happened. Inputs before the last snap can only count from it
     auto previous_snap_timePoint = lastSnapTimePoint;
-    auto next_snap_timePoint = std::chrono::steady_clock::now();
+    auto next_snap_timePoint = std::max(event_timePoint, previous_snap_timePoint);
 
     std::chrono::duration<float> duration = next_snap_timePoint - previous_snap_timePoint;
 
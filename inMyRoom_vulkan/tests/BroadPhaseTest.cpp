@@ -0,0 +1,418 @@
+// The broad phases' pairs, SweepAndPrune's and DynamicAABBtree's, against a brute force test of every two entries' boxes,
+// every frame of random scenes where bodies get added, removed, teleported and drift.
+// Then frame times of both and of the per frame sort and sweep that SweepAndPrune replaced
+
+#include <memory>
+#include <unordered_map>
+
+#include "TestsCommon.h"
+#include "CollisionDetection/DynamicAABBtree.h"
+#include "CollisionDetection/SweepAndPrune.h"
+
+namespace
+{
+    // Same as CollisionDetection's
+    std::array<glm::vec3, 3> GetBroadPhaseAxes()
+    {
+        glm::vec3 U_axis = glm::normalize(glm::vec3(0.8f, -0.2f, 0.f));
+        glm::vec3 W_axis = glm::normalize(glm::cross(U_axis, glm::vec3(0.f, -1.f, 0.f)));
+        glm::vec3 V_axis = glm::normalize(glm::cross(W_axis, U_axis));
+
+        return {U_axis, V_axis, W_axis};
+    }
+
+    using EntitiesPair = std::pair<Entity, Entity>;
+
+    std::vector<EntitiesPair> GetSortedEntitiesPairs(const std::vector<std::pair<CollisionDetectionEntry, CollisionDetectionEntry>>& entries_pairs)
+    {
+        std::vector<EntitiesPair> entities_pairs;
+        for (const auto& this_entries_pair : entries_pairs)
+            entities_pairs.emplace_back(std::minmax(this_entries_pair.first.entity, this_entries_pair.second.entity));
+
+        std::sort(entities_pairs.begin(), entities_pairs.end());
+        return entities_pairs;
+    }
+
+    // Every two entries whose projections at the axes overlap or touch, at least one of them wanting callback
+    std::vector<EntitiesPair> GetBruteForcePairs(const std::vector<CollisionDetectionEntry>& entries, const std::array<glm::vec3, 3>& axes)
+    {
+        std::vector<std::array<std::pair<float, float>, 3>> entries_projections;
+        for (const CollisionDetectionEntry& this_entry : entries)
+        {
+            Paralgram this_paralgram = this_entry.currentGlobalMatrix * this_entry.OBBtree_ptr->GetRootOBB();
+            entries_projections.push_back({this_paralgram.GetMinMaxProjectionToAxis(axes[0]),
+                                           this_paralgram.GetMinMaxProjectionToAxis(axes[1]),
+                                           this_paralgram.GetMinMaxProjectionToAxis(axes[2])});
+        }
+
+        std::vector<EntitiesPair> entities_pairs;
+        for (size_t i = 0; i != entries.size(); ++i)
+        {
+            for (size_t j = i + 1; j != entries.size(); ++j)
+            {
+                if (not entries[i].shouldCallback && not entries[j].shouldCallback)
+                    continue;
+
+                bool does_overlap = true;
+                for (size_t axis_index = 0; axis_index != 3; ++axis_index)
+                    does_overlap = does_overlap &&
+                                   entries_projections[i][axis_index].second >= entries_projections[j][axis_index].first &&
+                                   entries_projections[j][axis_index].second >= entries_projections[i][axis_index].first;
+
+                if (does_overlap)
+                    entities_pairs.emplace_back(std::minmax(entries[i].entity, entries[j].entity));
+            }
+        }
+
+        std::sort(entities_pairs.begin(), entities_pairs.end());
+        return entities_pairs;
+    }
+
+    // SweepAndPrune::ExecuteSweepAndPrune before it became persistent: every frame projects all entries, sorts them at the
+    // three axes, and counts the pairs each axis' sweep finds
+    class PerFrameSweepAndPrune
+    {
+    public:
+        explicit PerFrameSweepAndPrune(const std::array<glm::vec3, 3>& in_axes) : axes(in_axes) {}
+
+        std::vector<std::pair<CollisionDetectionEntry, CollisionDetectionEntry>> ExecuteSweepAndPrune(const std::vector<CollisionDetectionEntry>& collisionDetectionEntries) const
+        {
+            std::array<std::vector<SweepAndPruneEntry>, 3> axes_entries;
+            for (size_t index = 0; index < collisionDetectionEntries.size(); index++)
+            {
+                Paralgram this_paralgram = collisionDetectionEntries[index].currentGlobalMatrix * collisionDetectionEntries[index].OBBtree_ptr->GetRootOBB();
+
+                SweepAndPruneEntry this_entry;
+                this_entry.index = Entity(index);
+                this_entry.shouldCallback = collisionDetectionEntries[index].shouldCallback;
+                for (size_t axis_index = 0; axis_index != 3; ++axis_index)
+                {
+                    this_entry.minMaxProjection = this_paralgram.GetMinMaxProjectionToAxis(axes[axis_index]);
+                    axes_entries[axis_index].emplace_back(this_entry);
+                }
+            }
+
+            for (auto& this_axis_entries : axes_entries)
+                std::sort(this_axis_entries.begin(), this_axis_entries.end(),
+                          [](const SweepAndPruneEntry& a, const SweepAndPruneEntry& b) {return a.minMaxProjection.first < b.minMaxProjection.first;});
+
+            std::unordered_map<uint64_t, uint32_t> common_collision_umap;
+            std::vector<SweepAndPruneEntry> active_list;
+            auto sweepAndPrune = [&](const std::vector<SweepAndPruneEntry>& axis_entries, const bool first_axis)
+            {
+                active_list.clear();
+                for (const SweepAndPruneEntry& this_sweepAndPruneEntry : axis_entries)
+                {
+                    for (auto& active_elem : active_list)
+                    {
+                        if (active_elem.minMaxProjection.second < this_sweepAndPruneEntry.minMaxProjection.first)
+                            active_elem.index = Entity(-1);
+                        else if (active_elem.shouldCallback || this_sweepAndPruneEntry.shouldCallback)
+                        {
+                            auto [min_index, max_index] = std::minmax(active_elem.index, this_sweepAndPruneEntry.index);
+                            uint64_t pair_key = (uint64_t(min_index) << 32) | uint64_t(max_index);
+                            if (first_axis)
+                                common_collision_umap.emplace(pair_key, 1);
+                            else
+                            {
+                                auto search = common_collision_umap.find(pair_key);
+                                if (search != common_collision_umap.end())
+                                    search->second++;
+                            }
+                        }
+                    }
+
+                    std::erase_if(active_list, [](const auto& elem) {return elem.index == Entity(-1);});
+                    active_list.emplace_back(this_sweepAndPruneEntry);
+                }
+            };
+
+            sweepAndPrune(axes_entries[0], true);
+            sweepAndPrune(axes_entries[1], false);
+            sweepAndPrune(axes_entries[2], false);
+
+            std::vector<std::pair<CollisionDetectionEntry, CollisionDetectionEntry>> return_vector;
+            for (const auto& this_pair_count : common_collision_umap)
+                if (this_pair_count.second == 3)
+                    return_vector.emplace_back(collisionDetectionEntries[this_pair_count.first >> 32], collisionDetectionEntries[this_pair_count.first & 0xFFFFFFFF]);
+
+            return return_vector;
+        }
+
+    private:
+        struct SweepAndPruneEntry
+        {
+            std::pair<float, float> minMaxProjection;
+            Entity index;
+            bool shouldCallback;
+        };
+
+        const std::array<glm::vec3, 3> axes;
+    };
+
+    // Shapes of the bodies, a flat one among them
+    struct BroadPhaseShapes
+    {
+        std::vector<std::unique_ptr<OBBtree>> OBBtrees;
+
+        BroadPhaseShapes()
+        {
+            for (glm::vec3 half_extents : {glm::vec3(0.5f, 0.5f, 0.5f), glm::vec3(1.5f, 0.3f, 0.6f), glm::vec3(2.f, 0.02f, 2.f), glm::vec3(0.2f, 3.f, 0.2f)})
+                OBBtrees.emplace_back(std::make_unique<OBBtree>(CreateBoxTriangles(half_extents)));
+        }
+    };
+
+    struct BroadPhaseSceneSettings
+    {
+        size_t initialBodiesCount = 0;
+        float halfExtent = 0.f;
+        size_t maxAddsRemovesPerFrame = 0;          // each
+        size_t maxTeleportsPerFrame = 0;
+        size_t driftersPerTen = 0;                  // of the bodies drift a bit every frame, the rest stay still
+        float maxDriftSpeed = 0.f;
+    };
+
+    // Bodies as ModelCollisionComp feeds the broad phase: entries at an order that changes, still ones marked static once they
+    // did not move for two frames, entities of removed bodies reused by later ones
+    class BroadPhaseScene
+    {
+    public:
+        BroadPhaseScene(const BroadPhaseShapes& in_shapes, const BroadPhaseSceneSettings& in_settings, uint64_t seed)
+            :shapes(in_shapes), settings(in_settings), random(seed)
+        {
+            for (size_t i = 0; i != settings.initialBodiesCount; ++i)
+                AddBody();
+        }
+
+        void Step()
+        {
+            for (Body& this_body : bodies)
+                this_body.previousMatrix = this_body.matrix;
+
+            size_t removals_count = settings.maxAddsRemovesPerFrame != 0 ? random.NextUint() % (settings.maxAddsRemovesPerFrame + 1) : 0;
+            for (size_t i = 0; i != removals_count && bodies.size(); ++i)
+            {
+                size_t index = random.NextUint() % bodies.size();
+                freeEntities.emplace_back(bodies[index].entity);
+                bodies[index] = bodies.back();
+                bodies.pop_back();
+            }
+
+            size_t additions_count = settings.maxAddsRemovesPerFrame != 0 ? random.NextUint() % (settings.maxAddsRemovesPerFrame + 1) : 0;
+            for (size_t i = 0; i != additions_count; ++i)
+                AddBody();
+
+            size_t teleports_count = settings.maxTeleportsPerFrame != 0 ? random.NextUint() % (settings.maxTeleportsPerFrame + 1) : 0;
+            for (size_t i = 0; i != teleports_count && bodies.size(); ++i)
+            {
+                Body& this_body = bodies[random.NextUint() % bodies.size()];
+                this_body.position = random.NextVec3(-settings.halfExtent, settings.halfExtent);
+                this_body.matrix = CreateTranslationRotationMatrix(this_body.position, this_body.rotationAxis, this_body.angle);
+            }
+
+            for (Body& this_body : bodies)
+            {
+                if (this_body.velocity == glm::vec3(0.f))
+                    continue;
+
+                this_body.position += this_body.velocity;
+                for (int axis = 0; axis != 3; ++axis)
+                    if (std::abs(this_body.position[axis]) > settings.halfExtent)
+                        this_body.velocity[axis] = -this_body.velocity[axis];
+
+                this_body.angle += 0.02f;
+                this_body.matrix = CreateTranslationRotationMatrix(this_body.position, this_body.rotationAxis, this_body.angle);
+            }
+
+            // Callback wish changes now and then, as a component getting or losing its callback
+            if (bodies.size() && random.NextUint() % 8 == 0)
+            {
+                Body& this_body = bodies[random.NextUint() % bodies.size()];
+                this_body.shouldCallback = not this_body.shouldCallback;
+            }
+        }
+
+        std::vector<CollisionDetectionEntry> CreateEntries()
+        {
+            std::vector<CollisionDetectionEntry> entries;
+            for (Body& this_body : bodies)
+            {
+                bool has_moved = this_body.matrix != this_body.previousMatrix;
+
+                CollisionDetectionEntry this_entry;
+                this_entry.currentGlobalMatrix = this_body.matrix;
+                this_entry.previousGlobalMatrix = this_body.previousMatrix;
+                this_entry.OBBtree_ptr = this_body.OBBtree_ptr;
+                this_entry.shouldCallback = this_body.shouldCallback;
+                this_entry.isStatic = not has_moved && not this_body.hasMovedLastFrame;
+                this_entry.isContinuous = false;
+                this_entry.entity = this_body.entity;
+                entries.emplace_back(this_entry);
+
+                this_body.hasMovedLastFrame = has_moved;
+            }
+
+            return entries;
+        }
+
+        size_t GetBodiesCount() const {return bodies.size();}
+        Entity GetEntitiesCount() const {return nextEntity - 1;}
+
+    private:
+        struct Body
+        {
+            const OBBtree* OBBtree_ptr = nullptr;
+            glm::vec3 position = glm::vec3(0.f);
+            glm::vec3 velocity = glm::vec3(0.f);
+            glm::vec3 rotationAxis = glm::vec3(0.f, 1.f, 0.f);
+            float angle = 0.f;
+            glm::mat4 matrix = glm::mat4(1.f);
+            glm::mat4 previousMatrix = glm::mat4(1.f);
+            bool hasMovedLastFrame = true;
+            bool shouldCallback = true;
+            Entity entity = 0;
+        };
+
+        void AddBody()
+        {
+            Body& this_body = bodies.emplace_back();
+            this_body.OBBtree_ptr = shapes.OBBtrees[random.NextUint() % shapes.OBBtrees.size()].get();
+            this_body.position = random.NextVec3(-settings.halfExtent, settings.halfExtent);
+            this_body.rotationAxis = random.NextDirection();
+            this_body.angle = random.NextFloat(0.f, 6.f);
+            if (random.NextUint() % 10 < settings.driftersPerTen)
+                this_body.velocity = random.NextDirection() * random.NextFloat(0.f, settings.maxDriftSpeed);
+            this_body.matrix = CreateTranslationRotationMatrix(this_body.position, this_body.rotationAxis, this_body.angle);
+            this_body.previousMatrix = this_body.matrix;
+            this_body.shouldCallback = random.NextUint() % 5 != 0;
+
+            if (freeEntities.size())
+            {
+                this_body.entity = freeEntities.front();
+                freeEntities.erase(freeEntities.begin());
+            }
+            else
+            {
+                this_body.entity = nextEntity++;
+            }
+        }
+
+    private:
+        const BroadPhaseShapes& shapes;
+        const BroadPhaseSceneSettings settings;
+        TestsRandom random;
+
+        std::vector<Body> bodies;
+        std::vector<Entity> freeEntities;       // reused oldest first, so one is often removed and re-added within few frames
+        Entity nextEntity = 1;
+    };
+
+    void CheckAgainstBruteForce(const BroadPhaseShapes& shapes, const char* scene_name, const BroadPhaseSceneSettings& settings, uint64_t seed)
+    {
+        const std::array<glm::vec3, 3> axes = GetBroadPhaseAxes();
+        BroadPhaseScene scene(shapes, settings, seed);
+        SweepAndPrune sweep_and_prune(axes[0], axes[1], axes[2]);
+        PerFrameSweepAndPrune per_frame_sweep_and_prune(axes);
+        DynamicAABBtree dynamic_AABBtree(axes[0], axes[1], axes[2]);
+
+        const size_t frames_count = 300;
+        size_t mismatched_frames_count = 0;
+        size_t per_frame_mismatched_frames_count = 0;
+        size_t tree_mismatched_frames_count = 0;
+        size_t pairs_count = 0;
+        for (size_t frame = 0; frame != frames_count; ++frame)
+        {
+            scene.Step();
+            std::vector<CollisionDetectionEntry> entries = scene.CreateEntries();
+
+            std::vector<EntitiesPair> brute_force_pairs = GetBruteForcePairs(entries, axes);
+            mismatched_frames_count += GetSortedEntitiesPairs(sweep_and_prune.ExecuteBroadPhaseCollision(entries)) == brute_force_pairs ? 0 : 1;
+            per_frame_mismatched_frames_count += GetSortedEntitiesPairs(per_frame_sweep_and_prune.ExecuteSweepAndPrune(entries)) == brute_force_pairs ? 0 : 1;
+            tree_mismatched_frames_count += GetSortedEntitiesPairs(dynamic_AABBtree.ExecuteBroadPhaseCollision(entries)) == brute_force_pairs ? 0 : 1;
+            pairs_count += brute_force_pairs.size();
+        }
+
+        CHECK(mismatched_frames_count == 0);
+        CHECK(per_frame_mismatched_frames_count == 0);
+        CHECK(tree_mismatched_frames_count == 0);
+        CHECK(pairs_count != 0);
+
+        printf("%s: %zu bodies, %u entities used, %.1f pairs per frame, frames off brute force: SAP %zu, tree %zu of %zu\n",
+               scene_name, scene.GetBodiesCount(), unsigned(scene.GetEntitiesCount()), double(pairs_count) / double(frames_count),
+               mismatched_frames_count, tree_mismatched_frames_count, frames_count);
+    }
+
+    void Benchmark(const BroadPhaseShapes& shapes, const char* scene_name, const BroadPhaseSceneSettings& settings)
+    {
+        const std::array<glm::vec3, 3> axes = GetBroadPhaseAxes();
+        const size_t frames_count = 60;
+
+        // Same frames to both, the persistent one warmed up by its first frame
+        BroadPhaseScene scene(shapes, settings, 5);
+        std::vector<std::vector<CollisionDetectionEntry>> frames_entries;
+        for (size_t frame = 0; frame != frames_count + 1; ++frame)
+        {
+            scene.Step();
+            frames_entries.emplace_back(scene.CreateEntries());
+        }
+
+        // Persistent ones are timed apart from their first frame, which brings every body
+        auto measure_persistent = [&](auto create_broad_phase, size_t& pairs_count, double& first_frame_time, double& frames_time)
+        {
+            first_frame_time = std::numeric_limits<double>::infinity();
+            frames_time = std::numeric_limits<double>::infinity();
+            for (size_t repeat = 0; repeat != 3; ++repeat)
+            {
+                auto broad_phase = create_broad_phase();
+                first_frame_time = std::min(first_frame_time, MeasureBestTime(1, [&]() {broad_phase.ExecuteBroadPhaseCollision(frames_entries.front());}));
+
+                frames_time = std::min(frames_time, MeasureBestTime(1, [&]()
+                {
+                    pairs_count = 0;
+                    for (size_t frame = 1; frame != frames_count + 1; ++frame)
+                        pairs_count += broad_phase.ExecuteBroadPhaseCollision(frames_entries[frame]).size();
+                }));
+            }
+        };
+
+        size_t persistent_pairs_count = 0, tree_pairs_count = 0;
+        double first_frame_time = 0., persistent_time = 0., tree_first_frame_time = 0., tree_time = 0.;
+        measure_persistent([&axes]() {return SweepAndPrune(axes[0], axes[1], axes[2]);}, persistent_pairs_count, first_frame_time, persistent_time);
+        measure_persistent([&axes]() {return DynamicAABBtree(axes[0], axes[1], axes[2]);}, tree_pairs_count, tree_first_frame_time, tree_time);
+
+        PerFrameSweepAndPrune per_frame_sweep_and_prune(axes);
+        size_t per_frame_pairs_count = 0;
+        double per_frame_time = MeasureBestTime(3, [&]()
+        {
+            per_frame_pairs_count = 0;
+            for (size_t frame = 1; frame != frames_count + 1; ++frame)
+                per_frame_pairs_count += per_frame_sweep_and_prune.ExecuteSweepAndPrune(frames_entries[frame]).size();
+        });
+
+        CHECK(persistent_pairs_count == per_frame_pairs_count);
+        CHECK(tree_pairs_count == per_frame_pairs_count);
+
+        printf("%s: %zu bodies, %.1f pairs per frame, ms per frame: SAP %.3f (first frame %.1f), tree %.3f (first frame %.1f), per frame sort %.3f\n",
+               scene_name, scene.GetBodiesCount(), double(persistent_pairs_count) / double(frames_count),
+               persistent_time * 1.e3 / double(frames_count), first_frame_time * 1.e3,
+               tree_time * 1.e3 / double(frames_count), tree_first_frame_time * 1.e3, per_frame_time * 1.e3 / double(frames_count));
+    }
+}
+
+int main()
+{
+    BroadPhaseShapes shapes;
+
+    CheckAgainstBruteForce(shapes, "Churn", {300, 25.f, 3, 2, 5, 0.3f}, 1);
+    CheckAgainstBruteForce(shapes, "Crowded drift", {200, 8.f, 1, 0, 10, 0.1f}, 2);
+    CheckAgainstBruteForce(shapes, "Teleports only", {250, 20.f, 0, 6, 0, 0.f}, 3);
+    // Additions often over an eighth of the bodies, so frames switch between rebuilding and insertion sort
+    CheckAgainstBruteForce(shapes, "Few bodies", {12, 4.f, 3, 1, 5, 0.3f}, 4);
+
+    Benchmark(shapes, "Still", {5000, 150.f, 0, 0, 0, 0.f});
+    Benchmark(shapes, "Mostly still", {5000, 150.f, 2, 1, 1, 0.2f});
+    Benchmark(shapes, "All drifting", {5000, 150.f, 2, 1, 10, 0.2f});
+    Benchmark(shapes, "Many teleports", {2000, 80.f, 20, 100, 5, 0.2f});
+
+    return GetChecksResult("BroadPhaseTest");
+}
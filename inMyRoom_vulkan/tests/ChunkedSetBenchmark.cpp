@@ -0,0 +1,175 @@
+// Iteration and lookup throughput of chunked_set against sparse_set and dense_set, for entities the size of the global
+// matrices' ones, at several counts and fragmentations. The three must visit the same entities
+
+#include <bit>
+
+#include "TestsCommon.h"
+#include "ECS/ECStypes.h"
+#include "sparse_set.h"
+#include "dense_set.h"
+#include "chunked_set.h"
+
+namespace
+{
+    struct BenchCompEntityBase
+    {
+        Entity thisEntity = 0;
+    };
+
+    // Hot fields as EarlyNodeGlobalMatrixCompEntity's, and about its size
+    struct BenchCompEntity
+        :public BenchCompEntityBase
+    {
+        BenchCompEntity(Entity this_entity)
+        {
+            thisEntity = this_entity;
+            globalMatrix[3][0] = float(this_entity);
+            matrixVersion = uint32_t(this_entity) * 3;
+        }
+
+        glm::mat4 globalMatrix = glm::mat4(1.f);
+        uint32_t matrixVersion = 0;
+
+        float calculatedLocalTransform[10] = {};
+        Entity calculatedParentEntity = 0;
+        uint32_t calculatedParentMatrixVersion = 0;
+    };
+
+    template<template<typename _I, typename _D, typename _D_B, _I _D_B::*> typename data_set>
+    using BenchSet = data_set<Entity, BenchCompEntity, BenchCompEntityBase, &BenchCompEntityBase::thisEntity>;
+
+    struct VisitResult
+    {
+        size_t visitedCount = 0;
+        double checksum = 0.;
+
+        bool operator==(const VisitResult& rhs) const = default;
+    };
+
+    void Visit(const BenchCompEntity& comp_entity, VisitResult& result)
+    {
+        ++result.visitedCount;
+        result.checksum += double(comp_entity.globalMatrix[3][0]) + double(comp_entity.matrixVersion);
+    }
+
+    template<typename Set>
+    VisitResult IterateSet(const Set& set)
+    {
+        VisitResult result;
+        for (const BenchCompEntity& this_comp_entity : set)
+            Visit(this_comp_entity, result);
+        return result;
+    }
+
+    // The way ComponentDataClass::Update_impl hands chunks to workers
+    VisitResult IterateChunks(const BenchSet<chunked_set>& set)
+    {
+        VisitResult result;
+        for (size_t chunk_index = 0; chunk_index != set.chunks_count(); ++chunk_index)
+        {
+            const BenchSet<chunked_set>::chunk* this_chunk_ptr = set.get_chunk(chunk_index);
+            if (this_chunk_ptr == nullptr)
+                continue;
+
+            for (uint64_t mask = this_chunk_ptr->occupancy; mask != 0; mask &= mask - 1)
+                Visit(*this_chunk_ptr->element(size_t(std::countr_zero(mask))), result);
+        }
+        return result;
+    }
+
+    // Lookups at entity order, as the global matrices look up parents
+    template<typename Set>
+    VisitResult LookupSet(const Set& set, const std::vector<Entity>& alive_entities)
+    {
+        VisitResult result;
+        for (Entity this_entity : alive_entities)
+            Visit(set[this_entity], result);
+        return result;
+    }
+
+    template<typename Set>
+    Set CreateSet(size_t entities_count, const std::vector<std::pair<Entity, Entity>>& removed_ranges)
+    {
+        Set set;
+        for (Entity this_entity = 1; this_entity <= Entity(entities_count); ++this_entity)
+            set.add_element(BenchCompEntity(this_entity));
+        set.remove_oneshot_added_ranges(removed_ranges);
+
+        return set;
+    }
+
+    template<typename Func>
+    double MeasureNsPerEntity(size_t visited_count, Func&& func)
+    {
+        // Enough rounds for a few milliseconds per measure
+        size_t rounds_count = std::max(size_t(1), size_t(2000000) / std::max(visited_count, size_t(1)));
+        double best_time = MeasureBestTime(5, [&]()
+        {
+            for (size_t round = 0; round != rounds_count; ++round)
+                func();
+        });
+
+        return best_time / double(rounds_count * visited_count) * 1.e9;
+    }
+
+    void Benchmark(TestsRandom& random, size_t entities_count, size_t removed_percent)
+    {
+        // Removed as instances of 4 entities, as CompleteAddsAndRemoves does
+        std::vector<std::pair<Entity, Entity>> removed_ranges;
+        std::vector<Entity> alive_entities;
+        for (Entity first_entity = 1; first_entity <= Entity(entities_count); first_entity += 4)
+        {
+            Entity last_entity = std::min(first_entity + 3, Entity(entities_count));
+            if (random.NextUint() % 100 < removed_percent)
+                removed_ranges.emplace_back(first_entity, last_entity);
+            else
+                for (Entity this_entity = first_entity; this_entity <= last_entity; ++this_entity)
+                    alive_entities.emplace_back(this_entity);
+        }
+
+        BenchSet<sparse_set> sparse = CreateSet<BenchSet<sparse_set>>(entities_count, removed_ranges);
+        BenchSet<dense_set> dense = CreateSet<BenchSet<dense_set>>(entities_count, removed_ranges);
+        BenchSet<chunked_set> chunked = CreateSet<BenchSet<chunked_set>>(entities_count, removed_ranges);
+
+        VisitResult expected_result;
+        for (Entity this_entity : alive_entities)
+            Visit(BenchCompEntity(this_entity), expected_result);
+
+        // Sparse is packed, so its order differs, the sum does not
+        CHECK(IterateSet(sparse) == expected_result);
+        CHECK(IterateSet(dense) == expected_result);
+        CHECK(IterateSet(chunked) == expected_result);
+        CHECK(IterateChunks(chunked) == expected_result);
+        CHECK(LookupSet(sparse, alive_entities) == expected_result);
+        CHECK(LookupSet(dense, alive_entities) == expected_result);
+        CHECK(LookupSet(chunked, alive_entities) == expected_result);
+        CHECK(chunked.size() == alive_entities.size());
+
+        VisitResult sink;
+        size_t visited_count = alive_entities.size();
+        double sparse_ns = MeasureNsPerEntity(visited_count, [&]() {sink.checksum += IterateSet(sparse).checksum;});
+        double dense_ns = MeasureNsPerEntity(visited_count, [&]() {sink.checksum += IterateSet(dense).checksum;});
+        double chunked_ns = MeasureNsPerEntity(visited_count, [&]() {sink.checksum += IterateSet(chunked).checksum;});
+        double chunks_ns = MeasureNsPerEntity(visited_count, [&]() {sink.checksum += IterateChunks(chunked).checksum;});
+        double sparse_lookup_ns = MeasureNsPerEntity(visited_count, [&]() {sink.checksum += LookupSet(sparse, alive_entities).checksum;});
+        double dense_lookup_ns = MeasureNsPerEntity(visited_count, [&]() {sink.checksum += LookupSet(dense, alive_entities).checksum;});
+        double chunked_lookup_ns = MeasureNsPerEntity(visited_count, [&]() {sink.checksum += LookupSet(chunked, alive_entities).checksum;});
+        CHECK(sink.checksum != 0.);
+
+        printf("%6zu entities, %2zu%% removed: iterate sparse %.2f, dense %.2f, chunked %.2f, by chunks %.2f; lookup sparse %.2f, dense %.2f, chunked %.2f ns/entity\n",
+               entities_count, removed_percent,
+               sparse_ns, dense_ns, chunked_ns, chunks_ns, sparse_lookup_ns, dense_lookup_ns, chunked_lookup_ns);
+    }
+}
+
+int main()
+{
+    TestsRandom random(3);
+
+    printf("%zu bytes per entity\n", sizeof(BenchCompEntity));
+    for (size_t entities_count : {1000, 10000, 60000})
+        for (size_t removed_percent : {0, 25, 75})
+            Benchmark(random, entities_count, removed_percent);
+
+    return GetChecksResult("ChunkedSetBenchmark");
+}
@@ -0,0 +1,223 @@
+// Primitives' lights combinations through SpheresBVH and LightsCombinations, the way Lights::CreateCollidedLightsRange finds them, against
+// the brute force path it replaced: every local light's Sphere::IntersectParalgram and an unordered_map of combinations. Ranges and indices
+// byte identical, with sheared, flat and line-like OBBs among the primitives, and the times of both from 16 to 1024 lights
+
+#include <cstring>
+#include <unordered_map>
+
+#include "TestsCommon.h"
+#include "ECS/ECStypes.h"
+#include "Geometry/SpheresBVH.h"
+#include "Graphics/LightsCombinations.h"
+#include "hash_combine.h"
+
+namespace
+{
+    // Lights.h's spheres of the frame's lights with the lights' types, as Lights::AddLights fills them
+    struct LightsScene
+    {
+        std::vector<Sphere> lightsSpheres;
+        std::vector<LightType> lightsTypes;
+        std::vector<Paralgram> primitivesParalgrams;
+        size_t degeneratePrimitivesCount = 0;
+    };
+
+    // A fourth of the primitives are sheared, a tenth flat and a tenth line-like: zero sides give NaN normals at the slabs test
+    LightsScene CreateScene(TestsRandom& random, size_t lights_count, size_t primitives_count, float half_extent)
+    {
+        LightsScene scene;
+        for (size_t i = 0; i != lights_count; ++i)
+        {
+            scene.lightsSpheres.emplace_back(random.NextVec3(-half_extent, half_extent), random.NextFloat(2.f, 15.f));
+            scene.lightsTypes.emplace_back(i % 8 == 7 ? LightType::Cone : (i % 2 ? LightType::Cylinder : LightType::Sphere));
+        }
+
+        for (size_t i = 0; i != primitives_count; ++i)
+        {
+            glm::mat4 rotation_matrix = CreateTranslationRotationMatrix(random.NextVec3(-half_extent, half_extent), random.NextDirection(), random.NextFloat(0.f, 3.f));
+            glm::vec3 half_extents = random.NextVec3(0.1f, 3.f);
+            glm::vec3 side_u = glm::vec3(half_extents.x, 0.f, 0.f);
+            glm::vec3 side_v = glm::vec3(0.f, half_extents.y, 0.f);
+            glm::vec3 side_w = glm::vec3(0.f, 0.f, half_extents.z);
+
+            size_t kind = i % 20;
+            if (kind < 5)
+            {
+                side_v += 0.7f * side_u.x * glm::vec3(1.f, 0.f, 0.f);
+                side_w += 0.4f * half_extents.z * glm::vec3(0.f, 1.f, 1.f);
+            }
+            else if (kind < 7)
+            {
+                side_w = glm::vec3(0.f);
+                ++scene.degeneratePrimitivesCount;
+            }
+            else if (kind < 9)
+            {
+                side_v = glm::vec3(0.f);
+                side_w = glm::vec3(0.f);
+                ++scene.degeneratePrimitivesCount;
+            }
+
+            scene.primitivesParalgrams.emplace_back(rotation_matrix * Paralgram(glm::vec3(0.f), side_u, side_v, side_w));
+        }
+
+        return scene;
+    }
+
+    // Sphere::IntersectParalgram before it was split into ParalgramSlabs, normals normalized again for every light.
+    // Zero sides gave NaN normals there, whose comparisons pass with IEEE floats but not always with fast math, so they are skipped here
+    bool IntersectParalgramBruteForce(const Sphere& sphere, const Paralgram& paralgram)
+    {
+        glm::vec3 sphere_origin = sphere.GetOrigin() - paralgram.GetCenter();
+
+        std::array<glm::vec3, 3> sides = {paralgram.GetSideDirectionU(), paralgram.GetSideDirectionV(), paralgram.GetSideDirectionW()};
+        for (size_t i = 0; i != 3; ++i)
+        {
+            glm::vec3 plane_normal = glm::cross(sides[(i + 1) % 3], sides[(i + 2) % 3]);
+            if (glm::dot(plane_normal, plane_normal) == 0.f)
+                continue;
+
+            glm::vec3 plane_dir = glm::normalize(plane_normal);
+            float d = - std::abs(glm::dot(plane_dir, sides[i]));
+
+            float plane_has_center_dist = glm::dot(plane_dir, sphere_origin);
+            float v_n1 = + plane_has_center_dist + d;
+            float v_n2 = - plane_has_center_dist + d;
+
+            if (v_n1 - sphere.GetRadius() > 0 || v_n2 - sphere.GetRadius() > 0)
+                return false;
+        }
+
+        return true;
+    }
+
+    // The replaced Lights::CreateCollidedLightsRange: every local light tested in order, combinations found at an unordered_map
+    struct BruteForceLights
+    {
+        std::unordered_map<std::vector<uint16_t>, LightsIndicesRange> combinationToLightsIndicesRange;
+        std::vector<uint16_t> lightsCombinationsIndices;
+
+        void Clear()
+        {
+            combinationToLightsIndicesRange.clear();
+            lightsCombinationsIndices.clear();
+        }
+
+        LightsIndicesRange CreateCollidedLightsRange(const LightsScene& scene, const Paralgram& paralgram)
+        {
+            std::vector<uint16_t> collided_lights;
+            for (size_t i = 0; i != scene.lightsSpheres.size(); ++i)
+                if (scene.lightsTypes[i] != LightType::Cone && IntersectParalgramBruteForce(scene.lightsSpheres[i], paralgram))
+                    collided_lights.emplace_back(uint16_t(i));
+
+            LightsIndicesRange return_range = {};
+            if (collided_lights.size() == 0)
+                return return_range;
+
+            auto search = combinationToLightsIndicesRange.find(collided_lights);
+            if (search != combinationToLightsIndicesRange.end())
+            {
+                return_range = search->second;
+            }
+            else
+            {
+                return_range.offset = uint32_t(lightsCombinationsIndices.size());
+                return_range.size = uint32_t(collided_lights.size());
+
+                std::copy(collided_lights.begin(), collided_lights.end(), std::back_inserter(lightsCombinationsIndices));
+                combinationToLightsIndicesRange.emplace(std::move(collided_lights), return_range);
+            }
+
+            return return_range;
+        }
+    };
+
+    // As Lights::AddLights and Lights::CreateCollidedLightsRange with one CollidedLightsChunk
+    struct BVHLights
+    {
+        SpheresBVH localLightsBVH;
+        std::vector<uint32_t> localLightsIndices;
+
+        LightsCombinations combinations;
+        std::vector<uint32_t> collidedLights;
+        std::vector<uint16_t> collidedLightsCombination;
+        std::vector<uint32_t> traversalStack;
+
+        void Build(const LightsScene& scene)
+        {
+            localLightsIndices.clear();
+            for (size_t i = 0; i != scene.lightsSpheres.size(); ++i)
+                if (scene.lightsTypes[i] != LightType::Cone)
+                    localLightsIndices.emplace_back(uint32_t(i));
+            localLightsBVH.Build(scene.lightsSpheres, localLightsIndices);
+
+            combinations.Clear();
+        }
+
+        LightsIndicesRange CreateCollidedLightsRange(const Paralgram& paralgram)
+        {
+            localLightsBVH.CollideParalgram(paralgram, collidedLights, traversalStack);
+
+            collidedLightsCombination.clear();
+            for (uint32_t this_light : collidedLights)
+                collidedLightsCombination.emplace_back(uint16_t(this_light));
+
+            if (collidedLightsCombination.size() == 0)
+                return {};
+
+            return combinations.FindOrAddCombination(collidedLightsCombination);
+        }
+    };
+
+    template<typename T>
+    bool AreByteIdentical(const std::vector<T>& lhs, const std::vector<T>& rhs)
+    {
+        return lhs.size() == rhs.size() && std::memcmp(lhs.data(), rhs.data(), lhs.size() * sizeof(T)) == 0;
+    }
+
+    void CheckAndBenchmark(TestsRandom& random, size_t lights_count, size_t primitives_count)
+    {
+        // About the same lights per primitive at any lights count
+        float half_extent = 12.f * std::cbrt(float(lights_count));
+        LightsScene scene = CreateScene(random, lights_count, primitives_count, half_extent);
+
+        BruteForceLights brute_force_lights;
+        std::vector<LightsIndicesRange> brute_force_ranges(primitives_count);
+        double brute_force_time = MeasureBestTime(1, [&]()
+        {
+            brute_force_lights.Clear();
+            for (size_t i = 0; i != primitives_count; ++i)
+                brute_force_ranges[i] = brute_force_lights.CreateCollidedLightsRange(scene, scene.primitivesParalgrams[i]);
+        });
+
+        BVHLights bvh_lights;
+        std::vector<LightsIndicesRange> bvh_ranges(primitives_count);
+        double bvh_time = MeasureBestTime(3, [&]()
+        {
+            bvh_lights.Build(scene);
+            for (size_t i = 0; i != primitives_count; ++i)
+                bvh_ranges[i] = bvh_lights.CreateCollidedLightsRange(scene.primitivesParalgrams[i]);
+        });
+
+        CHECK(AreByteIdentical(bvh_ranges, brute_force_ranges));
+        CHECK(AreByteIdentical(bvh_lights.combinations.GetIndices(), brute_force_lights.lightsCombinationsIndices));
+
+        size_t lit_primitives_count = std::count_if(brute_force_ranges.begin(), brute_force_ranges.end(), [](const LightsIndicesRange& range) {return range.size != 0;});
+        CHECK(lit_primitives_count != 0);
+
+        printf("%5zu lights, %6zu primitives (%5zu degenerate): %6zu lit, %7zu combinations indices | brute force %8.2f ms, BVH %7.2f ms, x%.1f\n",
+               lights_count, primitives_count, scene.degeneratePrimitivesCount, lit_primitives_count, bvh_lights.combinations.GetIndices().size(),
+               brute_force_time * 1.e3, bvh_time * 1.e3, brute_force_time / bvh_time);
+    }
+}
+
+int main()
+{
+    TestsRandom random(24);
+
+    for (size_t lights_count : {16, 64, 256, 1024})
+        for (size_t primitives_count : {1000, 10000, 50000})
+            CheckAndBenchmark(random, lights_count, primitives_count);
+
+    return GetChecksResult("CollidedLightsTest");
+}
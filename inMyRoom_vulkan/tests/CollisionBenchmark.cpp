@@ -0,0 +1,525 @@
+// Scripted collision scenarios without window or renderer.
+// Prints per phase timings, and as a regression test compares the scenarios' results with a baseline file:
+//   CollisionBenchmark [--threads N] [--baseline file | --write-baseline file]
+// Every scenario runs with each broad phase, serially and at 1, 2, 4 and N worker threads (default hardware concurrency),
+// and all of them must make the same callbacks of every pair, bit for bit
+
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include "TestsCommon.h"
+#include "HeadlessCollisionScene.h"
+
+#include "WorkersPool.h"
+
+namespace
+{
+    struct ScenarioResult
+    {
+        size_t framesCount = 0;
+        size_t broadPhasePairsCount = 0;
+        size_t collidedPairsCount = 0;
+        size_t sweptPairsCount = 0;
+        size_t tunneledPairsCount = 0;
+        size_t callbacksCount = 0;
+        double deltasLengthSum = 0.;
+
+        std::vector<uint64_t> framesCallbacksHashes;
+        std::vector<std::vector<std::pair<Entity, std::vector<CollisionCallbackData>>>> framesCallbacks;
+
+        double broadPhaseSeconds = 0.;
+        double pairsSeconds = 0.;
+        double continuousSeconds = 0.;
+        double callbacksSeconds = 0.;
+    };
+
+    struct Scenario
+    {
+        std::string name;
+        size_t framesCount = 0;
+        std::function<void(HeadlessCollisionScene&)> setup;
+        std::function<void(HeadlessCollisionScene&, size_t frame)> animate;
+    };
+
+    OBBtree CreateEngineOBBtree(std::vector<Triangle>&& triangles)
+    {
+        // As PrimitivesOfMeshes builds them with the shipped config.cfg
+        OBBtree return_OBBtree(std::move(triangles), OBBtreeBuilder::midpoint);
+        return_OBBtree.QuantizeNodes();
+        return return_OBBtree;
+    }
+
+    // Shapes shared by the scenarios, trees are kept alive for all of them
+    struct ScenariosShapes
+    {
+        OBBtree floor = CreateEngineOBBtree(CreateBoxTriangles(glm::vec3(20.f, 0.5f, 16.f), 8));
+        OBBtree box = CreateEngineOBBtree(CreateBoxTriangles(glm::vec3(0.5f, 0.45f, 0.4f), 4));
+        OBBtree ellipsoid = CreateEngineOBBtree(CreateEllipsoidTriangles(glm::vec3(0.6f, 0.5f, 0.4f), 12, 24));
+        OBBtree bullet = CreateEngineOBBtree(CreateEllipsoidTriangles(glm::vec3(0.1f, 0.08f, 0.12f), 6, 12));
+        OBBtree wall = CreateEngineOBBtree(CreateBoxTriangles(glm::vec3(4.f, 3.f, 0.05f), 4));
+        OBBtree soup;
+        OBBtree segment = CreateEngineOBBtree(CreateEllipsoidTriangles(glm::vec3(0.35f, 0.25f, 0.2f), 8, 16));
+        OBBtree column = CreateEngineOBBtree(CreateBoxTriangles(glm::vec3(0.4f, 4.f, 0.35f), 4));
+        OBBtree hallWall = CreateEngineOBBtree(CreateBoxTriangles(glm::vec3(15.f, 4.f, 0.2f), 8));
+        OBBtree walker = CreateEngineOBBtree(CreateEllipsoidTriangles(glm::vec3(0.3f, 0.9f, 0.25f), 10, 20));
+
+        ScenariosShapes()
+        {
+            TestsRandom random(7);
+            soup = CreateEngineOBBtree(CreateTrianglesSoup(random, 400, 1.f, 0.3f));
+        }
+    };
+
+    std::vector<Scenario> CreateScenarios(const ScenariosShapes& shapes)
+    {
+        std::vector<Scenario> scenarios;
+
+        // Boxes resting on the floor and on each other, nothing moves: pair cache reuse
+        {
+            Scenario& scenario = scenarios.emplace_back();
+            scenario.name = "resting_boxes";
+            scenario.framesCount = 60;
+            scenario.setup = [&shapes](HeadlessCollisionScene& scene)
+            {
+                scene.AddBody(&shapes.floor, CreateTranslationRotationMatrix(glm::vec3(0.f, -0.5f, 0.f)));
+                for (int x = 0; x != 6; ++x)
+                    for (int z = 0; z != 6; ++z)
+                        for (int y = 0; y != 2; ++y)
+                            scene.AddBody(&shapes.box, CreateTranslationRotationMatrix(glm::vec3(2.f * float(x) - 5.f, 0.44f + 0.88f * float(y), 2.f * float(z) - 5.f)));
+            };
+            scenario.animate = [](HeadlessCollisionScene&, size_t) {};
+        }
+
+        // Ellipsoids sliding and spinning over the floor along crossing paths, into each other and a row of boxes
+        {
+            Scenario& scenario = scenarios.emplace_back();
+            scenario.name = "moving_ellipsoids";
+            scenario.framesCount = 120;
+            scenario.setup = [&shapes](HeadlessCollisionScene& scene)
+            {
+                scene.AddBody(&shapes.floor, CreateTranslationRotationMatrix(glm::vec3(0.f, -0.5f, 0.f)));
+                for (int x = 0; x != 8; ++x)
+                    scene.AddBody(&shapes.box, CreateTranslationRotationMatrix(glm::vec3(1.5f * float(x) - 5.25f, 0.44f, 0.f), glm::vec3(0.f, 1.f, 0.f), 0.3f * float(x)));
+                for (int i = 0; i != 24; ++i)
+                    scene.AddBody(&shapes.ellipsoid, glm::mat4(1.f));
+            };
+            scenario.animate = [](HeadlessCollisionScene& scene, size_t frame)
+            {
+                for (size_t i = 0; i != 24; ++i)
+                {
+                    float phase = 0.26f * float(i) + 0.05f * float(frame);
+                    float radius = 2.f + 0.25f * float(i % 8);
+                    glm::vec3 position = glm::vec3(radius * std::cos(phase), 0.45f, radius * std::sin(1.3f * phase));
+                    scene.SetBodyMatrix(9 + i, CreateTranslationRotationMatrix(position, glm::vec3(0.f, 1.f, 0.f), phase));
+                }
+            };
+        }
+
+        // Small fast bullets through thin walls, only continuous collision catches them
+        {
+            Scenario& scenario = scenarios.emplace_back();
+            scenario.name = "bullets_through_walls";
+            scenario.framesCount = 40;
+            scenario.setup = [&shapes](HeadlessCollisionScene& scene)
+            {
+                for (int i = 0; i != 4; ++i)
+                    scene.AddBody(&shapes.wall, CreateTranslationRotationMatrix(glm::vec3(0.f, 0.f, 10.f * float(i))));
+                for (int i = 0; i != 16; ++i)
+                    scene.AddBody(&shapes.bullet, CreateTranslationRotationMatrix(glm::vec3(0.f, 0.f, -5.f)), true);
+            };
+            scenario.animate = [](HeadlessCollisionScene& scene, size_t frame)
+            {
+                for (size_t i = 0; i != 16; ++i)
+                {
+                    glm::vec3 offset = glm::vec3(0.4f * float(i % 4) - 0.6f, 0.4f * float(i / 4) - 0.6f, 0.f);
+                    float z = -5.f + 1.3f * float(frame) + 0.17f * float(i);
+                    scene.SetBodyMatrix(4 + i, CreateTranslationRotationMatrix(offset + glm::vec3(0.f, 0.f, z)));
+                }
+            };
+        }
+
+        // Tumbling triangle soups crowded together: deep OBBtree traversals and many rays
+        {
+            Scenario& scenario = scenarios.emplace_back();
+            scenario.name = "tumbling_soups";
+            scenario.framesCount = 30;
+            scenario.setup = [&shapes](HeadlessCollisionScene& scene)
+            {
+                for (int i = 0; i != 12; ++i)
+                    scene.AddBody(&shapes.soup, glm::mat4(1.f));
+            };
+            scenario.animate = [](HeadlessCollisionScene& scene, size_t frame)
+            {
+                for (size_t i = 0; i != 12; ++i)
+                {
+                    glm::vec3 position = glm::vec3(1.2f * float(i % 4), 1.2f * float(i / 4), 0.3f * std::sin(0.2f * float(frame + i)));
+                    glm::vec3 axis = glm::normalize(glm::vec3(1.f, float(i % 3), 0.5f));
+                    scene.SetBodyMatrix(i, CreateTranslationRotationMatrix(position, axis, 0.07f * float(frame) + float(i)));
+                }
+            };
+        }
+
+        // A snake of ellipsoid segments slithering over the floor, neighbor segments overlap each other
+        {
+            Scenario& scenario = scenarios.emplace_back();
+            scenario.name = "snake_chain";
+            scenario.framesCount = 60;
+            scenario.setup = [&shapes](HeadlessCollisionScene& scene)
+            {
+                scene.AddBody(&shapes.floor, CreateTranslationRotationMatrix(glm::vec3(0.f, -0.5f, 0.f)));
+                for (int i = 0; i != 40; ++i)
+                    scene.AddBody(&shapes.segment, glm::mat4(1.f));
+            };
+            scenario.animate = [](HeadlessCollisionScene& scene, size_t frame)
+            {
+                for (size_t i = 0; i != 40; ++i)
+                {
+                    float x = 0.55f * float(i) - 11.f + 0.1f * float(frame);
+                    float phase = 0.4f * float(i) - 0.15f * float(frame);
+                    glm::vec3 position = glm::vec3(x, 0.22f, 1.5f * std::sin(phase));
+                    scene.SetBodyMatrix(1 + i, CreateTranslationRotationMatrix(position, glm::vec3(0.f, 1.f, 0.f), 0.8f * std::cos(phase)));
+                }
+            };
+        }
+
+        // Walk through an atrium of Sponza's layout: floor, long walls and two colonnades, static. Walkers go along
+        // the nave and weave between the columns, as cameras and characters of a game would
+        {
+            Scenario& scenario = scenarios.emplace_back();
+            scenario.name = "atrium_walkthrough";
+            scenario.framesCount = 90;
+            scenario.setup = [&shapes](HeadlessCollisionScene& scene)
+            {
+                scene.AddBody(&shapes.floor, CreateTranslationRotationMatrix(glm::vec3(0.f, -0.5f, 0.f)));
+                scene.AddBody(&shapes.floor, CreateTranslationRotationMatrix(glm::vec3(0.f, 8.5f, 0.f)));
+                scene.AddBody(&shapes.hallWall, CreateTranslationRotationMatrix(glm::vec3(0.f, 3.9f, -8.f)));
+                scene.AddBody(&shapes.hallWall, CreateTranslationRotationMatrix(glm::vec3(0.f, 3.9f, 8.f)));
+                for (int side = -1; side <= 1; side += 2)
+                    for (int i = 0; i != 12; ++i)
+                        scene.AddBody(&shapes.column, CreateTranslationRotationMatrix(glm::vec3(2.4f * float(i) - 13.2f, 3.9f, 4.f * float(side))));
+                for (int i = 0; i != 8; ++i)
+                    scene.AddBody(&shapes.walker, glm::mat4(1.f));
+            };
+            scenario.animate = [](HeadlessCollisionScene& scene, size_t frame)
+            {
+                for (size_t i = 0; i != 8; ++i)
+                {
+                    float x = -14.f + 0.3f * float(frame) + 1.1f * float(i);
+                    float z = (i % 2 == 0) ? 4.f + 0.5f * std::sin(0.9f * x) : 0.8f * float(i) - 3.f;
+                    scene.SetBodyMatrix(28 + i, CreateTranslationRotationMatrix(glm::vec3(x, 0.85f, z), glm::vec3(0.f, 1.f, 0.f), 0.1f * x));
+                }
+            };
+        }
+
+        return scenarios;
+    }
+
+    ScenarioResult RunScenario(const Scenario& scenario, const std::string& broad_phase, WorkersPool* workers_pool_ptr)
+    {
+        configuru::Config cfg = HeadlessCollisionScene::CreateDefaultCollisionConfig();
+        cfg["collisionSettings"]["broadPhase"] = broad_phase;
+        HeadlessCollisionScene scene(cfg, workers_pool_ptr);
+        scenario.setup(scene);
+
+        ScenarioResult result;
+        result.framesCount = scenario.framesCount;
+        for (size_t frame = 0; frame != scenario.framesCount; ++frame)
+        {
+            scenario.animate(scene, frame);
+            scene.ExecuteFrame();
+
+            const CollisionDetection::FrameStats& frame_stats = scene.GetFrameStats();
+            result.broadPhasePairsCount += frame_stats.broadPhasePairsCount;
+            result.collidedPairsCount += frame_stats.collidedPairsCount;
+            result.sweptPairsCount += frame_stats.sweptPairsCount;
+            result.tunneledPairsCount += frame_stats.tunneledPairsCount;
+            result.framesCallbacksHashes.emplace_back(frame_stats.callbacksHash);
+
+            result.broadPhaseSeconds += frame_stats.broadPhaseDuration.count();
+            result.pairsSeconds += frame_stats.pairsDuration.count();
+            result.continuousSeconds += frame_stats.continuousDuration.count();
+            result.callbacksSeconds += frame_stats.callbacksDuration.count();
+
+            result.framesCallbacks.emplace_back(scene.GetFrameCallbacks());
+            for (const auto& this_entity_data_pair : scene.GetFrameCallbacks())
+            {
+                result.callbacksCount += this_entity_data_pair.second.size();
+                for (const CollisionCallbackData& this_callbackData : this_entity_data_pair.second)
+                    result.deltasLengthSum += glm::length(this_callbackData.deltaVector);
+            }
+        }
+
+        return result;
+    }
+
+    bool AreVec3BitIdentical(const glm::vec3& lhs, const glm::vec3& rhs)
+    {
+        return std::memcmp(&lhs, &rhs, sizeof(glm::vec3)) == 0;
+    }
+
+    // Every callback of every frame, at the same order and with the same bits
+    bool AreCallbacksIdentical(const ScenarioResult& lhs, const ScenarioResult& rhs)
+    {
+        auto are_data_identical = [](const CollisionCallbackData& lhs_data, const CollisionCallbackData& rhs_data)
+        {
+            return lhs_data.familyEntity == rhs_data.familyEntity &&
+                   lhs_data.collideWithEntity == rhs_data.collideWithEntity &&
+                   AreVec3BitIdentical(lhs_data.deltaVector, rhs_data.deltaVector) &&
+                   lhs_data.hasTimeOfImpact == rhs_data.hasTimeOfImpact &&
+                   std::memcmp(&lhs_data.timeOfImpact, &rhs_data.timeOfImpact, sizeof(float)) == 0 &&
+                   AreVec3BitIdentical(lhs_data.contactNormal, rhs_data.contactNormal);
+        };
+
+        if (lhs.framesCallbacks.size() != rhs.framesCallbacks.size())
+            return false;
+
+        for (size_t frame = 0; frame != lhs.framesCallbacks.size(); ++frame)
+        {
+            const auto& lhs_frame = lhs.framesCallbacks[frame];
+            const auto& rhs_frame = rhs.framesCallbacks[frame];
+            if (lhs_frame.size() != rhs_frame.size())
+                return false;
+
+            for (size_t i = 0; i != lhs_frame.size(); ++i)
+            {
+                if (lhs_frame[i].first != rhs_frame[i].first ||
+                    not std::equal(lhs_frame[i].second.begin(), lhs_frame[i].second.end(),
+                                   rhs_frame[i].second.begin(), rhs_frame[i].second.end(), are_data_identical))
+                    return false;
+            }
+        }
+
+        return lhs.framesCallbacksHashes == rhs.framesCallbacksHashes;
+    }
+
+    std::string GetBaselineLine(const std::string& name, const std::string& broad_phase, const ScenarioResult& result)
+    {
+        std::ostringstream line;
+        line << name << " "
+             << broad_phase << " "
+             << result.framesCount << " "
+             << result.broadPhasePairsCount << " "
+             << result.collidedPairsCount << " "
+             << result.sweptPairsCount << " "
+             << result.tunneledPairsCount << " "
+             << result.callbacksCount << " "
+             << std::fixed << result.deltasLengthSum;
+        return line.str();
+    }
+
+    // Counts have to match. Deltas come from rays that float noise of other compilers and math flags may turn, so their sum only within 1%
+    bool DoesMatchBaselineLine(const std::string& line, const std::string& baseline_line)
+    {
+        std::istringstream line_stream(line);
+        std::istringstream baseline_stream(baseline_line);
+
+        for (size_t i = 0; i != 8; ++i)
+        {
+            std::string value, baseline_value;
+            line_stream >> value;
+            baseline_stream >> baseline_value;
+            if (value != baseline_value)
+                return false;
+        }
+
+        double deltas_length_sum = 0., baseline_deltas_length_sum = 0.;
+        line_stream >> deltas_length_sum;
+        baseline_stream >> baseline_deltas_length_sum;
+
+        return std::abs(deltas_length_sum - baseline_deltas_length_sum) <= 1.e-3 + 1.e-2 * std::abs(baseline_deltas_length_sum);
+    }
+
+    // Cost of continuous collision per flagged entity: fast bullets that sweep through walls every frame, and slow ones
+    // that stay under continuousCollisionMinMovement, so only the filter of movers runs for them
+    void BenchmarkContinuousCollisionCost(const ScenariosShapes& shapes)
+    {
+        // Rows are printed after all runs, as collision detection prints its settings when created
+        std::ostringstream table;
+        table << "\nbullets  speed  swept/frame  ccd ms/frame  ccd us/bullet\n";
+
+        for (size_t bullets_count : {1, 16, 64, 256})
+        {
+            for (float speed : {1.3f, 0.01f})
+            {
+                configuru::Config cfg = HeadlessCollisionScene::CreateDefaultCollisionConfig();
+                HeadlessCollisionScene scene(cfg);
+
+                for (int i = 0; i != 4; ++i)
+                    scene.AddBody(&shapes.wall, CreateTranslationRotationMatrix(glm::vec3(0.f, 0.f, 10.f * float(i))));
+
+                // A grid in front of the walls, each bullet starts at its own distance
+                auto get_bullet_position = [bullets_count, speed](size_t bullet, size_t frame)
+                {
+                    size_t grid_width = size_t(std::ceil(std::sqrt(double(bullets_count))));
+                    glm::vec3 offset = glm::vec3(0.3f * float(bullet % grid_width), 0.3f * float(bullet / grid_width), 0.f);
+                    offset -= glm::vec3(0.15f * float(grid_width - 1), 0.15f * float(grid_width - 1), 0.f);
+                    return offset + glm::vec3(0.f, 0.f, -5.f + speed * float(frame) + 0.17f * float(bullet % 8));
+                };
+
+                for (size_t i = 0; i != bullets_count; ++i)
+                    scene.AddBody(&shapes.bullet, CreateTranslationRotationMatrix(get_bullet_position(i, 0)), true);
+
+                const size_t frames_count = 40;
+                size_t swept_pairs_count = 0;
+                double continuous_seconds = 0.;
+                for (size_t frame = 0; frame != frames_count; ++frame)
+                {
+                    for (size_t i = 0; i != bullets_count; ++i)
+                        scene.SetBodyMatrix(4 + i, CreateTranslationRotationMatrix(get_bullet_position(i, frame)));
+                    scene.ExecuteFrame();
+
+                    swept_pairs_count += scene.GetFrameStats().sweptPairsCount;
+                    continuous_seconds += scene.GetFrameStats().continuousDuration.count();
+                }
+
+                if (speed > 1.f)
+                    CHECK(swept_pairs_count != 0);
+                else
+                    CHECK(swept_pairs_count == 0);
+
+                double ms_per_frame = continuous_seconds * 1.e3 / double(frames_count);
+                char row[128];
+                snprintf(row, sizeof(row), "%-8zu %-6s %11.2f %13.4f %14.3f\n",
+                         bullets_count, speed > 1.f ? "fast" : "slow", double(swept_pairs_count) / double(frames_count),
+                         ms_per_frame, ms_per_frame * 1.e3 / double(bullets_count));
+                table << row;
+            }
+        }
+
+        printf("%s", table.str().c_str());
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    size_t threads_count = std::max(size_t(std::thread::hardware_concurrency()), size_t(1));
+    std::string baseline_path;
+    bool should_write_baseline = false;
+
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        if (std::strcmp(argv[i], "--threads") == 0)
+            threads_count = std::max(size_t(std::stoul(argv[i + 1])), size_t(1));
+        else if (std::strcmp(argv[i], "--baseline") == 0)
+            baseline_path = argv[i + 1];
+        else if (std::strcmp(argv[i], "--write-baseline") == 0)
+            baseline_path = argv[i + 1], should_write_baseline = true;
+    }
+
+    std::map<std::string, std::string> baseline_lines;
+    if (not baseline_path.empty() && not should_write_baseline)
+    {
+        std::ifstream baseline_file(baseline_path);
+        CHECK(baseline_file.is_open());
+
+        std::string this_line;
+        while (std::getline(baseline_file, this_line))
+        {
+            if (not this_line.empty() && this_line[0] != '#')
+                baseline_lines.emplace(this_line.substr(0, this_line.find(' ', this_line.find(' ') + 1)), this_line);
+        }
+    }
+
+    ScenariosShapes shapes;
+    std::vector<Scenario> scenarios = CreateScenarios(shapes);
+
+    std::vector<size_t> threads_counts = {1, 2, 4};
+    if (std::find(threads_counts.begin(), threads_counts.end(), threads_count) == threads_counts.end())
+        threads_counts.emplace_back(threads_count);
+
+    std::vector<std::unique_ptr<WorkersPool>> workers_pools;
+    for (size_t this_threads_count : threads_counts)
+        workers_pools.emplace_back(std::make_unique<WorkersPool>(this_threads_count));
+
+    const std::vector<std::string> broad_phases = {"SweepAndPrune", "DynamicAABBtree"};
+
+    std::ostringstream new_baseline;
+    new_baseline << "# scenario broadPhase frames broadPhasePairs collidedPairs sweptPairs tunneledPairs callbacks deltasLengthSum\n";
+    new_baseline << "# regenerate with: CollisionBenchmark --write-baseline <this file>, when a change of results is intended\n";
+
+    // All runs before the table, as collision detection prints its settings when created
+    struct BroadPhaseRun
+    {
+        const Scenario* scenario_ptr = nullptr;
+        std::string broadPhase;
+        ScenarioResult serialResult;
+        std::vector<ScenarioResult> poolsResults;         // at each of threads_counts
+    };
+
+    std::vector<BroadPhaseRun> runs;
+    for (const Scenario& this_scenario : scenarios)
+    {
+        for (const std::string& this_broad_phase : broad_phases)
+        {
+            BroadPhaseRun& this_run = runs.emplace_back();
+            this_run.scenario_ptr = &this_scenario;
+            this_run.broadPhase = this_broad_phase;
+            this_run.serialResult = RunScenario(this_scenario, this_broad_phase, nullptr);
+            for (const std::unique_ptr<WorkersPool>& this_workers_pool_uptr : workers_pools)
+                this_run.poolsResults.emplace_back(RunScenario(this_scenario, this_broad_phase, this_workers_pool_uptr.get()));
+        }
+    }
+
+    printf("\n%-24s %-16s %10s %10s %10s %10s %10s | ms/frame: %8s %8s %8s %8s | pairs ms/frame at threads:",
+           "scenario", "broad phase", "pairs", "collided", "swept", "tunneled", "callbacks",
+           "broad", "pairs", "ccd", "callback");
+    for (size_t this_threads_count : threads_counts)
+        printf(" %8zu", this_threads_count);
+    printf("\n");
+
+    for (const BroadPhaseRun& this_run : runs)
+    {
+        const Scenario& this_scenario = *this_run.scenario_ptr;
+        const ScenarioResult& serial_result = this_run.serialResult;
+
+        double ms_per_frame = 1000. / double(serial_result.framesCount);
+        printf("%-24s %-16s %10zu %10zu %10zu %10zu %10zu | ms/frame: %8.3f %8.3f %8.3f %8.3f | pairs ms/frame at threads:",
+               this_scenario.name.c_str(), this_run.broadPhase.c_str(),
+               serial_result.broadPhasePairsCount, serial_result.collidedPairsCount, serial_result.sweptPairsCount,
+               serial_result.tunneledPairsCount, serial_result.callbacksCount,
+               serial_result.broadPhaseSeconds * ms_per_frame, serial_result.pairsSeconds * ms_per_frame,
+               serial_result.continuousSeconds * ms_per_frame, serial_result.callbacksSeconds * ms_per_frame);
+        for (const ScenarioResult& this_pool_result : this_run.poolsResults)
+            printf(" %8.3f", this_pool_result.pairsSeconds * ms_per_frame);
+        printf("\n");
+
+        // Callbacks of the scenario's first run, every broad phase and threads count must make the same
+        auto first_run_it = std::find_if(runs.begin(), runs.end(), [&this_run](const BroadPhaseRun& run) {return run.scenario_ptr == this_run.scenario_ptr;});
+        CHECK(AreCallbacksIdentical(serial_result, first_run_it->serialResult));
+        for (const ScenarioResult& this_pool_result : this_run.poolsResults)
+            CHECK(AreCallbacksIdentical(this_pool_result, first_run_it->serialResult));
+
+        std::string this_line = GetBaselineLine(this_scenario.name, this_run.broadPhase, serial_result);
+        new_baseline << this_line << "\n";
+
+        if (not baseline_path.empty() && not should_write_baseline)
+        {
+            auto search = baseline_lines.find(this_scenario.name + " " + this_run.broadPhase);
+            CHECK(search != baseline_lines.end());
+            if (search != baseline_lines.end() && not DoesMatchBaselineLine(this_line, search->second))
+            {
+                printf("%s with %s differs from the baseline\n    now:      %s\n    baseline: %s\n",
+                       this_scenario.name.c_str(), this_run.broadPhase.c_str(), this_line.c_str(), search->second.c_str());
+                ++GetFailedChecksCount();
+            }
+        }
+    }
+
+    BenchmarkContinuousCollisionCost(shapes);
+
+    if (should_write_baseline)
+    {
+        std::ofstream baseline_file(baseline_path);
+        baseline_file << new_baseline.str();
+        CHECK(baseline_file.good());
+    }
+
+    return GetChecksResult("CollisionBenchmark");
+}
@@ -0,0 +1,182 @@
+// Collision detection scenarios that once went wrong, run at the shipped config.cfg's collision settings
+
+#include "TestsCommon.h"
+#include "HeadlessCollisionScene.h"
+
+namespace
+{
+    struct RegressionShapes
+    {
+        OBBtree floor = OBBtree(CreateBoxTriangles(glm::vec3(10.f, 0.5f, 8.f), 4));
+        OBBtree box = OBBtree(CreateBoxTriangles(glm::vec3(0.5f, 0.45f, 0.4f), 2));
+        OBBtree wall = OBBtree(CreateBoxTriangles(glm::vec3(4.f, 3.f, 0.05f), 2));
+    };
+
+    // A continuous box resting on the floor jumps off it faster than continuous collision's threshold.
+    // It overlapped the floor at the previous frame, which is no impact to pull it back to
+    void SeparatingFromRestingContact(const RegressionShapes& shapes)
+    {
+        configuru::Config cfg = HeadlessCollisionScene::CreateDefaultCollisionConfig();
+        HeadlessCollisionScene scene(cfg);
+
+        scene.AddBody(&shapes.floor, CreateTranslationRotationMatrix(glm::vec3(0.f, -0.5f, 0.f)));
+        size_t box_index = scene.AddBody(&shapes.box, CreateTranslationRotationMatrix(glm::vec3(0.f, 0.44f, 0.f)), true);
+
+        for (size_t frame = 0; frame != 3; ++frame)
+            scene.ExecuteFrame();
+
+        const std::vector<CollisionCallbackData>* resting_callbacks_ptr = scene.GetBodyCallbacks(box_index);
+        CHECK(resting_callbacks_ptr != nullptr);
+
+        scene.SetBodyMatrix(box_index, CreateTranslationRotationMatrix(glm::vec3(0.f, 2.f, 0.f)));
+        scene.ExecuteFrame();
+
+        CHECK(scene.GetFrameStats().sweptPairsCount == 1);
+        CHECK(scene.GetFrameStats().tunneledPairsCount == 0);
+        CHECK(scene.GetBodyCallbacks(box_index) == nullptr);
+    }
+
+    // Same, but it slides fast along the floor and stays in contact: a callback that only adds the time of impact
+    void SlidingOnRestingContact(const RegressionShapes& shapes)
+    {
+        configuru::Config cfg = HeadlessCollisionScene::CreateDefaultCollisionConfig();
+        HeadlessCollisionScene scene(cfg);
+
+        scene.AddBody(&shapes.floor, CreateTranslationRotationMatrix(glm::vec3(0.f, -0.5f, 0.f)));
+        size_t box_index = scene.AddBody(&shapes.box, CreateTranslationRotationMatrix(glm::vec3(0.f, 0.44f, 0.f)), true);
+
+        for (size_t frame = 0; frame != 3; ++frame)
+            scene.ExecuteFrame();
+
+        scene.SetBodyMatrix(box_index, CreateTranslationRotationMatrix(glm::vec3(2.f, 0.44f, 0.f)));
+        scene.ExecuteFrame();
+
+        CHECK(scene.GetFrameStats().tunneledPairsCount == 0);
+
+        const std::vector<CollisionCallbackData>* sliding_callbacks_ptr = scene.GetBodyCallbacks(box_index);
+        CHECK(sliding_callbacks_ptr != nullptr && sliding_callbacks_ptr->size() == 1);
+        if (sliding_callbacks_ptr != nullptr && sliding_callbacks_ptr->size() == 1)
+        {
+            const CollisionCallbackData& this_callbackData = sliding_callbacks_ptr->front();
+            CHECK(this_callbackData.hasTimeOfImpact);
+            CHECK(this_callbackData.timeOfImpact == 0.f);
+            CHECK(this_callbackData.contactNormal == glm::vec3(0.f));
+            // Rays of the overlap push it up, out of the floor, not back to where it came from
+            CHECK(this_callbackData.deltaVector.y > 0.f);
+            CHECK(std::abs(this_callbackData.deltaVector.x) < 0.1f);
+        }
+    }
+
+    // A continuous box that moves through a thin wall between two frames is pulled back to the wall's face
+    void TunnelingThroughWall(const RegressionShapes& shapes)
+    {
+        configuru::Config cfg = HeadlessCollisionScene::CreateDefaultCollisionConfig();
+        HeadlessCollisionScene scene(cfg);
+
+        scene.AddBody(&shapes.wall, glm::mat4(1.f));
+        size_t box_index = scene.AddBody(&shapes.box, CreateTranslationRotationMatrix(glm::vec3(0.f, 0.f, -2.f)), true);
+
+        scene.ExecuteFrame();
+        CHECK(scene.GetBodyCallbacks(box_index) == nullptr);
+
+        scene.SetBodyMatrix(box_index, CreateTranslationRotationMatrix(glm::vec3(0.f, 0.f, +2.f)));
+        scene.ExecuteFrame();
+
+        CHECK(scene.GetFrameStats().tunneledPairsCount == 1);
+
+        const std::vector<CollisionCallbackData>* tunneled_callbacks_ptr = scene.GetBodyCallbacks(box_index);
+        CHECK(tunneled_callbacks_ptr != nullptr && tunneled_callbacks_ptr->size() == 1);
+        if (tunneled_callbacks_ptr != nullptr && tunneled_callbacks_ptr->size() == 1)
+        {
+            const CollisionCallbackData& this_callbackData = tunneled_callbacks_ptr->front();
+            CHECK(this_callbackData.hasTimeOfImpact);
+            CHECK(this_callbackData.timeOfImpact > 0.f && this_callbackData.timeOfImpact < 1.f);
+            CHECK(this_callbackData.contactNormal.z < -0.99f);
+
+            // From z = +2 back to touching the wall at z = -0.05 - 0.4
+            glm::vec3 uncollided_position = glm::vec3(0.f, 0.f, 2.f) + this_callbackData.deltaVector;
+            CHECK(std::abs(uncollided_position.z - (-0.45f)) < 0.01f);
+            CHECK(std::abs(uncollided_position.x) < 0.001f && std::abs(uncollided_position.y) < 0.001f);
+        }
+    }
+
+    // Bodies resting on each other, a platform carrying a box and a box creeping along the floor.
+    // Reusing the narrow phase of pairs must not change any callback, the creeping box must not reuse stale rays
+    void RestingContactsPairCache(const RegressionShapes& shapes)
+    {
+        auto run_resting_contacts = [&shapes](bool use_pair_cache, CollisionPairCache::Stats& out_pair_cache_stats)
+        {
+            configuru::Config cfg = HeadlessCollisionScene::CreateDefaultCollisionConfig();
+            cfg["collisionSettings"]["pairCache"] = use_pair_cache;
+            HeadlessCollisionScene scene(cfg);
+
+            scene.AddBody(&shapes.floor, CreateTranslationRotationMatrix(glm::vec3(0.f, -0.5f, 0.f)));
+            scene.AddBody(&shapes.box, CreateTranslationRotationMatrix(glm::vec3(0.f, 0.44f, 0.f)));
+            scene.AddBody(&shapes.box, CreateTranslationRotationMatrix(glm::vec3(0.f, 1.32f, 0.f)));
+            size_t platform_index = scene.AddBody(&shapes.box, CreateTranslationRotationMatrix(glm::vec3(-4.f, 3.f, 0.f)));
+            size_t carried_index = scene.AddBody(&shapes.box, CreateTranslationRotationMatrix(glm::vec3(-4.f, 3.875f, 0.f)));
+            size_t creeping_index = scene.AddBody(&shapes.box, CreateTranslationRotationMatrix(glm::vec3(4.f, 0.44f, 0.f)));
+
+            std::vector<std::vector<CollisionCallbackData>> frames_callbacks;
+            for (size_t frame = 0; frame != 30; ++frame)
+            {
+                // Steps exact at float, so the carried box's relative transform stays bit-identical
+                float platform_height = 3.f + 0.25f * float(frame);
+                scene.SetBodyMatrix(platform_index, CreateTranslationRotationMatrix(glm::vec3(-4.f, platform_height, 0.f)));
+                scene.SetBodyMatrix(carried_index, CreateTranslationRotationMatrix(glm::vec3(-4.f, platform_height + 0.875f, 0.f)));
+                // Below 0.002 of its size per frame
+                scene.SetBodyMatrix(creeping_index, CreateTranslationRotationMatrix(glm::vec3(4.f + 0.0005f * float(frame), 0.44f, 0.f)));
+
+                scene.ExecuteFrame();
+
+                std::vector<CollisionCallbackData> this_frame_callbacks;
+                for (size_t body_index = 0; body_index != 6; ++body_index)
+                    if (const std::vector<CollisionCallbackData>* body_callbacks_ptr = scene.GetBodyCallbacks(body_index))
+                        this_frame_callbacks.insert(this_frame_callbacks.end(), body_callbacks_ptr->begin(), body_callbacks_ptr->end());
+
+                frames_callbacks.emplace_back(std::move(this_frame_callbacks));
+            }
+
+            out_pair_cache_stats = scene.GetPairCacheStats();
+            return frames_callbacks;
+        };
+
+        CollisionPairCache::Stats cached_stats;
+        CollisionPairCache::Stats uncached_stats;
+        std::vector<std::vector<CollisionCallbackData>> cached_frames_callbacks = run_resting_contacts(true, cached_stats);
+        std::vector<std::vector<CollisionCallbackData>> uncached_frames_callbacks = run_resting_contacts(false, uncached_stats);
+
+        CHECK(cached_stats.sameTransformHitsCount > 0);
+        CHECK(cached_stats.revalidateHitsCount == 0);
+
+        CHECK(cached_frames_callbacks.size() == uncached_frames_callbacks.size());
+        for (size_t frame = 0; frame != std::min(cached_frames_callbacks.size(), uncached_frames_callbacks.size()); ++frame)
+        {
+            const std::vector<CollisionCallbackData>& cached_callbacks = cached_frames_callbacks[frame];
+            const std::vector<CollisionCallbackData>& uncached_callbacks = uncached_frames_callbacks[frame];
+
+            // Resting pairs, the carried box and the creeping box
+            CHECK(cached_callbacks.size() == 8);
+            CHECK(cached_callbacks.size() == uncached_callbacks.size());
+            for (size_t i = 0; i != std::min(cached_callbacks.size(), uncached_callbacks.size()); ++i)
+            {
+                CHECK(cached_callbacks[i].familyEntity == uncached_callbacks[i].familyEntity);
+                CHECK(cached_callbacks[i].collideWithEntity == uncached_callbacks[i].collideWithEntity);
+                CHECK(cached_callbacks[i].deltaVector == uncached_callbacks[i].deltaVector);
+                CHECK(cached_callbacks[i].hasTimeOfImpact == uncached_callbacks[i].hasTimeOfImpact);
+            }
+        }
+    }
+}
+
+int main()
+{
+    RegressionShapes shapes;
+
+    SeparatingFromRestingContact(shapes);
+    SlidingOnRestingContact(shapes);
+    TunnelingThroughWall(shapes);
+    RestingContactsPairCache(shapes);
+
+    return GetChecksResult("CollisionRegressionTest");
+}
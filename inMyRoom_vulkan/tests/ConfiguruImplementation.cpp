@@ -0,0 +1,3 @@
+// The game gets it from implementations.cpp, together with tinyglTF and VMA that tests do not link
+#define CONFIGURU_IMPLEMENTATION 1
+#include "configuru.hpp"
@@ -0,0 +1,210 @@
+// The draw list's lights ranges written by chunks on worker threads and merged at the chunks' order, the way
+// RendererBase::UpdateDrawList does, against one serial pass: combinations and every primitive's range byte identical
+// at any threads count, and the times of both
+
+#include <cstring>
+#include <memory>
+
+#include "TestsCommon.h"
+#include "Geometry/SpheresBVH.h"
+#include "Graphics/LightsCombinations.h"
+#include "WorkersPool.h"
+
+namespace
+{
+    struct DrawListScene
+    {
+        SpheresBVH lightsBVH;
+        std::vector<Paralgram> primitivesParalgrams;
+        std::vector<size_t> drawsInstanceOffsets;       // first primitive of each draw, as RendererBase::drawListInstanceOffsets
+    };
+
+    // Fields of Lights.h's CollidedLightsChunk, which needs Vulkan
+    struct LightsChunk
+    {
+        size_t firstDrawIndex = 0;
+        size_t lastDrawIndex = 0;
+
+        LightsCombinations combinations;
+        std::vector<uint32_t> mergedOffsets;
+
+        std::vector<uint32_t> collidedLights;
+        std::vector<uint16_t> collidedLightsCombination;
+        std::vector<uint32_t> traversalStack;
+    };
+
+    // Draws of 1 to 8 primitives clustered around lights, so many primitives share combinations
+    DrawListScene CreateScene(TestsRandom& random, size_t draws_count, size_t lights_count, float half_extent)
+    {
+        std::vector<Sphere> lights_spheres;
+        std::vector<uint32_t> lights_indices;
+        for (size_t i = 0; i != lights_count; ++i)
+        {
+            lights_spheres.emplace_back(random.NextVec3(-half_extent, half_extent), random.NextFloat(2.f, 15.f));
+            lights_indices.emplace_back(uint32_t(i));
+        }
+
+        DrawListScene scene;
+        scene.lightsBVH.Build(lights_spheres, lights_indices);
+
+        for (size_t draw_index = 0; draw_index != draws_count; ++draw_index)
+        {
+            scene.drawsInstanceOffsets.emplace_back(scene.primitivesParalgrams.size());
+
+            glm::vec3 draw_center = random.NextVec3(-half_extent, half_extent);
+            size_t primitives_count = 1 + random.NextUint() % 8;
+            for (size_t i = 0; i != primitives_count; ++i)
+            {
+                glm::vec3 half_extents = random.NextVec3(0.2f, 3.f);
+                scene.primitivesParalgrams.emplace_back(draw_center + random.NextVec3(-2.f, 2.f),
+                                                        glm::vec3(half_extents.x, 0.f, 0.f),
+                                                        glm::vec3(0.f, half_extents.y, 0.f),
+                                                        glm::vec3(0.f, 0.f, half_extents.z));
+            }
+        }
+
+        return scene;
+    }
+
+    LightsIndicesRange CreateCollidedLightsRange(const DrawListScene& scene, size_t primitive_index, LightsChunk& chunk)
+    {
+        scene.lightsBVH.CollideParalgram(scene.primitivesParalgrams[primitive_index], chunk.collidedLights, chunk.traversalStack);
+
+        chunk.collidedLightsCombination.clear();
+        for (uint32_t this_light : chunk.collidedLights)
+            chunk.collidedLightsCombination.emplace_back(uint16_t(this_light));
+
+        if (chunk.collidedLightsCombination.size() == 0)
+            return {};
+
+        return chunk.combinations.FindOrAddCombination(chunk.collidedLightsCombination);
+    }
+
+    void WriteSerially(const DrawListScene& scene, LightsCombinations& combinations, std::vector<LightsIndicesRange>& primitives_ranges)
+    {
+        LightsChunk chunk;
+        primitives_ranges.resize(scene.primitivesParalgrams.size());
+        for (size_t primitive_index = 0; primitive_index != scene.primitivesParalgrams.size(); ++primitive_index)
+            primitives_ranges[primitive_index] = CreateCollidedLightsRange(scene, primitive_index, chunk);
+
+        combinations = chunk.combinations;
+    }
+
+    // As RendererBase::SplitDrawListChunks
+    void SplitChunks(const DrawListScene& scene, size_t threads_count, size_t min_primitives, size_t chunks_per_thread, std::vector<LightsChunk>& chunks)
+    {
+        size_t primitives_count = scene.primitivesParalgrams.size();
+        size_t draws_count = scene.drawsInstanceOffsets.size();
+        size_t chunks_count = std::clamp(primitives_count / min_primitives, size_t(1), threads_count * chunks_per_thread);
+
+        chunks.resize(chunks_count);
+        size_t first_draw_index = 0;
+        for (size_t chunk_index = 0; chunk_index != chunks_count; ++chunk_index)
+        {
+            size_t last_draw_index = draws_count;
+            if (chunk_index + 1 != chunks_count)
+            {
+                size_t chunk_end_instance = (primitives_count * (chunk_index + 1)) / chunks_count;
+                last_draw_index = std::lower_bound(scene.drawsInstanceOffsets.begin(), scene.drawsInstanceOffsets.end(), chunk_end_instance) - scene.drawsInstanceOffsets.begin();
+                last_draw_index = std::max(last_draw_index, first_draw_index);
+            }
+
+            chunks[chunk_index].firstDrawIndex = first_draw_index;
+            chunks[chunk_index].lastDrawIndex = last_draw_index;
+            first_draw_index = last_draw_index;
+        }
+    }
+
+    // Same passes as RendererBase::UpdateDrawList: chunks at their own combinations, merge at the chunks' order, remap
+    void WriteByChunks(const DrawListScene& scene, WorkersPool& workers_pool, std::vector<LightsChunk>& chunks,
+                       LightsCombinations& combinations, std::vector<LightsIndicesRange>& primitives_ranges)
+    {
+        size_t primitives_count = scene.primitivesParalgrams.size();
+        primitives_ranges.resize(primitives_count);
+
+        auto get_primitives_range = [&scene, primitives_count](const LightsChunk& chunk)
+        {
+            size_t first_primitive = chunk.firstDrawIndex != scene.drawsInstanceOffsets.size() ? scene.drawsInstanceOffsets[chunk.firstDrawIndex] : primitives_count;
+            size_t last_primitive = chunk.lastDrawIndex != scene.drawsInstanceOffsets.size() ? scene.drawsInstanceOffsets[chunk.lastDrawIndex] : primitives_count;
+            return std::make_pair(first_primitive, last_primitive);
+        };
+
+        workers_pool.ParallelFor(chunks.size(), 1, [&](size_t first_chunk, size_t last_chunk)
+        {
+            for (size_t chunk_index = first_chunk; chunk_index != last_chunk; ++chunk_index)
+            {
+                LightsChunk& this_chunk = chunks[chunk_index];
+                this_chunk.combinations.Clear();
+
+                auto [first_primitive, last_primitive] = get_primitives_range(this_chunk);
+                for (size_t primitive_index = first_primitive; primitive_index != last_primitive; ++primitive_index)
+                    primitives_ranges[primitive_index] = CreateCollidedLightsRange(scene, primitive_index, this_chunk);
+            }
+        });
+
+        combinations.Clear();
+        for (LightsChunk& this_chunk : chunks)
+            combinations.MergeCombinations(this_chunk.combinations, this_chunk.mergedOffsets);
+
+        workers_pool.ParallelFor(chunks.size(), 1, [&](size_t first_chunk, size_t last_chunk)
+        {
+            for (size_t chunk_index = first_chunk; chunk_index != last_chunk; ++chunk_index)
+            {
+                const LightsChunk& this_chunk = chunks[chunk_index];
+
+                auto [first_primitive, last_primitive] = get_primitives_range(this_chunk);
+                for (size_t primitive_index = first_primitive; primitive_index != last_primitive; ++primitive_index)
+                    if (primitives_ranges[primitive_index].size != 0)
+                        primitives_ranges[primitive_index].offset = this_chunk.mergedOffsets[primitives_ranges[primitive_index].offset];
+            }
+        });
+    }
+
+    bool AreRangesByteIdentical(const std::vector<LightsIndicesRange>& lhs, const std::vector<LightsIndicesRange>& rhs)
+    {
+        return lhs.size() == rhs.size() && std::memcmp(lhs.data(), rhs.data(), lhs.size() * sizeof(LightsIndicesRange)) == 0;
+    }
+
+    void CheckScene(const DrawListScene& scene, const char* scene_name)
+    {
+        LightsCombinations serial_combinations;
+        std::vector<LightsIndicesRange> serial_ranges;
+        double serial_time = MeasureBestTime(3, [&]() {WriteSerially(scene, serial_combinations, serial_ranges);});
+
+        size_t lit_primitives_count = std::count_if(serial_ranges.begin(), serial_ranges.end(), [](const LightsIndicesRange& range) {return range.size != 0;});
+        CHECK(lit_primitives_count != 0);
+        printf("%s: %zu primitives, %zu lit, %zu combinations indices, serial %.3f ms\n",
+               scene_name, serial_ranges.size(), lit_primitives_count, serial_combinations.GetIndices().size(), serial_time * 1.e3);
+
+        // Small chunks too, so chunks of no draws and draws at the chunks' edges get exercised
+        for (size_t threads_count : {1, 2, 4, 8})
+        {
+            for (size_t min_primitives : {1, 256})
+            {
+                WorkersPool workers_pool(threads_count);
+                std::vector<LightsChunk> chunks;
+                SplitChunks(scene, threads_count, min_primitives, 4, chunks);
+
+                LightsCombinations chunks_combinations;
+                std::vector<LightsIndicesRange> chunks_ranges;
+                double chunks_time = MeasureBestTime(3, [&]() {WriteByChunks(scene, workers_pool, chunks, chunks_combinations, chunks_ranges);});
+
+                CHECK(chunks_combinations.GetIndices() == serial_combinations.GetIndices());
+                CHECK(AreRangesByteIdentical(chunks_ranges, serial_ranges));
+
+                if (min_primitives == 256)
+                    printf("    %zu threads, %2zu chunks: %.3f ms\n", threads_count, chunks.size(), chunks_time * 1.e3);
+            }
+        }
+    }
+}
+
+int main()
+{
+    TestsRandom random(8);
+
+    CheckScene(CreateScene(random, 10, 16, 15.f), "Few draws");
+    CheckScene(CreateScene(random, 20000, 512, 100.f), "Many draws");
+
+    return GetChecksResult("DrawListChunksTest");
+}
@@ -0,0 +1,340 @@
+// RendererBase::UpdateDrawList's frames over Sponza like scenes with 1%, 10% and 100% of the entities moving, replicated with the engine's
+// DrawListKeys as the draw list needs Vulkan: moving keeps the keys, so only the first frame builds the draw list, steady frames only patch
+// the matrices' offsets and the lights ranges and write the same parameters as a draw list built at that frame. Hiding and showing rebuilds
+
+#include <cmath>
+#include <limits>
+#include <tuple>
+
+#include "TestsCommon.h"
+#include "ECS/ECStypes.h"
+#include "Geometry/SpheresBVH.h"
+#include "Graphics/DrawListKeys.h"
+#include "Graphics/LightsCombinations.h"
+#include "common/structs/PrimitiveInstanceParameters.h"
+
+namespace
+{
+    struct SceneMesh
+    {
+        std::vector<Paralgram> primitivesParalgrams;        // at the mesh's space
+        size_t firstPrimitiveIndex = 0;                     // of the scene's primitives, as PrimitivesOfMeshes' indices
+    };
+
+    struct SceneEntity
+    {
+        size_t meshIndex = 0;
+        size_t lightIndex = -1;
+        glm::vec3 position = glm::vec3(0.f);
+        bool isMoving = false;
+        bool shouldDraw = true;
+    };
+
+    struct DrawListScene
+    {
+        std::vector<SceneMesh> meshes;
+        std::vector<SceneEntity> entities;
+        SpheresBVH lightsBVH;
+    };
+
+    // As RendererBase::PrimitiveDraw, without the pipeline
+    struct PrimitiveDraw
+    {
+        size_t material = -1;
+        size_t meshIndex = -1;
+        size_t primitiveIndex = -1;
+        size_t drawInfoIndex = -1;
+    };
+
+    // The draw list that RendererBase retains between frames, with Lights.h's CollidedLightsChunk fields for a serial pass
+    struct DrawList
+    {
+        DrawListKeys keys;
+        std::vector<size_t> instanceOffsets;
+        std::vector<PrimitiveInstanceParameters> instanceParameters;
+        std::vector<PrimitiveDraw> sortedPrimitiveDraws;
+
+        LightsCombinations combinations;
+        std::vector<uint32_t> collidedLights;
+        std::vector<uint16_t> collidedLightsCombination;
+        std::vector<uint32_t> traversalStack;
+
+        size_t framesCount = 0;
+        size_t rebuildsCount = 0;
+    };
+
+    constexpr size_t materialsCount = 24;
+
+    // A hall of architecture meshes of 1 to 6 primitives instanced many times, props scattered in it, and light sources drawn by mesh 0
+    DrawListScene CreateScene(TestsRandom& random, size_t meshes_count, size_t entities_count, size_t lights_count, size_t moving_every)
+    {
+        // Sponza's floor plan for a thousand entities, more spread on the floor for more
+        float floor_scale = std::sqrt(float(entities_count) / 1000.f);
+        const glm::vec3 hall_half_extents = glm::vec3(30.f * floor_scale, 8.f, 15.f * floor_scale);
+
+        DrawListScene scene;
+        size_t primitives_count = 0;
+        for (size_t mesh_index = 0; mesh_index != meshes_count; ++mesh_index)
+        {
+            SceneMesh this_mesh;
+            this_mesh.firstPrimitiveIndex = primitives_count;
+
+            size_t mesh_primitives_count = mesh_index == 0 ? 1 : 1 + random.NextUint() % 6;
+            for (size_t i = 0; i != mesh_primitives_count; ++i)
+            {
+                glm::vec3 half_extents = mesh_index == 0 ? glm::vec3(0.2f) : random.NextVec3(0.1f, 2.f);
+                this_mesh.primitivesParalgrams.emplace_back(random.NextVec3(-1.f, 1.f),
+                                                            glm::vec3(half_extents.x, 0.f, 0.f),
+                                                            glm::vec3(0.f, half_extents.y, 0.f),
+                                                            glm::vec3(0.f, 0.f, half_extents.z));
+            }
+            primitives_count += mesh_primitives_count;
+
+            scene.meshes.emplace_back(std::move(this_mesh));
+        }
+
+        std::vector<Sphere> lights_spheres;
+        std::vector<uint32_t> lights_indices;
+        for (size_t entity_index = 0; entity_index != entities_count; ++entity_index)
+        {
+            SceneEntity this_entity;
+            this_entity.position = random.NextVec3(-1.f, 1.f) * hall_half_extents;
+            this_entity.isMoving = entity_index % moving_every == 0;
+            if (entity_index < lights_count)
+            {
+                this_entity.meshIndex = 0;
+                this_entity.lightIndex = entity_index;
+                lights_spheres.emplace_back(this_entity.position, random.NextFloat(3.f, 10.f));
+                lights_indices.emplace_back(uint32_t(entity_index));
+            }
+            else
+            {
+                this_entity.meshIndex = 1 + random.NextUint() % (meshes_count - 1);
+            }
+
+            scene.entities.emplace_back(this_entity);
+        }
+        scene.lightsBVH.Build(lights_spheres, lights_indices);
+
+        return scene;
+    }
+
+    glm::vec3 GetEntityPosition(const SceneEntity& entity, size_t entity_index, size_t frame_index)
+    {
+        if (not entity.isMoving)
+            return entity.position;
+
+        float phase = 0.05f * float(frame_index) + float(entity_index);
+        return entity.position + glm::vec3(std::sin(phase), 0.25f * std::cos(phase), 0.5f * std::sin(0.5f * phase));
+    }
+
+    // As ModelDrawComp::AddDrawInfos: every drawn entity emits its draw info and matrices, whose offsets move with what is drawn
+    void AddDrawInfos(const DrawListScene& scene, size_t frame_index, FrameDrawData& frame_draw_data)
+    {
+        frame_draw_data.Clear();
+        for (size_t entity_index = 0; entity_index != scene.entities.size(); ++entity_index)
+        {
+            const SceneEntity& this_entity = scene.entities[entity_index];
+            if (not this_entity.shouldDraw)
+                continue;
+
+            DrawInfo this_draw_info;
+            this_draw_info.meshIndex = this_entity.meshIndex;
+            this_draw_info.matricesOffset = frame_draw_data.matrices.size();
+            if (this_entity.lightIndex != size_t(-1))
+            {
+                this_draw_info.isLightSource = true;
+                this_draw_info.lightIndex = this_entity.lightIndex;
+            }
+            frame_draw_data.drawInfos.emplace_back(this_draw_info);
+
+            glm::mat4 position_matrix = CreateTranslationRotationMatrix(GetEntityPosition(this_entity, entity_index, frame_index));
+            frame_draw_data.matrices.emplace_back(ModelMatrices({position_matrix, position_matrix}));
+        }
+    }
+
+    // As RendererBase::RebuildDrawList, static parameters written from the primitives' indices
+    void RebuildDrawList(const DrawListScene& scene, const std::vector<DrawInfo>& draw_infos, DrawList& draw_list)
+    {
+        draw_list.keys.Assign(draw_infos);
+        draw_list.instanceOffsets.clear();
+        draw_list.instanceParameters.assign(1, PrimitiveInstanceParameters{});
+        draw_list.sortedPrimitiveDraws.clear();
+
+        for (size_t draw_index = 0; draw_index != draw_infos.size(); ++draw_index)
+        {
+            const DrawInfo& this_draw_info = draw_infos[draw_index];
+            const SceneMesh& this_mesh = scene.meshes[this_draw_info.meshIndex];
+
+            size_t instance_offset = draw_list.instanceParameters.size();
+            draw_list.instanceOffsets.emplace_back(instance_offset);
+            for (size_t i = 0; i != this_mesh.primitivesParalgrams.size(); ++i)
+            {
+                size_t primitive_index = this_mesh.firstPrimitiveIndex + i;
+
+                PrimitiveInstanceParameters this_parameters = {};
+                this_parameters.material = uint16_t(primitive_index % materialsCount);
+                this_parameters.indicesOffset = uint32_t(primitive_index * 3000);
+                this_parameters.positionOffset = uint32_t(primitive_index * 1000);
+                this_parameters.indicesSetMultiplier = 3;
+                draw_list.instanceParameters.emplace_back(this_parameters);
+
+                if (not this_draw_info.isLightSource)
+                    draw_list.sortedPrimitiveDraws.emplace_back(PrimitiveDraw{primitive_index % materialsCount, this_draw_info.meshIndex, primitive_index, draw_index});
+            }
+        }
+
+        std::sort(draw_list.sortedPrimitiveDraws.begin(), draw_list.sortedPrimitiveDraws.end(), [](const PrimitiveDraw& lhs, const PrimitiveDraw& rhs)
+        {
+            return std::tie(lhs.material, lhs.meshIndex, lhs.primitiveIndex, lhs.drawInfoIndex)
+                 < std::tie(rhs.material, rhs.meshIndex, rhs.primitiveIndex, rhs.drawInfoIndex);
+        });
+    }
+
+    // As RendererBase::UpdateDrawList at one chunk: rebuilt only when the keys changed, then every frame's fields patched
+    void UpdateDrawList(const DrawListScene& scene, FrameDrawData& frame_draw_data, DrawList& draw_list,
+                        std::vector<PrimitiveInstanceParameters>& primitive_instance_parameters)
+    {
+        ++draw_list.framesCount;
+        if (not draw_list.keys.AreOf(frame_draw_data.drawInfos))
+        {
+            RebuildDrawList(scene, frame_draw_data.drawInfos, draw_list);
+            ++draw_list.rebuildsCount;
+        }
+
+        primitive_instance_parameters.assign(draw_list.instanceParameters.begin(), draw_list.instanceParameters.end());
+
+        draw_list.combinations.Clear();
+        for (size_t draw_index = 0; draw_index != frame_draw_data.drawInfos.size(); ++draw_index)
+        {
+            DrawInfo& this_draw_info = frame_draw_data.drawInfos[draw_index];
+            this_draw_info.primitivesInstanceOffset = draw_list.instanceOffsets[draw_index];
+
+            const SceneMesh& this_mesh = scene.meshes[this_draw_info.meshIndex];
+            const glm::mat4& position_matrix = frame_draw_data.matrices[this_draw_info.matricesOffset].positionMatrix;
+            for (size_t i = 0; i != this_mesh.primitivesParalgrams.size(); ++i)
+            {
+                PrimitiveInstanceParameters& this_parameters = primitive_instance_parameters[this_draw_info.primitivesInstanceOffset + i];
+                this_parameters.matricesOffset = uint16_t(this_draw_info.matricesOffset);
+                this_parameters.prevMatricesOffset = uint16_t(this_draw_info.prevMatricesOffset);
+
+                if (this_draw_info.isLightSource)
+                {
+                    this_parameters.light = uint16_t(this_draw_info.lightIndex);
+                    this_parameters.lightsCombinationsOffset = 0;
+                    this_parameters.lightsCombinationsCount = 0;
+                    continue;
+                }
+
+                scene.lightsBVH.CollideParalgram(position_matrix * this_mesh.primitivesParalgrams[i], draw_list.collidedLights, draw_list.traversalStack);
+                draw_list.collidedLightsCombination.assign(draw_list.collidedLights.begin(), draw_list.collidedLights.end());
+
+                LightsIndicesRange lights_range;
+                if (draw_list.collidedLightsCombination.size())
+                    lights_range = draw_list.combinations.FindOrAddCombination(draw_list.collidedLightsCombination);
+
+                this_parameters.light = uint16_t(-1);
+                this_parameters.lightsCombinationsOffset = uint16_t(lights_range.offset);
+                this_parameters.lightsCombinationsCount = uint16_t(lights_range.size);
+            }
+        }
+    }
+
+    bool AreParametersIdentical(const std::vector<PrimitiveInstanceParameters>& lhs, const std::vector<PrimitiveInstanceParameters>& rhs)
+    {
+        auto get_fields = [](const PrimitiveInstanceParameters& parameters)
+        {
+            return std::tie(parameters.indicesOffset, parameters.positionOffset, parameters.normalOffset, parameters.tangentOffset,
+                            parameters.texcoordsOffset, parameters.colorOffset, parameters.light, parameters.matricesOffset,
+                            parameters.prevMatricesOffset, parameters.material, parameters.lightsCombinationsOffset, parameters.lightsCombinationsCount,
+                            parameters.positionDescriptorIndex, parameters.normalDescriptorIndex, parameters.tangentDescriptorIndex,
+                            parameters.texcoordsDescriptorIndex, parameters.colorDescriptorIndex, parameters.indicesSetMultiplier,
+                            parameters.texcoordsStepMultiplier, parameters.colorStepMultiplier);
+        };
+
+        return lhs.size() == rhs.size()
+            && std::equal(lhs.begin(), lhs.end(), rhs.begin(), [&get_fields](const auto& lhs_parameters, const auto& rhs_parameters)
+               {
+                   return get_fields(lhs_parameters) == get_fields(rhs_parameters);
+               });
+    }
+
+    // The retained draw list against one built at the same frame, the way the renderer would have drawn it without retaining
+    void CheckAgainstRebuilt(const DrawListScene& scene, size_t frame_index, const DrawList& draw_list,
+                             const std::vector<PrimitiveInstanceParameters>& primitive_instance_parameters)
+    {
+        FrameDrawData frame_draw_data;
+        AddDrawInfos(scene, frame_index, frame_draw_data);
+
+        DrawList rebuilt_draw_list;
+        std::vector<PrimitiveInstanceParameters> rebuilt_parameters;
+        UpdateDrawList(scene, frame_draw_data, rebuilt_draw_list, rebuilt_parameters);
+
+        CHECK(rebuilt_draw_list.rebuildsCount == 1);
+        CHECK(AreParametersIdentical(primitive_instance_parameters, rebuilt_parameters));
+        CHECK(draw_list.combinations.GetIndices() == rebuilt_draw_list.combinations.GetIndices());
+        CHECK(draw_list.sortedPrimitiveDraws.size() == rebuilt_draw_list.sortedPrimitiveDraws.size());
+    }
+
+    void BenchmarkScene(TestsRandom& random, size_t meshes_count, size_t entities_count, size_t lights_count, const char* scene_name)
+    {
+        constexpr size_t steady_frames_count = 60;
+
+        printf("%s: %zu meshes, %zu entities, %zu lights\n", scene_name, meshes_count, entities_count, lights_count);
+        for (size_t moving_every : {100, 10, 1})
+        {
+            DrawListScene scene = CreateScene(random, meshes_count, entities_count, lights_count, moving_every);
+
+            FrameDrawData frame_draw_data;
+            DrawList draw_list;
+            std::vector<PrimitiveInstanceParameters> primitive_instance_parameters;
+
+            size_t frame_index = 0;
+            auto draw_frame = [&]()
+            {
+                AddDrawInfos(scene, frame_index++, frame_draw_data);
+                UpdateDrawList(scene, frame_draw_data, draw_list, primitive_instance_parameters);
+            };
+
+            auto first_frame_start = std::chrono::steady_clock::now();
+            draw_frame();
+            double first_frame_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - first_frame_start).count();
+
+            double steady_frames_time = MeasureBestTime(1, [&]()
+            {
+                for (size_t i = 0; i != steady_frames_count; ++i)
+                    draw_frame();
+            });
+
+            // Of 16 bits at the instances' parameters
+            CHECK(draw_list.combinations.GetIndices().size() <= std::numeric_limits<uint16_t>::max());
+            CHECK(draw_list.framesCount == 1 + steady_frames_count);
+            CHECK(draw_list.rebuildsCount == 1);
+            CheckAgainstRebuilt(scene, frame_index - 1, draw_list, primitive_instance_parameters);
+
+            // Hiding an entity changes the keys once, showing it again once more
+            scene.entities[entities_count / 2].shouldDraw = false;
+            draw_frame();
+            draw_frame();
+            CHECK(draw_list.rebuildsCount == 2);
+            scene.entities[entities_count / 2].shouldDraw = true;
+            draw_frame();
+            CHECK(draw_list.rebuildsCount == 3);
+            CheckAgainstRebuilt(scene, frame_index - 1, draw_list, primitive_instance_parameters);
+
+            printf("    %3zu%% moving: %zu instances, %zu combinations indices | first frame %.3f ms, steady frame %.3f ms, %zu rebuilds at %zu frames\n",
+                   100 / moving_every, primitive_instance_parameters.size(), draw_list.combinations.GetIndices().size(),
+                   first_frame_time * 1.e3, steady_frames_time * 1.e3 / double(steady_frames_count), draw_list.rebuildsCount, draw_list.framesCount);
+        }
+    }
+}
+
+int main()
+{
+    TestsRandom random(22);
+
+    BenchmarkScene(random, 100, 1000, 32, "Sponza like");
+    BenchmarkScene(random, 400, 10000, 128, "Sponza like, crowded");
+
+    return GetChecksResult("DrawListUpdateBenchmark");
+}
@@ -0,0 +1,241 @@
+// Entity handles through ECSwrapper while instances, nested ones included, are added and removed at random for many
+// frames, so entities get recycled: handles of removed instances must never resolve, not even to the recycled entity.
+// Then a stress of millions of spawns and despawns with far more live entities than 16 bits count, and handles' lookup times
+
+#include <memory>
+#include <string>
+
+#include "TestsCommon.h"
+#include "ECS/ECSwrapper.h"
+
+namespace
+{
+    struct TrackedInstance
+    {
+        Entity rootEntity = 0;
+        size_t parentIndex = size_t(-1);        // of the tracked instance it is nested to
+        std::vector<EntityHandle> handles;      // of every entity of the instance
+        bool isAlive = true;
+    };
+
+    // Root with a child that has a child of its own, so an instance has three entities
+    std::unique_ptr<Node> CreateCrateFabNode()
+    {
+        auto crate_node_uptr = std::make_unique<Node>();
+        crate_node_uptr->nodeName = "Crate";
+
+        auto& lid_node_uptr = crate_node_uptr->children.emplace_back(std::make_unique<Node>());
+        lid_node_uptr->nodeName = "Lid";
+
+        auto& handle_node_uptr = lid_node_uptr->children.emplace_back(std::make_unique<Node>());
+        handle_node_uptr->nodeName = "Handle";
+
+        return crate_node_uptr;
+    }
+
+    size_t CheckHandles(const ECSwrapper& ecs_wrapper, const std::vector<TrackedInstance>& tracked_instances)
+    {
+        size_t recycled_handles_count = 0;
+        for (const TrackedInstance& this_instance : tracked_instances)
+        {
+            for (const EntityHandle& this_handle : this_instance.handles)
+            {
+                Entity resolved_entity = ecs_wrapper.ResolveEntityHandle(this_handle);
+                CHECK(resolved_entity == (this_instance.isAlive ? this_handle.entity : Entity(-1)));
+                CHECK(ecs_wrapper.GetEntitiesHandler()->IsEntityHandleValid(this_handle) == this_instance.isAlive);
+
+                // Stale handle whose entity belongs to another instance by now
+                if (not this_instance.isAlive && ecs_wrapper.GetEntitiesHandler()->GetInstanceInfo(this_handle.entity) != nullptr)
+                {
+                    CHECK(ecs_wrapper.GetEntityHandle(this_handle.entity) != this_handle);
+                    ++recycled_handles_count;
+                }
+            }
+        }
+
+        return recycled_handles_count;
+    }
+
+    // One frame of "live_count" single entity instances, more than 65535 pending additions at once, then rounds that
+    // despawn a random part and spawn as many, each round's stale handles checked against the entities that took their place
+    void StressRecycles(TestsRandom& random)
+    {
+        const size_t live_count = 200000;
+        const size_t churn_count = 25000;
+        const size_t rounds_count = 80;
+
+        auto mote_node_uptr = std::make_unique<Node>();
+        mote_node_uptr->nodeName = "Mote";
+
+        ECSwrapper ecs_wrapper(nullptr);
+        ecs_wrapper.AddFabs({mote_node_uptr.get()});
+        EntitiesHandler* entities_handler_ptr = ecs_wrapper.GetEntitiesHandler();
+
+        auto spawn = [&ecs_wrapper]()
+        {
+            Entity this_entity = ecs_wrapper.AddInstance("Mote")->instance_info_ptr->entityOffset;
+            return ecs_wrapper.GetEntityHandle(this_entity);
+        };
+
+        std::vector<EntityHandle> live_handles;
+        for (size_t i = 0; i != live_count; ++i)
+            live_handles.emplace_back(spawn());
+        ecs_wrapper.CompleteAddsAndRemoves();
+
+        size_t spawns_count = live_count;
+        size_t max_entity = 0;
+        size_t recycled_handles_count = 0;
+        std::vector<EntityHandle> stale_handles;
+        for (size_t round = 0; round != rounds_count; ++round)
+        {
+            stale_handles.clear();
+            for (size_t i = 0; i != churn_count; ++i)
+            {
+                size_t index = random.NextUint() % live_handles.size();
+                stale_handles.emplace_back(live_handles[index]);
+                ecs_wrapper.RemoveInstance(entities_handler_ptr->GetInstanceInfo(live_handles[index].entity));
+
+                live_handles[index] = live_handles.back();
+                live_handles.pop_back();
+            }
+            ecs_wrapper.CompleteAddsAndRemoves();
+
+            for (size_t i = 0; i != churn_count; ++i)
+                live_handles.emplace_back(spawn());
+            ecs_wrapper.CompleteAddsAndRemoves();
+            spawns_count += churn_count;
+
+            for (const EntityHandle& this_handle : stale_handles)
+            {
+                CHECK(ecs_wrapper.ResolveEntityHandle(this_handle) == Entity(-1));
+                if (entities_handler_ptr->GetInstanceInfo(this_handle.entity) != nullptr)
+                {
+                    CHECK(ecs_wrapper.GetEntityHandle(this_handle.entity).generation != this_handle.generation);
+                    ++recycled_handles_count;
+                }
+            }
+
+            // Completed additions are at the components' main container, none left as if pending or removed
+            size_t failed_count = 0;
+            for (const EntityHandle& this_handle : live_handles)
+            {
+                failed_count += ecs_wrapper.ResolveEntityHandle(this_handle) == this_handle.entity ? 0 : 1;
+                failed_count += entities_handler_ptr->GetContainerIndexOfEntity(this_handle.entity) == 0 ? 0 : 1;
+                max_entity = std::max(max_entity, size_t(this_handle.entity));
+            }
+            CHECK(failed_count == 0);
+        }
+
+        // Past 16 bits, and despawned entities got reused instead of growing the range
+        CHECK(max_entity > 65535);
+        CHECK(max_entity <= live_count);
+        CHECK(recycled_handles_count == rounds_count * churn_count);
+
+        // Lookups at random order, as game code resolving the handles it keeps
+        std::vector<EntityHandle> lookup_handles = live_handles;
+        lookup_handles.insert(lookup_handles.end(), stale_handles.begin(), stale_handles.end());
+        for (size_t i = lookup_handles.size() - 1; i != 0; --i)
+            std::swap(lookup_handles[i], lookup_handles[random.NextUint() % (i + 1)]);
+
+        size_t resolved_count = 0;
+        double lookups_time = MeasureBestTime(5, [&]()
+        {
+            resolved_count = 0;
+            for (const EntityHandle& this_handle : lookup_handles)
+                resolved_count += ecs_wrapper.ResolveEntityHandle(this_handle) != Entity(-1) ? 1 : 0;
+        });
+        CHECK(resolved_count == live_handles.size());
+
+        printf("Stress: %zu spawns and %zu despawns, %zu live, highest entity %zu, %.2f ns per handle lookup\n",
+               spawns_count, rounds_count * churn_count, live_handles.size(), max_entity,
+               lookups_time / double(lookup_handles.size()) * 1.e9);
+    }
+}
+
+int main()
+{
+    TestsRandom random(1);
+
+    std::unique_ptr<Node> crate_node_uptr = CreateCrateFabNode();
+
+    ECSwrapper ecs_wrapper(nullptr);
+    ecs_wrapper.AddFabs({crate_node_uptr.get()});
+
+    std::vector<TrackedInstance> tracked_instances;
+    std::vector<size_t> alive_indices;
+    size_t recycled_handles_count = 0;
+    size_t max_entity = 0;
+
+    for (size_t frame = 0; frame != 300; ++frame)
+    {
+        // Additions, some nested to the lid of an alive instance
+        size_t additions_count = random.NextUint() % 12;
+        for (size_t i = 0; i != additions_count; ++i)
+        {
+            TrackedInstance this_instance;
+            Entity parent = 0;
+            if (not alive_indices.empty() && random.NextUint() % 3 == 0)
+            {
+                this_instance.parentIndex = alive_indices[random.NextUint() % alive_indices.size()];
+                parent = tracked_instances[this_instance.parentIndex].rootEntity + 1;
+            }
+
+            AdditionInfo* addition_info_ptr = ecs_wrapper.AddInstance("Crate", parent);
+            this_instance.rootEntity = addition_info_ptr->instance_info_ptr->entityOffset;
+            for (Entity this_entity = this_instance.rootEntity; this_entity != this_instance.rootEntity + 3; ++this_entity)
+                this_instance.handles.emplace_back(ecs_wrapper.GetEntityHandle(this_entity));
+
+            max_entity = std::max(max_entity, size_t(this_instance.rootEntity + 2));
+            alive_indices.emplace_back(tracked_instances.size());
+            tracked_instances.emplace_back(std::move(this_instance));
+        }
+        ecs_wrapper.CompleteAddsAndRemoves();
+
+        // Removals, nested instances go with their parent
+        std::vector<size_t> previous_alive_indices = alive_indices;
+        size_t removals_count = alive_indices.empty() ? 0 : random.NextUint() % (alive_indices.size() / 2 + 2);
+        for (size_t i = 0; i != removals_count && not alive_indices.empty(); ++i)
+        {
+            size_t index = alive_indices[random.NextUint() % alive_indices.size()];
+            ecs_wrapper.RemoveInstance(ecs_wrapper.GetEntitiesHandler()->GetInstanceInfo(tracked_instances[index].rootEntity));
+
+            tracked_instances[index].isAlive = false;
+            bool has_removed_more = true;
+            while (has_removed_more)
+            {
+                has_removed_more = false;
+                for (TrackedInstance& this_instance : tracked_instances)
+                {
+                    if (this_instance.isAlive && this_instance.parentIndex != size_t(-1) && not tracked_instances[this_instance.parentIndex].isAlive)
+                    {
+                        this_instance.isAlive = false;
+                        has_removed_more = true;
+                    }
+                }
+            }
+
+            std::erase_if(alive_indices, [&](size_t alive_index) {return not tracked_instances[alive_index].isAlive;});
+        }
+
+        // Removals complete at CompleteAddsAndRemoves, until then the handles still resolve
+        for (size_t this_index : previous_alive_indices)
+            for (const EntityHandle& this_handle : tracked_instances[this_index].handles)
+                CHECK(ecs_wrapper.ResolveEntityHandle(this_handle) == this_handle.entity);
+
+        ecs_wrapper.CompleteAddsAndRemoves();
+
+        recycled_handles_count = CheckHandles(ecs_wrapper, tracked_instances);
+    }
+
+    // Entities got reused, and stale handles to them were told apart
+    CHECK(recycled_handles_count != 0);
+    CHECK(max_entity < 3 * tracked_instances.size());
+    CHECK(ecs_wrapper.ResolveEntityHandle(EntityHandle{}) == Entity(-1));
+
+    printf("%zu instances, %zu alive, highest entity %zu, %zu stale handles of recycled entities\n",
+           tracked_instances.size(), alive_indices.size(), max_entity, recycled_handles_count);
+
+    StressRecycles(random);
+
+    return GetChecksResult("EntityHandleTest");
+}
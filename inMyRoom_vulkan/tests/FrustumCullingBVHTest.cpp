@@ -0,0 +1,298 @@
+// FrustumCullingBVH::Cull against FrustumCulling::IsParalgramInsideFrustum of every instance, after Build and after moving
+// instances with SetInstance and Refit, and the instances per millisecond of both. CullingInstancesBVH, ModelDrawComp's cache of it,
+// built only when its instances' keys change: moving refits, a recycled entity or a changed mesh at the same matrix version builds again
+
+#include "TestsCommon.h"
+#include "Geometry/FrustumCulling.h"
+#include "Geometry/FrustumCullingBVH.h"
+#include "Graphics/CullingInstancesBVH.h"
+
+namespace
+{
+    // Normals point out of the frustum, as ViewportFrustum::GetWorldSpacePlanesOfFrustum's
+    std::array<Plane, 6> CreateFrustumPlanes(glm::vec3 eye, glm::vec3 forward, float half_fov_tan, float near_distance, float far_distance)
+    {
+        forward = glm::normalize(forward);
+        glm::vec3 right = glm::normalize(glm::cross(forward, glm::vec3(0.f, 1.f, 0.f)));
+        glm::vec3 up = glm::cross(right, forward);
+
+        auto create_plane = [&eye](glm::vec3 normal, float distance_from_eye)
+        {
+            normal = glm::normalize(normal);
+            return Plane(normal, -glm::dot(normal, eye) - distance_from_eye);
+        };
+
+        return {create_plane(-right - half_fov_tan * forward, 0.f),
+                create_plane(right - half_fov_tan * forward, 0.f),
+                create_plane(up - half_fov_tan * forward, 0.f),
+                create_plane(-up - half_fov_tan * forward, 0.f),
+                create_plane(-forward, -near_distance),
+                create_plane(forward, far_distance)};
+    }
+
+    Paralgram CreateBox(glm::vec3 center, glm::vec3 half_extents)
+    {
+        return Paralgram(center,
+                         glm::vec3(half_extents.x, 0.f, 0.f),
+                         glm::vec3(0.f, half_extents.y, 0.f),
+                         glm::vec3(0.f, 0.f, half_extents.z));
+    }
+
+    Paralgram CreateRandomBox(TestsRandom& random, float half_extent)
+    {
+        return CreateBox(random.NextVec3(-half_extent, half_extent), random.NextVec3(0.1f, 2.f));
+    }
+
+    std::vector<uint32_t> CullBruteForce(const std::vector<Paralgram>& boxes, const std::array<Plane, 6>& frustum_planes)
+    {
+        FrustumCulling frustum_culling;
+        frustum_culling.SetFrustumPlanes(frustum_planes);
+
+        std::vector<uint32_t> visible_instances;
+        for (size_t i = 0; i != boxes.size(); ++i)
+            if (frustum_culling.IsParalgramInsideFrustum(boxes[i]))
+                visible_instances.emplace_back(uint32_t(i));
+
+        return visible_instances;
+    }
+
+    struct CullStats
+    {
+        size_t instancesCount = 0;
+        size_t visibleCount = 0;
+        size_t mismatchesCount = 0;
+    };
+
+    void CompareCull(FrustumCullingBVH& bvh, const std::vector<Paralgram>& boxes, const std::array<Plane, 6>& frustum_planes, CullStats& stats)
+    {
+        std::vector<uint32_t> bvh_visible;
+        bvh.Cull(frustum_planes, bvh_visible);
+        std::vector<uint32_t> brute_force_visible = CullBruteForce(boxes, frustum_planes);
+
+        CHECK(std::is_sorted(bvh_visible.begin(), bvh_visible.end()));
+        CHECK(std::adjacent_find(bvh_visible.begin(), bvh_visible.end()) == bvh_visible.end());
+
+        // Counts instances in only one of the two, boxes that touch a plane may go either way with fused operations
+        std::vector<uint32_t> differences;
+        std::set_symmetric_difference(bvh_visible.begin(), bvh_visible.end(),
+                                      brute_force_visible.begin(), brute_force_visible.end(),
+                                      std::back_inserter(differences));
+
+        stats.instancesCount += boxes.size();
+        stats.visibleCount += brute_force_visible.size();
+        stats.mismatchesCount += differences.size();
+    }
+
+    void CheckCullStats(const CullStats& stats)
+    {
+#if !defined(__FMA__)
+        CHECK(stats.mismatchesCount == 0);
+#else
+        CHECK(stats.mismatchesCount * 1000 <= stats.instancesCount);
+#endif
+        CHECK(stats.visibleCount != 0);
+        CHECK(stats.visibleCount != stats.instancesCount);
+    }
+
+    std::array<Plane, 6> CreateRandomFrustumPlanes(TestsRandom& random, float half_extent)
+    {
+        return CreateFrustumPlanes(random.NextVec3(-half_extent, half_extent), random.NextDirection(),
+                                   random.NextFloat(0.2f, 1.5f), 0.1f, random.NextFloat(half_extent * 0.2f, half_extent * 2.f));
+    }
+
+    void CheckScenes(TestsRandom& random)
+    {
+        const float half_extent = 200.f;
+
+        // Counts not a multiple of the width, so leaves and levels have partial nodes
+        CullStats built_stats;
+        CullStats refitted_stats;
+        for (size_t instances_count : {1, 7, 100, 1000, 20001})
+        {
+            std::vector<Paralgram> boxes;
+            for (size_t i = 0; i != instances_count; ++i)
+                boxes.emplace_back(CreateRandomBox(random, half_extent));
+
+            FrustumCullingBVH bvh;
+            bvh.Build(boxes);
+            CHECK(bvh.GetInstancesCount() == instances_count);
+
+            for (size_t frustum = 0; frustum != 20; ++frustum)
+                CompareCull(bvh, boxes, CreateRandomFrustumPlanes(random, half_extent), built_stats);
+
+            // A tenth moves far, as instances animated after Build
+            for (size_t i = 0; i < instances_count; i += 10)
+            {
+                boxes[i] = CreateRandomBox(random, half_extent);
+                bvh.SetInstance(i, boxes[i]);
+            }
+            bvh.Refit();
+
+            for (size_t frustum = 0; frustum != 20; ++frustum)
+                CompareCull(bvh, boxes, CreateRandomFrustumPlanes(random, half_extent), refitted_stats);
+        }
+
+        CheckCullStats(built_stats);
+        CheckCullStats(refitted_stats);
+
+        printf("Built: %zu of %zu visible, %zu mismatches; refitted: %zu of %zu visible, %zu mismatches\n",
+               built_stats.visibleCount, built_stats.instancesCount, built_stats.mismatchesCount,
+               refitted_stats.visibleCount, refitted_stats.instancesCount, refitted_stats.mismatchesCount);
+    }
+
+    // As ModelDrawComp sees its drawn entities: the entity's handle, the mesh it draws and its node's matrix
+    struct CullingEntity
+    {
+        EntityHandle entityHandle;
+        size_t meshIndex = 0;
+        uint32_t matrixVersion = 1;
+        glm::vec3 position = glm::vec3(0.f);
+    };
+
+    // Meshes far apart at their own space, so drawing another mesh moves the world box
+    Paralgram GetEntityWorldBox(const CullingEntity& entity)
+    {
+        return CreateBox(entity.position + glm::vec3(100.f * float(entity.meshIndex), 0.f, 0.f), glm::vec3(0.5f + 0.25f * float(entity.meshIndex)));
+    }
+
+    bool IsEntityVisibleNearBy(CullingInstancesBVH& culling_bvh, size_t instance_index, const CullingEntity& entity)
+    {
+        glm::vec3 box_center = GetEntityWorldBox(entity).GetCenter();
+        std::vector<uint32_t> visible_instances;
+        culling_bvh.Cull(CreateFrustumPlanes(box_center - glm::vec3(0.f, 0.f, 5.f), glm::vec3(0.f, 0.f, 1.f), 0.2f, 0.1f, 10.f), visible_instances);
+
+        return std::binary_search(visible_instances.begin(), visible_instances.end(), uint32_t(instance_index));
+    }
+
+    void CheckCullingInstancesBVH(TestsRandom& random)
+    {
+        const float half_extent = 200.f;
+
+        std::vector<CullingEntity> entities;
+        for (size_t i = 0; i != 1000; ++i)
+            entities.emplace_back(CullingEntity{EntityHandle{Entity(i), 0}, i % 3, 1, random.NextVec3(-half_extent, half_extent)});
+
+        CullingInstancesBVH culling_bvh;
+        std::vector<CullingInstancesBVH::InstanceKey> instances_keys;
+        size_t paralgrams_asked_count = 0;
+        auto update = [&]()
+        {
+            instances_keys.clear();
+            for (const CullingEntity& this_entity : entities)
+                instances_keys.emplace_back(CullingInstancesBVH::InstanceKey{this_entity.entityHandle, this_entity.meshIndex});
+
+            paralgrams_asked_count = 0;
+            culling_bvh.Update(instances_keys,
+                               [&entities](size_t index) {return entities[index].matrixVersion;},
+                               [&entities, &paralgrams_asked_count](size_t index) {++paralgrams_asked_count; return GetEntityWorldBox(entities[index]);});
+        };
+
+        CullStats stats;
+        auto compare_cull = [&]()
+        {
+            std::vector<Paralgram> boxes;
+            for (const CullingEntity& this_entity : entities)
+                boxes.emplace_back(GetEntityWorldBox(this_entity));
+
+            for (size_t frustum = 0; frustum != 10; ++frustum)
+            {
+                std::array<Plane, 6> frustum_planes = CreateRandomFrustumPlanes(random, half_extent);
+
+                std::vector<uint32_t> visible_instances;
+                culling_bvh.Cull(frustum_planes, visible_instances);
+                std::vector<uint32_t> brute_force_visible = CullBruteForce(boxes, frustum_planes);
+
+                std::vector<uint32_t> differences;
+                std::set_symmetric_difference(visible_instances.begin(), visible_instances.end(),
+                                              brute_force_visible.begin(), brute_force_visible.end(),
+                                              std::back_inserter(differences));
+                stats.instancesCount += boxes.size();
+                stats.visibleCount += brute_force_visible.size();
+                stats.mismatchesCount += differences.size();
+            }
+        };
+
+        update();
+        compare_cull();
+        CHECK(culling_bvh.GetBuildsCount() == 1);
+        CHECK(paralgrams_asked_count == entities.size());
+
+        // Same frame again asks nothing, moving a tenth asks only them and refits
+        update();
+        CHECK(culling_bvh.GetBuildsCount() == 1);
+        CHECK(paralgrams_asked_count == 0);
+
+        for (size_t i = 0; i < entities.size(); i += 10)
+        {
+            entities[i].position = random.NextVec3(-half_extent, half_extent);
+            ++entities[i].matrixVersion;
+        }
+        update();
+        compare_cull();
+        CHECK(culling_bvh.GetBuildsCount() == 1);
+        CHECK(paralgrams_asked_count == entities.size() / 10);
+        CHECK(IsEntityVisibleNearBy(culling_bvh, 500, entities[500]));
+
+        // The entity got removed and its slot recycled by an entity elsewhere, whose matrix happens to be at the same version
+        entities[501].entityHandle.generation++;
+        entities[501].position = -entities[501].position + glm::vec3(7.f);
+        update();
+        compare_cull();
+        CHECK(culling_bvh.GetBuildsCount() == 2);
+        CHECK(IsEntityVisibleNearBy(culling_bvh, 501, entities[501]));
+
+        // Draws another mesh, its node unchanged
+        entities[502].meshIndex = (entities[502].meshIndex + 1) % 3;
+        update();
+        compare_cull();
+        CHECK(culling_bvh.GetBuildsCount() == 3);
+        CHECK(IsEntityVisibleNearBy(culling_bvh, 502, entities[502]));
+
+        CheckCullStats(stats);
+        printf("Culling instances BVH: %zu builds, %zu of %zu visible, %zu mismatches\n",
+               culling_bvh.GetBuildsCount(), stats.visibleCount, stats.instancesCount, stats.mismatchesCount);
+    }
+
+    void Benchmark(TestsRandom& random, size_t instances_count, float half_fov_tan)
+    {
+        const float half_extent = 500.f;
+
+        std::vector<Paralgram> boxes;
+        for (size_t i = 0; i != instances_count; ++i)
+            boxes.emplace_back(CreateRandomBox(random, half_extent));
+
+        FrustumCullingBVH bvh;
+        bvh.Build(boxes);
+
+        std::array<Plane, 6> frustum_planes = CreateFrustumPlanes(glm::vec3(0.f, 0.f, -half_extent), glm::vec3(0.f, 0.f, 1.f),
+                                                                  half_fov_tan, 0.1f, half_extent);
+
+        size_t visible_count = 0;
+        std::vector<uint32_t> bvh_visible;
+        double brute_force_time = MeasureBestTime(5, [&]() {visible_count = CullBruteForce(boxes, frustum_planes).size();});
+        double bvh_time = MeasureBestTime(5, [&]() {bvh.Cull(frustum_planes, bvh_visible);});
+        CHECK(visible_count != 0);
+
+        printf("%6zu instances, %4.1f%% visible: brute force %.1fk, BVH %.1fk instances/ms (width %zu)\n",
+               instances_count, double(visible_count) * 100. / double(instances_count),
+               double(instances_count) / (brute_force_time * 1.e3) / 1.e3,
+               double(instances_count) / (bvh_time * 1.e3) / 1.e3,
+               FrustumCullingBVH::width);
+    }
+}
+
+int main()
+{
+    TestsRandom random(7);
+
+    CheckScenes(random);
+    CheckCullingInstancesBVH(random);
+
+    for (size_t instances_count : {10000, 100000})
+    {
+        Benchmark(random, instances_count, 0.1f);
+        Benchmark(random, instances_count, 0.6f);
+    }
+
+    return GetChecksResult("FrustumCullingBVHTest");
+}
@@ -0,0 +1,132 @@
+#include "HeadlessCollisionScene.h"
+
+#include <algorithm>
+
+#include "ECS/ComponentsIDsEnum.h"
+
+class HeadlessCollisionScene::CollisionRecorderComp
+    :public ComponentBaseClass
+{
+public:
+    explicit CollisionRecorderComp(ECSwrapper* in_ecs_wrapper_ptr) : ComponentBaseClass(in_ecs_wrapper_ptr) {}
+
+    void CollisionCallback(const std::vector<std::pair<Entity, std::vector<CollisionCallbackData>>>& callback_entity_data_pairs) override
+    {
+        frameCallbacks = callback_entity_data_pairs;
+    }
+
+    componentID GetComponentID() const override {return static_cast<componentID>(componentIDenum::ModelDraw) + 1;}
+    std::string GetComponentName() const override {return "CollisionRecorder";}
+
+public:
+    std::vector<std::pair<Entity, std::vector<CollisionCallbackData>>> frameCallbacks;
+};
+
+HeadlessCollisionScene::HeadlessCollisionScene(configuru::Config& cfg_file, WorkersPool* workers_pool_ptr)
+{
+    ECSwrapper_uptr = std::make_unique<ECSwrapper>(nullptr);
+
+    collisionRecorderComp_uptr = std::make_unique<CollisionRecorderComp>(ECSwrapper_uptr.get());
+    ECSwrapper_uptr->AddComponent(collisionRecorderComp_uptr.get());
+
+    bodyFabNode_uptr = std::make_unique<Node>();
+    bodyFabNode_uptr->nodeName = "Body";
+    ECSwrapper_uptr->AddFabs({bodyFabNode_uptr.get()});
+
+    collisionDetection_uptr = std::make_unique<CollisionDetection>(ECSwrapper_uptr.get(), cfg_file, workers_pool_ptr);
+}
+
+HeadlessCollisionScene::~HeadlessCollisionScene()
+{
+    collisionDetection_uptr.reset();
+    ECSwrapper_uptr.reset();
+}
+
+size_t HeadlessCollisionScene::AddBody(const OBBtree* OBBtree_ptr, const glm::mat4& global_matrix, bool is_continuous)
+{
+    AdditionInfo* addition_info_ptr = ECSwrapper_uptr->AddInstance("Body");
+    Entity body_entity = addition_info_ptr->instance_info_ptr->entityOffset;
+    ECSwrapper_uptr->CompleteAddsAndRemoves();
+
+    Body& this_body = bodies.emplace_back();
+    this_body.OBBtree_ptr = OBBtree_ptr;
+    this_body.currentGlobalMatrix = global_matrix;
+    this_body.previousGlobalMatrix = global_matrix;
+    this_body.isContinuous = is_continuous;
+    this_body.entity = body_entity;
+
+    return bodies.size() - 1;
+}
+
+void HeadlessCollisionScene::SetBodyMatrix(size_t body_index, const glm::mat4& global_matrix)
+{
+    bodies[body_index].currentGlobalMatrix = global_matrix;
+}
+
+Entity HeadlessCollisionScene::GetBodyEntity(size_t body_index) const
+{
+    return bodies[body_index].entity;
+}
+
+void HeadlessCollisionScene::ExecuteFrame()
+{
+    collisionRecorderComp_uptr->frameCallbacks.clear();
+
+    collisionDetection_uptr->Reset();
+    for (Body& this_body : bodies)
+    {
+        bool has_moved = this_body.currentGlobalMatrix != this_body.previousGlobalMatrix;
+
+        CollisionDetectionEntry this_collisionDetectionEntry;
+        this_collisionDetectionEntry.currentGlobalMatrix = this_body.currentGlobalMatrix;
+        this_collisionDetectionEntry.previousGlobalMatrix = this_body.previousGlobalMatrix;
+        this_collisionDetectionEntry.OBBtree_ptr = this_body.OBBtree_ptr;
+        this_collisionDetectionEntry.shouldCallback = true;
+        this_collisionDetectionEntry.isStatic = not has_moved && not this_body.hasMovedLastFrame;
+        this_collisionDetectionEntry.isContinuous = this_body.isContinuous;
+        this_collisionDetectionEntry.entity = this_body.entity;
+
+        collisionDetection_uptr->AddCollisionDetectionEntry(this_collisionDetectionEntry);
+
+        this_body.hasMovedLastFrame = has_moved;
+    }
+
+    collisionDetection_uptr->ExecuteCollisionDetection();
+
+    // Late matrices of the engine, at the next frame they are the previous ones
+    for (Body& this_body : bodies)
+        this_body.previousGlobalMatrix = this_body.currentGlobalMatrix;
+}
+
+const std::vector<std::pair<Entity, std::vector<CollisionCallbackData>>>& HeadlessCollisionScene::GetFrameCallbacks() const
+{
+    return collisionRecorderComp_uptr->frameCallbacks;
+}
+
+const std::vector<CollisionCallbackData>* HeadlessCollisionScene::GetBodyCallbacks(size_t body_index) const
+{
+    const auto& frame_callbacks = collisionRecorderComp_uptr->frameCallbacks;
+    auto search = std::find_if(frame_callbacks.begin(), frame_callbacks.end(),
+                               [this_entity = bodies[body_index].entity](const auto& this_entity_data_pair) {return this_entity_data_pair.first == this_entity;});
+
+    return search != frame_callbacks.end() ? &search->second : nullptr;
+}
+
+const CollisionDetection::FrameStats& HeadlessCollisionScene::GetFrameStats() const
+{
+    return collisionDetection_uptr->GetFrameStats();
+}
+
+CollisionPairCache::Stats HeadlessCollisionScene::GetPairCacheStats() const
+{
+    return collisionDetection_uptr->GetPairCacheStats();
+}
+
+configuru::Config HeadlessCollisionScene::CreateDefaultCollisionConfig()
+{
+    return configuru::Config::object({{"collisionSettings", configuru::Config::object({{"broadPhase", "SweepAndPrune"},
+                                                                                      {"pairCache", true},
+                                                                                      {"pairCacheRevalidateMovement", 0.f},
+                                                                                      {"continuousCollision", true},
+                                                                                      {"continuousCollisionMinMovement", 0.5f}})}});
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "configuru.hpp"
+
+#include "ECS/ECSwrapper.h"
+#include "CollisionDetection/CollisionDetection.h"
+#include "Geometry/OBBtree.h"
+
+class WorkersPool;
+
+// Collision detection over scripted bodies, the way ModelCollisionComp feeds it but without renderer, meshes or game.
+// Every body is an instance of its own, callbacks of a frame are kept until the next one
+class HeadlessCollisionScene
+{
+public:
+    HeadlessCollisionScene(configuru::Config& cfg_file, WorkersPool* workers_pool_ptr = nullptr);
+    ~HeadlessCollisionScene();
+
+    // Returns the body's index
+    size_t AddBody(const OBBtree* OBBtree_ptr, const glm::mat4& global_matrix, bool is_continuous = false);
+    void SetBodyMatrix(size_t body_index, const glm::mat4& global_matrix);
+    Entity GetBodyEntity(size_t body_index) const;
+
+    void ExecuteFrame();
+
+    const std::vector<std::pair<Entity, std::vector<CollisionCallbackData>>>& GetFrameCallbacks() const;
+    // Callbacks data of the body's entity, nullptr if it has none this frame
+    const std::vector<CollisionCallbackData>* GetBodyCallbacks(size_t body_index) const;
+
+    const CollisionDetection::FrameStats& GetFrameStats() const;
+    CollisionPairCache::Stats GetPairCacheStats() const;
+
+    // The "collisionSettings" that CollisionDetection reads, same values as the shipped config.cfg
+    static configuru::Config CreateDefaultCollisionConfig();
+
+private:
+    struct Body
+    {
+        const OBBtree* OBBtree_ptr = nullptr;
+        glm::mat4 currentGlobalMatrix = glm::mat4(1.f);
+        glm::mat4 previousGlobalMatrix = glm::mat4(1.f);
+        bool hasMovedLastFrame = true;
+        bool isContinuous = false;
+        Entity entity = 0;
+    };
+
+    class CollisionRecorderComp;
+
+private:
+    std::vector<Body> bodies;
+    std::unique_ptr<Node> bodyFabNode_uptr;
+
+    std::unique_ptr<ECSwrapper> ECSwrapper_uptr;
+    std::unique_ptr<CollisionRecorderComp> collisionRecorderComp_uptr;
+    std::unique_ptr<CollisionDetection> collisionDetection_uptr;
+};
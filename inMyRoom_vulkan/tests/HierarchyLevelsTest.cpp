@@ -0,0 +1,158 @@
+// HierarchyLevels kept incrementally while nested instances are added and removed at random, against one rebuilt from
+// scratch every frame: same levels, at entity order, with every parent at the level before
+
+#include <memory>
+
+#include "TestsCommon.h"
+#include "ECS/ECSwrapper.h"
+#include "ECS/HierarchyLevels.h"
+
+namespace
+{
+    struct TrackedInstance
+    {
+        Entity rootEntity = 0;
+        size_t parentIndex = size_t(-1);        // of the tracked instance it is nested to
+        bool isAlive = true;
+    };
+
+    // Root with a child that has a child of its own, so an instance spans three levels
+    std::unique_ptr<Node> CreateCrateFabNode()
+    {
+        auto crate_node_uptr = std::make_unique<Node>();
+        crate_node_uptr->nodeName = "Crate";
+
+        auto& lid_node_uptr = crate_node_uptr->children.emplace_back(std::make_unique<Node>());
+        lid_node_uptr->nodeName = "Lid";
+
+        auto& handle_node_uptr = lid_node_uptr->children.emplace_back(std::make_unique<Node>());
+        handle_node_uptr->nodeName = "Handle";
+
+        return crate_node_uptr;
+    }
+
+    void CheckLevels(const HierarchyLevels& hierarchy_levels, const HierarchyLevels& rebuilt_levels, const EntitiesHandler* entities_handler_ptr)
+    {
+        CHECK(hierarchy_levels.GetLevelsCount() == rebuilt_levels.GetLevelsCount());
+        for (size_t level = 0; level != std::min(hierarchy_levels.GetLevelsCount(), rebuilt_levels.GetLevelsCount()); ++level)
+        {
+            const std::vector<HierarchyLevels::LevelEntry>& this_level = hierarchy_levels.GetLevel(level);
+            const std::vector<HierarchyLevels::LevelEntry>& rebuilt_level = rebuilt_levels.GetLevel(level);
+
+            CHECK(this_level.size() == rebuilt_level.size());
+            for (size_t i = 0; i != std::min(this_level.size(), rebuilt_level.size()); ++i)
+            {
+                CHECK(this_level[i].entity == rebuilt_level[i].entity);
+                CHECK(this_level[i].parent == entities_handler_ptr->GetParentOfEntity(this_level[i].entity));
+                if (i != 0)
+                    CHECK(this_level[i - 1].entity < this_level[i].entity);
+
+                if (level == 0)
+                {
+                    CHECK(this_level[i].parent == 0);
+                }
+                else
+                {
+                    const std::vector<HierarchyLevels::LevelEntry>& previous_level = hierarchy_levels.GetLevel(level - 1);
+                    auto by_entity = [](const HierarchyLevels::LevelEntry& lhs, const HierarchyLevels::LevelEntry& rhs) {return lhs.entity < rhs.entity;};
+                    CHECK(std::binary_search(previous_level.begin(), previous_level.end(), HierarchyLevels::LevelEntry{this_level[i].parent, 0}, by_entity));
+                }
+            }
+        }
+    }
+}
+
+int main()
+{
+    TestsRandom random(4);
+
+    std::unique_ptr<Node> crate_node_uptr = CreateCrateFabNode();
+
+    ECSwrapper ecs_wrapper(nullptr);
+    ecs_wrapper.AddFabs({crate_node_uptr.get()});
+    const EntitiesHandler* entities_handler_ptr = ecs_wrapper.GetEntitiesHandler();
+
+    HierarchyLevels hierarchy_levels(entities_handler_ptr);
+
+    std::vector<TrackedInstance> tracked_instances;
+    std::vector<size_t> alive_indices;
+    size_t max_levels_count = 0;
+
+    for (size_t frame = 0; frame != 300; ++frame)
+    {
+        // Additions, some nested to the lid of an alive instance
+        std::vector<Entity> added_entities;
+        size_t additions_count = random.NextUint() % 12;
+        for (size_t i = 0; i != additions_count; ++i)
+        {
+            TrackedInstance this_instance;
+            Entity parent = 0;
+            if (not alive_indices.empty() && random.NextUint() % 2 == 0)
+            {
+                this_instance.parentIndex = alive_indices[random.NextUint() % alive_indices.size()];
+                parent = tracked_instances[this_instance.parentIndex].rootEntity + 1;
+            }
+
+            AdditionInfo* addition_info_ptr = ecs_wrapper.AddInstance("Crate", parent);
+            this_instance.rootEntity = addition_info_ptr->instance_info_ptr->entityOffset;
+            for (Entity this_entity = this_instance.rootEntity; this_entity != this_instance.rootEntity + 3; ++this_entity)
+                added_entities.emplace_back(this_entity);
+
+            alive_indices.emplace_back(tracked_instances.size());
+            tracked_instances.emplace_back(this_instance);
+        }
+        ecs_wrapper.CompleteAddsAndRemoves();
+        hierarchy_levels.AddEntities(added_entities);
+
+        // Removals, nested instances go with their parent
+        std::vector<std::pair<Entity, Entity>> removed_ranges;
+        size_t removals_count = alive_indices.empty() ? 0 : random.NextUint() % (alive_indices.size() / 2 + 2);
+        for (size_t i = 0; i != removals_count && not alive_indices.empty(); ++i)
+        {
+            size_t index = alive_indices[random.NextUint() % alive_indices.size()];
+            ecs_wrapper.RemoveInstance(ecs_wrapper.GetEntitiesHandler()->GetInstanceInfo(tracked_instances[index].rootEntity));
+
+            tracked_instances[index].isAlive = false;
+            bool has_removed_more = true;
+            while (has_removed_more)
+            {
+                has_removed_more = false;
+                for (TrackedInstance& this_instance : tracked_instances)
+                {
+                    if (this_instance.isAlive && this_instance.parentIndex != size_t(-1) && not tracked_instances[this_instance.parentIndex].isAlive)
+                    {
+                        this_instance.isAlive = false;
+                        has_removed_more = true;
+                    }
+                }
+            }
+
+            for (size_t alive_index : alive_indices)
+                if (not tracked_instances[alive_index].isAlive)
+                    removed_ranges.emplace_back(tracked_instances[alive_index].rootEntity, tracked_instances[alive_index].rootEntity + 2);
+
+            std::erase_if(alive_indices, [&](size_t alive_index) {return not tracked_instances[alive_index].isAlive;});
+        }
+        hierarchy_levels.RemoveEntitiesByRanges(removed_ranges);
+        ecs_wrapper.CompleteAddsAndRemoves();
+
+        // From scratch, the way the global matrices rebuild them after a parent change
+        std::vector<Entity> alive_entities;
+        for (size_t alive_index : alive_indices)
+            for (Entity this_entity = tracked_instances[alive_index].rootEntity; this_entity != tracked_instances[alive_index].rootEntity + 3; ++this_entity)
+                alive_entities.emplace_back(this_entity);
+
+        HierarchyLevels rebuilt_levels(entities_handler_ptr);
+        rebuilt_levels.AddEntities(alive_entities);
+
+        CheckLevels(hierarchy_levels, rebuilt_levels, entities_handler_ptr);
+        max_levels_count = std::max(max_levels_count, hierarchy_levels.GetLevelsCount());
+    }
+
+    // Deep enough that levels got nested instances of recycled entities
+    CHECK(max_levels_count > 4);
+
+    printf("%zu instances, %zu alive, up to %zu levels\n", tracked_instances.size(), alive_indices.size(), max_levels_count);
+
+    return GetChecksResult("HierarchyLevelsTest");
+}
@@ -0,0 +1,365 @@
+// MultiplyMat4 against glm's product, and LateNodeGlobalMatrixComp's propagation against the chain of glm products it
+// replaced, at deep (long chains) and wide (many children of a root) hierarchies, with times of both.
+// Then partial changes and reparenting, where only the nodes below a change may be recalculated
+
+#include <memory>
+#include <string>
+
+#include "TestsCommon.h"
+#include "ECS/ECSwrapper.h"
+#include "ECS/ComponentsIDsEnum.h"
+#include "ECS/GeneralComponents/NodeDataComp.h"
+#include "ECS/GeneralComponents/LateNodeGlobalMatrixComp.h"
+#include "Geometry/FloatLanes.h"
+
+namespace
+{
+    glm::mat4 CreateRandomMatrix(TestsRandom& random)
+    {
+        glm::mat4 matrix;
+        for (int column = 0; column != 4; ++column)
+            for (int row = 0; row != 4; ++row)
+                matrix[column][row] = random.NextFloat(-2.f, 2.f);
+
+        return matrix;
+    }
+
+    // NodeDataCompEntity::GetGlobalMatrix before it composed T * R * S in place and went through MultiplyMat4
+    glm::mat4 GetGlobalMatrixByGlm(const NodeDataCompEntity& node_data, const glm::mat4& parent_global_matrix)
+    {
+        glm::mat4 S_matrix = glm::scale(glm::mat4(1.0f), node_data.localScale);
+        glm::mat4 R_matrix = glm::toMat4(node_data.localRotation);
+        glm::mat4 T_matrix = glm::translate(glm::mat4(1.0f), node_data.localTranslation);
+        glm::mat4 gT_matrix = glm::translate(glm::mat4(1.0f), node_data.globalTranslation);
+
+        return gT_matrix * parent_global_matrix * T_matrix * R_matrix * S_matrix;
+    }
+
+    bool AreMatricesClose(const glm::mat4& lhs, const glm::mat4& rhs)
+    {
+        for (int column = 0; column != 4; ++column)
+            for (int row = 0; row != 4; ++row)
+                if (std::abs(lhs[column][row] - rhs[column][row]) > 1.e-4f * (1.f + std::abs(rhs[column][row])))
+                    return false;
+
+        return true;
+    }
+
+    void CheckMultiplyMat4(TestsRandom& random)
+    {
+        const size_t products_count = 10000;
+        size_t mismatches_count = 0;
+        for (size_t i = 0; i != products_count; ++i)
+        {
+            glm::mat4 lhs = CreateRandomMatrix(random);
+            glm::mat4 rhs = CreateRandomMatrix(random);
+
+            CHECK(AreMatricesClose(MultiplyMat4(lhs, rhs), lhs * rhs));
+            mismatches_count += MultiplyMat4(lhs, rhs) == lhs * rhs ? 0 : 1;
+        }
+
+        // Same sums at the same order. With FMA the compiler may fuse glm's and not the lanes', so only close there
+#if !defined(__FMA__)
+        CHECK(mismatches_count == 0);
+#endif
+        printf("MultiplyMat4: %zu of %zu products off glm's\n", mismatches_count, products_count);
+    }
+
+    void BenchmarkProducts(TestsRandom& random)
+    {
+        const size_t matrices_count = 4096;
+        std::vector<glm::mat4> matrices;
+        for (size_t i = 0; i != matrices_count; ++i)
+            matrices.emplace_back(CreateRandomMatrix(random));
+
+        std::vector<NodeDataCompEntity> nodes_data;
+        for (size_t i = 0; i != matrices_count; ++i)
+        {
+            NodeDataCompEntity this_node_data(Entity(i + 1));
+            this_node_data.localScale = random.NextVec3(0.5f, 2.f);
+            this_node_data.localRotation = glm::normalize(glm::qua<float>(random.NextFloat(-1.f, 1.f), random.NextDirection()));
+            this_node_data.localTranslation = random.NextVec3(-5.f, 5.f);
+            nodes_data.emplace_back(this_node_data);
+        }
+
+        glm::mat4 sink(0.f);
+        auto measure_ns = [&](auto&& func)
+        {
+            double best_time = MeasureBestTime(20, [&]()
+            {
+                for (size_t i = 0; i != matrices_count; ++i)
+                {
+                    glm::mat4 this_matrix = func(i);
+                    for (int column = 0; column != 4; ++column)
+                        sink[column] += this_matrix[column];
+                }
+            });
+            return best_time / double(matrices_count) * 1.e9;
+        };
+
+        double glm_product_ns = measure_ns([&](size_t i) {return matrices[i] * matrices[(i + 1) % matrices_count];});
+        double lanes_product_ns = measure_ns([&](size_t i) {return MultiplyMat4(matrices[i], matrices[(i + 1) % matrices_count]);});
+        double glm_global_ns = measure_ns([&](size_t i) {return GetGlobalMatrixByGlm(nodes_data[i], matrices[i]);});
+        double lanes_global_ns = measure_ns([&](size_t i) {return nodes_data[i].GetGlobalMatrix(matrices[i]);});
+
+        // Printing the sink keeps -ffast-math from dropping the measured loops
+        printf("mat4 product: glm %.2f, MultiplyMat4 %.2f ns; global matrix: glm chain %.2f, GetGlobalMatrix %.2f ns (sink %g)\n",
+               glm_product_ns, lanes_product_ns, glm_global_ns, lanes_global_ns, double(sink[3][3]));
+    }
+
+    // Random local transforms, small enough scales that a long chain stays in float's comfort
+    std::unique_ptr<Node> CreateTransformNode(TestsRandom& random, const std::string& node_name)
+    {
+        auto node_uptr = std::make_unique<Node>();
+        node_uptr->nodeName = node_name;
+
+        glm::vec3 axis = random.NextDirection();
+        float half_angle = random.NextFloat(-1.5f, 1.5f);
+        CompEntityInitMap node_data_map;
+        node_data_map.vec4Map["LocalScale"] = glm::vec4(random.NextVec3(0.95f, 1.05f), 0.f);
+        node_data_map.vec4Map["LocalRotation"] = glm::vec4(axis * std::sin(half_angle), std::cos(half_angle));
+        node_data_map.vec4Map["LocalTranslation"] = glm::vec4(random.NextVec3(-1.f, 1.f), 0.f);
+
+        node_uptr->componentIDsToInitMaps.emplace(static_cast<componentID>(componentIDenum::NodeData), node_data_map);
+        node_uptr->componentIDsToInitMaps.emplace(static_cast<componentID>(componentIDenum::LateNodeGlobalMatrix), CompEntityInitMap());
+
+        return node_uptr;
+    }
+
+    std::unique_ptr<Node> CreateChainFabNode(TestsRandom& random, size_t depth)
+    {
+        std::unique_ptr<Node> root_node_uptr = CreateTransformNode(random, "Chain");
+        Node* last_node_ptr = root_node_uptr.get();
+        for (size_t i = 1; i != depth; ++i)
+            last_node_ptr = last_node_ptr->children.emplace_back(CreateTransformNode(random, "Link" + std::to_string(i))).get();
+
+        return root_node_uptr;
+    }
+
+    std::unique_ptr<Node> CreateWideFabNode(TestsRandom& random, size_t children_count)
+    {
+        std::unique_ptr<Node> root_node_uptr = CreateTransformNode(random, "Wide");
+        for (size_t i = 0; i != children_count; ++i)
+            root_node_uptr->children.emplace_back(CreateTransformNode(random, "Child" + std::to_string(i)));
+
+        return root_node_uptr;
+    }
+
+    // Instances of a fab with NodeData and LateNodeGlobalMatrix, added at once so their entities are consecutive
+    struct NodesScene
+    {
+        NodesScene(Node* fab_node_ptr, size_t instances_count)
+        {
+            auto node_data_comp_uptr = std::make_unique<NodeDataComp>(&ecsWrapper);
+            nodeDataComp_ptr = node_data_comp_uptr.get();
+            ecsWrapper.AddComponentAndOwnership(std::move(node_data_comp_uptr));
+            auto global_matrix_comp_uptr = std::make_unique<LateNodeGlobalMatrixComp>(&ecsWrapper);
+            globalMatrixComp_ptr = global_matrix_comp_uptr.get();
+            ecsWrapper.AddComponentAndOwnership(std::move(global_matrix_comp_uptr));
+
+            ecsWrapper.AddFabs({fab_node_ptr});
+            for (size_t i = 0; i != instances_count; ++i)
+                rootEntities.emplace_back(ecsWrapper.AddInstance(fab_node_ptr->nodeName)->instance_info_ptr->entityOffset);
+            ecsWrapper.CompleteAddsAndRemoves();
+
+            entitiesPerInstance = Entity(ecsWrapper.GetFabInfo(fab_node_ptr->nodeName)->size);
+        }
+
+        size_t GetEntitiesCount() const
+        {
+            return size_t(entitiesPerInstance) * rootEntities.size();
+        }
+
+        size_t GetEntitiesEnd() const
+        {
+            return size_t(rootEntities.back() + entitiesPerInstance);
+        }
+
+        // Calls func(entity, parent) once for every entity, after its parent's call whatever the order of their entities
+        template<typename Func>
+        void ForEachParentFirst(Func&& func) const
+        {
+            const EntitiesHandler* entities_handler_ptr = ecsWrapper.GetEntitiesHandler();
+
+            std::vector<uint8_t> is_visited(GetEntitiesEnd(), 0);
+            std::vector<Entity> unvisited_ancestors;
+            for (Entity this_root : rootEntities)
+            {
+                for (Entity this_entity = this_root; this_entity != this_root + entitiesPerInstance; ++this_entity)
+                {
+                    for (Entity ancestor = this_entity; ancestor != 0 && not is_visited[ancestor]; ancestor = entities_handler_ptr->GetParentOfEntity(ancestor))
+                        unvisited_ancestors.emplace_back(ancestor);
+
+                    for (; not unvisited_ancestors.empty(); unvisited_ancestors.pop_back())
+                    {
+                        func(unvisited_ancestors.back(), entities_handler_ptr->GetParentOfEntity(unvisited_ancestors.back()));
+                        is_visited[unvisited_ancestors.back()] = 1;
+                    }
+                }
+            }
+        }
+
+        // Every global matrix against the glm chain recalculated from scratch, returns how many are off
+        size_t CountMismatchesOfFullRecalculation() const
+        {
+            size_t mismatches_count = 0;
+            std::vector<glm::mat4> reference_matrices(GetEntitiesEnd());
+            ForEachParentFirst([&](Entity entity, Entity parent_entity)
+            {
+                glm::mat4 parent_matrix = parent_entity != 0 ? reference_matrices[parent_entity] : glm::mat4(1.f);
+                reference_matrices[entity] = GetGlobalMatrixByGlm(nodeDataComp_ptr->GetComponentEntity(entity), parent_matrix);
+
+                const glm::mat4& global_matrix = globalMatrixComp_ptr->GetComponentEntity(entity).globalMatrix;
+                mismatches_count += AreMatricesClose(global_matrix, reference_matrices[entity]) ? 0 : 1;
+            });
+
+            return mismatches_count;
+        }
+
+        ECSwrapper ecsWrapper = ECSwrapper(nullptr);
+        NodeDataComp* nodeDataComp_ptr = nullptr;
+        LateNodeGlobalMatrixComp* globalMatrixComp_ptr = nullptr;
+
+        std::vector<Entity> rootEntities;
+        Entity entitiesPerInstance = 0;
+    };
+
+    // Every frame moves the roots, so every matrix gets recalculated
+    void RunScene(TestsRandom& random, const char* scene_name, std::unique_ptr<Node> fab_node_uptr, size_t instances_count)
+    {
+        NodesScene scene(fab_node_uptr.get(), instances_count);
+
+        auto move_roots = [&]()
+        {
+            for (Entity this_root : scene.rootEntities)
+                scene.nodeDataComp_ptr->GetComponentEntity(this_root).LocalTranslate(random.NextVec3(-0.1f, 0.1f));
+        };
+
+        size_t mismatches_count = 0;
+        for (size_t frame = 0; frame != 4; ++frame)
+        {
+            move_roots();
+            scene.ecsWrapper.Update();
+            CHECK(scene.globalMatrixComp_ptr->GetCleanEntitiesCount() == 0);
+
+            mismatches_count += scene.CountMismatchesOfFullRecalculation();
+        }
+        CHECK(mismatches_count == 0);
+
+        double frame_time = MeasureBestTime(20, [&]()
+        {
+            move_roots();
+            scene.ecsWrapper.Update();
+        });
+
+        printf("%s: %zu entities, %.3f ms per frame, %.2f ns per matrix, %zu of %zu matrices off glm's\n",
+               scene_name, scene.GetEntitiesCount(), frame_time * 1.e3,
+               frame_time / double(scene.GetEntitiesCount()) * 1.e9, mismatches_count, 4 * scene.GetEntitiesCount());
+    }
+
+    // Clean nodes next to dirty ones: frames move a tenth of the roots and one inner link, and hang a top instance under a
+    // link of another, every fourth frame nothing changes. Only the subtrees under a change may be recalculated, and every
+    // matrix must still be what a full recalculation gives
+    void RunPartialScene(TestsRandom& random, std::unique_ptr<Node> fab_node_uptr, size_t instances_count)
+    {
+        NodesScene scene(fab_node_uptr.get(), instances_count);
+        EntitiesHandler* entities_handler_ptr = scene.ecsWrapper.GetEntitiesHandler();
+
+        scene.ecsWrapper.Update();
+        CHECK(scene.globalMatrixComp_ptr->GetDirtyEntitiesCount() == scene.GetEntitiesCount());
+
+        std::vector<uint8_t> is_changed;
+        auto change_entities = [&](bool should_reparent)
+        {
+            is_changed.assign(scene.GetEntitiesEnd(), 0);
+
+            for (Entity this_root : scene.rootEntities)
+            {
+                if (random.NextUint() % 10 == 0)
+                {
+                    scene.nodeDataComp_ptr->GetComponentEntity(this_root).LocalTranslate(random.NextVec3(-0.1f, 0.1f));
+                    is_changed[this_root] = 1;
+                }
+            }
+
+            Entity inner_entity = scene.rootEntities[random.NextUint() % instances_count] + 1 + random.NextUint() % (scene.entitiesPerInstance - 1);
+            scene.nodeDataComp_ptr->GetComponentEntity(inner_entity).LocalTranslate(random.NextVec3(-0.1f, 0.1f));
+            is_changed[inner_entity] = 1;
+
+            // Both at the top, so the new parent can't be below the moved instance
+            std::vector<Entity> top_roots;
+            for (Entity this_root : scene.rootEntities)
+                if (entities_handler_ptr->GetParentOfEntity(this_root) == 0)
+                    top_roots.emplace_back(this_root);
+
+            if (should_reparent && top_roots.size() > 1)
+            {
+                size_t moved_index = random.NextUint() % top_roots.size();
+                size_t parent_index = (moved_index + 1 + random.NextUint() % (top_roots.size() - 1)) % top_roots.size();
+                Entity new_parent = top_roots[parent_index] + random.NextUint() % scene.entitiesPerInstance;
+
+                entities_handler_ptr->ChangeParentOfInstance(entities_handler_ptr->GetInstanceInfo(top_roots[moved_index]), new_parent);
+                is_changed[top_roots[moved_index]] = 1;
+            }
+        };
+
+        auto count_expected_dirty = [&]()
+        {
+            std::vector<uint8_t> is_dirty(scene.GetEntitiesEnd(), 0);
+            size_t dirty_count = 0;
+            scene.ForEachParentFirst([&](Entity entity, Entity parent_entity)
+            {
+                is_dirty[entity] = is_changed[entity] || (parent_entity != 0 && is_dirty[parent_entity]);
+                dirty_count += is_dirty[entity];
+            });
+
+            return dirty_count;
+        };
+
+        size_t mismatches_count = 0;
+        size_t dirty_count_sum = 0;
+        const size_t frames_count = 16;
+        for (size_t frame = 0; frame != frames_count; ++frame)
+        {
+            if (frame % 4 != 3)
+                change_entities(frame % 2 == 0);
+            else
+                is_changed.assign(scene.GetEntitiesEnd(), 0);
+
+            scene.ecsWrapper.Update();
+
+            size_t expected_dirty_count = count_expected_dirty();
+            CHECK(scene.globalMatrixComp_ptr->GetDirtyEntitiesCount() == expected_dirty_count);
+            CHECK(scene.globalMatrixComp_ptr->GetCleanEntitiesCount() == scene.GetEntitiesCount() - expected_dirty_count);
+            CHECK((frame % 4 == 3) == (expected_dirty_count == 0));
+            CHECK(expected_dirty_count < scene.GetEntitiesCount() / 2);
+            dirty_count_sum += expected_dirty_count;
+
+            mismatches_count += scene.CountMismatchesOfFullRecalculation();
+        }
+        CHECK(mismatches_count == 0);
+
+        double frame_time = MeasureBestTime(20, [&]()
+        {
+            change_entities(false);
+            scene.ecsWrapper.Update();
+        });
+
+        printf("Partial: %zu entities, %.1f recalculated per frame, %.3f ms per frame of a tenth of the roots moving, %zu matrices off\n",
+               scene.GetEntitiesCount(), double(dirty_count_sum) / double(frames_count), frame_time * 1.e3, mismatches_count);
+    }
+}
+
+int main()
+{
+    TestsRandom random(6);
+
+    CheckMultiplyMat4(random);
+    BenchmarkProducts(random);
+
+    RunScene(random, "Deep", CreateChainFabNode(random, 64), 150);
+    RunScene(random, "Wide", CreateWideFabNode(random, 512), 20);
+    RunPartialScene(random, CreateChainFabNode(random, 64), 150);
+
+    return GetChecksResult("NodeGlobalMatrixBenchmark");
+}
@@ -0,0 +1,289 @@
+// Trees of the SAH builder against the midpoint builder's over the same meshes: the same intersecting triangle pairs
+// (also against every pair, for the small meshes) and the same ray hits. Then the build time of both, and the nodes
+// a query visits at each, as the measure of the trees' quality
+
+#include <array>
+#include <map>
+#include <memory>
+
+#include "TestsCommon.h"
+#include "Geometry/OBBtree.h"
+#include "Geometry/Ray.h"
+#include "WorkersPool.h"
+
+namespace
+{
+    // Builders reorder triangles, a mesh's triangle is known by its vertex indices
+    std::vector<size_t> GetMeshIndicesOfTreeTriangles(const OBBtree& obb_tree, const std::vector<Triangle>& triangles)
+    {
+        std::map<std::array<uint32_t, 3>, size_t> indices_to_mesh_index;
+        for (size_t i = 0; i != triangles.size(); ++i)
+        {
+            TriangleIndices this_indices = triangles[i].GetTriangleIndices();
+            indices_to_mesh_index.emplace(std::array<uint32_t, 3>{this_indices.GetI(0), this_indices.GetI(1), this_indices.GetI(2)}, i);
+        }
+        CHECK(indices_to_mesh_index.size() == triangles.size());
+
+        std::vector<size_t> mesh_indices;
+        for (size_t i = 0; i != triangles.size(); ++i)
+        {
+            TriangleIndices this_indices = obb_tree.GetTriangleIndices(i);
+            auto search = indices_to_mesh_index.find({this_indices.GetI(0), this_indices.GetI(1), this_indices.GetI(2)});
+            CHECK(search != indices_to_mesh_index.end());
+            mesh_indices.emplace_back(search != indices_to_mesh_index.end() ? search->second : size_t(-1));
+        }
+
+        return mesh_indices;
+    }
+
+    struct BuiltMesh
+    {
+        OBBtree tree;
+        std::vector<size_t> meshIndices;        // of each tree's triangle
+    };
+
+    std::unique_ptr<BuiltMesh> BuildMesh(const std::vector<Triangle>& triangles, OBBtreeBuilder builder)
+    {
+        auto built_mesh_uptr = std::make_unique<BuiltMesh>();
+        built_mesh_uptr->tree = OBBtree(std::vector<Triangle>(triangles), builder);
+        built_mesh_uptr->meshIndices = GetMeshIndicesOfTreeTriangles(built_mesh_uptr->tree, triangles);
+        return built_mesh_uptr;
+    }
+
+    // Sorted (first mesh's, second mesh's) triangles that intersect, of the trees' candidates
+    std::vector<std::pair<size_t, size_t>> GetIntersectingPairs(const BuiltMesh& first, const BuiltMesh& second, const glm::mat4& second_matrix)
+    {
+        OBBtreesIntersectInfo intersect_info;
+        OBBtree::IntersectOBBtrees(first.tree, second.tree, second_matrix, intersect_info);
+
+        std::vector<std::pair<size_t, size_t>> pairs;
+        for (const auto& this_combination : intersect_info.candidateTriangleRangeCombinations)
+        {
+            for (size_t i = this_combination.first_obbtree_offset; i != this_combination.first_obbtree_offset + this_combination.first_obbtree_count; ++i)
+            {
+                for (size_t j = this_combination.second_obbtree_offset; j != this_combination.second_obbtree_offset + this_combination.second_obbtree_count; ++j)
+                {
+                    TrianglePosition second_triangle = second_matrix * second.tree.GetTrianglePosition(j);
+                    if (TrianglePosition::IntersectTriangles(first.tree.GetTrianglePosition(i), second_triangle).doIntersept)
+                        pairs.emplace_back(first.meshIndices[i], second.meshIndices[j]);
+                }
+            }
+        }
+
+        std::sort(pairs.begin(), pairs.end());
+        return pairs;
+    }
+
+    std::vector<std::pair<size_t, size_t>> GetBruteForcePairs(const std::vector<Triangle>& first, const std::vector<Triangle>& second, const glm::mat4& second_matrix)
+    {
+        std::vector<std::pair<size_t, size_t>> pairs;
+        for (size_t i = 0; i != first.size(); ++i)
+        {
+            for (size_t j = 0; j != second.size(); ++j)
+            {
+                TrianglePosition second_triangle = second_matrix * second[j].GetTrianglePosition();
+                if (TrianglePosition::IntersectTriangles(first[i].GetTrianglePosition(), second_triangle).doIntersept)
+                    pairs.emplace_back(i, j);
+            }
+        }
+
+        return pairs;
+    }
+
+    // Nodes pairs IntersectOBBtrees visits, with its choice of which tree splits
+    size_t CountNodesPairsVisits(const OBBtree::OBBtreeTraveler& first_traveler, const Paralgram& first_paralgram,
+                                 const OBBtree::OBBtreeTraveler& second_traveler, const Paralgram& second_paralgram,
+                                 const glm::mat4& second_matrix)
+    {
+        if (first_traveler.IsLeaf() && second_traveler.IsLeaf())
+            return 1;
+
+        bool should_split_first = second_traveler.IsLeaf() ||
+                                  (not first_traveler.IsLeaf() && first_paralgram.GetSurface() >= second_paralgram.GetSurface());
+
+        size_t visits_count = 1;
+        if (should_split_first)
+        {
+            for (const OBBtree::OBBtreeTraveler& this_child : {first_traveler.GetLeftChildTraveler(), first_traveler.GetRightChildTraveler()})
+            {
+                Paralgram child_paralgram = this_child.GetOBB();
+                if (Paralgram::IntersectParalgramsBoolean(child_paralgram, second_paralgram))
+                    visits_count += CountNodesPairsVisits(this_child, child_paralgram, second_traveler, second_paralgram, second_matrix);
+            }
+        }
+        else
+        {
+            for (const OBBtree::OBBtreeTraveler& this_child : {second_traveler.GetLeftChildTraveler(), second_traveler.GetRightChildTraveler()})
+            {
+                Paralgram child_paralgram = second_matrix * this_child.GetOBB();
+                if (Paralgram::IntersectParalgramsBoolean(first_paralgram, child_paralgram))
+                    visits_count += CountNodesPairsVisits(first_traveler, first_paralgram, this_child, child_paralgram, second_matrix);
+            }
+        }
+
+        return visits_count;
+    }
+
+    size_t CountNodesPairsVisits(const OBBtree& first_tree, const OBBtree& second_tree, const glm::mat4& second_matrix)
+    {
+        Paralgram first_paralgram = first_tree.GetRootTraveler().GetOBB();
+        Paralgram second_paralgram = second_matrix * second_tree.GetRootTraveler().GetOBB();
+        if (not Paralgram::IntersectParalgramsBoolean(first_paralgram, second_paralgram))
+            return 0;
+
+        return CountNodesPairsVisits(first_tree.GetRootTraveler(), first_paralgram, second_tree.GetRootTraveler(), second_paralgram, second_matrix);
+    }
+
+    // Nodes the ray crosses, the most an ordered walk can visit
+    size_t CountRayNodesVisits(const Ray& ray, const OBBtree::OBBtreeTraveler& traveler)
+    {
+        if (not ray.IntersectParalgram(traveler.GetOBB()).first)
+            return 0;
+        if (traveler.IsLeaf())
+            return 1;
+
+        return 1 + CountRayNodesVisits(ray, traveler.GetLeftChildTraveler()) + CountRayNodesVisits(ray, traveler.GetRightChildTraveler());
+    }
+
+    Ray CreateRayTowardsMesh(TestsRandom& random, float half_extent)
+    {
+        glm::vec3 origin = random.NextDirection() * half_extent * 3.f;
+        glm::vec3 target = random.NextVec3(-half_extent, half_extent) * 0.5f;
+        return Ray(origin, glm::normalize(target - origin));
+    }
+
+    struct CompareStats
+    {
+        size_t placementsCount = 0;
+        size_t intersectingPairsCount = 0;
+        size_t pairsMismatchesCount = 0;
+        size_t bruteForceMismatchesCount = 0;
+
+        size_t raysCount = 0;
+        size_t hitsCount = 0;
+        size_t hitsMismatchesCount = 0;
+        size_t tiesCount = 0;
+    };
+
+    void CompareBuilders(TestsRandom& random, const std::vector<Triangle>& first_triangles, const std::vector<Triangle>& second_triangles,
+                         float half_extent, bool should_brute_force, CompareStats& stats)
+    {
+        std::unique_ptr<BuiltMesh> first_midpoint_uptr = BuildMesh(first_triangles, OBBtreeBuilder::midpoint);
+        std::unique_ptr<BuiltMesh> second_midpoint_uptr = BuildMesh(second_triangles, OBBtreeBuilder::midpoint);
+        std::unique_ptr<BuiltMesh> first_SAH_uptr = BuildMesh(first_triangles, OBBtreeBuilder::SAH);
+        std::unique_ptr<BuiltMesh> second_SAH_uptr = BuildMesh(second_triangles, OBBtreeBuilder::SAH);
+
+        for (size_t placement = 0; placement != 30; ++placement)
+        {
+            glm::mat4 second_matrix = CreateTranslationRotationMatrix(random.NextVec3(-half_extent, half_extent),
+                                                                      random.NextDirection(), random.NextFloat(0.f, 6.28f));
+
+            std::vector<std::pair<size_t, size_t>> midpoint_pairs = GetIntersectingPairs(*first_midpoint_uptr, *second_midpoint_uptr, second_matrix);
+            std::vector<std::pair<size_t, size_t>> SAH_pairs = GetIntersectingPairs(*first_SAH_uptr, *second_SAH_uptr, second_matrix);
+
+            ++stats.placementsCount;
+            stats.intersectingPairsCount += midpoint_pairs.size();
+            stats.pairsMismatchesCount += midpoint_pairs != SAH_pairs ? 1 : 0;
+            if (should_brute_force)
+                stats.bruteForceMismatchesCount += midpoint_pairs != GetBruteForcePairs(first_triangles, second_triangles, second_matrix) ? 1 : 0;
+
+            for (size_t i = 0; i != 50; ++i)
+            {
+                Ray this_ray = CreateRayTowardsMesh(random, half_extent);
+                RayOBBtreeIntersectInfo midpoint_info = this_ray.IntersectOBBtree(second_midpoint_uptr->tree, second_matrix);
+                RayOBBtreeIntersectInfo SAH_info = this_ray.IntersectOBBtree(second_SAH_uptr->tree, second_matrix);
+
+                ++stats.raysCount;
+                stats.hitsCount += midpoint_info.doIntersect ? 1 : 0;
+
+                // The same triangles at the same space give the same distance bits. Ties on shared edges go to the lowest
+                // index of each tree's order, so the triangle may differ there
+                if (midpoint_info.doIntersect != SAH_info.doIntersect ||
+                    midpoint_info.distanceFromOrigin != SAH_info.distanceFromOrigin)
+                    ++stats.hitsMismatchesCount;
+                else if (midpoint_info.doIntersect &&
+                         second_midpoint_uptr->meshIndices[midpoint_info.triangle_index] != second_SAH_uptr->meshIndices[SAH_info.triangle_index])
+                    ++stats.tiesCount;
+            }
+        }
+    }
+
+    void CheckBuilders(TestsRandom& random)
+    {
+        CompareStats stats;
+
+        CompareBuilders(random,
+                        CreateTrianglesSoup(random, 300, 1.f, 0.4f),
+                        CreateTrianglesSoup(random, 300, 1.f, 0.4f),
+                        1.f, true, stats);
+        CompareBuilders(random,
+                        CreateEllipsoidTriangles(glm::vec3(1.2f, 0.8f, 0.5f), 12, 24),
+                        CreateBoxTriangles(glm::vec3(0.9f, 0.3f, 0.6f), 4),
+                        1.f, true, stats);
+        // Thin and long, and big meshes of many levels
+        CompareBuilders(random,
+                        CreateBoxTriangles(glm::vec3(3.f, 0.02f, 0.01f), 8),
+                        CreateTrianglesSoup(random, 150, 0.8f, 0.3f),
+                        1.f, true, stats);
+        CompareBuilders(random,
+                        CreateEllipsoidTriangles(glm::vec3(2.f, 1.5f, 1.f), 64, 128),
+                        CreateTrianglesSoup(random, 5000, 2.f, 0.3f),
+                        2.f, false, stats);
+
+        CHECK(stats.intersectingPairsCount != 0);
+        CHECK(stats.pairsMismatchesCount == 0);
+        CHECK(stats.bruteForceMismatchesCount == 0);
+        CHECK(stats.hitsCount != 0);
+        CHECK(stats.hitsMismatchesCount == 0);
+
+        printf("%zu placements, %zu intersecting triangle pairs: %zu placements differ between builders, %zu from brute force\n",
+               stats.placementsCount, stats.intersectingPairsCount, stats.pairsMismatchesCount, stats.bruteForceMismatchesCount);
+        printf("%zu rays, %zu hits: %zu differ between builders, %zu ties on other triangles\n",
+               stats.raysCount, stats.hitsCount, stats.hitsMismatchesCount, stats.tiesCount);
+    }
+
+    void Benchmark(TestsRandom& random, const char* mesh_name, const std::vector<Triangle>& triangles, float half_extent)
+    {
+        WorkersPool workers_pool(4);
+
+        std::unique_ptr<OBBtree> midpoint_uptr;
+        std::unique_ptr<OBBtree> SAH_uptr;
+        double midpoint_time = MeasureBestTime(3, [&]() {midpoint_uptr = std::make_unique<OBBtree>(std::vector<Triangle>(triangles), OBBtreeBuilder::midpoint);});
+        double SAH_time = MeasureBestTime(3, [&]() {SAH_uptr = std::make_unique<OBBtree>(std::vector<Triangle>(triangles), OBBtreeBuilder::SAH);});
+        double SAH_pool_time = MeasureBestTime(3, [&]() {SAH_uptr = std::make_unique<OBBtree>(std::vector<Triangle>(triangles), OBBtreeBuilder::SAH, &workers_pool);});
+
+        // Pairs of the mesh with itself, placed to overlap partly
+        size_t midpoint_pairs_visits = 0, SAH_pairs_visits = 0;
+        size_t midpoint_ray_visits = 0, SAH_ray_visits = 0;
+        const size_t queries_count = 50;
+        for (size_t i = 0; i != queries_count; ++i)
+        {
+            glm::mat4 second_matrix = CreateTranslationRotationMatrix(random.NextVec3(-half_extent, half_extent),
+                                                                      random.NextDirection(), random.NextFloat(0.f, 6.28f));
+            midpoint_pairs_visits += CountNodesPairsVisits(*midpoint_uptr, *midpoint_uptr, second_matrix);
+            SAH_pairs_visits += CountNodesPairsVisits(*SAH_uptr, *SAH_uptr, second_matrix);
+
+            Ray this_ray = CreateRayTowardsMesh(random, half_extent);
+            midpoint_ray_visits += CountRayNodesVisits(this_ray, midpoint_uptr->GetRootTraveler());
+            SAH_ray_visits += CountRayNodesVisits(this_ray, SAH_uptr->GetRootTraveler());
+        }
+
+        printf("%-10s %6zu triangles | build ms: midpoint %8.3f, SAH %8.3f, SAH at 4 threads %8.3f | nodes visits per pair query: midpoint %8.1f, SAH %8.1f | per ray: midpoint %6.1f, SAH %6.1f\n",
+               mesh_name, triangles.size(), midpoint_time * 1.e3, SAH_time * 1.e3, SAH_pool_time * 1.e3,
+               double(midpoint_pairs_visits) / double(queries_count), double(SAH_pairs_visits) / double(queries_count),
+               double(midpoint_ray_visits) / double(queries_count), double(SAH_ray_visits) / double(queries_count));
+    }
+}
+
+int main()
+{
+    TestsRandom random(10);
+
+    CheckBuilders(random);
+
+    Benchmark(random, "ellipsoid", CreateEllipsoidTriangles(glm::vec3(2.f, 1.5f, 1.f), 128, 256), 2.f);
+    Benchmark(random, "box", CreateBoxTriangles(glm::vec3(2.f, 0.5f, 1.f), 64), 2.f);
+    Benchmark(random, "soup", CreateTrianglesSoup(random, 20000, 2.f, 0.1f), 2.f);
+
+    return GetChecksResult("OBBtreeBuildersTest");
+}
@@ -0,0 +1,195 @@
+// OBBtreeCache round trip, and files or folders it has to refuse without throwing
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+
+#include "TestsCommon.h"
+#include "Geometry/OBBtreeCache.h"
+
+namespace
+{
+    bool AreOBBsEqual(const Paralgram& lhs, const Paralgram& rhs)
+    {
+        return lhs.GetCenter() == rhs.GetCenter() &&
+               lhs.GetSideDirectionU() == rhs.GetSideDirectionU() &&
+               lhs.GetSideDirectionV() == rhs.GetSideDirectionV() &&
+               lhs.GetSideDirectionW() == rhs.GetSideDirectionW();
+    }
+
+    // Leaves' triangles are compared too
+    bool AreTravelersEqual(const OBBtree& lhs_tree, const OBBtree::OBBtreeTraveler& lhs,
+                           const OBBtree& rhs_tree, const OBBtree::OBBtreeTraveler& rhs)
+    {
+        if (lhs.IsLeaf() != rhs.IsLeaf() || not AreOBBsEqual(lhs.GetOBB(), rhs.GetOBB()))
+            return false;
+
+        if (lhs.IsLeaf())
+        {
+            if (lhs.GetTrianglesOffset() != rhs.GetTrianglesOffset() || lhs.GetTrianglesCount() != rhs.GetTrianglesCount())
+                return false;
+
+            for (size_t i = lhs.GetTrianglesOffset(); i != lhs.GetTrianglesOffset() + lhs.GetTrianglesCount(); ++i)
+                for (size_t j = 0; j != 3; ++j)
+                    if (lhs_tree.GetTrianglePosition(i).GetP(j) != rhs_tree.GetTrianglePosition(i).GetP(j))
+                        return false;
+
+            return true;
+        }
+
+        return AreTravelersEqual(lhs_tree, lhs.GetLeftChildTraveler(), rhs_tree, rhs.GetLeftChildTraveler()) &&
+               AreTravelersEqual(lhs_tree, lhs.GetRightChildTraveler(), rhs_tree, rhs.GetRightChildTraveler());
+    }
+
+    bool AreOBBtreesEqual(const OBBtree& lhs, const OBBtree& rhs)
+    {
+        return AreTravelersEqual(lhs, lhs.GetRootTraveler(), rhs, rhs.GetRootTraveler());
+    }
+
+    size_t CountTemporaryFiles(const std::filesystem::path& folder)
+    {
+        size_t temporary_files_count = 0;
+        for (const std::filesystem::directory_entry& this_entry : std::filesystem::directory_iterator(folder))
+            if (this_entry.path().extension() == ".tmp")
+                ++temporary_files_count;
+
+        return temporary_files_count;
+    }
+
+    std::filesystem::path GetCacheFilePath(const std::filesystem::path& folder, uint64_t key)
+    {
+        char key_hex[17];
+        snprintf(key_hex, sizeof(key_hex), "%016llx", static_cast<unsigned long long>(key));
+
+        return folder / (std::string(key_hex) + ".obbtree");
+    }
+
+    void RoundTrip(const std::filesystem::path& folder, const std::vector<Triangle>& triangles)
+    {
+        OBBtreeCache cache(folder.string());
+        CHECK(cache.IsEnabled());
+
+        uint64_t key = OBBtreeCache::GetKey(triangles, OBBtreeBuilder::midpoint);
+        CHECK(not cache.Load(key).has_value());
+
+        OBBtree built_OBBtree(std::vector<Triangle>(triangles), OBBtreeBuilder::midpoint);
+        cache.Store(key, built_OBBtree);
+        CHECK(std::filesystem::exists(GetCacheFilePath(folder, key)));
+        CHECK(CountTemporaryFiles(folder) == 0);
+
+        std::optional<OBBtree> loaded_OBBtree = cache.Load(key);
+        CHECK(loaded_OBBtree.has_value());
+        if (loaded_OBBtree.has_value())
+        {
+            CHECK(AreOBBtreesEqual(built_OBBtree, loaded_OBBtree.value()));
+
+            // Same candidates against another tree
+            OBBtree other_OBBtree(CreateBoxTriangles(glm::vec3(1.5f, 0.3f, 0.7f), 4));
+            glm::mat4 other_matrix = CreateTranslationRotationMatrix(glm::vec3(0.3f, 0.2f, -0.1f), glm::vec3(0.f, 1.f, 0.f), 0.4f);
+
+            OBBtreesIntersectInfo built_info;
+            OBBtreesIntersectInfo loaded_info;
+            OBBtree::IntersectOBBtrees(built_OBBtree, other_OBBtree, other_matrix, built_info);
+            OBBtree::IntersectOBBtrees(loaded_OBBtree.value(), other_OBBtree, other_matrix, loaded_info);
+            CHECK(not built_info.candidateTriangleRangeCombinations.empty());
+            CHECK(built_info.candidateTriangleRangeCombinations.size() == loaded_info.candidateTriangleRangeCombinations.size());
+        }
+
+        // A different builder is a different key
+        CHECK(OBBtreeCache::GetKey(triangles, OBBtreeBuilder::SAH) != key);
+        CHECK(not cache.Load(OBBtreeCache::GetKey(triangles, OBBtreeBuilder::SAH)).has_value());
+    }
+
+    void CorruptedFiles(const std::filesystem::path& folder, const std::vector<Triangle>& triangles)
+    {
+        OBBtreeCache cache(folder.string());
+
+        uint64_t key = OBBtreeCache::GetKey(triangles, OBBtreeBuilder::midpoint);
+        std::filesystem::path file_path = GetCacheFilePath(folder, key);
+        cache.Store(key, OBBtree(std::vector<Triangle>(triangles), OBBtreeBuilder::midpoint));
+        CHECK(cache.Load(key).has_value());
+
+        std::vector<char> file_bytes;
+        {
+            std::ifstream file(file_path, std::ios::binary);
+            file_bytes.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        }
+        CHECK(file_bytes.size() > 64);
+
+        auto write_file = [&file_path](const std::vector<char>& bytes)
+        {
+            std::ofstream file(file_path, std::ios::binary | std::ios::trunc);
+            file.write(bytes.data(), std::streamsize(bytes.size()));
+        };
+
+        // Flipped byte at the payload: checksum
+        std::vector<char> flipped_bytes = file_bytes;
+        flipped_bytes[flipped_bytes.size() / 2] ^= 0x5a;
+        write_file(flipped_bytes);
+        CHECK(not cache.Load(key).has_value());
+
+        // Truncated: payload size
+        write_file(std::vector<char>(file_bytes.begin(), file_bytes.end() - 16));
+        CHECK(not cache.Load(key).has_value());
+
+        // Shorter than the header
+        write_file(std::vector<char>(file_bytes.begin(), file_bytes.begin() + 8));
+        CHECK(not cache.Load(key).has_value());
+
+        // Empty
+        write_file({});
+        CHECK(not cache.Load(key).has_value());
+
+        // Valid file of another key
+        write_file(file_bytes);
+        std::filesystem::path other_key_path = GetCacheFilePath(folder, key + 1);
+        std::filesystem::copy_file(file_path, other_key_path);
+        CHECK(not cache.Load(key + 1).has_value());
+        CHECK(cache.Load(key).has_value());
+    }
+
+    void FailedStore(const std::filesystem::path& folder, const std::vector<Triangle>& triangles)
+    {
+        OBBtreeCache cache(folder.string());
+
+        // A folder where the file should go, so the temporary file cannot be renamed over it
+        uint64_t key = OBBtreeCache::GetKey(triangles, OBBtreeBuilder::SAH);
+        std::filesystem::create_directories(GetCacheFilePath(folder, key));
+
+        cache.Store(key, OBBtree(std::vector<Triangle>(triangles), OBBtreeBuilder::SAH));
+        CHECK(CountTemporaryFiles(folder) == 0);
+        CHECK(not cache.Load(key).has_value());
+    }
+
+    void UncreatableFolder(const std::filesystem::path& folder, const std::vector<Triangle>& triangles)
+    {
+        // A file where the folder should go
+        std::filesystem::path blocked_folder = folder / "blocked";
+        std::ofstream(blocked_folder) << "not a folder";
+
+        OBBtreeCache cache((blocked_folder / "cache").string());
+        CHECK(not cache.IsEnabled());
+
+        uint64_t key = OBBtreeCache::GetKey(triangles, OBBtreeBuilder::midpoint);
+        cache.Store(key, OBBtree(std::vector<Triangle>(triangles), OBBtreeBuilder::midpoint));
+        CHECK(not cache.Load(key).has_value());
+    }
+}
+
+int main()
+{
+    TestsRandom random(11);
+    std::vector<Triangle> triangles = CreateTrianglesSoup(random, 300, 2.f, 0.4f);
+
+    std::filesystem::path folder = std::filesystem::temp_directory_path() / ("OBBtreeCacheTest_" + std::to_string(random.NextUint()));
+    std::filesystem::remove_all(folder);
+
+    RoundTrip(folder / "roundtrip", triangles);
+    CorruptedFiles(folder / "corrupted", triangles);
+    FailedStore(folder / "failed", triangles);
+    UncreatableFolder(folder, triangles);
+
+    std::filesystem::remove_all(folder);
+
+    return GetChecksResult("OBBtreeCacheTest");
+}
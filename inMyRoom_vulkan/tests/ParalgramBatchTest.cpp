@@ -0,0 +1,177 @@
+// ParalgramBatch::IntersectParalgramBoolean against Paralgram::IntersectParalgramsBoolean of every paralgram of the batch,
+// and the paralgram pairs per second of both
+
+#include <bit>
+
+#include "TestsCommon.h"
+#include "Geometry/ParalgramBatch.h"
+
+namespace
+{
+    struct PairsStats
+    {
+        size_t pairsCount = 0;
+        size_t intersectionsCount = 0;
+        size_t mismatchesCount = 0;
+    };
+
+    // "paralgrams" is cut to batches of every size up to the width
+    void CompareBatches(const Paralgram& lhs, const std::vector<Paralgram>& paralgrams, PairsStats& stats)
+    {
+        size_t batch_size = 1;
+        for (size_t first = 0; first < paralgrams.size(); first += batch_size, batch_size = batch_size % ParalgramBatch::width + 1)
+        {
+            size_t last = std::min(first + batch_size, paralgrams.size());
+
+            ParalgramBatch batch;
+            for (size_t i = first; i != last; ++i)
+                batch.Add(paralgrams[i]);
+
+            uint32_t intersect_mask = batch.IntersectParalgramBoolean(lhs);
+            CHECK((intersect_mask >> batch.GetSize()) == 0);
+
+            for (size_t i = first; i != last; ++i)
+            {
+                bool scalar_intersect = Paralgram::IntersectParalgramsBoolean(lhs, paralgrams[i]);
+                bool batch_intersect = ((intersect_mask >> (i - first)) & 1u) != 0;
+
+                ++stats.pairsCount;
+                stats.intersectionsCount += scalar_intersect ? 1 : 0;
+                stats.mismatchesCount += scalar_intersect != batch_intersect ? 1 : 0;
+            }
+        }
+    }
+
+    // "flat" ones have no thickness along w, as OBBtree nodes of coplanar triangles
+    Paralgram CreateRandomParalgram(TestsRandom& random, float half_extent, float max_half_size, bool is_flat)
+    {
+        glm::mat4 rotation = CreateTranslationRotationMatrix(glm::vec3(0.f), random.NextDirection(), random.NextFloat(0.f, 6.28f));
+        glm::vec3 half_sizes = random.NextVec3(0.05f, max_half_size);
+        if (is_flat)
+            half_sizes.z = 0.f;
+
+        return Paralgram(random.NextVec3(-half_extent, half_extent),
+                         half_sizes.x * glm::vec3(rotation[0]),
+                         half_sizes.y * glm::vec3(rotation[1]),
+                         half_sizes.z * glm::vec3(rotation[2]));
+    }
+
+    Paralgram CreateAxisAlignedParalgram(glm::vec3 center, glm::vec3 half_sizes)
+    {
+        return Paralgram(center,
+                         glm::vec3(half_sizes.x, 0.f, 0.f),
+                         glm::vec3(0.f, half_sizes.y, 0.f),
+                         glm::vec3(0.f, 0.f, half_sizes.z));
+    }
+
+    void CompareRandom(TestsRandom& random)
+    {
+        PairsStats stats;
+
+        for (size_t i = 0; i != 2000; ++i)
+        {
+            Paralgram lhs = CreateRandomParalgram(random, 1.f, 0.6f, i % 5 == 0);
+
+            std::vector<Paralgram> paralgrams;
+            for (size_t j = 0; j != 36; ++j)
+                paralgrams.emplace_back(CreateRandomParalgram(random, 1.f, 0.6f, j % 7 == 0));
+
+            CompareBatches(lhs, paralgrams, stats);
+        }
+
+        CHECK(stats.intersectionsCount > stats.pairsCount / 10);
+        CHECK(stats.intersectionsCount < stats.pairsCount - stats.pairsCount / 10);
+#if defined(__FMA__)
+        // The lanes and Paralgram.cpp may be contracted to different fused multiply-adds, so boxes that barely touch
+        // can round the other way: counted, not failed
+        CHECK(stats.mismatchesCount * 1000 <= stats.pairsCount);
+#else
+        CHECK(stats.mismatchesCount == 0);
+#endif
+
+        printf("random: %zu pairs, %zu intersections, %zu differences\n",
+               stats.pairsCount, stats.intersectionsCount, stats.mismatchesCount);
+    }
+
+    // Same orientations, where the cross product axes are zero, and boxes that touch exactly at a face
+    void CompareAxisAligned(TestsRandom& random)
+    {
+        PairsStats stats;
+
+        for (size_t i = 0; i != 500; ++i)
+        {
+            Paralgram lhs = CreateAxisAlignedParalgram(random.NextVec3(-1.f, 1.f), random.NextVec3(0.125f, 0.5f));
+
+            std::vector<Paralgram> paralgrams;
+            for (size_t j = 0; j != 24; ++j)
+            {
+                // Halves and quarters, so touching faces are exact
+                glm::vec3 half_sizes = glm::vec3(float(1 + random.NextUint() % 4), float(1 + random.NextUint() % 4), float(1 + random.NextUint() % 4)) / 8.f;
+                glm::vec3 offset = glm::vec3(float(int(random.NextUint() % 17) - 8), float(int(random.NextUint() % 17) - 8), float(int(random.NextUint() % 17) - 8)) / 8.f;
+
+                paralgrams.emplace_back(CreateAxisAlignedParalgram(lhs.GetCenter() + offset, half_sizes));
+            }
+
+            CompareBatches(lhs, paralgrams, stats);
+        }
+
+        CHECK(stats.intersectionsCount != 0);
+        CHECK(stats.mismatchesCount == 0);
+
+        printf("axis aligned: %zu pairs, %zu intersections, %zu differences\n",
+               stats.pairsCount, stats.intersectionsCount, stats.mismatchesCount);
+    }
+
+    void Benchmark(TestsRandom& random)
+    {
+        std::vector<Paralgram> lhs_paralgrams;
+        std::vector<Paralgram> rhs_paralgrams;
+        for (size_t i = 0; i != 2000; ++i)
+            lhs_paralgrams.emplace_back(CreateRandomParalgram(random, 1.f, 0.3f, false));
+        for (size_t i = 0; i != ParalgramBatch::width * 100; ++i)
+            rhs_paralgrams.emplace_back(CreateRandomParalgram(random, 1.f, 0.3f, false));
+
+        std::vector<ParalgramBatch> batches(rhs_paralgrams.size() / ParalgramBatch::width);
+        for (size_t i = 0; i != rhs_paralgrams.size(); ++i)
+            batches[i / ParalgramBatch::width].Add(rhs_paralgrams[i]);
+
+        size_t scalar_intersections_count = 0;
+        double scalar_time = MeasureBestTime(5, [&]()
+        {
+            scalar_intersections_count = 0;
+            for (const Paralgram& this_lhs : lhs_paralgrams)
+                for (const Paralgram& this_rhs : rhs_paralgrams)
+                    scalar_intersections_count += Paralgram::IntersectParalgramsBoolean(this_lhs, this_rhs) ? 1 : 0;
+        });
+
+        size_t batch_intersections_count = 0;
+        double batch_time = MeasureBestTime(5, [&]()
+        {
+            batch_intersections_count = 0;
+            for (const Paralgram& this_lhs : lhs_paralgrams)
+                for (const ParalgramBatch& this_batch : batches)
+                    batch_intersections_count += size_t(std::popcount(this_batch.IntersectParalgramBoolean(this_lhs)));
+        });
+
+        // Same budget as the random pairs
+        size_t counts_difference = std::max(scalar_intersections_count, batch_intersections_count) - std::min(scalar_intersections_count, batch_intersections_count);
+        CHECK(counts_difference * 1000 <= scalar_intersections_count);
+
+        size_t pairs_count = lhs_paralgrams.size() * rhs_paralgrams.size();
+        printf("%zu paralgram pairs, %zu intersect: scalar %.2f Mpairs/s, batches of %zu %.2f Mpairs/s\n",
+               pairs_count, scalar_intersections_count,
+               double(pairs_count) / scalar_time * 1.e-6, ParalgramBatch::width, double(pairs_count) / batch_time * 1.e-6);
+    }
+}
+
+int main()
+{
+    TestsRandom random(9);
+
+    CompareRandom(random);
+    CompareAxisAligned(random);
+
+    Benchmark(random);
+
+    return GetChecksResult("ParalgramBatchTest");
+}
@@ -0,0 +1,131 @@
+// Quantized OBBtree nodes must contain their float nodes, so IntersectOBBtrees never misses a triangle pair because of them
+
+#include "TestsCommon.h"
+#include "Geometry/OBBtree.h"
+
+namespace
+{
+    bool DoesParalgramContainParalgram(const Paralgram& outer, const Paralgram& inner)
+    {
+        glm::mat3 outer_to_unit = glm::inverse(glm::mat3(outer.GetSideDirectionU(), outer.GetSideDirectionV(), outer.GetSideDirectionW()));
+
+        for (size_t corner_index = 0; corner_index != 8; ++corner_index)
+        {
+            glm::vec3 corner = inner.GetCenter() + ((corner_index & 1) ? +1.f : -1.f) * inner.GetSideDirectionU()
+                                                 + ((corner_index & 2) ? +1.f : -1.f) * inner.GetSideDirectionV()
+                                                 + ((corner_index & 4) ? +1.f : -1.f) * inner.GetSideDirectionW();
+
+            glm::vec3 unit_corner = outer_to_unit * (corner - outer.GetCenter());
+            if (std::abs(unit_corner.x) > 1.f + 1.e-4f || std::abs(unit_corner.y) > 1.f + 1.e-4f || std::abs(unit_corner.z) > 1.f + 1.e-4f)
+                return false;
+        }
+
+        return true;
+    }
+
+    // Returns the count of nodes whose quantized box does not contain the float box
+    size_t CountUncontainedNodes(const OBBtree::OBBtreeTraveler& float_traveler, const OBBtree::QuantizedOBBtreeTraveler& quantized_traveler)
+    {
+        size_t uncontained_count = DoesParalgramContainParalgram(quantized_traveler.GetOBB(), float_traveler.GetOBB()) ? 0 : 1;
+
+        CHECK(float_traveler.IsLeaf() == quantized_traveler.IsLeaf());
+        if (float_traveler.IsLeaf() || quantized_traveler.IsLeaf())
+        {
+            CHECK(float_traveler.GetTrianglesOffset() == quantized_traveler.GetTrianglesOffset());
+            CHECK(float_traveler.GetTrianglesCount() == quantized_traveler.GetTrianglesCount());
+            return uncontained_count;
+        }
+
+        return uncontained_count +
+               CountUncontainedNodes(float_traveler.GetLeftChildTraveler(), quantized_traveler.GetLeftChildTraveler()) +
+               CountUncontainedNodes(float_traveler.GetRightChildTraveler(), quantized_traveler.GetRightChildTraveler());
+    }
+
+    // Triangle pairs of the candidates, as a first_count * second_count mask
+    std::vector<bool> GetCandidatePairs(const OBBtreesIntersectInfo& intersect_info, size_t first_count, size_t second_count)
+    {
+        std::vector<bool> candidate_pairs(first_count * second_count, false);
+        for (const auto& this_combination : intersect_info.candidateTriangleRangeCombinations)
+            for (size_t i = this_combination.first_obbtree_offset; i != this_combination.first_obbtree_offset + this_combination.first_obbtree_count; ++i)
+                for (size_t j = this_combination.second_obbtree_offset; j != this_combination.second_obbtree_offset + this_combination.second_obbtree_count; ++j)
+                    candidate_pairs[i * second_count + j] = true;
+
+        return candidate_pairs;
+    }
+
+    void CompareTrees(TestsRandom& random, const std::vector<Triangle>& first_triangles, const std::vector<Triangle>& second_triangles, size_t placements_count)
+    {
+        size_t first_count = first_triangles.size();
+        size_t second_count = second_triangles.size();
+
+        OBBtree first_OBBtree(std::vector<Triangle>(first_triangles), OBBtreeBuilder::midpoint);
+        OBBtree second_OBBtree(std::vector<Triangle>(second_triangles), OBBtreeBuilder::midpoint);
+        OBBtree first_quantized_OBBtree = first_OBBtree;
+        OBBtree second_quantized_OBBtree = second_OBBtree;
+        first_quantized_OBBtree.QuantizeNodes();
+        second_quantized_OBBtree.QuantizeNodes();
+
+        CHECK(CountUncontainedNodes(first_OBBtree.GetRootTraveler(), first_quantized_OBBtree.GetRootQuantizedTraveler()) == 0);
+        CHECK(CountUncontainedNodes(second_OBBtree.GetRootTraveler(), second_quantized_OBBtree.GetRootQuantizedTraveler()) == 0);
+
+        // Both copies are kept, so quantizing costs memory
+        CHECK(first_quantized_OBBtree.GetNodesMemorySize() > first_OBBtree.GetNodesMemorySize());
+
+        size_t intersecting_pairs_count = 0;
+        for (size_t placement = 0; placement != placements_count; ++placement)
+        {
+            glm::mat4 second_matrix = CreateTranslationRotationMatrix(random.NextVec3(-1.f, 1.f), random.NextDirection(), random.NextFloat(0.f, 6.28f));
+
+            OBBtreesIntersectInfo float_info;
+            OBBtreesIntersectInfo quantized_info;
+            OBBtree::IntersectOBBtrees(first_OBBtree, second_OBBtree, second_matrix, float_info);
+            OBBtree::IntersectOBBtrees(first_quantized_OBBtree, second_quantized_OBBtree, second_matrix, quantized_info);
+
+            // Candidates are not a superset of the float ones: larger quantized boxes can change which tree splits first,
+            // so pairs of boxes that never got tested together may differ. Triangles that intersect must be candidates of both
+            std::vector<bool> float_pairs = GetCandidatePairs(float_info, first_count, second_count);
+            std::vector<bool> quantized_pairs = GetCandidatePairs(quantized_info, first_count, second_count);
+
+            size_t missed_intersections_count = 0;
+            for (size_t i = 0; i != first_count; ++i)
+            {
+                TrianglePosition first_triangle = first_OBBtree.GetTrianglePosition(i);
+                for (size_t j = 0; j != second_count; ++j)
+                {
+                    TrianglePosition second_triangle = second_matrix * second_OBBtree.GetTrianglePosition(j);
+                    if (TrianglePosition::IntersectTriangles(first_triangle, second_triangle).doIntersept)
+                    {
+                        ++intersecting_pairs_count;
+                        if (not float_pairs[i * second_count + j] || not quantized_pairs[i * second_count + j])
+                            ++missed_intersections_count;
+                    }
+                }
+            }
+
+            CHECK(missed_intersections_count == 0);
+        }
+
+        CHECK(intersecting_pairs_count != 0);
+    }
+}
+
+int main()
+{
+    TestsRandom random(5);
+
+    CompareTrees(random,
+                 CreateTrianglesSoup(random, 200, 1.f, 0.4f),
+                 CreateTrianglesSoup(random, 200, 1.f, 0.4f),
+                 40);
+    CompareTrees(random,
+                 CreateEllipsoidTriangles(glm::vec3(1.2f, 0.8f, 0.5f), 12, 24),
+                 CreateBoxTriangles(glm::vec3(0.9f, 0.3f, 0.6f), 4),
+                 40);
+    // Thin and long, where quantization steps are largest relative to the box
+    CompareTrees(random,
+                 CreateBoxTriangles(glm::vec3(3.f, 0.02f, 0.01f), 8),
+                 CreateTrianglesSoup(random, 150, 0.8f, 0.3f),
+                 40);
+
+    return GetChecksResult("QuantizedOBBtreeTest");
+}
@@ -0,0 +1,169 @@
+// Ray::IntersectOBBtree against every triangle of the tree: the same hit at tree's space, and the hit of the world space
+// traversal it replaced, which moved every triangle with the matrix, up to rounding on shared edges
+
+#include "TestsCommon.h"
+#include "Geometry/Ray.h"
+
+namespace
+{
+    // Same rule as the traversal: nearest distance, ties to the lowest triangle index
+    RayOBBtreeIntersectInfo IntersectAllTriangles(const Ray& ray, const OBBtree& obb_tree, size_t triangles_count, const glm::mat4& triangles_matrix)
+    {
+        RayOBBtreeIntersectInfo return_info;
+        for (size_t i = 0; i != triangles_count; ++i)
+        {
+            RayTriangleIntersectInfo this_info = ray.IntersectTriangle(triangles_matrix * obb_tree.GetTrianglePosition(i));
+            if (this_info.doIntersect &&
+                this_info.distanceFromOrigin > 0.f &&
+                this_info.distanceFromOrigin < return_info.distanceFromOrigin)
+            {
+                return_info.doIntersect = true;
+                return_info.itBackfaces = this_info.itBackfaces;
+                return_info.distanceFromOrigin = this_info.distanceFromOrigin;
+                return_info.triangle_index = i;
+                return_info.baryPosition = this_info.baryPosition;
+            }
+        }
+
+        return return_info;
+    }
+
+    struct RaysStats
+    {
+        size_t raysCount = 0;
+        size_t hitsCount = 0;
+        size_t tiesCount = 0;
+        size_t localSpaceHitMismatchesCount = 0;
+        size_t localSpaceTieFlipsCount = 0;
+        size_t worldSpaceHitMismatchesCount = 0;
+    };
+
+    void CompareRay(const Ray& ray, const OBBtree& obb_tree, size_t triangles_count, const glm::mat4& matrix, RaysStats& stats)
+    {
+        RayOBBtreeIntersectInfo traversal_info = ray.IntersectOBBtree(obb_tree, matrix);
+
+        // The ray at tree's space, the way IntersectOBBtree moves it
+        glm::mat4 inverse_matrix = glm::inverse(matrix);
+        Ray local_ray(glm::vec3(inverse_matrix * glm::vec4(ray.GetOrigin(), 1.f)),
+                      glm::vec3(inverse_matrix * glm::vec4(ray.GetDirection(), 0.f)));
+        RayOBBtreeIntersectInfo local_info = IntersectAllTriangles(local_ray, obb_tree, triangles_count, glm::mat4(1.f));
+        if (glm::determinant(glm::mat3(matrix)) < 0.f)
+            local_info.itBackfaces = not local_info.itBackfaces;
+
+        ++stats.raysCount;
+        stats.hitsCount += traversal_info.doIntersect ? 1 : 0;
+
+        // Ray.cpp may contract the ray's transform and the triangle test to other fused multiply-adds than this file,
+        // so hits on edges and ties can round the other way: counted, not failed
+        if (traversal_info.doIntersect != local_info.doIntersect)
+        {
+            ++stats.localSpaceHitMismatchesCount;
+        }
+        else if (traversal_info.doIntersect)
+        {
+            float tolerance = 1.e-4f * std::max(1.f, local_info.distanceFromOrigin);
+            CHECK(std::abs(traversal_info.distanceFromOrigin - local_info.distanceFromOrigin) < tolerance);
+            if (traversal_info.triangle_index != local_info.triangle_index)
+            {
+                RayTriangleIntersectInfo traversal_triangle_info = local_ray.IntersectTriangle(obb_tree.GetTrianglePosition(traversal_info.triangle_index));
+                CHECK(traversal_triangle_info.doIntersect);
+                CHECK(std::abs(traversal_triangle_info.distanceFromOrigin - local_info.distanceFromOrigin) < tolerance);
+                ++stats.localSpaceTieFlipsCount;
+            }
+            else
+            {
+                CHECK(traversal_info.itBackfaces == local_info.itBackfaces);
+            }
+        }
+
+        // Rays through the vertices grid hit several triangles at the same distance
+        if (local_info.doIntersect)
+        {
+            for (size_t i = local_info.triangle_index + 1; i != triangles_count; ++i)
+            {
+                RayTriangleIntersectInfo this_info = local_ray.IntersectTriangle(obb_tree.GetTrianglePosition(i));
+                if (this_info.doIntersect && this_info.distanceFromOrigin == local_info.distanceFromOrigin)
+                {
+                    ++stats.tiesCount;
+                    break;
+                }
+            }
+        }
+
+        // World space, the way the traversal before this one moved every triangle: distances agree up to rounding,
+        // hit or miss may only differ for rays grazing an edge
+        RayOBBtreeIntersectInfo world_info = IntersectAllTriangles(ray, obb_tree, triangles_count, matrix);
+        if (world_info.doIntersect != traversal_info.doIntersect)
+        {
+            ++stats.worldSpaceHitMismatchesCount;
+        }
+        else if (world_info.doIntersect)
+        {
+            float tolerance = 1.e-4f * std::max(1.f, world_info.distanceFromOrigin);
+            CHECK(std::abs(world_info.distanceFromOrigin - traversal_info.distanceFromOrigin) < tolerance);
+        }
+    }
+
+    glm::mat4 CreateScaleMatrix(glm::vec3 scale)
+    {
+        glm::mat4 matrix = glm::mat4(1.f);
+        matrix[0][0] = scale.x;
+        matrix[1][1] = scale.y;
+        matrix[2][2] = scale.z;
+        return matrix;
+    }
+
+    void CompareMesh(const char* mesh_name, TestsRandom& random, const std::vector<Triangle>& triangles, OBBtreeBuilder builder)
+    {
+        OBBtree obb_tree(std::vector<Triangle>(triangles), builder);
+
+        const glm::mat4 matrices[] = {glm::mat4(1.f),
+                                      CreateTranslationRotationMatrix(glm::vec3(3.f, -1.f, 2.f), glm::normalize(glm::vec3(1.f, 2.f, 3.f)), 0.7f),
+                                      CreateTranslationRotationMatrix(glm::vec3(-2.f, 0.5f, 1.f)) * CreateScaleMatrix(glm::vec3(2.f, 0.5f, 1.3f)),
+                                      CreateScaleMatrix(glm::vec3(-1.f, 1.f, 1.f))};
+
+        RaysStats stats;
+        for (const glm::mat4& this_matrix : matrices)
+        {
+            glm::vec3 mesh_center = glm::vec3(this_matrix * glm::vec4(0.f, 0.f, 0.f, 1.f));
+
+            // Random rays from around the mesh towards it
+            for (size_t i = 0; i != 2000; ++i)
+            {
+                glm::vec3 origin = mesh_center + 4.f * random.NextDirection();
+                glm::vec3 target = mesh_center + random.NextVec3(-1.f, 1.f);
+                CompareRay(Ray(origin, target - origin), obb_tree, triangles.size(), this_matrix, stats);
+            }
+
+            // Axis aligned rays through the grid of vertices, where triangles tie
+            for (int x = -8; x <= 8; ++x)
+                for (int y = -8; y <= 8; ++y)
+                    CompareRay(Ray(mesh_center + glm::vec3(float(x) / 8.f, float(y) / 8.f, 5.f), glm::vec3(0.f, 0.f, -1.f)),
+                               obb_tree, triangles.size(), this_matrix, stats);
+        }
+
+        CHECK(stats.hitsCount > stats.raysCount / 4);
+        // Hit or miss flips only for rays grazing an edge at the rim of the mesh
+        CHECK(stats.localSpaceHitMismatchesCount * 1000 <= stats.raysCount);
+        CHECK(stats.localSpaceTieFlipsCount * 1000 <= stats.raysCount);
+        CHECK(stats.worldSpaceHitMismatchesCount * 1000 <= stats.raysCount);
+
+        printf("%s: %zu rays, %zu hits, %zu ties, %zu/%zu hit-or-miss/tie differences to tree space, %zu hit-or-miss differences to world space\n",
+               mesh_name, stats.raysCount, stats.hitsCount, stats.tiesCount,
+               stats.localSpaceHitMismatchesCount, stats.localSpaceTieFlipsCount, stats.worldSpaceHitMismatchesCount);
+    }
+}
+
+int main()
+{
+    TestsRandom random(13);
+
+    for (OBBtreeBuilder this_builder : {OBBtreeBuilder::midpoint, OBBtreeBuilder::SAH})
+    {
+        CompareMesh("box", random, CreateBoxTriangles(glm::vec3(1.f, 1.f, 1.f), 8), this_builder);
+        CompareMesh("ellipsoid", random, CreateEllipsoidTriangles(glm::vec3(1.2f, 0.8f, 0.5f), 16, 32), this_builder);
+        CompareMesh("soup", random, CreateTrianglesSoup(random, 500, 1.f, 0.3f), this_builder);
+    }
+
+    return GetChecksResult("RayOBBtreeTest");
+}
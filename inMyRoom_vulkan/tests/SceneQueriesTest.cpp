@@ -0,0 +1,384 @@
+// SceneQueries against brute force over every entry and every triangle: Raycast at its 3 modes, OverlapBox, OverlapSphere
+// and NearestEntities, on random scenes of boxes, ellipsoids and triangle soups. Then the queries per second of each,
+// at 1k and 10k entities
+
+#include <array>
+#include <memory>
+
+#include "TestsCommon.h"
+#include "CollisionDetection/SceneQueries.h"
+#include "Geometry/OBBtree.h"
+#include "Geometry/Ray.h"
+#include "Geometry/Sphere.h"
+
+namespace
+{
+    std::array<glm::vec3, 3> GetBroadPhaseAxes()
+    {
+        glm::vec3 U_axis = glm::normalize(glm::vec3(0.8f, -0.2f, 0.f));
+        glm::vec3 W_axis = glm::normalize(glm::cross(U_axis, glm::vec3(0.f, -1.f, 0.f)));
+        glm::vec3 V_axis = glm::normalize(glm::cross(W_axis, U_axis));
+
+        return {U_axis, V_axis, W_axis};
+    }
+
+    // Boxes, a flat one, ellipsoids and triangle soups, with their triangles' counts for brute force
+    struct QueriesShapes
+    {
+        std::vector<std::unique_ptr<OBBtree>> OBBtrees;
+        std::vector<size_t> trianglesCounts;
+
+        QueriesShapes()
+        {
+            TestsRandom random(18);
+            AddShape(CreateBoxTriangles(glm::vec3(0.8f, 0.4f, 0.6f), 2));
+            AddShape(CreateBoxTriangles(glm::vec3(1.5f, 0.02f, 1.f), 1));
+            AddShape(CreateEllipsoidTriangles(glm::vec3(0.7f, 0.5f, 0.4f), 8, 16));
+            AddShape(CreateTrianglesSoup(random, 60, 1.f, 0.4f));
+        }
+
+        void AddShape(std::vector<Triangle>&& triangles)
+        {
+            trianglesCounts.emplace_back(triangles.size());
+            OBBtrees.emplace_back(std::make_unique<OBBtree>(std::move(triangles)));
+        }
+    };
+
+    struct QueriesScene
+    {
+        std::vector<CollisionDetectionEntry> entries;
+        // Bounding spheres of the entries' root OBBs, so brute force skips far entries without the engine's tests
+        std::vector<Sphere> entriesBoundingSpheres;
+        std::vector<size_t> entriesTrianglesCounts;
+        float halfExtent = 0.f;
+    };
+
+    QueriesScene CreateScene(TestsRandom& random, const QueriesShapes& shapes, size_t entities_count)
+    {
+        // About the same density at any count
+        QueriesScene scene;
+        scene.halfExtent = 3.f * std::cbrt(float(entities_count));
+        for (size_t i = 0; i != entities_count; ++i)
+        {
+            CollisionDetectionEntry this_entry = {};
+            this_entry.currentGlobalMatrix = CreateTranslationRotationMatrix(random.NextVec3(-scene.halfExtent, scene.halfExtent),
+                                                                             random.NextDirection(), random.NextFloat(0.f, 6.28f));
+            this_entry.previousGlobalMatrix = this_entry.currentGlobalMatrix;
+            size_t shape_index = random.NextUint() % shapes.OBBtrees.size();
+            this_entry.OBBtree_ptr = shapes.OBBtrees[shape_index].get();
+            this_entry.shouldCallback = true;
+            this_entry.isStatic = true;
+            this_entry.entity = Entity(3 * i + 7);          // not the entries' order
+            scene.entries.emplace_back(this_entry);
+
+            OBB root_OBB = this_entry.OBBtree_ptr->GetRootOBB();
+            float radius = glm::length(root_OBB.GetSideDirectionU() + root_OBB.GetSideDirectionV() + root_OBB.GetSideDirectionW());
+            scene.entriesBoundingSpheres.emplace_back(glm::vec3(this_entry.currentGlobalMatrix * glm::vec4(root_OBB.GetCenter(), 1.f)), radius);
+            scene.entriesTrianglesCounts.emplace_back(shapes.trianglesCounts[shape_index]);
+        }
+
+        return scene;
+    }
+
+    bool DoSpheresOverlap(const Sphere& lhs, const Sphere& rhs)
+    {
+        return glm::length(lhs.GetOrigin() - rhs.GetOrigin()) <= lhs.GetRadius() + rhs.GetRadius() + 1.e-3f;
+    }
+
+    // Brute force of the triangle tests below, over every triangle of the entries near the shape
+    template<typename TriangleTest>
+    std::vector<Entity> OverlapBruteForce(const QueriesScene& scene, const Sphere& shape_bounding_sphere, TriangleTest&& triangle_test)
+    {
+        std::vector<Entity> return_entities;
+        for (size_t entry_index = 0; entry_index != scene.entries.size(); ++entry_index)
+        {
+            if (not DoSpheresOverlap(scene.entriesBoundingSpheres[entry_index], shape_bounding_sphere))
+                continue;
+
+            const CollisionDetectionEntry& this_entry = scene.entries[entry_index];
+            const OBBtree& this_OBBtree = *this_entry.OBBtree_ptr;
+            for (size_t index = 0; index != scene.entriesTrianglesCounts[entry_index]; ++index)
+            {
+                if (triangle_test(this_entry.currentGlobalMatrix * this_OBBtree.GetTrianglePosition(index)))
+                {
+                    return_entities.emplace_back(this_entry.entity);
+                    break;
+                }
+            }
+        }
+
+        std::sort(return_entities.begin(), return_entities.end());
+        return return_entities;
+    }
+
+    // Same separating axes as SceneQueries.cpp's, of the box's faces, the triangle's face and their edges' cross products
+    bool IntersectBoxTriangle(const Paralgram& box, const TrianglePosition& triangle)
+    {
+        const glm::vec3 box_sides[3] = {box.GetSideDirectionU(), box.GetSideDirectionV(), box.GetSideDirectionW()};
+        const glm::vec3 triangle_edges[3] = {triangle.GetP(1) - triangle.GetP(0), triangle.GetP(2) - triangle.GetP(1), triangle.GetP(0) - triangle.GetP(2)};
+
+        std::vector<glm::vec3> axes = {glm::cross(box_sides[1], box_sides[2]), glm::cross(box_sides[2], box_sides[0]),
+                                       glm::cross(box_sides[0], box_sides[1]), glm::cross(triangle_edges[0], triangle_edges[1])};
+        for (const glm::vec3& this_side : box_sides)
+            for (const glm::vec3& this_edge : triangle_edges)
+                axes.emplace_back(glm::cross(this_side, this_edge));
+
+        for (const glm::vec3& this_axis : axes)
+        {
+            std::pair<float, float> box_projection = box.GetMinMaxProjectionToAxis(this_axis);
+            std::pair<float, float> triangle_projection = triangle.GetMinMaxProjectionToAxis(this_axis);
+            if (box_projection.second < triangle_projection.first || triangle_projection.second < box_projection.first)
+                return false;
+        }
+
+        return true;
+    }
+
+    // Nearest hit of every entry within the distance, as (entity, distance) sorted by entity
+    std::vector<std::pair<Entity, float>> RaycastBruteForce(const QueriesScene& scene, const Ray& ray, float max_distance)
+    {
+        std::vector<std::pair<Entity, float>> hits;
+        for (const CollisionDetectionEntry& this_entry : scene.entries)
+        {
+            RayOBBtreeIntersectInfo this_intersection = ray.IntersectOBBtree(*this_entry.OBBtree_ptr, this_entry.currentGlobalMatrix);
+            if (this_intersection.doIntersect && this_intersection.distanceFromOrigin <= max_distance)
+                hits.emplace_back(this_entry.entity, this_intersection.distanceFromOrigin);
+        }
+
+        std::sort(hits.begin(), hits.end());
+        return hits;
+    }
+
+    // Distance of the nearest point of the entry's root OBB, the exact one for matrices without shear
+    float GetDistanceToRootOBB(const CollisionDetectionEntry& entry, const glm::vec3& point)
+    {
+        const OBB root_OBB = entry.OBBtree_ptr->GetRootOBB();
+        const glm::mat4 inverse_matrix = glm::inverse(entry.currentGlobalMatrix);
+        const glm::vec3 local_offset = glm::vec3(inverse_matrix * glm::vec4(point, 1.f)) - root_OBB.GetCenter();
+
+        glm::vec3 local_closest_point = root_OBB.GetCenter();
+        for (const glm::vec3& this_side : {root_OBB.GetSideDirectionU(), root_OBB.GetSideDirectionV(), root_OBB.GetSideDirectionW()})
+        {
+            float side_length_squared = glm::dot(this_side, this_side);
+            if (side_length_squared > 0.f)
+                local_closest_point += this_side * std::clamp(glm::dot(local_offset, this_side) / side_length_squared, -1.f, 1.f);
+        }
+
+        return glm::length(point - glm::vec3(entry.currentGlobalMatrix * glm::vec4(local_closest_point, 1.f)));
+    }
+
+    bool AreDistancesClose(float lhs, float rhs)
+    {
+#if !defined(__FMA__)
+        return lhs == rhs;
+#else
+        return std::abs(lhs - rhs) <= 1.e-5f * std::max(1.f, std::abs(rhs));
+#endif
+    }
+
+    struct QueriesStats
+    {
+        size_t queriesCount = 0;
+        size_t resultsCount = 0;
+        size_t mismatchesCount = 0;
+    };
+
+    void CheckRaycasts(TestsRandom& random, const QueriesScene& scene, const SceneQueries& scene_queries, size_t rays_count, QueriesStats& stats)
+    {
+        for (size_t i = 0; i != rays_count; ++i)
+        {
+            glm::vec3 origin = random.NextVec3(-scene.halfExtent, scene.halfExtent);
+            glm::vec3 direction = random.NextDirection();
+            float max_distance = random.NextFloat(1.f, 2.f * scene.halfExtent);
+
+            // Raycast normalizes the direction again, which may change its last bits, and with fused multiply-adds differently than here
+            std::vector<std::pair<Entity, float>> brute_force_hits = RaycastBruteForce(scene, Ray(origin, glm::normalize(direction)), max_distance);
+            float nearest_distance = std::numeric_limits<float>::infinity();
+            for (const auto& [entity, distance] : brute_force_hits)
+                nearest_distance = std::min(nearest_distance, distance);
+
+            auto is_brute_force_hit = [&brute_force_hits](const SceneRaycastHit& hit)
+            {
+                auto search = std::lower_bound(brute_force_hits.begin(), brute_force_hits.end(), std::make_pair(hit.entity, -std::numeric_limits<float>::infinity()));
+                return search != brute_force_hits.end() && search->first == hit.entity && AreDistancesClose(hit.distance, search->second);
+            };
+
+            std::vector<SceneRaycastHit> all_hits = scene_queries.Raycast(origin, direction, max_distance, SceneRaycastMode::All);
+            std::vector<SceneRaycastHit> closest_hits = scene_queries.Raycast(origin, direction, max_distance, SceneRaycastMode::Closest);
+            std::vector<SceneRaycastHit> any_hits = scene_queries.Raycast(origin, direction, max_distance, SceneRaycastMode::Any);
+
+            bool is_all_right = all_hits.size() == brute_force_hits.size() &&
+                                std::is_sorted(all_hits.begin(), all_hits.end(), [](const auto& lhs, const auto& rhs) {return lhs.distance < rhs.distance;}) &&
+                                std::all_of(all_hits.begin(), all_hits.end(), is_brute_force_hit);
+
+            // Ties of the nearest distance may go to any of their entities
+            bool is_closest_right = brute_force_hits.empty() ? closest_hits.empty()
+                                                             : closest_hits.size() == 1 && AreDistancesClose(closest_hits[0].distance, nearest_distance) && is_brute_force_hit(closest_hits[0]);
+
+            bool is_any_right = brute_force_hits.empty() ? any_hits.empty()
+                                                         : any_hits.size() == 1 && is_brute_force_hit(any_hits[0]);
+
+            stats.queriesCount += 3;
+            stats.resultsCount += all_hits.size() + closest_hits.size() + any_hits.size();
+            stats.mismatchesCount += (is_all_right ? 0 : 1) + (is_closest_right ? 0 : 1) + (is_any_right ? 0 : 1);
+        }
+    }
+
+    void CheckOverlaps(TestsRandom& random, const QueriesScene& scene, const SceneQueries& scene_queries, size_t queries_count,
+                       QueriesStats& box_stats, QueriesStats& sphere_stats)
+    {
+        for (size_t i = 0; i != queries_count; ++i)
+        {
+            glm::vec3 center = random.NextVec3(-scene.halfExtent, scene.halfExtent);
+            glm::mat4 rotation = CreateTranslationRotationMatrix(glm::vec3(0.f), random.NextDirection(), random.NextFloat(0.f, 6.28f));
+            glm::vec3 half_extents = random.NextVec3(0.05f, 4.f);
+            glm::vec3 half_side_u = glm::vec3(rotation * glm::vec4(half_extents.x, 0.f, 0.f, 0.f));
+            glm::vec3 half_side_v = glm::vec3(rotation * glm::vec4(0.f, half_extents.y, 0.f, 0.f));
+            glm::vec3 half_side_w = glm::vec3(rotation * glm::vec4(0.f, 0.f, half_extents.z, 0.f));
+
+            const Paralgram box(center, half_side_u, half_side_v, half_side_w);
+            std::vector<Entity> box_entities = scene_queries.OverlapBox(center, half_side_u, half_side_v, half_side_w);
+            std::vector<Entity> box_brute_force_entities = OverlapBruteForce(scene, Sphere(center, glm::length(half_extents)),
+                                                                             [&box](const TrianglePosition& triangle) {return IntersectBoxTriangle(box, triangle);});
+
+            ++box_stats.queriesCount;
+            box_stats.resultsCount += box_brute_force_entities.size();
+            box_stats.mismatchesCount += box_entities != box_brute_force_entities ? 1 : 0;
+
+            const Sphere sphere(center, random.NextFloat(0.05f, 4.f));
+            std::vector<Entity> sphere_entities = scene_queries.OverlapSphere(sphere.GetOrigin(), sphere.GetRadius());
+            std::vector<Entity> sphere_brute_force_entities = OverlapBruteForce(scene, sphere,
+                                                                                [&sphere](const TrianglePosition& triangle) {return sphere.IntersectTriangle(triangle);});
+
+            ++sphere_stats.queriesCount;
+            sphere_stats.resultsCount += sphere_brute_force_entities.size();
+            sphere_stats.mismatchesCount += sphere_entities != sphere_brute_force_entities ? 1 : 0;
+        }
+    }
+
+    void CheckNearest(TestsRandom& random, const QueriesScene& scene, const SceneQueries& scene_queries, size_t queries_count, QueriesStats& stats)
+    {
+        for (size_t i = 0; i != queries_count; ++i)
+        {
+            glm::vec3 point = random.NextVec3(-scene.halfExtent * 1.2f, scene.halfExtent * 1.2f);
+            size_t count = std::array<size_t, 4>{1, 4, 16, 64}[i % 4];
+
+            std::vector<std::pair<float, Entity>> brute_force_distances;
+            for (const CollisionDetectionEntry& this_entry : scene.entries)
+                brute_force_distances.emplace_back(GetDistanceToRootOBB(this_entry, point), this_entry.entity);
+            std::sort(brute_force_distances.begin(), brute_force_distances.end());
+
+            std::vector<SceneNearestEntity> nearest_entities = scene_queries.NearestEntities(point, count);
+
+            // Every entity at its own distance, the distances the count smallest ones; ties at the last may go to any entity
+            bool is_right = nearest_entities.size() == std::min(count, scene.entries.size());
+            for (size_t j = 0; is_right && j != nearest_entities.size(); ++j)
+            {
+                auto search = std::find_if(brute_force_distances.begin(), brute_force_distances.end(),
+                                           [&nearest_entities, j](const auto& distance_entity) {return distance_entity.second == nearest_entities[j].entity;});
+                is_right = AreDistancesClose(nearest_entities[j].distance, search->first) &&
+                           AreDistancesClose(nearest_entities[j].distance, brute_force_distances[j].first);
+            }
+
+            ++stats.queriesCount;
+            stats.resultsCount += nearest_entities.size();
+            stats.mismatchesCount += is_right ? 0 : 1;
+        }
+    }
+
+    void PrintAndCheckStats(const char* query_name, const QueriesStats& stats)
+    {
+        printf("    %-16s %5zu queries, %7zu results, %zu mismatches\n", query_name, stats.queriesCount, stats.resultsCount, stats.mismatchesCount);
+        CHECK(stats.resultsCount != 0);
+#if !defined(__FMA__)
+        CHECK(stats.mismatchesCount == 0);
+#else
+        // This file's copies of the triangle tests may contract to other fused multiply-adds than SceneQueries.cpp's
+        CHECK(stats.mismatchesCount * 100 <= stats.queriesCount);
+#endif
+    }
+
+    void CheckScene(TestsRandom& random, const QueriesShapes& shapes, size_t entities_count, size_t queries_count)
+    {
+        QueriesScene scene = CreateScene(random, shapes, entities_count);
+
+        const std::array<glm::vec3, 3> axes = GetBroadPhaseAxes();
+        SceneQueries scene_queries(axes[0], axes[1], axes[2]);
+        scene_queries.Update(scene.entries);
+
+        QueriesStats raycast_stats, box_stats, sphere_stats, nearest_stats;
+        CheckRaycasts(random, scene, scene_queries, queries_count, raycast_stats);
+        CheckOverlaps(random, scene, scene_queries, queries_count, box_stats, sphere_stats);
+        CheckNearest(random, scene, scene_queries, queries_count, nearest_stats);
+
+        printf("%zu entities:\n", entities_count);
+        PrintAndCheckStats("Raycast", raycast_stats);
+        PrintAndCheckStats("OverlapBox", box_stats);
+        PrintAndCheckStats("OverlapSphere", sphere_stats);
+        PrintAndCheckStats("NearestEntities", nearest_stats);
+    }
+
+    void Benchmark(TestsRandom& random, const QueriesShapes& shapes, size_t entities_count)
+    {
+        QueriesScene scene = CreateScene(random, shapes, entities_count);
+
+        const std::array<glm::vec3, 3> axes = GetBroadPhaseAxes();
+        SceneQueries scene_queries(axes[0], axes[1], axes[2]);
+        double update_time = MeasureBestTime(3, [&]() {scene_queries.Update(scene.entries);});
+
+        const size_t queries_count = 2000;
+        std::vector<glm::vec3> points, directions;
+        for (size_t i = 0; i != queries_count; ++i)
+        {
+            points.emplace_back(random.NextVec3(-scene.halfExtent, scene.halfExtent));
+            directions.emplace_back(random.NextDirection());
+        }
+
+        size_t results_count = 0;
+        auto measure_queries_per_second = [&](auto&& query)
+        {
+            double time = MeasureBestTime(3, [&]()
+            {
+                for (size_t i = 0; i != queries_count; ++i)
+                    results_count += query(points[i], directions[i]);
+            });
+            return double(queries_count) / time;
+        };
+
+        const float ray_distance = scene.halfExtent;
+        double closest_rate = measure_queries_per_second([&](const glm::vec3& point, const glm::vec3& direction)
+                                                         {return scene_queries.Raycast(point, direction, ray_distance, SceneRaycastMode::Closest).size();});
+        double any_rate = measure_queries_per_second([&](const glm::vec3& point, const glm::vec3& direction)
+                                                     {return scene_queries.Raycast(point, direction, ray_distance, SceneRaycastMode::Any).size();});
+        double all_rate = measure_queries_per_second([&](const glm::vec3& point, const glm::vec3& direction)
+                                                     {return scene_queries.Raycast(point, direction, ray_distance, SceneRaycastMode::All).size();});
+        double box_rate = measure_queries_per_second([&](const glm::vec3& point, const glm::vec3& direction)
+                                                     {return scene_queries.OverlapBox(point, 2.f * direction, glm::vec3(0.f, 1.f, 0.f), glm::vec3(1.f, 0.f, 0.f)).size();});
+        double sphere_rate = measure_queries_per_second([&](const glm::vec3& point, const glm::vec3&)
+                                                        {return scene_queries.OverlapSphere(point, 2.f).size();});
+        double nearest_rate = measure_queries_per_second([&](const glm::vec3& point, const glm::vec3&)
+                                                         {return scene_queries.NearestEntities(point, 8).size();});
+        double brute_force_rate = measure_queries_per_second([&](const glm::vec3& point, const glm::vec3& direction)
+                                                             {return RaycastBruteForce(scene, Ray(point, direction), ray_distance).size();});
+
+        printf("%6zu entities, update %.3f ms | thousand queries/s: raycast closest %.1f, any %.1f, all %.1f, brute force %.1f | "
+               "box %.1f, sphere %.1f, nearest 8 %.1f (%zu results)\n",
+               entities_count, update_time * 1.e3, closest_rate / 1.e3, any_rate / 1.e3, all_rate / 1.e3, brute_force_rate / 1.e3,
+               box_rate / 1.e3, sphere_rate / 1.e3, nearest_rate / 1.e3, results_count);
+    }
+}
+
+int main()
+{
+    TestsRandom random(18);
+    QueriesShapes shapes;
+
+    CheckScene(random, shapes, 1, 100);
+    CheckScene(random, shapes, 1000, 400);
+    CheckScene(random, shapes, 10000, 100);
+
+    Benchmark(random, shapes, 1000);
+    Benchmark(random, shapes, 10000);
+
+    return GetChecksResult("SceneQueriesTest");
+}
@@ -0,0 +1,143 @@
+// spsc_ring with its pending queue, the way InputManager hands input from the input thread to the main thread: a small ring
+// overflowing deterministically, then a producer and a consumer thread with sequenced events, checking on the consumer's side
+// that every event comes once and in order, and how late
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "TestsCommon.h"
+#include "spsc_ring.h"
+
+namespace
+{
+    struct SequencedEvent
+    {
+        uint64_t sequence = 0;
+        std::chrono::steady_clock::time_point timePoint;
+    };
+
+    void CheckOverflow()
+    {
+        spsc_ring<uint32_t, 4> ring;
+        std::deque<uint32_t> pending;
+        std::vector<uint32_t> popped;
+
+        auto pop_all = [&]()
+        {
+            uint32_t value;
+            while (ring.try_pop(value))
+                popped.emplace_back(value);
+        };
+
+        // 4 fit, the rest wait at the pending queue
+        for (uint32_t i = 0; i != 10; ++i)
+            push_or_keep_pending(ring, pending, i);
+        CHECK(ring.size() == 4);
+        CHECK(pending.size() == 6);
+
+        // A consumer that takes some makes room for the oldest pending ones, never for a new one before them
+        uint32_t value = 0;
+        CHECK(ring.try_pop(value) && value == 0);
+        CHECK(ring.try_pop(value) && value == 1);
+        popped = {0, 1};
+        push_or_keep_pending(ring, pending, 10u);
+        CHECK(ring.size() == 4);
+        CHECK(pending.size() == 5);
+
+        // Flushing without new values, as FlushPendingEvents when no input comes
+        CHECK(push_pending(ring, pending));
+        pop_all();
+        CHECK(push_pending(ring, pending) && pending.size() == 1);
+        pop_all();
+        CHECK(not push_pending(ring, pending));
+        pop_all();
+
+        CHECK(pending.empty());
+        CHECK(ring.empty());
+        CHECK(popped.size() == 11);
+        for (uint32_t i = 0; i != popped.size(); ++i)
+            CHECK(popped[i] == i);
+    }
+
+    // The consumer stalls now and then, as a main thread's long frame. A producer without interval floods the ring, so the pending
+    // queue takes over; one with an interval is closer to input, and its latency is the handing over's
+    void CheckTwoThreads(size_t events_count, std::chrono::microseconds producer_interval, size_t stall_every, std::chrono::microseconds stall_time)
+    {
+        spsc_ring<SequencedEvent, 4096> ring;
+        std::atomic<bool> has_producer_finished = false;
+        size_t max_pending_size = 0;
+
+        std::thread producer_thread([&]()
+        {
+            std::deque<SequencedEvent> pending;
+            for (uint64_t i = 0; i != events_count; ++i)
+            {
+                auto push_time = std::chrono::steady_clock::now();
+                push_or_keep_pending(ring, pending, SequencedEvent{i, push_time});
+                max_pending_size = std::max(max_pending_size, pending.size());
+
+                while (std::chrono::steady_clock::now() - push_time < producer_interval)
+                    std::this_thread::yield();
+            }
+
+            while (push_pending(ring, pending))
+                std::this_thread::yield();
+
+            has_producer_finished.store(true, std::memory_order_release);
+        });
+
+        size_t received_count = 0;
+        size_t out_of_order_count = 0;
+        uint64_t expected_sequence = 0;
+        std::vector<double> latencies;
+        latencies.reserve(events_count);
+
+        SequencedEvent this_event;
+        while (true)
+        {
+            if (ring.try_pop(this_event))
+            {
+                latencies.emplace_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - this_event.timePoint).count());
+                out_of_order_count += this_event.sequence != expected_sequence ? 1 : 0;
+                expected_sequence = this_event.sequence + 1;
+
+                if (++received_count % stall_every == 0)
+                    std::this_thread::sleep_for(stall_time);
+            }
+            else if (has_producer_finished.load(std::memory_order_acquire) && ring.empty())
+            {
+                break;
+            }
+            else
+            {
+                std::this_thread::yield();
+            }
+        }
+
+        producer_thread.join();
+
+        CHECK(received_count == events_count);
+        CHECK(out_of_order_count == 0);
+        if (producer_interval.count() == 0)
+            CHECK(max_pending_size != 0);
+
+        std::sort(latencies.begin(), latencies.end());
+        auto get_percentile = [&latencies](double percentile) {return latencies.empty() ? 0. : latencies[size_t(percentile * double(latencies.size() - 1))];};
+        printf("%zu events every %lld us, consumer stalls %lld us every %zu: %zu received, %zu out of order, up to %zu pending | "
+               "latency us: median %.1f, 99%% %.1f, max %.1f\n",
+               events_count, static_cast<long long>(producer_interval.count()), static_cast<long long>(stall_time.count()), stall_every, received_count, out_of_order_count, max_pending_size,
+               get_percentile(0.5), get_percentile(0.99), get_percentile(1.));
+    }
+}
+
+int main()
+{
+    CheckOverflow();
+
+    CheckTwoThreads(1000000, std::chrono::microseconds(0), 100000, std::chrono::microseconds(2000));
+    CheckTwoThreads(200000, std::chrono::microseconds(0), 1000, std::chrono::microseconds(100));
+    CheckTwoThreads(10000, std::chrono::microseconds(20), 2500, std::chrono::microseconds(2000));
+
+    return GetChecksResult("SpscRingTest");
+}
@@ -0,0 +1,168 @@
+#include "TestsCommon.h"
+
+#include <cmath>
+
+#include "glm/gtc/matrix_transform.hpp"
+
+size_t& GetFailedChecksCount()
+{
+    static size_t failed_checks_count = 0;
+    return failed_checks_count;
+}
+
+int GetChecksResult(const char* test_name)
+{
+    if (GetFailedChecksCount() == 0)
+    {
+        printf("%s: passed\n", test_name);
+        return 0;
+    }
+    else
+    {
+        printf("%s: %zu checks failed\n", test_name, GetFailedChecksCount());
+        return 1;
+    }
+}
+
+uint32_t TestsRandom::NextUint()
+{
+    // xorshift64*
+    state ^= state >> 12;
+    state ^= state << 25;
+    state ^= state >> 27;
+    return uint32_t((state * 0x2545f4914f6cdd1dull) >> 32);
+}
+
+float TestsRandom::NextFloat(float min, float max)
+{
+    float unit = float(NextUint() >> 8) / float(1u << 24);
+    return min + (max - min) * unit;
+}
+
+glm::vec3 TestsRandom::NextVec3(float min, float max)
+{
+    float x = NextFloat(min, max);
+    float y = NextFloat(min, max);
+    float z = NextFloat(min, max);
+    return glm::vec3(x, y, z);
+}
+
+glm::vec3 TestsRandom::NextDirection()
+{
+    glm::vec3 direction = NextVec3(-1.f, 1.f);
+    while (glm::length(direction) < 0.1f || glm::length(direction) > 1.f)
+        direction = NextVec3(-1.f, 1.f);
+
+    return glm::normalize(direction);
+}
+
+std::vector<Triangle> CreateBoxTriangles(glm::vec3 half_extents, size_t face_subdivisions)
+{
+    std::vector<glm::vec3> points;
+    std::vector<uint32_t> indices;
+
+    // Every face is a grid at its plane, "u" cross "v" points outwards
+    const glm::vec3 faces_normals[6] = {glm::vec3(+1.f, 0.f, 0.f), glm::vec3(-1.f, 0.f, 0.f),
+                                        glm::vec3(0.f, +1.f, 0.f), glm::vec3(0.f, -1.f, 0.f),
+                                        glm::vec3(0.f, 0.f, +1.f), glm::vec3(0.f, 0.f, -1.f)};
+    for (const glm::vec3& this_normal : faces_normals)
+    {
+        glm::vec3 u = glm::vec3(this_normal.y, this_normal.z, this_normal.x);
+        glm::vec3 v = glm::cross(this_normal, u);
+
+        uint32_t first_point_index = uint32_t(points.size());
+        for (size_t i = 0; i != face_subdivisions + 1; ++i)
+        {
+            for (size_t j = 0; j != face_subdivisions + 1; ++j)
+            {
+                float s = 2.f * float(i) / float(face_subdivisions) - 1.f;
+                float t = 2.f * float(j) / float(face_subdivisions) - 1.f;
+                points.emplace_back((this_normal + s * u + t * v) * half_extents);
+            }
+        }
+
+        for (uint32_t i = 0; i != uint32_t(face_subdivisions); ++i)
+        {
+            for (uint32_t j = 0; j != uint32_t(face_subdivisions); ++j)
+            {
+                uint32_t p00 = first_point_index + i * uint32_t(face_subdivisions + 1) + j;
+                uint32_t p10 = p00 + uint32_t(face_subdivisions + 1);
+                uint32_t p01 = p00 + 1;
+                uint32_t p11 = p10 + 1;
+                indices.insert(indices.end(), {p00, p10, p11, p00, p11, p01});
+            }
+        }
+    }
+
+    return Triangle::CreateTriangleList(points, {}, indices, glTFmode::triangles);
+}
+
+std::vector<Triangle> CreateEllipsoidTriangles(glm::vec3 radii, size_t rings, size_t segments)
+{
+    std::vector<glm::vec3> points;
+    std::vector<uint32_t> indices;
+
+    const float pi = 3.14159265f;
+    for (size_t i = 0; i != rings + 1; ++i)
+    {
+        float theta = pi * float(i) / float(rings);
+        for (size_t j = 0; j != segments + 1; ++j)
+        {
+            float phi = 2.f * pi * float(j) / float(segments);
+            points.emplace_back(radii * glm::vec3(std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi)));
+        }
+    }
+
+    for (uint32_t i = 0; i != uint32_t(rings); ++i)
+    {
+        for (uint32_t j = 0; j != uint32_t(segments); ++j)
+        {
+            uint32_t p00 = i * uint32_t(segments + 1) + j;
+            uint32_t p10 = p00 + uint32_t(segments + 1);
+            uint32_t p01 = p00 + 1;
+            uint32_t p11 = p10 + 1;
+            if (i != 0)
+                indices.insert(indices.end(), {p00, p01, p11});
+            if (i != uint32_t(rings) - 1)
+                indices.insert(indices.end(), {p00, p11, p10});
+        }
+    }
+
+    return Triangle::CreateTriangleList(points, {}, indices, glTFmode::triangles);
+}
+
+std::vector<Triangle> CreateTrianglesSoup(TestsRandom& random, size_t count, float half_extent, float max_triangle_size)
+{
+    std::vector<glm::vec3> points;
+    std::vector<uint32_t> indices;
+
+    for (size_t i = 0; i != count; ++i)
+    {
+        glm::vec3 center = random.NextVec3(-half_extent, half_extent);
+        for (size_t j = 0; j != 3; ++j)
+        {
+            indices.emplace_back(uint32_t(points.size()));
+            points.emplace_back(center + random.NextDirection() * random.NextFloat(0.1f, 1.f) * max_triangle_size);
+        }
+    }
+
+    return Triangle::CreateTriangleList(points, {}, indices, glTFmode::triangles);
+}
+
+std::vector<TrianglePosition> GetTrianglesPositions(const std::vector<Triangle>& triangles)
+{
+    std::vector<TrianglePosition> triangles_positions;
+    for (const Triangle& this_triangle : triangles)
+        triangles_positions.emplace_back(this_triangle.GetTrianglePosition());
+
+    return triangles_positions;
+}
+
+glm::mat4 CreateTranslationRotationMatrix(glm::vec3 translation, glm::vec3 rotation_axis, float angle)
+{
+    glm::mat4 matrix = glm::translate(glm::mat4(1.f), translation);
+    if (angle != 0.f)
+        matrix = glm::rotate(matrix, angle, rotation_axis);
+
+    return matrix;
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstdio>
+#include <cstdint>
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <vector>
+
+#include "glm/vec3.hpp"
+#include "glm/mat4x4.hpp"
+
+#include "Geometry/Triangle.h"
+
+// Checks of the headless tests. A failed check prints where and is counted, so a test reports every failure at once
+size_t& GetFailedChecksCount();
+
+#define CHECK(condition)                                                                        \
+    do {                                                                                        \
+        if (not (condition)) {                                                                  \
+            printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition);                \
+            ++GetFailedChecksCount();                                                           \
+        }                                                                                       \
+    } while (false)
+
+// Exit code of the test's main
+int GetChecksResult(const char* test_name);
+
+// Same numbers on every platform, unlike std::uniform_real_distribution
+class TestsRandom
+{
+public:
+    explicit TestsRandom(uint64_t seed) : state(seed * 0x9e3779b97f4a7c15ull + 1) {}
+
+    uint32_t NextUint();
+    float NextFloat(float min, float max);
+    glm::vec3 NextVec3(float min, float max);
+    glm::vec3 NextDirection();
+
+private:
+    uint64_t state;
+};
+
+// Closed meshes centered at the origin. Different extents per axis keep their OBBs (of points' covariance) at the mesh's axes
+std::vector<Triangle> CreateBoxTriangles(glm::vec3 half_extents, size_t face_subdivisions = 1);
+std::vector<Triangle> CreateEllipsoidTriangles(glm::vec3 radii, size_t rings, size_t segments);
+// Triangles of random size and orientation inside a cube of "half_extent"
+std::vector<Triangle> CreateTrianglesSoup(TestsRandom& random, size_t count, float half_extent, float max_triangle_size);
+
+std::vector<TrianglePosition> GetTrianglesPositions(const std::vector<Triangle>& triangles);
+
+glm::mat4 CreateTranslationRotationMatrix(glm::vec3 translation, glm::vec3 rotation_axis = glm::vec3(0.f, 1.f, 0.f), float angle = 0.f);
+
+// Best of "repeats" runs, in seconds
+template<typename Func>
+double MeasureBestTime(size_t repeats, Func&& func)
+{
+    double best_time = std::numeric_limits<double>::infinity();
+    for (size_t i = 0; i != repeats; ++i)
+    {
+        auto start_time = std::chrono::steady_clock::now();
+        func();
+        std::chrono::duration<double> this_time = std::chrono::steady_clock::now() - start_time;
+        best_time = std::min(best_time, this_time.count());
+    }
+
+    return best_time;
+}
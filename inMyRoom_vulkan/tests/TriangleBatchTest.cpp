@@ -0,0 +1,201 @@
+// TriangleBatch::IntersectTriangle against TrianglePosition::IntersectTriangles of every triangle of the batch, and the
+// triangle pairs per second of both
+
+#include <bit>
+
+#include "TestsCommon.h"
+#include "Geometry/TriangleBatch.h"
+
+namespace
+{
+    struct PairsStats
+    {
+        size_t pairsCount = 0;
+        size_t intersectionsCount = 0;
+        size_t coplanarCount = 0;
+        size_t mismatchesCount = 0;
+    };
+
+    bool AreSegmentsClose(const TrianglesIntersectionInfo& lhs, const TrianglesIntersectionInfo& rhs, float tolerance)
+    {
+        return glm::length(lhs.source - rhs.source) < tolerance && glm::length(lhs.target - rhs.target) < tolerance;
+    }
+
+    // "triangles" is cut to batches of every size up to the width
+    void CompareBatches(const TrianglePosition& lhs, const std::vector<TrianglePosition>& triangles, PairsStats& stats)
+    {
+        size_t batch_size = 1;
+        for (size_t first = 0; first < triangles.size(); first += batch_size, batch_size = batch_size % TriangleBatch::width + 1)
+        {
+            size_t last = std::min(first + batch_size, triangles.size());
+
+            TriangleBatch batch;
+            for (size_t i = first; i != last; ++i)
+                batch.Add(triangles[i]);
+
+            std::array<TrianglesIntersectionInfo, TriangleBatch::width> batch_infos;
+            uint32_t intersect_mask = batch.IntersectTriangle(lhs, batch_infos);
+            CHECK((intersect_mask >> batch.GetSize()) == 0);
+
+            for (size_t i = first; i != last; ++i)
+            {
+                size_t index = i - first;
+                TrianglesIntersectionInfo scalar_info = TrianglePosition::IntersectTriangles(lhs, triangles[i]);
+                const TrianglesIntersectionInfo& batch_info = batch_infos[index];
+
+                ++stats.pairsCount;
+                stats.intersectionsCount += scalar_info.doIntersept ? 1 : 0;
+                stats.coplanarCount += scalar_info.doIntersept && scalar_info.areCoplanar ? 1 : 0;
+
+                CHECK(batch_info.doIntersept == (((intersect_mask >> index) & 1u) != 0));
+                if (batch_info.doIntersept != scalar_info.doIntersept)
+                {
+                    ++stats.mismatchesCount;
+                }
+                else if (scalar_info.doIntersept)
+                {
+                    CHECK(batch_info.areCoplanar == scalar_info.areCoplanar);
+                    if (not scalar_info.areCoplanar)
+                        CHECK(AreSegmentsClose(batch_info, scalar_info, 1.e-4f));
+                }
+            }
+        }
+    }
+
+    TrianglePosition CreateRandomTriangle(TestsRandom& random, float half_extent, float max_size)
+    {
+        glm::vec3 center = random.NextVec3(-half_extent, half_extent);
+        return TrianglePosition(center + random.NextVec3(-max_size, max_size),
+                                center + random.NextVec3(-max_size, max_size),
+                                center + random.NextVec3(-max_size, max_size));
+    }
+
+    void CompareRandom(TestsRandom& random)
+    {
+        PairsStats stats;
+
+        // Random triangles crossing each other
+        for (size_t i = 0; i != 500; ++i)
+        {
+            TrianglePosition lhs = CreateRandomTriangle(random, 0.5f, 0.6f);
+
+            std::vector<TrianglePosition> triangles;
+            for (size_t j = 0; j != 40; ++j)
+                triangles.emplace_back(CreateRandomTriangle(random, 0.5f, 0.6f));
+
+            CompareBatches(lhs, triangles, stats);
+        }
+
+        // Coplanar triangles, left to the scalar test
+        for (size_t i = 0; i != 200; ++i)
+        {
+            auto flatten = [](const TrianglePosition& triangle)
+            {
+                return TrianglePosition(glm::vec3(triangle.GetP(0).x, triangle.GetP(0).y, 0.f),
+                                        glm::vec3(triangle.GetP(1).x, triangle.GetP(1).y, 0.f),
+                                        glm::vec3(triangle.GetP(2).x, triangle.GetP(2).y, 0.f));
+            };
+
+            TrianglePosition lhs = flatten(CreateRandomTriangle(random, 0.5f, 0.6f));
+
+            std::vector<TrianglePosition> triangles;
+            for (size_t j = 0; j != 12; ++j)
+                triangles.emplace_back(flatten(CreateRandomTriangle(random, 0.5f, 0.6f)));
+            // Mixed with crossing ones at the same batches
+            for (size_t j = 0; j != 12; ++j)
+                triangles.emplace_back(CreateRandomTriangle(random, 0.5f, 0.6f));
+
+            CompareBatches(lhs, triangles, stats);
+        }
+
+        CHECK(stats.intersectionsCount > stats.pairsCount / 10);
+        CHECK(stats.coplanarCount != 0);
+        CHECK(stats.mismatchesCount == 0);
+
+        printf("random: %zu pairs, %zu intersections, %zu coplanar, %zu differences\n",
+               stats.pairsCount, stats.intersectionsCount, stats.coplanarCount, stats.mismatchesCount);
+    }
+
+    // Triangles of a mesh against the mesh moved by a little, so many pairs share or almost share vertices and edges
+    void CompareMesh(const char* mesh_name, TestsRandom& random, const std::vector<Triangle>& triangles)
+    {
+        std::vector<TrianglePosition> positions = GetTrianglesPositions(triangles);
+
+        PairsStats stats;
+        for (size_t placement = 0; placement != 4; ++placement)
+        {
+            glm::mat4 matrix = placement == 0 ? glm::mat4(1.f)
+                                              : CreateTranslationRotationMatrix(random.NextVec3(-0.05f, 0.05f), random.NextDirection(), random.NextFloat(0.f, 0.1f));
+
+            std::vector<TrianglePosition> moved_positions;
+            for (const TrianglePosition& this_position : positions)
+                moved_positions.emplace_back(matrix * this_position);
+
+            for (size_t i = 0; i < positions.size(); i += 7)
+                CompareBatches(positions[i], moved_positions, stats);
+        }
+
+        CHECK(stats.intersectionsCount != 0);
+        // Vertices and edges that touch are decided by rounding, and the lanes may be contracted to other fused
+        // multiply-adds than Triangle.cpp: counted, not failed
+        CHECK(stats.mismatchesCount * 1000 <= stats.pairsCount);
+
+        printf("%s: %zu pairs, %zu intersections, %zu coplanar, %zu differences\n",
+               mesh_name, stats.pairsCount, stats.intersectionsCount, stats.coplanarCount, stats.mismatchesCount);
+    }
+
+    void Benchmark(TestsRandom& random)
+    {
+        std::vector<TrianglePosition> lhs_triangles;
+        std::vector<TrianglePosition> rhs_triangles;
+        for (size_t i = 0; i != 2000; ++i)
+            lhs_triangles.emplace_back(CreateRandomTriangle(random, 0.5f, 0.4f));
+        for (size_t i = 0; i != TriangleBatch::width * 100; ++i)
+            rhs_triangles.emplace_back(CreateRandomTriangle(random, 0.5f, 0.4f));
+
+        std::vector<TriangleBatch> batches(rhs_triangles.size() / TriangleBatch::width);
+        for (size_t i = 0; i != rhs_triangles.size(); ++i)
+            batches[i / TriangleBatch::width].Add(rhs_triangles[i]);
+
+        size_t scalar_intersections_count = 0;
+        double scalar_time = MeasureBestTime(5, [&]()
+        {
+            scalar_intersections_count = 0;
+            for (const TrianglePosition& this_lhs : lhs_triangles)
+                for (const TrianglePosition& this_rhs : rhs_triangles)
+                    scalar_intersections_count += TrianglePosition::IntersectTriangles(this_lhs, this_rhs).doIntersept ? 1 : 0;
+        });
+
+        size_t batch_intersections_count = 0;
+        double batch_time = MeasureBestTime(5, [&]()
+        {
+            batch_intersections_count = 0;
+            std::array<TrianglesIntersectionInfo, TriangleBatch::width> intersections_info;
+            for (const TrianglePosition& this_lhs : lhs_triangles)
+                for (const TriangleBatch& this_batch : batches)
+                    batch_intersections_count += size_t(std::popcount(this_batch.IntersectTriangle(this_lhs, intersections_info)));
+        });
+
+        // Same budget as the meshes' touching pairs
+        size_t counts_difference = std::max(scalar_intersections_count, batch_intersections_count) - std::min(scalar_intersections_count, batch_intersections_count);
+        CHECK(counts_difference * 1000 <= scalar_intersections_count);
+
+        size_t pairs_count = lhs_triangles.size() * rhs_triangles.size();
+        printf("%zu triangle pairs, %zu intersect: scalar %.2f Mpairs/s, batches of %zu %.2f Mpairs/s\n",
+               pairs_count, scalar_intersections_count,
+               double(pairs_count) / scalar_time * 1.e-6, TriangleBatch::width, double(pairs_count) / batch_time * 1.e-6);
+    }
+}
+
+int main()
+{
+    TestsRandom random(16);
+
+    CompareRandom(random);
+    CompareMesh("box", random, CreateBoxTriangles(glm::vec3(1.f, 0.6f, 0.8f), 6));
+    CompareMesh("ellipsoid", random, CreateEllipsoidTriangles(glm::vec3(1.2f, 0.8f, 0.5f), 12, 24));
+
+    Benchmark(random);
+
+    return GetChecksResult("TriangleBatchTest");
+}
@@ -0,0 +1,278 @@
+// ECSwrapper's scheduled update against the sequential one, with stand-ins of the engine's components that declare the
+// same accesses: conflicting updates never overlap and keep their componentID order, results are the same, and frame times
+// of the declared accesses against those before, when only NodeData and the global matrices were schedulable
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include "TestsCommon.h"
+#include "ECS/ECSwrapper.h"
+#include "ECS/ComponentsIDsEnum.h"
+#include "WorkersPool.h"
+
+namespace
+{
+    std::atomic<size_t> updateTicks = 0;
+
+    // Mixes the data of the components it reads and writes into its own, and its own into those it writes, so an
+    // update overlapping a conflicting one changes the results
+    class SyntheticComp
+        :public ComponentBaseClass
+    {
+    public:
+        SyntheticComp(ECSwrapper* in_ecs_wrapper_ptr, componentIDenum in_component_ID, std::string in_name, UpdateAccess in_update_access, size_t data_size)
+            :ComponentBaseClass(in_ecs_wrapper_ptr),
+             component_ID(static_cast<componentID>(in_component_ID)),
+             name(std::move(in_name)),
+             updateAccess(std::move(in_update_access)),
+             data(data_size)
+        {
+            for (size_t i = 0; i != data.size(); ++i)
+                data[i] = (uint64_t(component_ID) << 32) + i;
+        }
+
+        void Update() override
+        {
+            size_t begin_tick = updateTicks++;
+
+            for (componentID this_read_ID : updateAccess.readComponentIDs)
+                MixFrom(GetSyntheticComp(this_read_ID));
+            for (componentID this_write_ID : updateAccess.writeComponentIDs)
+                if (this_write_ID != component_ID)
+                    MixFrom(GetSyntheticComp(this_write_ID));
+
+            for (componentID this_write_ID : updateAccess.writeComponentIDs)
+                if (this_write_ID != component_ID)
+                    AddTo(GetSyntheticComp(this_write_ID));
+
+            updateIntervals.emplace_back(begin_tick, updateTicks++);
+        }
+
+        UpdateAccess GetUpdateAccess() const override {return updateAccess;}
+        componentID GetComponentID() const override {return component_ID;}
+        std::string GetComponentName() const override {return name;}
+
+        uint64_t GetChecksum() const
+        {
+            uint64_t checksum = 0;
+            for (uint64_t this_value : data)
+                checksum = checksum * 31 + this_value;
+            return checksum;
+        }
+
+    private:
+        SyntheticComp* GetSyntheticComp(componentID component_id) const
+        {
+            return static_cast<SyntheticComp*>(ecsWrapper_ptr->GetComponentByID(component_id));
+        }
+
+        void MixFrom(const SyntheticComp* other_ptr)
+        {
+            for (size_t i = 0; i != data.size(); ++i)
+            {
+                uint64_t value = data[i] ^ other_ptr->data[i];
+                for (size_t round = 0; round != 8; ++round)
+                    value = (value ^ (value >> 29)) * 0xbf58476d1ce4e5b9ull;
+                data[i] = value;
+            }
+        }
+
+        void AddTo(SyntheticComp* other_ptr) const
+        {
+            for (size_t i = 0; i != data.size(); ++i)
+                other_ptr->data[i] += data[i];
+        }
+
+    public:
+        const componentID component_ID;
+        const std::string name;
+        const UpdateAccess updateAccess;
+
+        std::vector<uint64_t> data;
+        std::vector<std::pair<size_t, size_t>> updateIntervals;     // in updateTicks, one per update
+    };
+
+    UpdateAccess CreateUpdateAccess(std::vector<componentIDenum> read_IDs, std::vector<componentIDenum> write_IDs, bool reads_entities_handler = false)
+    {
+        UpdateAccess update_access;
+        update_access.isSchedulable = true;
+        update_access.readsEntitiesHandler = reads_entities_handler;
+        for (componentIDenum this_ID : read_IDs)
+            update_access.readComponentIDs.emplace_back(static_cast<componentID>(this_ID));
+        for (componentIDenum this_ID : write_IDs)
+            update_access.writeComponentIDs.emplace_back(static_cast<componentID>(this_ID));
+
+        return update_access;
+    }
+
+    // The accesses the engine's components declare. With "only_global_matrices", the ones before the rest declared theirs
+    std::vector<SyntheticComp*> CreateEngineLikeComps(ECSwrapper* ecs_wrapper_ptr, bool only_global_matrices, size_t data_size)
+    {
+        using enum componentIDenum;
+
+        struct CompDeclaration
+        {
+            componentIDenum componentEnum;
+            std::string name;
+            UpdateAccess updateAccess;
+        };
+        std::vector<CompDeclaration> declarations = {
+            {NodeData,              "NodeData",              CreateUpdateAccess({}, {NodeData})},
+            {AnimationComposer,     "AnimationComposer",     CreateUpdateAccess({}, {NodeData, AnimationActor, AnimationComposer})},
+            {AnimationActor,        "AnimationActor",        CreateUpdateAccess({}, {NodeData, AnimationActor})},
+            {EarlyNodeGlobalMatrix, "EarlyNodeGlobalMatrix", CreateUpdateAccess({NodeData}, {EarlyNodeGlobalMatrix}, true)},
+            {ModelCollision,        "ModelCollision",        UpdateAccess()},
+            {LateNodeGlobalMatrix,  "LateNodeGlobalMatrix",  CreateUpdateAccess({NodeData}, {LateNodeGlobalMatrix}, true)},
+            {DynamicMesh,           "DynamicMesh",           CreateUpdateAccess({}, {ModelDraw, DynamicMesh})},
+            {CameraDefaultInput,    "CameraDefaultInput",    CreateUpdateAccess({}, {Camera, CameraDefaultInput})},
+            {Camera,                "Camera",                CreateUpdateAccess({}, {Camera})},
+            {Light,                 "Light",                 CreateUpdateAccess({}, {Light})},
+            {ModelDraw,             "ModelDraw",             UpdateAccess()}};
+
+        std::vector<SyntheticComp*> comp_ptrs;
+        for (CompDeclaration& this_declaration : declarations)
+        {
+            bool was_schedulable = this_declaration.componentEnum == NodeData ||
+                                   this_declaration.componentEnum == EarlyNodeGlobalMatrix ||
+                                   this_declaration.componentEnum == LateNodeGlobalMatrix;
+            if (only_global_matrices && not was_schedulable)
+                this_declaration.updateAccess.isSchedulable = false;
+
+            auto comp_uptr = std::make_unique<SyntheticComp>(ecs_wrapper_ptr, this_declaration.componentEnum, this_declaration.name,
+                                                             std::move(this_declaration.updateAccess), data_size);
+            comp_ptrs.emplace_back(comp_uptr.get());
+            ecs_wrapper_ptr->AddComponentAndOwnership(std::move(comp_uptr));
+        }
+
+        return comp_ptrs;
+    }
+
+    bool DoUpdateAccessesConflict(const UpdateAccess& lhs, const UpdateAccess& rhs)
+    {
+        if (not lhs.isSchedulable || not rhs.isSchedulable)
+            return true;
+        if ((lhs.writesEntitiesHandler && (rhs.readsEntitiesHandler || rhs.writesEntitiesHandler)) ||
+            (rhs.writesEntitiesHandler && lhs.readsEntitiesHandler))
+            return true;
+
+        auto contains = [](const std::vector<componentID>& ids, componentID id)
+        {
+            return std::find(ids.begin(), ids.end(), id) != ids.end();
+        };
+
+        for (componentID this_write_ID : lhs.writeComponentIDs)
+            if (contains(rhs.readComponentIDs, this_write_ID) || contains(rhs.writeComponentIDs, this_write_ID))
+                return true;
+        for (componentID this_write_ID : rhs.writeComponentIDs)
+            if (contains(lhs.readComponentIDs, this_write_ID))
+                return true;
+
+        return false;
+    }
+
+    struct OrderStats
+    {
+        size_t conflictingPairsCount = 0;
+        size_t overlappingUpdatesCount = 0;     // of components without conflicts
+    };
+
+    // "comps" are at componentID order
+    OrderStats CheckUpdatesOrder(const std::vector<SyntheticComp*>& comps, size_t frames_count)
+    {
+        OrderStats stats;
+        for (size_t i = 0; i != comps.size(); ++i)
+        {
+            CHECK(comps[i]->updateIntervals.size() == frames_count);
+
+            for (size_t j = i + 1; j != comps.size(); ++j)
+            {
+                bool do_conflict = DoUpdateAccessesConflict(comps[i]->updateAccess, comps[j]->updateAccess);
+                stats.conflictingPairsCount += do_conflict ? 1 : 0;
+
+                for (size_t frame = 0; frame != frames_count; ++frame)
+                {
+                    std::pair<size_t, size_t> lhs_interval = comps[i]->updateIntervals[frame];
+                    std::pair<size_t, size_t> rhs_interval = comps[j]->updateIntervals[frame];
+
+                    // Conflicting ones keep componentID order, the others of a stage may run at any order or together
+                    if (do_conflict)
+                        CHECK(lhs_interval.second < rhs_interval.first);
+                    else if (lhs_interval.first < rhs_interval.second && rhs_interval.first < lhs_interval.second)
+                        ++stats.overlappingUpdatesCount;
+                }
+            }
+        }
+
+        return stats;
+    }
+
+    std::vector<uint64_t> RunFrames(WorkersPool* workers_pool_ptr, bool only_global_matrices, size_t data_size, size_t frames_count,
+                                    OrderStats* order_stats_ptr = nullptr)
+    {
+        ECSwrapper ecs_wrapper(nullptr);
+        std::vector<SyntheticComp*> comp_ptrs = CreateEngineLikeComps(&ecs_wrapper, only_global_matrices, data_size);
+        ecs_wrapper.SetWorkersPool(workers_pool_ptr);
+
+        for (size_t frame = 0; frame != frames_count; ++frame)
+            ecs_wrapper.Update();
+
+        if (order_stats_ptr != nullptr)
+            *order_stats_ptr = CheckUpdatesOrder(comp_ptrs, frames_count);
+
+        std::vector<uint64_t> checksums;
+        for (const SyntheticComp* this_comp_ptr : comp_ptrs)
+            checksums.emplace_back(this_comp_ptr->GetChecksum());
+
+        return checksums;
+    }
+
+    void CompareToSequential(WorkersPool& workers_pool)
+    {
+        std::vector<uint64_t> sequential_checksums = RunFrames(nullptr, false, 4096, 50);
+
+        size_t overlapping_updates_count = 0;
+        for (bool only_global_matrices : {true, false})
+        {
+            OrderStats order_stats;
+            std::vector<uint64_t> scheduled_checksums = RunFrames(&workers_pool, only_global_matrices, 4096, 50, &order_stats);
+
+            CHECK(scheduled_checksums == sequential_checksums);
+            CHECK(order_stats.conflictingPairsCount != 0);
+            overlapping_updates_count += order_stats.overlappingUpdatesCount;
+
+            printf("%s: %zu conflicting pairs, %zu overlapping updates of the others\n",
+                   only_global_matrices ? "only global matrices schedulable" : "declared accesses",
+                   order_stats.conflictingPairsCount, order_stats.overlappingUpdatesCount);
+        }
+
+        // Threads only overlap for sure when there are cores for them
+        if (std::thread::hardware_concurrency() > 1)
+            CHECK(overlapping_updates_count != 0);
+    }
+
+    void Benchmark(WorkersPool& workers_pool)
+    {
+        constexpr size_t data_size = 1 << 15;
+        constexpr size_t frames_count = 20;
+
+        double sequential_time = MeasureBestTime(3, [&]() {RunFrames(nullptr, false, data_size, frames_count);});
+        double before_time = MeasureBestTime(3, [&]() {RunFrames(&workers_pool, true, data_size, frames_count);});
+        double declared_time = MeasureBestTime(3, [&]() {RunFrames(&workers_pool, false, data_size, frames_count);});
+
+        printf("%zu threads, %u hardware threads: sequential %.2f ms/frame, only global matrices schedulable %.2f ms/frame, declared accesses %.2f ms/frame\n",
+               workers_pool.GetThreadsCount(), std::thread::hardware_concurrency(),
+               sequential_time / frames_count * 1.e3, before_time / frames_count * 1.e3, declared_time / frames_count * 1.e3);
+    }
+}
+
+int main()
+{
+    WorkersPool workers_pool(4);
+
+    CompareToSequential(workers_pool);
+    Benchmark(workers_pool);
+
+    return GetChecksResult("UpdateSchedulerTest");
+}